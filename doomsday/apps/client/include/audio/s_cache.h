@@ -6,6 +6,13 @@
  *  1) Figure out the ID of the sound.
  *  2) Call Sfx_Cache() to get a sfxsample_t.
  *  3) Pass the sfxsample_t to Sfx_StartSound().
+ *
+ * Samples can also be decoded and resampled in background threads, so that
+ * the first use of a sound does not stall the game: Sfx_Precache() begins
+ * decoding a sample ahead of time (e.g., for the sounds of a map), and
+ * Sfx_CacheAsync() returns a sample only if it is ready. Decoded samples
+ * enter the cache in Sfx_UpdateCache(), which also keeps the cache within
+ * its memory budget by purging the least recently used samples.
 
  * @authors Copyright © 2003-2013 Jaakko Keränen <jaakko.keranen@iki.fi>
  * @authors Copyright © 2013 Daniel Swanson <danij@dengine.net>
@@ -39,14 +46,48 @@ void Sfx_ShutdownCache(void);
 
 
 /**
+ * Called periodically (once per frame). Moves the samples decoded in the
+ * background into the cache and purges the least recently used samples that
+ * are not playing, if the cache is too large or they have not been used in a
+ * long time.
+ */
+void Sfx_UpdateCache(void);
+
+/**
+ * Caches the sample immediately, if it is not already cached.
+ *
  * @return  Ptr to the cached copy of the sample (give this ptr to
  *          Sfx_StartSound(); otherwise @c 0 if invalid.
  */
 sfxsample_t *Sfx_Cache(int id);
 
+/**
+ * Returns the sample if it has been cached. Otherwise, begins decoding it in
+ * the background (see Sfx_IsCaching()).
+ *
+ * @return  Ptr to the cached copy of the sample, or @c 0 if not yet cached.
+ */
+sfxsample_t *Sfx_CacheAsync(int id);
+
+/**
+ * Begins decoding a sample in the background, unless it is already cached.
+ */
+void Sfx_Precache(int id);
+
+/**
+ * Determines whether a sample is being decoded in the background.
+ */
+dd_bool Sfx_IsCaching(int id);
+
+/**
+ * Marks the sample as the most recently used one.
+ */
 void Sfx_CacheHit(int id);
 
 /**
+ * Determines the length of a sound. If the sample is not cached, the length is
+ * read from its header and the sample is decoded in the background.
+ *
  * @return  The length of the sound (in milliseconds).
  */
 uint Sfx_GetSoundLength(int id);
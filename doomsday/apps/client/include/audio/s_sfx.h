@@ -95,12 +95,6 @@ void Sfx_StartFrame(void);
 
 void Sfx_EndFrame(void);
 
-/**
- * Called periodically by S_Ticker(). If the cache is too large, stopped
- * samples with the lowest hitcount will be uncached.
- */
-void Sfx_PurgeCache(void);
-
 void Sfx_RefreshChannels(void);
 
 /**
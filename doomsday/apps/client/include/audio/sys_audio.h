@@ -32,6 +32,7 @@
 #include "api_audiod_sfx.h"
 #include "api_audiod_mus.h"
 #include "sys_audiod_dummy.h"
+#include "sys_audiod_softmixer.h"
 
 #ifndef DENG_DISABLE_SDLMIXER
 #  include "sys_audiod_sdlmixer.h"
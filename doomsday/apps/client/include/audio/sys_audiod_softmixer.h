@@ -0,0 +1,36 @@
+/** @file sys_audiod_softmixer.h  Built-in software mixer audio driver.
+ *
+ * @authors Copyright © 2015 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#ifndef DENG_SYSTEM_AUDIO_SOFTMIXER_H
+#define DENG_SYSTEM_AUDIO_SOFTMIXER_H
+
+#include <de/liblegacy.h>
+#include "api_audiod.h"
+#include "api_audiod_sfx.h"
+
+/**
+ * SFX interface that mixes all the channels itself (with de::AudioMixer) and
+ * outputs the result through an SDL audio device. Panning and distance
+ * attenuation of 3D sounds and the environmental reverb are done by the
+ * mixer, so the per-channel cost is low and hundreds of channels can play at
+ * the same time.
+ */
+DENG_EXTERN_C audiodriver_t audiod_softmixer;
+DENG_EXTERN_C audiointerface_sfx_t audiod_softmixer_sfx;
+
+#endif // DENG_SYSTEM_AUDIO_SOFTMIXER_H
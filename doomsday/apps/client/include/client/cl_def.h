@@ -51,7 +51,10 @@ int Cl_GameReady();
 /**
  * Sends a hello packet.
  * PCL_HELLO2 includes the Game ID (16 chars).
+ *
+ * @param flags  @c HELLOF_* flags. A keyframe hello asks for the world state
+ *               without restarting the session (see Sv_Handshake()).
  */
-void Cl_SendHello();
+void Cl_SendHello(int flags = 0);
 
 #endif // DENG_CLIENT_H
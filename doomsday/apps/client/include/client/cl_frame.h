@@ -24,7 +24,7 @@ void Cl_InitFrame();
 void Cl_ResetFrame();
 
 /**
- * Read a PSV_FRAME2/PSV_FIRST_FRAME2 packet.
+ * Read a PSV_FRAME2/PSV_FIRST_FRAME2 or PSV_FRAME3/PSV_FIRST_FRAME3 packet.
  */
 void Cl_Frame2Received(int packetType);
 
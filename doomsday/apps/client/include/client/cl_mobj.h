@@ -24,6 +24,8 @@
 #include "world/p_object.h"
 #include "world/clientmobjthinkerdata.h"
 
+class DeltaReader;
+
 /// Asserts that a given mobj is a client mobj.
 #define CL_ASSERT_CLMOBJ(mo)    DENG_ASSERT(Cl_IsClientMobj(mo));
 
@@ -61,19 +63,19 @@ void ClMobj_Link(mobj_t *cmo); // needed?
 void ClMobj_SetState(mobj_t *mo, int stnum); // needed?
 
 /**
- * Reads a single mobj delta (inside PSV_FRAME2 packet) from the message buffer
- * and applies it to the client mobj in question.
+ * Reads a single mobj delta (inside a PSV_FRAME2 or PSV_FRAME3 packet) from the
+ * message buffer and applies it to the client mobj in question.
  *
  * For client mobjs that belong to players, updates the real player mobj
  * accordingly.
  */
-void ClMobj_ReadDelta();
+void ClMobj_ReadDelta(DeltaReader &in);
 
 /**
- * Null mobjs deltas have their own type in a PSV_FRAME2 packet.
+ * Null mobjs deltas have their own type in a frame packet.
  * Here we remove the mobj in question.
  */
-void ClMobj_ReadNullDelta();
+void ClMobj_ReadNullDelta(DeltaReader &in);
 
 /**
  * Determines whether a mobj is a client mobj.
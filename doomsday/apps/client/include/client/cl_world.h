@@ -20,6 +20,8 @@
 #ifndef DENG_CLIENT_WORLD_MAP_H
 #define DENG_CLIENT_WORLD_MAP_H
 
+class DeltaReader;
+
 void Cl_InitTransTables();
 void Cl_ResetTransTables();
 
@@ -43,9 +45,10 @@ int Cl_LocalMobjType(int serverMobjType);
 int Cl_LocalMobjState(int serverMobjState);
 
 /**
- * Reads a sector delta from the PSV_FRAME2 message buffer and applies it to the world.
+ * Reads a sector delta from the PSV_FRAME2/PSV_FRAME3 message buffer and applies
+ * it to the world.
  */
-void Cl_ReadSectorDelta(int deltaType);
+void Cl_ReadSectorDelta(DeltaReader &in, int deltaType);
 
 /**
  * Reads a side delta from the message buffer and applies it to the world.
@@ -125,6 +125,12 @@ public:
      */
     Vertex *newVertex(Vector2d const &origin = de::Vector2d());
 
+    /**
+     * Add a @a vertex which was constructed for the mesh (but not by it) to the
+     * set of vertexes. Ownership is given to the mesh.
+     */
+    void addVertex(Vertex &vertex);
+
     /**
      * Construct a new half-edge.
      */
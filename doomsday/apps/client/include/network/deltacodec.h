@@ -0,0 +1,183 @@
+/**
+ * @file deltacodec.h
+ * Reading and writing the contents of frame deltas. @ingroup network
+ *
+ * The deltas of a PSV_FRAME2 packet consist of whole bytes, shorts and floats.
+ * A PSV_FRAME3 packet has the same structure (a type byte followed by the
+ * contents of the delta), but the contents of mobj, player and sector deltas
+ * are bit-packed:
+ *
+ * - IDs, flags and indices are variable-length integers;
+ * - other small signed values (heights, momentum) are stored with a two-bit
+ *   size class and only as many bits as the class requires;
+ * - mobj coordinates are relative to the coordinates previously transmitted
+ *   for the same mobj, when the receiver knows them;
+ * - angles are quantized to 4096 bins.
+ *
+ * Each delta is padded to a byte boundary so that a frame can still be cut
+ * after any delta and parsed one delta at a time.
+ *
+ * @authors Copyright © 2015 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#ifndef LIBDENG_NETWORK_DELTACODEC_H
+#define LIBDENG_NETWORK_DELTACODEC_H
+
+#include <de/types.h>
+#include <de/reader.h>
+#include <de/writer.h>
+#include <de/FlatHashMap>
+
+/**
+ * Mobj coordinates most recently transmitted in bit-packed deltas. The server
+ * keeps one for each client and the client keeps one for the server; both are
+ * updated in the same order as the deltas are written and read, so they always
+ * agree about the reference coordinates.
+ *
+ * Coordinates are stored in the transmitted precision (fixed_t >> 8).
+ */
+class DeltaOrigins
+{
+public:
+    struct Origin {
+        int32_t pos[3];
+        byte known;     ///< Bit for each axis whose coordinate is known.
+
+        Origin() : known(0) { pos[0] = pos[1] = pos[2] = 0; }
+    };
+
+public:
+    void clear();
+
+    /**
+     * Returns the coordinates known for an mobj. If nothing is known, the
+     * returned Origin has no known axes.
+     */
+    Origin origin(thid_t id) const;
+
+    /**
+     * Replaces the coordinates known for an mobj. Used for restoring the
+     * state when a written delta is canceled.
+     */
+    void setOrigin(thid_t id, Origin const &origin);
+
+    /// Forgets the coordinates of a removed mobj.
+    void remove(thid_t id);
+
+private:
+    de::FlatHashMap<thid_t, Origin> _origins;
+};
+
+/**
+ * Writes the contents of a delta in either of the frame formats.
+ */
+class DeltaWriter
+{
+public:
+    /**
+     * @param writer   Destination of the delta.
+     * @param origins  Reference coordinates. If @c NULL, the delta is written
+     *                 in the byte-aligned PSV_FRAME2 format; otherwise the
+     *                 delta is bit-packed.
+     */
+    DeltaWriter(Writer *writer, DeltaOrigins *origins = 0);
+
+    /// Pads the written bits to a byte boundary.
+    ~DeltaWriter();
+
+    bool isBitPacked() const;
+
+    void writeByte(byte v);
+    void writeUInt16(uint16_t v);
+    void writeUInt32(uint32_t v);
+    void writeInt32(int32_t v);
+    void writeFloat(float v);
+    void writePackedUInt16(uint16_t v);
+    void writePackedUInt32(uint32_t v);
+
+    /// Small signed value, for instance a plane height or momentum.
+    void writeInt16(int16_t v);
+
+    void writeId(uint16_t id);
+    void writeAngle(angle_t angle);
+
+    /**
+     * Writes one coordinate of an mobj's origin with 16.8 precision.
+     *
+     * @param id     Mobj ID.
+     * @param axis   Coordinate axis (VX, VY, VZ).
+     * @param value  Coordinate.
+     */
+    void writeCoord(thid_t id, int axis, fixed_t value);
+
+    /// Forgets the coordinates of a removed mobj.
+    void removeOrigin(thid_t id);
+
+private:
+    void writeBits(uint32_t value, int count);
+    void writeVarUInt(uint32_t value);
+    void writeSigned(int32_t value, int const widths[4]);
+
+    Writer *_writer;
+    DeltaOrigins *_origins;
+    uint64_t _bits;
+    int _count;
+};
+
+/**
+ * Reads the contents of a delta written with DeltaWriter.
+ */
+class DeltaReader
+{
+public:
+    /**
+     * @param reader   Source of the delta.
+     * @param origins  Reference coordinates. If @c NULL, the delta is in the
+     *                 byte-aligned PSV_FRAME2 format; otherwise the delta is
+     *                 bit-packed.
+     */
+    DeltaReader(Reader *reader, DeltaOrigins *origins = 0);
+
+    bool isBitPacked() const;
+
+    byte readByte();
+    uint16_t readUInt16();
+    uint32_t readUInt32();
+    int32_t readInt32();
+    float readFloat();
+    uint16_t readPackedUInt16();
+    uint32_t readPackedUInt32();
+    int16_t readInt16();
+    uint16_t readId();
+    angle_t readAngle();
+    fixed_t readCoord(thid_t id, int axis);
+
+    /// Forgets the coordinates of a removed mobj.
+    void removeOrigin(thid_t id);
+
+private:
+    uint32_t readBits(int count);
+    uint32_t readVarUInt();
+    int32_t readSigned(int const widths[4]);
+
+    Reader *_reader;
+    DeltaOrigins *_origins;
+    uint64_t _bits;
+    int _count;
+};
+
+#endif // LIBDENG_NETWORK_DELTACODEC_H
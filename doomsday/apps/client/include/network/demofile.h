@@ -0,0 +1,132 @@
+/**
+ * @file demofile.h
+ * Seekable demo files. @ingroup network
+ *
+ * A demo is a sequence of the packets received from the server, each stamped
+ * with the tic when it was received. The packets are stored in chunks that are
+ * compressed separately. A new chunk begins at every keyframe: a re-handshake
+ * requested from the server while recording, after which the server sends the
+ * complete world state (the same packets that a joining client gets). Playback
+ * can therefore begin at any keyframe.
+ *
+ * File layout (little-endian):
+ *
+ * <pre>
+ * Header:  "DDmo", version (uint32)
+ * Chunk:   start tic (uint32), flags (uint32), compressed size (uint32),
+ *          packet records compressed with qCompress()
+ * Index:   "DIdx", count (uint32), { tic (uint32), chunk offset (uint32) }...
+ * Footer:  index offset (uint32), length in tics (uint32), "DEnd"
+ * </pre>
+ *
+ * A packet record is: tic (uint32), length (uint32), type (byte), data.
+ *
+ * The index is written when the recording is stopped. If it is missing (e.g.,
+ * the recording was interrupted), the reader rebuilds it by scanning the chunk
+ * headers.
+ *
+ * @authors Copyright © 2015 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#ifndef LIBDENG_NETWORK_DEMOFILE_H
+#define LIBDENG_NETWORK_DEMOFILE_H
+
+#include <de/libcore.h>
+#include <de/Block>
+#include <de/Error>
+#include <de/NativePath>
+
+/**
+ * Writes a demo file.
+ */
+class DemoWriter
+{
+public:
+    /// The file could not be created. @ingroup errors
+    DENG2_ERROR(OpenError);
+
+public:
+    DemoWriter(de::NativePath const &path);
+
+    /// Finishes the file by writing the last chunk and the index.
+    ~DemoWriter();
+
+    /**
+     * Begins a keyframe. The packets written after this are stored in a new
+     * chunk that is listed in the index.
+     *
+     * @param tic  Tic of the keyframe.
+     */
+    void beginKeyframe(int tic);
+
+    void writePacket(int tic, de::dbyte type, void const *data, de::dsize length);
+
+private:
+    DENG2_PRIVATE(d)
+};
+
+/**
+ * Reads a demo file written with DemoWriter.
+ */
+class DemoReader
+{
+public:
+    /// The file could not be opened or it is not a demo file. @ingroup errors
+    DENG2_ERROR(FormatError);
+
+public:
+    DemoReader(de::NativePath const &path);
+
+    /**
+     * Determines whether a file is a demo file in this format (as opposed
+     * to an old-style LZSS-compressed demo).
+     */
+    static bool recognize(de::NativePath const &path);
+
+    /// Length of the demo in tics.
+    int length() const;
+
+    int keyframeCount() const;
+    int keyframeTic(int index) const;
+
+    /**
+     * Continues reading from a keyframe. The next packet read is the first
+     * packet of the keyframe.
+     */
+    void seekToKeyframe(int index);
+
+    /**
+     * Returns the tic of the next packet, or -1 if there are no more packets.
+     */
+    int nextTic();
+
+    /**
+     * Reads the next packet. nextTic() must have been called first to check
+     * that there is one.
+     *
+     * @param type  Packet type.
+     * @param data  Packet contents.
+     *
+     * @throws FormatError  The packet extends past the end of its chunk.
+     */
+    void readPacket(de::dbyte &type, de::Block &data);
+
+private:
+    DENG2_PRIVATE(d)
+};
+
+#endif // LIBDENG_NETWORK_DEMOFILE_H
@@ -51,6 +51,19 @@ dd_bool         Demo_BeginPlayback(const char* filename);
 dd_bool         Demo_ReadPacket(void);
 void            Demo_StopPlayback(void);
 
+/**
+ * Returns the current playback position in tics since the beginning of the demo.
+ */
+int             Demo_PlaybackTic(void);
+
+/**
+ * Continues playback from the keyframe nearest to @a tic. When seeking forward,
+ * the keyframe is always after the current position.
+ *
+ * @return @c false, if there is no such keyframe (or the demo has none).
+ */
+dd_bool         Demo_Seek(int tic);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
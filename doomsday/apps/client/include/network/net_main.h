@@ -113,11 +113,16 @@ enum {
     PCL_GOODBYE = 31,
     PSV_MOBJ_TYPE_ID_LIST = 32,
     PSV_MOBJ_STATE_ID_LIST = 33,
+    PSV_FRAME3 = 34,                // Frame packet v3 (bit-packed deltas)
+    PSV_FIRST_FRAME3 = 35,          // First PSV_FRAME3 after map change
 
     // Game specific events.
     PKT_GAME_MARKER = DDPT_FIRST_GAME_EVENT, // 64
 };
 
+// Flags for PCL_HELLO2. Optional; sent after the game ID.
+#define HELLOF_KEYFRAME     0x1    // Re-handshake for a demo keyframe; not a new session.
+
 // Use the number defined in dd_share.h for sound packets.
 // This is for backwards compatibility.
 #define PSV_SOUND           71     /* DDPT_SOUND */
@@ -200,8 +205,7 @@ typedef struct {
     // Ping tracker for this client.
     pinger_t        ping;
 
-    // Demo recording file (being recorded if not NULL).
-    LZFILE         *demo;
+    // Demo recording status.
     dd_bool         recording;
     dd_bool         recordPaused;
 
@@ -0,0 +1,98 @@
+/**
+ * @file timedemo.h
+ * Timedemo benchmarking. @ingroup network
+ *
+ * In a timedemo, a demo is played back as fast as possible: every refresh
+ * advances time by exactly one tic, regardless of how long the refresh took.
+ * While the demo plays, the durations of world tics, render preparation of
+ * frames, and frame delta decoding are sampled. When the demo ends, a summary
+ * is written in JSON so that it can be compared between builds.
+ *
+ * In headless mode, the game view is not drawn (render preparation is still
+ * done) and audio is played via the dummy driver, so that the results
+ * depend less on the GPU and sound hardware.
+ *
+ * @authors Copyright © 2015 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#ifndef LIBDENG_NETWORK_TIMEDEMO_H
+#define LIBDENG_NETWORK_TIMEDEMO_H
+
+#include <de/NativePath>
+
+#ifdef __SERVER__
+#  error Timedemos are not available in a SERVER build
+#endif
+
+/// Measured statistics.
+enum timedemostat_t
+{
+    TDS_WORLD_TIC,      ///< Running the tickers of one tic.
+    TDS_RENDER_PREP,    ///< Preparing the world for rendering a frame.
+    TDS_DELTA_DECODE,   ///< Reading a frame packet from the server.
+    NUM_TIMEDEMO_STATS
+};
+
+/**
+ * Begins measuring. Called when the playback of the demo begins.
+ *
+ * @param demoName     Name of the demo (for the summary).
+ * @param summaryPath  Where to write the JSON summary.
+ * @param headless     Skip drawing the game view.
+ */
+void TimeDemo_Begin(char const *demoName, de::NativePath const &summaryPath, bool headless);
+
+/**
+ * Ends measuring and writes the summary. Called when the playback of the
+ * demo ends. Does nothing if a timedemo is not running.
+ */
+void TimeDemo_End();
+
+bool TimeDemo_IsRunning();
+
+/**
+ * Determines whether the game view should be drawn.
+ */
+bool TimeDemo_IsHeadless();
+
+/**
+ * Determines whether headless mode was requested on the command line
+ * (-headless). Used during startup for choosing the dummy audio driver.
+ */
+bool TimeDemo_HeadlessRequested();
+
+/// Counts a refresh frame.
+void TimeDemo_NewFrame();
+
+void TimeDemo_AddSample(timedemostat_t stat, double seconds);
+
+/**
+ * Measures the duration of the enclosing scope for a statistic. Nothing is
+ * measured unless a timedemo is running.
+ */
+class TimeDemoSample
+{
+public:
+    TimeDemoSample(timedemostat_t stat);
+    ~TimeDemoSample();
+
+private:
+    timedemostat_t _stat;
+    double _startedAt; ///< Negative, if not measuring.
+};
+
+#endif // LIBDENG_NETWORK_TIMEDEMO_H
@@ -75,6 +75,7 @@ DENG_EXTERN_C de::dfloat modelSpinSpeed;
 DENG_EXTERN_C de::dint maxModelDistance;
 DENG_EXTERN_C de::dfloat rendModelLOD;
 DENG_EXTERN_C de::dbyte precacheSkins;
+DENG_EXTERN_C de::dbyte compactModels; ///< Load models with compact frames (see Model::compactFrames()).
 
 /**
  * Registers the console commands and variables used by this module.
@@ -126,7 +127,23 @@ TextureVariantSpec const &Rend_ModelDiffuseTextureSpec(bool noCompression);
 TextureVariantSpec const &Rend_ModelShinyTextureSpec();
 
 /**
- * Render all the submodels of a model.
+ * Prepares the vertices, lighting and shiny texture coordinates of all the
+ * models among the sorted vissprites. The work is divided among background
+ * threads, so that only the drawing remains for Rend_DrawModel(). Must be
+ * followed by Rend_ReleasePreparedModels() once the vissprites have been drawn.
+ *
+ * @param sortedHead  Head of the sorted list of vissprites.
+ */
+void Rend_PrepareModels(vissprite_t const &sortedHead);
+
+/**
+ * Forgets the models prepared with Rend_PrepareModels().
+ */
+void Rend_ReleasePreparedModels();
+
+/**
+ * Render all the submodels of a model. Models that have not been prepared with
+ * Rend_PrepareModels() are prepared first.
  */
 void Rend_DrawModel(vissprite_t const &spr);
 
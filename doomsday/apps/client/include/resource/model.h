@@ -61,6 +61,17 @@ public:
     };
     Q_DECLARE_FLAGS(Flags, Flag)
 
+    /**
+     * Vertex in the compact frame storage (see compactFrames()). The position
+     * is quantized to 16 bits within the bounds of the frame, and the normal is
+     * octahedral-encoded with 8 bits per component.
+     */
+    struct PackedVertex
+    {
+        de::dint16 pos[3];  ///< Position = Frame::packOffset + pos * Frame::packScale.
+        de::dint8 norm[2];  ///< Octahedral projection, scaled by 127.
+    };
+
     /**
      * Animation key-frame.
      */
@@ -72,15 +83,25 @@ public:
             de::Vector3f norm;
         };
         typedef QVector<Vertex> VertexBuf;
-        VertexBuf vertices;
+        VertexBuf vertices;          ///< Empty if the frame is compact.
+        PackedVertex const *packed;  ///< Compact vertices (owned by the model); otherwise @c 0.
+        de::Vector3f packOffset;
+        de::Vector3f packScale;
         de::Vector3f min;
         de::Vector3f max;
         de::String name;
 
         Frame(Model &model, de::String const &name = "")
-            : model(model), name(name)
+            : model(model), packed(0), name(name)
         {}
 
+        inline bool isCompact() const { return packed != 0; }
+
+        /**
+         * Returns vertex @a index, decoding it if the frame is compact.
+         */
+        Vertex vertex(int index) const;
+
         void bounds(de::Vector3f &min, de::Vector3f &max) const;
 
         float horizontalRange(float *top, float *bottom) const;
@@ -222,6 +243,19 @@ public:
      */
     void clearAllFrames();
 
+    /**
+     * Converts the animation frames to the compact storage format. The
+     * vertices of all the frames are packed contiguously with quantized
+     * positions and normals, taking a third of the memory; the full-precision
+     * vertices are released. The vertices are decoded when interpolated.
+     */
+    void compactFrames();
+
+    /**
+     * Determines whether the animation frames are in the compact storage format.
+     */
+    bool hasCompactFrames() const;
+
     /**
      * Lookup a model skin by @a name.
      *
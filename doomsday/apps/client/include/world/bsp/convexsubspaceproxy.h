@@ -163,6 +163,18 @@ public:
         return *this;
     }
 
+    /**
+     * Replace @a segment with the line segments that cover the same span (in
+     * order, from the start of @a segment), for instance the pieces of its twin
+     * after the twin was split elsewhere.
+     *
+     * @param segment       Line segment in the subspace to be replaced.
+     * @param replacements  Line segments to replace it with. Ownership is @em NOT
+     *                      given to the subspace.
+     */
+    void replaceSegment(LineSegmentSide const &segment,
+                        QList<LineSegmentSide *> const &replacements);
+
     /**
      * Build and assign all geometries to the BSP leaf specified. Note that
      * any existing geometries will be replaced (thus destroyed by BspLeaf).
@@ -24,6 +24,8 @@
 #define DENG_WORLD_BSP_PARTITIONER_H
 
 #include <QSet>
+#include <de/Block>
+#include <de/NativePath>
 #include <de/Observers>
 #include <de/Vector>
 
@@ -79,6 +81,27 @@ public:
      */
     void setSplitCostFactor(int newFactor);
 
+    /**
+     * Set the folder of the node cache. When set, the results of each build
+     * are written there, keyed by a checksum of the input geometry and the
+     * split cost factor. Subsequent builds of identical geometry are then
+     * loaded from the cache rather than partitioned again.
+     *
+     * @param folder  Native path of the cache folder. An empty path disables
+     *                the cache (the default).
+     */
+    void setCachePath(NativePath const &folder);
+
+    /**
+     * Change whether the two half-spaces of a partition are built concurrently
+     * (the default), when both are large enough to be worth a task. Which
+     * partitions are split up this way does not depend on the setting, so the
+     * output is the same either way.
+     *
+     * @param yes  @c false= build everything on the calling thread.
+     */
+    void setConcurrent(bool yes);
+
     /**
      * Build a new BspTree for the given geometry.
      *
@@ -96,6 +119,19 @@ public:
      */
     BspTree *makeBspTree(LineSet const &lines, Mesh &mesh);
 
+    /**
+     * Partition the given geometry as makeBspTree() would, without producing any
+     * map geometry (or using the node cache) and without notifying the audiences.
+     * Used for verifying and timing the build.
+     *
+     * @param lines  Set of lines to partition (ownership is unaffected).
+     *
+     * @return  Checksum of the resultant tree: the partitions, the bounds of the
+     * half-spaces and the line segments of each convex subspace. Identical
+     * builds produce identical checksums.
+     */
+    Block partitionChecksum(LineSet const &lines);
+
     /**
      * Retrieve the number of Segments owned by the partitioner. When the build
      * completes this number will be the total number of line segments that were
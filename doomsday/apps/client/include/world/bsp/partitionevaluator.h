@@ -38,6 +38,14 @@ public:
      */
     PartitionEvaluator(int splitCostFactor);
 
+    /**
+     * Change whether large sets of candidates are costed concurrently (the
+     * default). The choice is the same either way. Disable when choosing on a
+     * thread of the task pool, which would otherwise be left waiting for tasks
+     * queued behind its own.
+     */
+    void setConcurrent(bool yes);
+
     /**
      * Find the best line segment to use as the next partition.
      *
@@ -56,6 +56,13 @@ public:
 
     void link(LineSegmentSide &seg);
 
+    /**
+     * Replace the linked line segment @a seg with @a replacement, which takes its
+     * place in the list. Both must be of the same kind (map or partition line),
+     * so the ref counters are unaffected.
+     */
+    void replace(LineSegmentSide &seg, LineSegmentSide &replacement);
+
     void addRef(LineSegmentSide const &seg);
 
     void decRef(LineSegmentSide const &seg);
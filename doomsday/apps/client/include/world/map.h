@@ -71,6 +71,8 @@ class EntityDatabase;
 #ifdef __CLIENT__
 class LightGrid;
 #endif
+class Reject;
+class SightLineTable;
 class Thinkers;
 
 /**
@@ -105,6 +107,12 @@ public:
     /// Required thinker lists are missing. @ingroup errors
     DENG2_ERROR(MissingThinkersError);
 
+    /// Required reject data is missing. @ingroup errors
+    DENG2_ERROR(MissingRejectError);
+
+    /// Required sight line table is missing. @ingroup errors
+    DENG2_ERROR(MissingSightLineTableError);
+
 #ifdef __CLIENT__
     /// Required light grid is missing. @ingroup errors
     DENG2_ERROR(MissingLightGridError);
@@ -703,6 +711,36 @@ public:  // Data structures ----------------------------------------------------
      */
     BspLeaf &bspLeafAt_FixedPrecision(Vector2d const &point) const;
 
+    /**
+     * Returns @c true iff Reject data has been initialized for the map.
+     *
+     * @see reject()
+     */
+    bool hasReject() const;
+
+    /**
+     * Provides access to the sector => sector Reject data for the map, which
+     * is used to trivially reject line of sight tests.
+     *
+     * @see hasReject(), initReject()
+     */
+    Reject const &reject() const;
+
+    /**
+     * Returns @c true iff the SightLineTable has been built for the map.
+     *
+     * @see sightLineTable()
+     */
+    bool hasSightLineTable() const;
+
+    /**
+     * Provides access to the packed line geometry of each convex subspace, used
+     * for quickly rejecting lines during line of sight tests.
+     *
+     * @see hasSightLineTable()
+     */
+    SightLineTable const &sightLineTable() const;
+
     /**
      * Given an @a emitter origin, attempt to identify the map element
      * to which it belongs.
@@ -833,6 +871,13 @@ public: /// @todo Most of the following should be private:
      */
     void initPolyobjs();
 
+    /**
+     * Begin building the sector => sector Reject data for the map (or load
+     * it from the cache). Building is done in the background; line of sight
+     * tests are unaffected until it completes. To be called after map load.
+     */
+    void initReject();
+
 #ifdef __CLIENT__
     /**
      * Fixing the sky means that for adjacent sky sectors the lower sky
@@ -1,9 +1,6 @@
 /** @file reject.h World map sector LOS reject LUT building.
  *
- * @authors Copyright © 2007-2013 Daniel Swanson <danij@dengine.net>
- * @authors Copyright © 2000-2007 Andrew Apted <ajapted@gmail.com>
- * @authors Copyright © 1998-2000 Colin Reed <cph@moria.org.uk>
- * @authors Copyright © 1998-2000 Lee Killough <killough@rsn.hp.com>
+ * @authors Copyright © 2007-2015 Daniel Swanson <danij@dengine.net>
  *
  * @par License
  * GPL: http://www.gnu.org/licenses/gpl.html
@@ -23,55 +20,69 @@
 #ifndef DENG_WORLD_REJECT_H
 #define DENG_WORLD_REJECT_H
 
-#if 0 // Needs updating
+#include <de/libcore.h>
+
+class Sector;
+
+namespace de {
+
 class Map;
 
 /**
- * The REJECT resource is a LUT that provides the results of trivial
- * line-of-sight tests between sectors. This is done with a matrix of sector
- * pairs i.e. if a monster in sector 4 can see the player in sector 2; the
- * inverse should be true.
- *
- * Note however, some PWADS have carefully constructed REJECT data to create
- * special effects. For example it is possible to make a player completely
- * invissible in certain sectors.
- *
- * The format of the table is a simple matrix of dd_bool values, a (true)
- * value indicates that it is impossible for mobjs in sector A to see mobjs
- * in sector B (and vice-versa). A (false) value indicates that a
- * line-of-sight MIGHT be possible and a more accurate (thus more expensive)
- * calculation will have to be made.
- *
- * The table itself is constructed as follows:
- *
- *     X = sector num player is in
- *     Y = sector num monster is in
- *
- *         X
+ * Sector => sector "potentially visible set" used for trivially rejecting
+ * line-of-sight tests. This serves the same purpose as the REJECT resource
+ * of the original id Tech 1 map format, however it is built by the engine
+ * itself (many maps ship an empty or zeroed REJECT lump, which would leave
+ * every sight check to the full BSP trace).
  *
- *       0 1 2 3 4 ->
- *     0 1 - 1 - -
- *  Y  1 - - 1 - -
- *     2 1 1 - - 1
- *     3 - - - 1 -
- *    \|/
+ * Visibility is determined conservatively from the portals formed between
+ * the convex subspaces of adjacent sectors (i.e., the hedges of lines with
+ * a sector on both sides). A 2D anti-penumbra flood is performed from each
+ * sector; any sector which cannot be reached by a straight line through the
+ * chain of portals cannot possibly be seen. Sector heights are ignored as
+ * these may change during play (doors etc...).
  *
- * These results are read left-to-right, top-to-bottom and are packed into
- * bytes (each byte represents eight results). As are all lumps in WAD the
- * data is in little-endian order.
+ * Building may take some time on complex maps, so it is done in the
+ * background using a pool of worker tasks. Until the result is ready all
+ * sectors are assumed to be mutually visible. The result is cached on disk,
+ * keyed by a checksum of the portal geometry, so that subsequent loads of
+ * the same map are near instantaneous.
  *
- * Thus the size of a valid REJECT lump can be calculated as:
- *
- *     ceiling(numSectors^2)
- *
- * For now we only do very basic reject processing, limited to determining
- * all isolated sector groups (islands that are surrounded by void space).
- *
- * @note Algorithm:
- * Initially all sectors are in individual groups. Next, we scan the line
- * list. For each 2-sectored line, merge the two sector groups into one.
+ * @ingroup world
  */
-byte *BuildRejectForMap(Map const &map);
-#endif
+class Reject
+{
+public:
+    /**
+     * Begin building the reject data for the given @a map (or load it from
+     * the cache). The map geometry is sampled immediately; the map is not
+     * referenced afterward.
+     */
+    Reject(Map const &map);
+
+    /**
+     * Returns @c true if the reject data is ready for use.
+     */
+    bool isReady() const;
+
+    /**
+     * Returns the number of sectors in the matrix.
+     */
+    dint sectorCount() const;
+
+    /**
+     * Determines whether a line of sight between @a a and @a b is possible.
+     * The result is conservative: @c false is only returned if it has been
+     * determined that neither sector can see into the other.
+     *
+     * If the reject data is not yet ready, @c true is always returned.
+     */
+    bool mightSee(Sector const &a, Sector const &b) const;
+
+private:
+    DENG2_PRIVATE(d)
+};
+
+} // namespace de
 
 #endif // DENG_WORLD_REJECT_H
@@ -0,0 +1,126 @@
+/** @file sightlinetable.h  Packed line geometry for line of sight testing.
+ *
+ * @authors Copyright © 2015 Daniel Swanson <danij@dengine.net>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#ifndef DENG_WORLD_SIGHTLINETABLE_H
+#define DENG_WORLD_SIGHTLINETABLE_H
+
+#include <de/aabox.h>
+#include <de/libcore.h>
+#include <de/Vector>
+#include "Line"
+
+class ConvexSubspace;
+
+namespace de {
+
+class Map;
+
+/**
+ * Read-only table of the line sides which bound each convex subspace of a map,
+ * with the line end points packed as a structure of arrays. A line of sight
+ * trace entering a subspace can then reject, in one vectorized pass, all the
+ * lines which either miss the bounds of the ray or lie entirely on one side of
+ * it, before touching any of the Line objects themselves.
+ *
+ * The side test is conservative: a line is only rejected when both of its end
+ * points are clear of the ray by more than the rounding error of the fixed-point
+ * test in LineSightTest, so the survivors are exactly the lines it would need to
+ * examine (plus a few borderline cases it resolves itself).
+ *
+ * Only the (static) lines of the primary map geometry are included; polyobj
+ * lines move and are tested separately.
+ *
+ * @ingroup world
+ */
+class SightLineTable
+{
+public:
+    /// Number of entries considered in one batch.
+    static dint const BATCH_SIZE = 8;
+
+    /**
+     * Line of sight ray, prepared for testing against the table.
+     */
+    struct Ray
+    {
+        ddouble fromX, fromY;
+        ddouble dirX, dirY;
+        ddouble slack;  ///< Error allowance of the side test due to the ray.
+        AABoxd box;
+
+        Ray(Vector2d const &from, Vector2d const &to);
+    };
+
+public:
+    /**
+     * Build the table for all the convex subspaces of @a map.
+     */
+    SightLineTable(Map const &map);
+
+    /**
+     * Returns the total number of entries in the table.
+     */
+    dint entryCount() const;
+
+    /**
+     * Iterate the line sides bounding @a subspace which may be crossed by @a ray.
+     * The order is the same as that of the subspace's half-edges (followed by
+     * those of any extra meshes).
+     *
+     * @param subspace  Convex subspace of the map.
+     * @param ray       Ray to check for crossing.
+     * @param func      Callback made for each line side which may cross the ray.
+     *
+     * @return  @c LoopAbort if @a func aborted iteration.
+     */
+    template <typename Func>
+    LoopResult forAllCrossing(ConvexSubspace const &subspace, Ray const &ray,
+                              Func func) const
+    {
+        dint first, last;
+        range(subspace, first, last);
+        for(dint i = first; i < last; i += BATCH_SIZE)
+        {
+            for(duint mask = crossingMask(i, de::min(i + BATCH_SIZE, last), ray); mask; mask &= mask - 1)
+            {
+                if(auto result = func(side(i + lowestBit(mask))))
+                    return result;
+            }
+        }
+        return LoopContinue;
+    }
+
+private:
+    void range(ConvexSubspace const &subspace, dint &first, dint &last) const;
+    duint crossingMask(dint first, dint last, Ray const &ray) const;
+    LineSide &side(dint index) const;
+
+    static inline dint lowestBit(duint mask)
+    {
+        dint bit = 0;
+        while(!(mask & 1)) { mask >>= 1; bit++; }
+        return bit;
+    }
+
+    DENG2_PRIVATE(d)
+};
+
+} // namespace de
+
+#endif // DENG_WORLD_SIGHTLINETABLE_H
@@ -24,6 +24,7 @@
 #include "de_misc.h"
 #include "de_audio.h"
 #include "audio/sys_audio.h"
+#include "network/timedemo.h"
 
 #include <de/Library>
 #include <de/LibraryFile>
@@ -45,7 +46,8 @@ static const char* driverIdentifier[AUDIODRIVER_COUNT] = {
     "fmod",
     "fluidsynth",
     "dsound",
-    "winmm"
+    "winmm",
+    "softmixer"
 };
 
 // The active/loaded interfaces.
@@ -181,7 +183,8 @@ static const char* getDriverName(audiodriverid_t id)
     /* AUDIOD_FMOD */       "FMOD",
     /* AUDIOD_FLUIDSYNTH */ "FluidSynth",
     /* AUDIOD_DSOUND */     "DirectSound", // Win32 only
-    /* AUDIOD_WINMM */      "Windows Multimedia" // Win32 only
+    /* AUDIOD_WINMM */      "Windows Multimedia", // Win32 only
+    /* AUDIOD_SOFTMIXER */  "Software Mixer"
     };
     if(VALID_AUDIODRIVER_IDENTIFIER(id))
         return audioDriverNames[id];
@@ -235,6 +238,11 @@ static dd_bool initDriver(audiodriverid_t id)
         break;
 #endif
 
+    case AUDIOD_SOFTMIXER: // built-in
+        memcpy(&d->interface, &audiod_softmixer, sizeof(d->interface));
+        memcpy(&d->sfx, &audiod_softmixer_sfx, sizeof(d->sfx));
+        break;
+
     case AUDIOD_OPENAL:
         if(!loadAudioDriver(d, "openal"))
             return false;
@@ -277,7 +285,7 @@ static dd_bool initDriver(audiodriverid_t id)
 static audiodriverid_t chooseAudioDriver(void)
 {
     // No audio output?
-    if(isDedicated || CommandLine_Exists("-dummy"))
+    if(isDedicated || CommandLine_Exists("-dummy") || TimeDemo_HeadlessRequested())
         return AUDIOD_DUMMY;
 
     if(CommandLine_Exists("-fmod"))
@@ -296,6 +304,10 @@ static audiodriverid_t chooseAudioDriver(void)
         return AUDIOD_WINMM;
 #endif
 
+    // Mix sound effects in the engine?
+    if(CommandLine_Exists("-softmixer"))
+        return AUDIOD_SOFTMIXER;
+
 #ifndef DENG_DISABLE_SDLMIXER
     if(CommandLine_Exists("-sdlmixer"))
         return AUDIOD_SDL_MIXER;
@@ -26,6 +26,18 @@
 #include "de_audio.h"
 #include "de_misc.h"
 
+#include <de/Guard>
+#include <de/Lockable>
+#include <de/Resampler>
+#include <de/Task>
+#include <de/TaskPool>
+#include <QHash>
+#include <QScopedPointer>
+#include <QList>
+#include <QSet>
+#include <QVector>
+#include <cmath>
+
 using namespace de;
 
 #ifdef __SERVER__
@@ -33,20 +45,15 @@ using namespace de;
 #  define END_COP
 #endif
 
-// The cached samples are stored in a hash. When a sample is purged, its
-// data will stay in the hash (sample lengths needed by the Logical Sound
-// Manager).
 #define CACHE_HASH_SIZE     (64)
 
-#define PURGE_TIME          (10 * TICSPERSEC)
-
 // Convert an unsigned byte to signed short (for resampling).
 #define U8_S16(b)           (((byte)(b) - 0x80) << 8)
 
 struct SfxCache
 {
     SfxCache *next, *prev;
-    int hits;
+    SfxCache *older, *newer; // Least recently used order.
     int lastUsed; // Tic the sample was last hit.
     sfxsample_t sample;
 };
@@ -56,24 +63,77 @@ struct CacheHash
     SfxCache *first, *last;
 };
 
+/**
+ * Sample data read from a file or lump, waiting to be decoded.
+ */
+struct SampleSource
+{
+    int id;
+    int group;
+    bool isWave;        ///< RIFF WAVE; otherwise a DOOM format sample.
+    Block data;
+    String name;        ///< For log messages.
+
+    // Format of the cached sample.
+    int bits;
+    int rate;
+    bool mustUpsample;
+};
+
 // 1 Mb = about 12 sec of 44KHz 16bit sound in the cache.
-int sfxMaxCacheKB = 4096;
+int sfxMaxCacheKB = 16384;
 
 // Even one minute of silence is quite a long time during gameplay.
 int sfxMaxCacheTics = TICSPERSEC * 60 * 4; // 4 minutes.
 
+// Guards all the cache state below. Samples are precached during map setup
+// in the busy worker thread, while the main thread may be updating the cache.
+static Lockable cacheLock;
+
 static CacheHash scHash[CACHE_HASH_SIZE];
+static SfxCache *lruOldest, *lruNewest;
+static uint totalBytes; // Size of the cached sample data.
+
+static QSet<int> decoding;                  ///< Ids of samples being decoded.
+static QList<sfxsample_t> decoded;          ///< Decoded, not yet in the cache.
+
+// Lengths of the sounds in milliseconds. These stay known when a sample is
+// purged (sample lengths are needed by the Logical Sound Manager).
+static QHash<int, uint> sampleLengths;
 
 static void Sfx_Uncache(SfxCache *node);
 
+static TaskPool &decodeTasks()
+{
+    static TaskPool pool;
+    return pool;
+}
+
 void Sfx_InitCache()
 {
+    DENG2_GUARD(cacheLock);
+
     // The cache is empty in the beginning.
     std::memset(scHash, 0, sizeof(scHash));
+    lruOldest = lruNewest = 0;
+    totalBytes = 0;
 }
 
 void Sfx_ShutdownCache()
 {
+    // Samples still being decoded are of no use any more.
+    decodeTasks().waitForDone();
+
+    DENG2_GUARD(cacheLock);
+
+    foreach(sfxsample_t const &sample, decoded)
+    {
+        M_Free(sample.data);
+    }
+    decoded.clear();
+    decoding.clear();
+    sampleLengths.clear();
+
     // Uncache all the samples in the cache.
     for(int i = 0; i < CACHE_HASH_SIZE; ++i)
     {
@@ -102,159 +162,106 @@ static SfxCache *Sfx_GetCached(int id)
     return 0;
 }
 
+static void lruUnlink(SfxCache *node)
+{
+    if(node->older) node->older->newer = node->newer;
+    else            lruOldest = node->newer;
+
+    if(node->newer) node->newer->older = node->older;
+    else            lruNewest = node->older;
+
+    node->older = node->newer = 0;
+}
+
+static void lruAppend(SfxCache *node)
+{
+    node->older = lruNewest;
+    node->newer = 0;
+    if(lruNewest) lruNewest->newer = node;
+    lruNewest = node;
+    if(!lruOldest) lruOldest = node;
+}
+
+static bool isPlaying(int id)
+{
+#ifdef __CLIENT__
+    return Sfx_CountPlaying(id) > 0;
+#else
+    DENG2_UNUSED(id);
+    return false;
+#endif
+}
+
 /**
- * Simple linear resampling with possible conversion to 16 bits.
- * The destination sample must be initialized and it must have a large
- * enough buffer. We won't reduce rate or bits here.
- *
- * @note This is not a clean way to resample a sound. If you read about
- * DSP a bit, you'll find out that interpolation adds a lot of extra
- * frequencies in the sample. It should be low-pass filtered after the
- * interpolation.
+ * Converts sample data to another sample size. Unsigned 8-bit samples are
+ * converted to signed 16-bit ones. We won't reduce bits here.
  */
-static void resample(void *dst, int dstBytesPer, int dstRate,
-                     void const *src, int srcBytesPer, int srcRate,
-                     int srcNumSamples, uint srcSize)
+static void convertSampleSize(void *dst, int dstBytesPer, void const *src, int srcBytesPer,
+                              int numSamples)
 {
     DENG_ASSERT(src);
     DENG_ASSERT(dst);
 
-    // Let's first check for the easy cases.
-    if(dstRate == srcRate)
+    if(srcBytesPer == dstBytesPer)
     {
-        if(srcBytesPer == dstBytesPer)
-        {
-            // A simple copy will suffice.
-            std::memcpy(dst, src, srcSize);
-        }
-        else if(srcBytesPer == 1 && dstBytesPer == 2)
-        {
-            // Just changing the bytes won't do much good...
-            unsigned char const *sp = (unsigned char const *) src;
-            short *dp = (short *) dst;
+        // A simple copy will suffice.
+        std::memcpy(dst, src, numSamples * srcBytesPer);
+    }
+    else if(srcBytesPer == 1 && dstBytesPer == 2)
+    {
+        unsigned char const *sp = (unsigned char const *) src;
+        short *dp = (short *) dst;
 
-            for(int i = 0; i < srcNumSamples; ++i)
-            {
-                *dp++ = (*sp++ - 0x80) << 8;
-            }
+        for(int i = 0; i < numSamples; ++i)
+        {
+            *dp++ = U8_S16(*sp++);
         }
-
-        return;
     }
+}
 
-    // 2x resampling.
-    if(dstRate == 2 * srcRate)
+/**
+ * Converts sample data to floating point (-1...1).
+ */
+static void samplesToFloat(float *dst, void const *src, int srcBytesPer, int numSamples)
+{
+    if(srcBytesPer == 1)
     {
-        if(dstBytesPer == 1)
-        {   // The source has a byte per sample as well.
-            unsigned char const *sp = (unsigned char const *) src;
-            unsigned char *dp = (unsigned char *) dst;
-
-            for(int i = 0; i < srcNumSamples - 1; ++i, sp++)
-            {
-                *dp++ = *sp;
-                *dp++ = (*sp + sp[1]) >> 1;
-            }
-
-            // Fill in the last two as well.
-            dp[0] = dp[1] = *sp;
-        }
-        else if(srcBytesPer == 1)
+        unsigned char const *sp = (unsigned char const *) src;
+        for(int i = 0; i < numSamples; ++i)
         {
-            // Destination is signed 16bit. Source is 8bit.
-            unsigned char const *sp = (unsigned char const *) src;
-            short *dp = (short *) dst;
-            short first;
-
-            for(int i = 0; i < srcNumSamples - 1; ++i, sp++)
-            {
-                *dp++ = first = U8_S16(*sp);
-                *dp++ = (first + U8_S16(sp[1])) >> 1;
-            }
-
-            // Fill in the last two as well.
-            dp[0] = dp[1] = U8_S16(*sp);
+            dst[i] = (sp[i] - 0x80) / 128.f;
         }
-        else if(srcBytesPer == 2)
+    }
+    else
+    {
+        short const *sp = (short const *) src;
+        for(int i = 0; i < numSamples; ++i)
         {
-            // Destination is signed 16bit. Source is 16bit.
-            short const *sp = (short const *) src;
-            short *dp = (short *) dst;
-
-            for(int i = 0; i < srcNumSamples - 1; ++i, sp++)
-            {
-                *dp++ = *sp;
-                *dp++ = (*sp + sp[1]) >> 1;
-            }
-
-            dp[0] = dp[1] = *sp;
+            dst[i] = sp[i] / 32768.f;
         }
-
-        return;
     }
+}
 
-    // 4x resampling (11Khz => 44KHz only).
-    if(dstRate == 4 * srcRate)
+/**
+ * Converts floating point sample data (-1...1) to unsigned 8-bit or signed
+ * 16-bit samples. Values out of range are clipped.
+ */
+static void floatToSamples(void *dst, int dstBytesPer, float const *src, int numSamples)
+{
+    if(dstBytesPer == 1)
     {
-        if(dstBytesPer == 1)
+        unsigned char *dp = (unsigned char *) dst;
+        for(int i = 0; i < numSamples; ++i)
         {
-            // The source has a byte per sample as well.
-            unsigned char const *sp = (unsigned char const *) src;
-            unsigned char *dp = (unsigned char *) dst;
-            unsigned char mid;
-
-            for(int i = 0; i < srcNumSamples - 1; ++i, sp++)
-            {
-                mid = (*sp + sp[1]) >> 1;
-                *dp++ = *sp;
-                *dp++ = (*sp + mid) >> 1;
-                *dp++ = mid;
-                *dp++ = (mid + sp[1]) >> 1;
-            }
-
-            // Fill in the last four as well.
-            dp[0] = dp[1] = dp[2] = dp[3] = *sp;
-        }
-        else if(srcBytesPer == 1)
-        {
-            // Destination is signed 16bit. Source is 8bit.
-            unsigned char const *sp = (unsigned char const *) src;
-            short *dp = (short *) dst;
-            short first, mid, last;
-
-            for(int i = 0; i < srcNumSamples - 1; ++i, sp++)
-            {
-                first = U8_S16(*sp);
-                last = U8_S16(sp[1]);
-                mid = (first + last) >> 1;
-                *dp++ = first;
-                *dp++ = (first + mid) >> 1;
-                *dp++ = mid;
-                *dp++ = (mid + last) >> 1;
-            }
-
-            // Fill in the last four as well.
-            dp[0] = dp[1] = dp[2] = dp[3] = U8_S16(*sp);
+            dp[i] = (unsigned char) de::clamp(0, int(std::floor(src[i] * 128 + .5f)) + 0x80, 255);
         }
-        else if(srcBytesPer == 2)
+    }
+    else
+    {
+        short *dp = (short *) dst;
+        for(int i = 0; i < numSamples; ++i)
         {
-            // Destination is signed 16bit. Source is 16bit.
-            short const *sp = (short const *) src;
-            short *dp = (short *) dst;
-            short mid;
-
-            for(int i = 0; i < srcNumSamples - 1; ++i, sp++)
-            {
-                mid = (*sp + sp[1]) >> 1;
-
-                *dp++ = *sp;
-                *dp++ = (*sp + mid) >> 1;
-                *dp++ = mid;
-                *dp++ = (mid + sp[1]) >> 1;
-            }
-
-            // Fill in the last four as well.
-            dp[0] = dp[1] = dp[2] = dp[3] = *sp;
+            dp[i] = (short) de::clamp(-32768, int(std::floor(src[i] * 32768 + .5f)), 32767);
         }
     }
 }
@@ -279,37 +286,20 @@ static bool sfxMustUpsampleToSfxRate()
 #endif
 
 /**
- * Caches a copy of the given sample. If it's already in the cache and has
- * the same format, nothing is done.
+ * Makes a copy of the given sample in the format of the cache. This can be
+ * done in any thread.
  *
- * @param id            Id number of the sound sample.
+ * @param src           Source of the sample (determines the format).
  * @param data          Actual sample data.
- * @param size          Size in bytes.
  * @param numSamples    Number of samples.
  * @param bytesPer      Bytes per sample (1 or 2).
  * @param rate          Samples per second.
- * @param group         Exclusion group (0, if none).
  *
- * @returns             Ptr to the cached sample. Always valid.
+ * @returns  The converted sample. The data is allocated with M_Malloc().
  */
-static SfxCache *Sfx_CacheInsert(int id, void const *data, uint size, int numSamples,
-    int bytesPer, int rate, int group)
+static sfxsample_t convertSample(SampleSource const &src, void const *data, int numSamples,
+                                 int bytesPer, int rate)
 {
-    int rsfactor = 1;
-
-    /**
-     * First convert the sample to the minimum resolution and bits, set
-     * by sfxRate and sfxBits.
-     */
-
-#ifdef __CLIENT__
-    // The (up)resampling factor.
-    if(sfxMustUpsampleToSfxRate())
-    {
-        rsfactor = de::max(1, sfxRate / rate);
-    }
-#endif
-
     /**
      * If the sample is already in the right format, just make a copy of it.
      * If necessary, resample the sound upwards, but not downwards.
@@ -318,67 +308,265 @@ static SfxCache *Sfx_CacheInsert(int id, void const *data, uint size, int numSam
      */
 
     sfxsample_t cached;
-    cached.size = numSamples * bytesPer * rsfactor;
+    cached.id = src.id;
+    cached.group = src.group;
+    cached.bytesPer = (src.bits == 16? 2 : bytesPer); // 8-bit will be converted to 16-bit.
+    cached.rate = (src.mustUpsample? de::max(rate, src.rate) : rate);
 
-    if(sfxBits == 16 && bytesPer == 1)
+    if(cached.rate == rate)
     {
-        cached.bytesPer = 2;
-        cached.size *= 2; // Will be resampled to 16bit.
+        cached.numSamples = numSamples;
+        cached.size = numSamples * cached.bytesPer;
+        cached.data = M_Malloc(cached.size);
+        convertSampleSize(cached.data, cached.bytesPer, data, bytesPer, numSamples);
+        return cached;
     }
-    else
+
+    // Resample with a band-limited filter, so that no spurious high
+    // frequencies are added.
+    Resampler resampler(rate, cached.rate);
+
+    QVector<float> input(numSamples);
+    samplesToFloat(input.data(), data, bytesPer, numSamples);
+
+    QVector<float> output(int(resampler.outputLength(numSamples)));
+    resampler.convert(input.constData(), numSamples, output.data());
+
+    cached.numSamples = output.size();
+    cached.size = cached.numSamples * cached.bytesPer;
+    cached.data = M_Malloc(cached.size);
+    floatToSamples(cached.data, cached.bytesPer, output.constData(), cached.numSamples);
+    return cached;
+}
+
+/**
+ * Reads the header of an old-fashioned DOOM format sample.
+ *
+ * @return  @c true, if the data looks like a DOOM sample. The sample data
+ * (8-bit) follows the 8-byte header.
+ */
+static bool readDoomSampleHeader(Block const &data, int &rate, int &numSamples)
+{
+    if(data.size() <= 8) return false;
+
+    byte const *hdr = data.data();
+    int head        = DD_SHORT(*(short const *) (hdr));
+    rate            = DD_USHORT(*(unsigned short const *) (hdr + 2));
+    numSamples      = de::max(0, DD_LONG(*(int const *) (hdr + 4)));
+
+    return head == 3 && rate > 0 && numSamples > 0 && numSamples <= int(data.size()) - 8;
+}
+
+/**
+ * Determines the length of a sample from the header of its data, without
+ * decoding it.
+ *
+ * @return  Length in milliseconds, or zero if the format is not recognized.
+ */
+static uint sampleSourceLength(SampleSource const &src)
+{
+    int bits = 0, rate = 0, numSamples = 0;
+    if(src.isWave)
+    {
+        if(!WAV_MemoryInfo(src.data.data(), src.data.size(), &bits, &rate, &numSamples))
+            return 0;
+    }
+    else if(!readDoomSampleHeader(src.data, rate, numSamples))
     {
-        cached.bytesPer = bytesPer;
+        return 0;
     }
+    if(rate <= 0) return 0;
+    return uint((1000 * duint64(numSamples)) / uint(rate));
+}
+
+/**
+ * Decodes a sample and converts it to the format of the cache. This can be
+ * done in any thread.
+ *
+ * @returns  The decoded sample. If decoding failed, the data is @c NULL.
+ */
+static sfxsample_t decodeSample(SampleSource const &src)
+{
+    LOG_AS("Sfx_Cache");
 
-    cached.rate = rsfactor * rate;
-    cached.numSamples = numSamples * rsfactor;
-    cached.id = id;
-    cached.group = group;
+    sfxsample_t failed;
+    std::memset(&failed, 0, sizeof(failed));
+    failed.id = src.id;
 
-    // Check if this kind of a sample already exists.
-    SfxCache *node = Sfx_GetCached(id);
-    if(node)
+    if(src.isWave)
+    {
+        int bits = 0, rate = 0, numSamples = 0;
+        void *data = WAV_MemoryLoad(src.data.data(), src.data.size(), &bits, &rate, &numSamples);
+        if(!data || rate <= 0)
+        {
+            LOG_AUDIO_WARNING("Unknown WAV format in \"%s\"") << src.name;
+            Z_Free(data);
+            return failed;
+        }
+
+        sfxsample_t const sample = convertSample(src, data, numSamples, bits / 8, rate);
+        Z_Free(data);
+        return sample;
+    }
+
+    // Probably an old-fashioned DOOM sample.
+    int rate = 0, numSamples = 0;
+    if(readDoomSampleHeader(src.data, rate, numSamples))
     {
-        // The sound is already in the cache. Is it in the right format?
-        if(cached.bytesPer * 8 == sfxBits && cached.rate == sfxRate)
-            return node; // This will do.
+        // The sample data follows the header; it is 8-bit.
+        return convertSample(src, src.data.data() + 8, numSamples, 1, rate);
+    }
+
+    LOG_AUDIO_WARNING("Unknown lump '%s' sound format") << src.name;
+    return failed;
+}
 
+/**
+ * Reads a WAV file in its entirety.
+ *
+ * @return  @c true, if the file was found and it looks like WAV.
+ */
+static bool readWaveFile(String const &path, Block &data)
+{
+    try
+    {
+        // Relative paths are relative to the native working directory.
+        String const absPath = (NativePath::workPath() / NativePath(path).expand()).withSeparators('/');
+        QScopedPointer<FileHandle> hndl(&App_FileSystem().openFile(absPath, "rb"));
+        data.resize(hndl->length());
+        hndl->read(data.data(), data.size());
+        App_FileSystem().releaseFile(hndl->file());
+
+        return data.size() >= 12 && WAV_CheckFormat(data.constData());
+    }
+    catch(FS1::NotFoundError const &)
+    {} // Ignore this error.
+    return false;
+}
+
+/**
+ * Reads the data of a sound for decoding. The file system is not thread-safe,
+ * so this is done in the thread where the sound is requested; the decoding
+ * and resampling can then be done in any thread.
+ *
+ * @return  @c true, if the data was found.
+ */
+static bool readSampleSource(int id, sfxinfo_t const *info, SampleSource &src)
+{
+    src.id    = id;
+    src.group = info->group;
+    src.name  = info->lumpName;
+    src.bits  = sfxBits;
+    src.rate  = sfxRate;
 #ifdef __CLIENT__
-        // Stop all sounds using this sample (we are going to destroy the
-        // existing sample data).
-        Sfx_UnloadSoundID(node->sample.id);
+    src.mustUpsample = sfxMustUpsampleToSfxRate();
+#else
+    src.mustUpsample = false;
 #endif
 
-        // It's in the wrong format! We'll reuse this node.
-        M_Free(node->sample.data);
-    }
-    else
+    /**
+     * Figure out where to get the sample data for this sound. It might be
+     * from a data file such as a WAD or external sound resources.
+     * The definition and the configuration settings will help us in making
+     * the decision.
+     */
+    src.isWave = true;
+
+    /// Has an external sound file been defined?
+    /// @note Path is relative to the base path.
+    if(!Str_IsEmpty(&info->external))
     {
-        // Get a new node and link it in.
-        node = reinterpret_cast<SfxCache *>(M_Calloc(sizeof(SfxCache)));
+        src.name = Str_Text(&info->external);
+        if(readWaveFile(App_BasePath() / src.name, src.data))
+        {
+            return true;
+        }
+        src.name = info->lumpName;
+    }
+
+    // If external didn't succeed, let's try the default resource dir.
 
-        CacheHash *hash = Sfx_CacheHash(id);
-        if(hash->last)
+    /**
+     * If the sound has an invalid lumpname, search external anyway.
+     * If the original sound is from a PWAD, we won't look for an
+     * external resource (probably a custom sound).
+     * @todo should be a cvar.
+     */
+    if(info->lumpNum < 0 || !App_FileSystem().lump(info->lumpNum).container().hasCustom())
+    {
+        try
         {
-            hash->last->next = node;
-            node->prev = hash->last;
+            String foundPath = App_FileSystem().findPath(de::Uri(info->lumpName, RC_SOUND),
+                                                         RLF_DEFAULT, App_ResourceClass(RC_SOUND));
+            foundPath = App_BasePath() / foundPath; // Ensure the path is absolute.
+
+            if(readWaveFile(foundPath, src.data))
+            {
+                return true;
+            }
         }
-        hash->last = node;
+        catch(FS1::NotFoundError const&)
+        {} // Ignore this error.
+    }
+
+    // Try loading from the lump.
+    if(info->lumpNum < 0)
+    {
+        LOG_AUDIO_WARNING("Failed to locate lump resource '%s' for sound '%s'")
+            << info->lumpName << info->id;
+        return false;
+    }
 
-        if(!hash->first)
-            hash->first = node;
+    File1 &lump = App_FileSystem().lump(info->lumpNum);
+    if(lump.size() <= 8) return false;
+
+    src.data.resize(lump.size());
+    lump.read(src.data.data(), 0, lump.size());
+
+    // Is this perhaps a WAV sound? Otherwise, it's in the DOOM format.
+    src.isWave = (src.data.size() >= 12 && WAV_CheckFormat(src.data.constData()));
+    return true;
+}
+
+/**
+ * Inserts a decoded sample into the cache. If the sound is already cached,
+ * the new copy is discarded. The cache must be locked.
+ *
+ * @param sample  Decoded sample. Ownership of the data is given to the cache.
+ *
+ * @returns  The cached sample.
+ */
+static SfxCache *Sfx_CacheInsert(sfxsample_t const &sample)
+{
+    if(SfxCache *node = Sfx_GetCached(sample.id))
+    {
+        // This happens when a sample was needed immediately while it was
+        // still being decoded in the background.
+        M_Free(sample.data);
+        return node;
     }
 
-    void *buf = M_Malloc(cached.size);
-    // Do the resampling, if necessary.
-    resample(buf, cached.bytesPer, cached.rate, data, bytesPer, rate,
-             numSamples, size);
-    cached.data = buf;
+    // Get a new node and link it in.
+    SfxCache *node = reinterpret_cast<SfxCache *>(M_Calloc(sizeof(SfxCache)));
 
-    // Hits keep count of how many times the cached sound has been played.
-    // The purger will remove samples with the lowest hitcount first.
-    node->hits = 0;
-    std::memcpy(&node->sample, &cached, sizeof(cached));
+    CacheHash *hash = Sfx_CacheHash(sample.id);
+    if(hash->last)
+    {
+        hash->last->next = node;
+        node->prev = hash->last;
+    }
+    hash->last = node;
+
+    if(!hash->first)
+        hash->first = node;
+
+    lruAppend(node);
+
+    node->lastUsed = Timer_Ticks();
+    std::memcpy(&node->sample, &sample, sizeof(sample));
+
+    totalBytes += sample.size;
+    sampleLengths.insert(sample.id, (1000 * sample.numSamples) / sample.rate);
     return node;
 }
 
@@ -408,278 +596,243 @@ static void Sfx_Uncache(SfxCache *node)
 
     END_COP;
 
+    lruUnlink(node);
+    totalBytes -= node->sample.size;
+
     // Free all memory allocated for the node.
     M_Free(node->sample.data);
     M_Free(node);
 }
 
-void Sfx_PurgeCache()
+/**
+ * Decodes a sample in a background thread.
+ */
+class SampleDecodeTask : public Task
 {
-    static int lastPurge = 0;
+public:
+    SampleDecodeTask(SampleSource const &source) : _source(source) {}
 
-#ifdef __CLIENT__
-    if(!sfxAvail) return;
-#endif
+    void runTask()
+    {
+        sfxsample_t const sample = decodeSample(_source);
 
-    // Is it time for a purge?
-    int nowTime = Timer_Ticks();
-    if(nowTime - lastPurge < PURGE_TIME) return; // No.
+        DENG2_GUARD(cacheLock);
+        decoded << sample;
+    }
 
-    lastPurge = nowTime;
+private:
+    SampleSource _source;
+};
 
-    // Count the total size of the cache.
-    // Also get rid of all sounds that have timed out.
-    int totalSize = 0;
-    SfxCache *next = 0;
-    for(int i = 0; i < CACHE_HASH_SIZE; i++)
+/**
+ * Moves the samples decoded in the background into the cache. The cache must
+ * be locked.
+ */
+static void installDecoded()
+{
+    foreach(sfxsample_t const &sample, decoded)
     {
-        for(SfxCache *it = scHash[i].first; it; it = next)
+        decoding.remove(sample.id);
+        if(sample.data)
         {
-            next = it->next;
-            if(nowTime - it->lastUsed > sfxMaxCacheTics)
-            {
-                // This sound hasn't been used in a looong time.
-                Sfx_Uncache(it);
-                continue;
-            }
-
-            totalSize += it->sample.size + sizeof(*it);
+            Sfx_CacheInsert(sample);
         }
     }
+    decoded.clear();
+}
+
+/**
+ * Begins decoding a sample in the background, unless it is already cached or
+ * being decoded.
+ */
+static void beginDecoding(int id)
+{
+    {
+        DENG2_GUARD(cacheLock);
+        if(Sfx_GetCached(id) || decoding.contains(id)) return;
+    }
 
-    int const maxSize = sfxMaxCacheKB * 1024;
-    int lowHits = 0;
-    SfxCache *lowest;
-    while(totalSize > maxSize)
+    sfxinfo_t *info = S_GetSoundInfo(id, 0, 0);
+    if(!info)
     {
-        /**
-         * The cache is too large! Find the stopped sample with the lowest
-         * hitcount and get rid of it. Repeat until cache size is within
-         * limits or there are no more stopped sounds.
-         */
-        lowest = 0;
-        for(int i = 0; i < CACHE_HASH_SIZE; i++)
-        {
-            for(SfxCache *it = scHash[i].first; it; it = it->next)
-            {
+        LOG_AUDIO_WARNING("Ignoring id:%i (missing sfxinfo_t)") << id;
+        return;
+    }
+
+    LOG_AUDIO_XVERBOSE("Decoding sample '%s' (#%i) in the background") << info->id << id;
+
+    // The data is read without locking the cache, so that the main thread
+    // does not need to wait for the file system.
+    SampleSource src;
+    if(!readSampleSource(id, info, src)) return;
+
+    DENG2_GUARD(cacheLock);
+    if(decoding.contains(id)) return;
+    decoding.insert(id);
+    decodeTasks().start(new SampleDecodeTask(src));
+
+    // The length is known before the sample is decoded.
+    if(uint const length = sampleSourceLength(src))
+    {
+        sampleLengths.insert(id, length);
+    }
+}
+
+void Sfx_UpdateCache()
+{
 #ifdef __CLIENT__
-                // If the sample is playing we won't remove it now.
-                if(Sfx_CountPlaying(it->sample.id))
-                    continue;
+    if(!sfxAvail) return;
 #endif
 
-                // This sample could be removed, let's check the hits.
-                if(!lowest || it->hits < lowHits)
-                {
-                    lowest = it;
-                    lowHits = it->hits;
-                }
-            }
-        }
+    DENG2_GUARD(cacheLock);
+
+    installDecoded();
+
+    /**
+     * Purge the least recently used samples: the ones that haven't been used
+     * in a looong time, and as many others as needed to fit the cache within
+     * its budget. Samples that are playing are never purged.
+     */
+    int const nowTime = Timer_Ticks();
+    uint const maxBytes = uint(de::max(0, sfxMaxCacheKB)) * 1024;
+    for(SfxCache *it = lruOldest; it; )
+    {
+        SfxCache *newer = it->newer;
 
-        // No more samples to remove?
-        if(!lowest) break;
+        // The rest have been used more recently than this one.
+        if(totalBytes <= maxBytes && nowTime - it->lastUsed <= sfxMaxCacheTics)
+            break;
 
-        // Stop and uncache this cached sample.
-        totalSize -= lowest->sample.size + sizeof(*lowest);
-        Sfx_Uncache(lowest);
+        if(!isPlaying(it->sample.id))
+        {
+            Sfx_Uncache(it);
+        }
+        it = newer;
     }
 }
 
 void Sfx_GetCacheInfo(uint *cacheBytes, uint *sampleCount)
 {
-    uint size = 0, count = 0;
+    DENG2_GUARD(cacheLock);
 
-    for(int i = 0; i < CACHE_HASH_SIZE; ++i)
+    uint count = 0;
+    for(SfxCache *it = lruOldest; it; it = it->newer)
     {
-        for(SfxCache *it = scHash[i].first; it; it = it->next, count++)
-        {
-            size += it->sample.size;
-        }
+        count++;
     }
 
-    if(cacheBytes)  *cacheBytes  = size;
+    if(cacheBytes)  *cacheBytes  = totalBytes;
     if(sampleCount) *sampleCount = count;
 }
 
 void Sfx_CacheHit(int id)
 {
+    DENG2_GUARD(cacheLock);
+
     SfxCache *node = Sfx_GetCached(id);
     if(node)
     {
-        node->hits++;
         node->lastUsed = Timer_Ticks();
+
+        // This is now the most recently used sample.
+        lruUnlink(node);
+        lruAppend(node);
     }
 }
 
-static sfxsample_t *cacheSample(int id, sfxinfo_t const *info)
+sfxsample_t *Sfx_Cache(int id)
 {
     LOG_AS("Sfx_Cache");
-    LOG_AUDIO_VERBOSE("Caching sample '%s' (#%i)...") << info->id << id;
-
-    int bytesPer = 0, rate = 0, numSamples = 0;
 
-    /**
-     * Figure out where to get the sample data for this sound. It might be
-     * from a data file such as a WAD or external sound resources.
-     * The definition and the configuration settings will help us in making
-     * the decision.
-     */
-    void *data = 0;
+#ifdef __CLIENT__
+    if(!sfxAvail || !id) return 0;
+#endif
 
-    /// Has an external sound file been defined?
-    /// @note Path is relative to the base path.
-    if(!Str_IsEmpty(&info->external))
+    // Are we so lucky that the sound is already cached?
     {
-        String searchPath = App_BasePath() / String(Str_Text(&info->external));
-        // Try loading.
-        data = WAV_Load(searchPath.toUtf8().constData(), &bytesPer, &rate, &numSamples);
-        if(data)
-        {
-            bytesPer /= 8; // Was returned as bits.
-        }
-    }
-
-    // If external didn't succeed, let's try the default resource dir.
-    if(!data)
-    {
-        /**
-         * If the sound has an invalid lumpname, search external anyway.
-         * If the original sound is from a PWAD, we won't look for an
-         * external resource (probably a custom sound).
-         * @todo should be a cvar.
-         */
-        if(info->lumpNum < 0 || !App_FileSystem().lump(info->lumpNum).container().hasCustom())
+        DENG2_GUARD(cacheLock);
+        installDecoded();
+        if(SfxCache *node = Sfx_GetCached(id))
         {
-            try
-            {
-                String foundPath = App_FileSystem().findPath(de::Uri(info->lumpName, RC_SOUND),
-                                                             RLF_DEFAULT, App_ResourceClass(RC_SOUND));
-                foundPath = App_BasePath() / foundPath; // Ensure the path is absolute.
-
-                data = WAV_Load(foundPath.toUtf8().constData(), &bytesPer, &rate, &numSamples);
-                if(data)
-                {
-                    // Loading was successful.
-                    bytesPer /= 8; // Was returned as bits.
-                }
-            }
-            catch(FS1::NotFoundError const&)
-            {} // Ignore this error.
+            return &node->sample;
         }
     }
 
-    // No sample loaded yet?
-    if(!data)
+    // Get the sound decription.
+    sfxinfo_t *info = S_GetSoundInfo(id, 0, 0);
+    if(!info)
     {
-        // Try loading from the lump.
-        if(info->lumpNum < 0)
-        {
-            LOG_AUDIO_WARNING("Failed to locate lump resource '%s' for sound '%s'")
-                << info->lumpName << info->id;
-            return 0;
-        }
-
-        File1 &lump = App_FileSystem().lump(info->lumpNum);
-        if(lump.size() <= 8) return 0;
+        LOG_AUDIO_WARNING("Ignoring id:%i (missing sfxinfo_t)") << id;
+        return 0;
+    }
 
-        char hdr[12];
-        lump.read((uint8_t *)hdr, 0, 12);
+    LOG_AUDIO_VERBOSE("Caching sample '%s' (#%i)...") << info->id << id;
 
-        // Is this perhaps a WAV sound?
-        if(WAV_CheckFormat(hdr))
-        {
-            // Load as WAV, then.
-            uint8_t const *sp = lump.cache();
-            data = WAV_MemoryLoad((byte const *) sp, lump.size(), &bytesPer, &rate, &numSamples);
-            lump.unlock();
+    // The sample is needed right away, so it is decoded here even if it is
+    // already being decoded in the background.
+    SampleSource src;
+    if(!readSampleSource(id, info, src)) return 0;
 
-            if(!data)
-            {
-                // Abort...
-                LOG_AUDIO_WARNING("Unknown WAV format in lump '%s'") << info->lumpName;
-                return 0;
-            }
+    sfxsample_t const sample = decodeSample(src);
+    if(!sample.data) return 0;
 
-            bytesPer /= 8;
-        }
-    }
+    DENG2_GUARD(cacheLock);
+    return &Sfx_CacheInsert(sample)->sample;
+}
 
-    if(data) // Loaded!
-    {
-        // Insert a copy of this into the cache.
-        SfxCache *node = Sfx_CacheInsert(id, data, bytesPer * numSamples, numSamples,
-                                           bytesPer, rate, info->group);
-        Z_Free(data);
-        return &node->sample;
-    }
+sfxsample_t *Sfx_CacheAsync(int id)
+{
+#ifdef __CLIENT__
+    if(!sfxAvail || !id) return 0;
+#endif
 
-    // Probably an old-fashioned DOOM sample.
-    size_t lumpLength = 0;
-    if(info->lumpNum >= 0)
     {
-        File1 &lump = App_FileSystem().lump(info->lumpNum);
-
-        if(lump.size() > 8)
+        DENG2_GUARD(cacheLock);
+        if(SfxCache *node = Sfx_GetCached(id))
         {
-            uint8_t hdr[8];
-            lump.read(hdr, 0, 8);
-            int head   = DD_SHORT(*(short const *) (hdr));
-            rate       = DD_SHORT(*(short const *) (hdr + 2));
-            numSamples = de::max(0, DD_LONG(*(int const *) (hdr + 4)));
-
-            bytesPer = 1; // 8-bit.
-
-            if(head == 3 && numSamples > 0 && (unsigned) numSamples <= lumpLength - 8)
-            {
-                // The sample data can be used as-is - load directly from the lump cache.
-                uint8_t const *data = lump.cache() + 8; // Skip the header.
-
-                // Insert a copy of this into the cache.
-                SfxCache *node = Sfx_CacheInsert(id, data, bytesPer * numSamples, numSamples,
-                                                   bytesPer, rate, info->group);
-
-                lump.unlock();
-
-                return &node->sample;
-            }
+            return &node->sample;
         }
     }
 
-    LOG_AUDIO_WARNING("Unknown lump '%s' sound format") << info->lumpName;
+    beginDecoding(id);
     return 0;
 }
 
-sfxsample_t *Sfx_Cache(int id)
+void Sfx_Precache(int id)
 {
-    LOG_AS("Sfx_Cache");
-
 #ifdef __CLIENT__
-    if(!sfxAvail || !id) return 0;
+    if(!sfxAvail) return;
 #endif
 
-    // Are we so lucky that the sound is already cached?
-    if(SfxCache *node = Sfx_GetCached(id))
-    {
-        return &node->sample;
-    }
-
-    // Get the sound decription.
-    if(sfxinfo_t *info = S_GetSoundInfo(id, 0, 0))
+    if(id > 0)
     {
-        return cacheSample(id, info);
+        beginDecoding(id);
     }
+}
 
-    LOG_AUDIO_WARNING("Ignoring id:%i (missing sfxinfo_t)") << id;
-    return 0;
+dd_bool Sfx_IsCaching(int id)
+{
+    DENG2_GUARD(cacheLock);
+    return decoding.contains(id);
 }
 
 uint Sfx_GetSoundLength(int id)
 {
-    sfxsample_t *sample = Sfx_Cache(id & ~DDSF_FLAG_MASK);
-    if(sample)
+    id &= ~DDSF_FLAG_MASK;
+
     {
-        return (1000 * sample->numSamples) / sample->rate;
+        DENG2_GUARD(cacheLock);
+        QHash<int, uint>::const_iterator found = sampleLengths.constFind(id);
+        if(found != sampleLengths.constEnd())
+        {
+            return found.value();
+        }
     }
-    return 0;
+
+    // The length is read from the header of the sample; the sample itself is
+    // decoded in the background, as it is probably about to be played.
+    beginDecoding(id);
+
+    DENG2_GUARD(cacheLock);
+    return sampleLengths.value(id, 0);
 }
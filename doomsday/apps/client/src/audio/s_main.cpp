@@ -50,6 +50,13 @@
 #ifdef __CLIENT__
 #  include "gl/gl_main.h"
 #  include "ui/clientwindow.h"
+#  include "world/map.h"
+#  include "world/thinkers.h"
+#  include "world/worldsystem.h"
+#  include <de/math.h>
+#  include <de/timer.h>
+#  include <QList>
+#  include <QSet>
 #endif
 #ifdef __SERVER__
 #  include "server/sv_sound.h"
@@ -80,6 +87,118 @@ byte sfxOneSoundPerEmitter; // Traditional Doomsday behavior: allows sounds to o
 
 static bool noRndPitch;
 
+#ifdef __CLIENT__
+static byte sfxPrecache = true;    ///< Decode the sounds of a map during map setup.
+static int sfxCacheLatency = 100;  ///< Milliseconds a sound may wait for its sample.
+
+/**
+ * A sound whose sample was still being decoded when the sound was started.
+ * It is started when the sample is ready, unless it has waited too long.
+ */
+struct DeferredSound
+{
+    int soundIdAndFlags;
+    mobj_t *origin;
+    bool hasPoint;
+    coord_t point[3];
+    float volume;
+    uint deadline;  ///< Real time in milliseconds.
+};
+static QList<DeferredSound> deferredSounds;
+static bool startingDeferred;
+
+static void deferSound(int soundIdAndFlags, mobj_t *origin, coord_t *point, float volume)
+{
+    DeferredSound snd;
+    snd.soundIdAndFlags = soundIdAndFlags;
+    snd.origin          = origin;
+    snd.hasPoint        = (point != nullptr);
+    snd.volume          = volume;
+    snd.deadline        = Timer_RealMilliseconds() + de::max(0, sfxCacheLatency);
+    for(int i = 0; i < 3; ++i)
+    {
+        snd.point[i] = (point? point[i] : 0);
+    }
+    deferredSounds << snd;
+}
+
+/**
+ * Starts the deferred sounds whose samples have been decoded. Sounds that
+ * have waited longer than the allowed latency are dropped.
+ */
+static void startDeferredSounds()
+{
+    if(deferredSounds.isEmpty()) return;
+
+    uint const nowTime = Timer_RealMilliseconds();
+    for(int i = 0; i < deferredSounds.size(); )
+    {
+        DeferredSound snd = deferredSounds.at(i);
+        bool const expired = (nowTime > snd.deadline);
+        if(!expired && Sfx_IsCaching(snd.soundIdAndFlags & ~DDSF_FLAG_MASK))
+        {
+            ++i; // Keep waiting.
+            continue;
+        }
+
+        deferredSounds.removeAt(i);
+        if(!expired)
+        {
+            startingDeferred = true;
+            S_LocalSoundAtVolumeFrom(snd.soundIdAndFlags, snd.origin,
+                                     snd.hasPoint? snd.point : nullptr,
+                                     snd.volume);
+            startingDeferred = false;
+        }
+    }
+}
+
+static void cancelDeferredSounds(int soundId, mobj_t *emitter)
+{
+    for(int i = 0; i < deferredSounds.size(); )
+    {
+        DeferredSound const &snd = deferredSounds.at(i);
+        if((!soundId || (snd.soundIdAndFlags & ~DDSF_FLAG_MASK) == soundId) &&
+           (!emitter || snd.origin == emitter))
+        {
+            deferredSounds.removeAt(i);
+            continue;
+        }
+        ++i;
+    }
+}
+
+/**
+ * Begins decoding the samples of the sounds that the objects of the current
+ * map may make, so that they are ready when needed.
+ */
+static void precacheMapSounds()
+{
+    if(!sfxAvail || !sfxPrecache) return;
+    if(!App_WorldSystem().hasMap()) return;
+
+    QSet<int> types;
+    App_WorldSystem().map().thinkers().forAll(reinterpret_cast<thinkfunc_t>(gx.MobjThinker),
+                                              0x1/*public*/, [&types] (thinker_t *th)
+    {
+        types.insert(reinterpret_cast<mobj_t *>(th)->type);
+        return LoopContinue;
+    });
+
+    foreach(int type, types)
+    {
+        if(type < 0 || type >= defs.mobjs.size()) continue;
+
+        mobjinfo_t const &info = runtimeDefs.mobjInfo[type];
+        Sfx_Precache(info.seeSound);
+        Sfx_Precache(info.attackSound);
+        Sfx_Precache(info.painSound);
+        Sfx_Precache(info.deathSound);
+        Sfx_Precache(info.activeSound);
+    }
+}
+#endif
+
 dd_bool S_Init()
 {
 #ifdef __CLIENT__
@@ -132,6 +251,9 @@ void S_MapChange()
     Sfx_InitLogical();
 
 #ifdef __CLIENT__
+    // Mobjs are about to be destroyed.
+    deferredSounds.clear();
+
     Sfx_MapChange();
 #endif
 }
@@ -141,6 +263,8 @@ void S_SetupForChangedMap()
 #ifdef __CLIENT__
     // Update who is listening now.
     Sfx_SetListener(S_GetListenerMobj());
+
+    precacheMapSounds();
 #endif
 }
 
@@ -177,6 +301,9 @@ BEGIN_PROF( PROF_SOUND_STARTFRAME );
     // Update all channels (freq, 2D:pan,volume, 3D:position,velocity).
     Sfx_StartFrame();
     Mus_StartFrame();
+
+    // Samples decoded in the background are now in the cache.
+    startDeferredSounds();
 #endif
 
     // Remove stopped sounds from the LSM.
@@ -256,6 +383,8 @@ int S_LocalSoundAtVolumeFrom(int soundIdAndFlags, mobj_t *origin, coord_t *point
 
     LOG_AS("S_LocalSoundAtVolumeFrom");
 
+    float const requestedVolume = volume;
+
     if(volume > 1)
     {
         LOGDEV_AUDIO_WARNING("Volume is too high (%f > 1)") << volume;
@@ -279,9 +408,15 @@ int S_LocalSoundAtVolumeFrom(int soundIdAndFlags, mobj_t *origin, coord_t *point
     }
 
     // Load the sample.
-    sfxsample_t *sample = Sfx_Cache(soundId);
+    sfxsample_t *sample = Sfx_CacheAsync(soundId);
     if(!sample)
     {
+        if(Sfx_IsCaching(soundId) && !startingDeferred)
+        {
+            // Play it when the sample has been decoded.
+            deferSound(soundIdAndFlags, origin, point, requestedVolume);
+            return false;
+        }
         if(sfxAvail)
         {
             LOG_AUDIO_VERBOSE("S_LocalSoundAtVolumeFrom: Caching of sound %i failed")
@@ -419,6 +554,9 @@ static void stopSectorSounds(ddmobj_base_t *sectorEmitter, int soundID, int flag
 void S_StopSound(int soundID, mobj_t *emitter)
 {
 #ifdef __CLIENT__
+    // Sounds still waiting for their samples won't be started.
+    cancelDeferredSounds(soundID, emitter);
+
     // No special stop behavior.
     // Sfx provides a routine for this.
     Sfx_StopSound(soundID, emitter);
@@ -616,6 +754,9 @@ void S_Register()
     C_VAR_INT   ("sound-16bit",         &sfx16Bit,              0, 0, 1);
     C_VAR_INT   ("sound-3d",            &sfx3D,                 0, 0, 1);
     C_VAR_FLOAT2("sound-reverb-volume", &sfxReverbStrength,     0, 0, 1.5f, S_ReverbVolumeChanged);
+    C_VAR_INT   ("sound-cache-size",    &sfxMaxCacheKB,         0, 0, 1024 * 1024);
+    C_VAR_INT   ("sound-cache-latency", &sfxCacheLatency,       0, 0, 1000);
+    C_VAR_BYTE  ("sound-precache",      &sfxPrecache,           0, 0, 1);
 
     C_CMD_FLAGS("playsound", nullptr, PlaySound, CMDF_NO_DEDICATED);
 
@@ -55,6 +55,12 @@ static dd_bool musAvail = false;
 static dd_bool musicPaused = false;
 static String currentSong;
 
+// Music definition fields.
+static RecordKey const MUSIC_ID       ("id");
+static RecordKey const MUSIC_PATH     ("path");
+static RecordKey const MUSIC_LUMP_NAME("lumpName");
+static RecordKey const MUSIC_CD_TRACK ("cdTrack");
+
 static int getInterfaces(audiointerface_music_generic_t** ifs)
 {
     return AudioDriver_FindInterfaces(AUDIO_IMUSIC_OR_ICD, (void**) ifs);
@@ -211,7 +217,7 @@ static int Mus_GetExt(Record const *rec, ddstring_t *retPath)
 
     defn::Music musicDef(*rec);
 
-    de::Uri songUri(musicDef.gets("path"), RC_NULL);
+    de::Uri songUri(musicDef.gets(MUSIC_PATH), RC_NULL);
     if(!songUri.path().isEmpty())
     {
         // All external music files are specified relative to the base path.
@@ -224,11 +230,11 @@ static int Mus_GetExt(Record const *rec, ddstring_t *retPath)
         }
 
         LOG_AUDIO_WARNING("Music file \"%s\" not found (id '%s')")
-            << songUri << musicDef.gets("id");
+            << songUri << musicDef.gets(MUSIC_ID);
     }
 
     // Try the resource locator?
-    String const lumpName = musicDef.gets("lumpName");
+    String const lumpName = musicDef.gets(MUSIC_LUMP_NAME);
     if(!lumpName.isEmpty())
     {
         try
@@ -260,10 +266,10 @@ static int Mus_GetCD(Record const *rec)
 
     defn::Music musicDef(*rec);
 
-    int cdTrack = musicDef.geti("cdTrack");
+    int cdTrack = musicDef.geti(MUSIC_CD_TRACK);
     if(cdTrack) return cdTrack;
 
-    String path = musicDef.gets("path");
+    String path = musicDef.gets(MUSIC_PATH);
     if(!path.compareWithoutCase("cd"))
     {
         bool ok;
@@ -310,7 +316,7 @@ int Mus_Start(Record const *rec, bool looped)
 {
     if(!musAvail || !rec) return false;
 
-    String songID = rec->gets("id");
+    String songID = rec->gets(MUSIC_ID);
 
     LOG_AS("Mus_Start");
     LOG_AUDIO_VERBOSE("Starting ID:%s looped:%b, currentSong ID:%s") << songID << looped << currentSong;
@@ -372,7 +378,7 @@ int Mus_Start(Record const *rec, bool looped)
             if(Mus_GetExt(rec, &path))
             {
                 LOG_AUDIO_VERBOSE("Attempting to play song '%s' (file \"%s\")")
-                        << rec->gets("id") << NativePath(Str_Text(&path)).pretty();
+                        << rec->gets(MUSIC_ID) << NativePath(Str_Text(&path)).pretty();
 
                 // Its an external file.
                 if(AudioDriver_Music_PlayFile(Str_Text(&path), looped))
@@ -387,7 +393,7 @@ int Mus_Start(Record const *rec, bool looped)
         case MUSP_MUS:
             if(AudioDriver_Music_Available())
             {
-                lumpnum_t const lumpNum = App_FileSystem().lumpNumForName(rec->gets("lumpName"));
+                lumpnum_t const lumpNum = App_FileSystem().lumpNumForName(rec->gets(MUSIC_LUMP_NAME));
                 if(Mus_StartLump(lumpNum, looped, canPlayMUS) == 1)
                     return true;
             }
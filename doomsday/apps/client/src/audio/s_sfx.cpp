@@ -669,7 +669,7 @@ int Sfx_StartSound(sfxsample_t *sample, float volume, float freq, mobj_t *emitte
         }
     }
 
-    // Hit count tells how many times the cached sound has been used.
+    // Recently used samples are the last to be purged from the cache.
     Sfx_CacheHit(sample->id);
 
     /*
@@ -891,8 +891,9 @@ void Sfx_StartFrame()
         oldRate = sfxSampleRate;
     }
 
-    // Should we purge the cache (to conserve memory)?
-    Sfx_PurgeCache();
+    // Bring in the samples decoded in the background, and purge the cache
+    // (to conserve memory).
+    Sfx_UpdateCache();
 }
 
 void Sfx_EndFrame(void)
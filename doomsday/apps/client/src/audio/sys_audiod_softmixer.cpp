@@ -0,0 +1,465 @@
+/** @file sys_audiod_softmixer.cpp  Built-in software mixer audio driver.
+ *
+ * @authors Copyright © 2015 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#include "de_base.h"
+#include "de_console.h"
+#include "de_system.h"
+#include "de_misc.h"
+
+#include "audio/sys_audiod_softmixer.h"
+
+#include <de/AudioMixer>
+#include <de/Log>
+#include <de/Resampler>
+#include <QCache>
+
+#ifndef DENG_NO_SDL
+#  include <SDL.h>
+#  undef main
+#endif
+
+using namespace de;
+
+int         DS_SoftMixerInit(void);
+void        DS_SoftMixerShutdown(void);
+void        DS_SoftMixerEvent(int type);
+
+int         DS_SoftMixer_SFX_Init(void);
+sfxbuffer_t* DS_SoftMixer_SFX_CreateBuffer(int flags, int bits, int rate);
+void        DS_SoftMixer_SFX_DestroyBuffer(sfxbuffer_t *buf);
+void        DS_SoftMixer_SFX_Load(sfxbuffer_t *buf, struct sfxsample_s *sample);
+void        DS_SoftMixer_SFX_Reset(sfxbuffer_t *buf);
+void        DS_SoftMixer_SFX_Play(sfxbuffer_t *buf);
+void        DS_SoftMixer_SFX_Stop(sfxbuffer_t *buf);
+void        DS_SoftMixer_SFX_Refresh(sfxbuffer_t *buf);
+void        DS_SoftMixer_SFX_Set(sfxbuffer_t *buf, int prop, float value);
+void        DS_SoftMixer_SFX_Setv(sfxbuffer_t *buf, int prop, float *values);
+void        DS_SoftMixer_SFX_Listener(int prop, float value);
+void        DS_SoftMixer_SFX_Listenerv(int prop, float *values);
+int         DS_SoftMixer_SFX_Getv(int prop, void *values);
+
+audiodriver_t audiod_softmixer = {
+    DS_SoftMixerInit,
+    DS_SoftMixerShutdown,
+    DS_SoftMixerEvent,
+    0
+};
+
+audiointerface_sfx_t audiod_softmixer_sfx = { {
+    DS_SoftMixer_SFX_Init,
+    DS_SoftMixer_SFX_CreateBuffer,
+    DS_SoftMixer_SFX_DestroyBuffer,
+    DS_SoftMixer_SFX_Load,
+    DS_SoftMixer_SFX_Reset,
+    DS_SoftMixer_SFX_Play,
+    DS_SoftMixer_SFX_Stop,
+    DS_SoftMixer_SFX_Refresh,
+    DS_SoftMixer_SFX_Set,
+    DS_SoftMixer_SFX_Setv,
+    DS_SoftMixer_SFX_Listener,
+    DS_SoftMixer_SFX_Listenerv,
+    DS_SoftMixer_SFX_Getv
+} };
+
+#define OUTPUT_RATE             44100
+#define OUTPUT_FRAMES           1024    ///< Frames mixed per device callback.
+#define CONVERTED_CACHE_KB      8192
+
+/// Positional state of a 3D buffer (sfxbuffer_t::ptr3D).
+struct Buffer3D
+{
+    Vector3f position;
+    bool relative;
+    float minDistance;
+    float maxDistance;
+
+    Buffer3D() : relative(false), minDistance(256), maxDistance(2025) {}
+};
+
+/// Sample converted to floating point at the output rate.
+struct ConvertedSample
+{
+    int bytesPer;
+    int rate;
+    int numSamples;
+    QVector<float> samples;
+};
+
+static AudioMixer *mixer;
+
+#ifndef DENG_NO_SDL
+static SDL_AudioDeviceID device;
+#endif
+
+// Most recently used samples are kept converted (only accessed in the main
+// thread).
+static QCache<int, ConvertedSample> converted(CONVERTED_CACHE_KB);
+
+static Vector3f listenerPos;
+static float listenerYaw;
+
+/// The buffer's cursor is used for storing the mixer voice.
+static inline int voiceOf(sfxbuffer_t const *buf)
+{
+    return int(buf->cursor);
+}
+
+#ifndef DENG_NO_SDL
+/**
+ * Called by SDL in the audio thread when the device needs more output.
+ */
+static void audioCallback(void *, Uint8 *stream, int len)
+{
+    mixer->render(reinterpret_cast<float *>(stream), dsize(len) / (2 * sizeof(float)));
+}
+#endif
+
+int DS_SoftMixerInit(void)
+{
+    if(mixer) return true; // Already initialized.
+
+#ifndef DENG_NO_SDL
+    if(SDL_InitSubSystem(SDL_INIT_AUDIO))
+    {
+        LOG_AUDIO_ERROR("Error initializing SDL audio: %s") << SDL_GetError();
+        return false;
+    }
+
+    SDL_AudioSpec desired, obtained;
+    zap(desired);
+    desired.freq     = OUTPUT_RATE;
+    desired.format   = AUDIO_F32SYS;
+    desired.channels = 2;
+    desired.samples  = OUTPUT_FRAMES;
+    desired.callback = audioCallback;
+
+    // The mixer can output at any rate. SDL converts the format if needed.
+    device = SDL_OpenAudioDevice(NULL, 0, &desired, &obtained, SDL_AUDIO_ALLOW_FREQUENCY_CHANGE);
+    if(!device)
+    {
+        LOG_AUDIO_ERROR("Failed to open audio device: %s") << SDL_GetError();
+        SDL_QuitSubSystem(SDL_INIT_AUDIO);
+        return false;
+    }
+
+    mixer = new AudioMixer(obtained.freq);
+
+    LOG_AUDIO_VERBOSE("Software mixer: %i Hz stereo output, %s kernel")
+            << obtained.freq << AudioMixer::kernelName();
+
+    // Start calling the callback.
+    SDL_PauseAudioDevice(device, 0);
+    return true;
+#else
+    LOG_AUDIO_ERROR("Software mixer needs SDL for audio output");
+    return false;
+#endif
+}
+
+void DS_SoftMixerShutdown(void)
+{
+    if(!mixer) return;
+
+#ifndef DENG_NO_SDL
+    // Waits for the callback to return.
+    SDL_CloseAudioDevice(device);
+    device = 0;
+    SDL_QuitSubSystem(SDL_INIT_AUDIO);
+#endif
+
+    converted.clear();
+    delete mixer;
+    mixer = 0;
+}
+
+void DS_SoftMixerEvent(int)
+{
+    // Nothing to do: all changes take effect immediately.
+}
+
+int DS_SoftMixer_SFX_Init(void)
+{
+    return mixer != 0;
+}
+
+sfxbuffer_t *DS_SoftMixer_SFX_CreateBuffer(int flags, int bits, int rate)
+{
+    sfxbuffer_t *buf = (sfxbuffer_t *) Z_Calloc(sizeof(*buf), PU_APPSTATIC, 0);
+
+    buf->bytes  = bits / 8;
+    buf->rate   = rate;
+    buf->flags  = flags;
+    buf->freq   = rate; // Modified by calls to Set(SFXBP_FREQUENCY).
+    buf->cursor = mixer->createVoice();
+
+    if(flags & SFXBF_3D)
+    {
+        buf->ptr3D = new Buffer3D;
+    }
+    return buf;
+}
+
+void DS_SoftMixer_SFX_DestroyBuffer(sfxbuffer_t *buf)
+{
+    if(!buf) return;
+
+    mixer->destroyVoice(voiceOf(buf));
+    delete reinterpret_cast<Buffer3D *>(buf->ptr3D);
+    Z_Free(buf);
+}
+
+/**
+ * Converts a sample to floating point at the output rate. Resampling is done
+ * with a band-limited filter, so samples of any rate can be played.
+ */
+static QVector<float> convertSample(sfxsample_t const *sample)
+{
+    ConvertedSample *conv = converted.object(sample->id);
+    if(conv && conv->bytesPer == sample->bytesPer && conv->rate == sample->rate &&
+       conv->numSamples == sample->numSamples)
+    {
+        return conv->samples;
+    }
+
+    int const count = sample->numSamples;
+    QVector<float> input(count);
+    if(sample->bytesPer == 1)
+    {
+        duint8 const *src = reinterpret_cast<duint8 const *>(sample->data);
+        for(int i = 0; i < count; ++i) input[i] = (src[i] - 128) / 128.f;
+    }
+    else
+    {
+        dint16 const *src = reinterpret_cast<dint16 const *>(sample->data);
+        for(int i = 0; i < count; ++i) input[i] = src[i] / 32768.f;
+    }
+
+    conv = new ConvertedSample;
+    conv->bytesPer   = sample->bytesPer;
+    conv->rate       = sample->rate;
+    conv->numSamples = count;
+
+    if(sample->rate == mixer->sampleRate())
+    {
+        conv->samples = input;
+    }
+    else
+    {
+        Resampler resampler(sample->rate, mixer->sampleRate());
+        conv->samples.resize(int(resampler.outputLength(count)));
+        resampler.convert(input.constData(), count, conv->samples.data());
+    }
+
+    QVector<float> const samples = conv->samples;
+    converted.insert(sample->id, conv, de::max(1, samples.size() * int(sizeof(float)) / 1024));
+    return samples;
+}
+
+void DS_SoftMixer_SFX_Load(sfxbuffer_t *buf, struct sfxsample_s *sample)
+{
+    if(!buf || !sample) return;
+
+    // Is the same sample already loaded?
+    if(buf->sample && buf->sample->id == sample->id) return;
+
+    mixer->setSamples(voiceOf(buf), convertSample(sample));
+    buf->sample = sample;
+}
+
+/**
+ * Stops the buffer and makes it forget about its sample.
+ */
+void DS_SoftMixer_SFX_Reset(sfxbuffer_t *buf)
+{
+    if(!buf) return;
+
+    DS_SoftMixer_SFX_Stop(buf);
+    mixer->setSamples(voiceOf(buf), QVector<float>());
+    buf->sample = 0;
+}
+
+void DS_SoftMixer_SFX_Play(sfxbuffer_t *buf)
+{
+    // Playing is quite impossible without a sample.
+    if(!buf || !buf->sample) return;
+
+    mixer->play(voiceOf(buf), (buf->flags & SFXBF_REPEAT) != 0);
+
+    buf->endTime = Timer_RealMilliseconds() + 1000 * buf->sample->numSamples / de::max(1u, buf->freq);
+    buf->flags |= SFXBF_PLAYING;
+}
+
+void DS_SoftMixer_SFX_Stop(sfxbuffer_t *buf)
+{
+    if(!buf || !buf->sample) return;
+
+    mixer->stop(voiceOf(buf));
+    buf->flags &= ~SFXBF_PLAYING;
+}
+
+void DS_SoftMixer_SFX_Refresh(sfxbuffer_t *buf)
+{
+    // Can only be done if there is a sample and the buffer is playing.
+    if(!buf || !buf->sample || !(buf->flags & SFXBF_PLAYING))
+        return;
+
+    // The mixer knows exactly when the sound has ended.
+    if(!mixer->isPlaying(voiceOf(buf)))
+    {
+        buf->flags &= ~SFXBF_PLAYING;
+    }
+}
+
+static void updatePosition(sfxbuffer_t *buf)
+{
+    Buffer3D const *b3d = reinterpret_cast<Buffer3D const *>(buf->ptr3D);
+    mixer->setPosition(voiceOf(buf), b3d->position, b3d->relative);
+    mixer->setDistanceRange(voiceOf(buf), b3d->minDistance, b3d->maxDistance);
+}
+
+/**
+ * @param prop  SFXBP_VOLUME (0..1)
+ *              SFXBP_FREQUENCY
+ *              SFXBP_PAN (-1..1)
+ *              SFXBP_MIN_DISTANCE
+ *              SFXBP_MAX_DISTANCE
+ *              SFXBP_RELATIVE_MODE
+ */
+void DS_SoftMixer_SFX_Set(sfxbuffer_t *buf, int prop, float value)
+{
+    if(!buf) return;
+
+    Buffer3D *b3d = reinterpret_cast<Buffer3D *>(buf->ptr3D);
+
+    switch(prop)
+    {
+    case SFXBP_VOLUME:
+        mixer->setVolume(voiceOf(buf), value);
+        break;
+
+    case SFXBP_FREQUENCY:
+        // Samples are converted to the output rate when loaded.
+        buf->freq = unsigned(buf->rate * value);
+        mixer->setPitch(voiceOf(buf), value);
+        break;
+
+    case SFXBP_PAN:
+        if(!b3d) mixer->setPan(voiceOf(buf), value);
+        break;
+
+    case SFXBP_MIN_DISTANCE:
+        if(b3d)
+        {
+            b3d->minDistance = value;
+            updatePosition(buf);
+        }
+        break;
+
+    case SFXBP_MAX_DISTANCE:
+        if(b3d)
+        {
+            b3d->maxDistance = value;
+            updatePosition(buf);
+        }
+        break;
+
+    case SFXBP_RELATIVE_MODE:
+        if(b3d) b3d->relative = (value != 0);
+        break;
+
+    default:
+        break;
+    }
+}
+
+/**
+ * Coordinates are specified in the map coordinate system.
+ *
+ * @param prop  SFXBP_POSITION
+ *              SFXBP_VELOCITY (ignored; there is no Doppler effect)
+ */
+void DS_SoftMixer_SFX_Setv(sfxbuffer_t *buf, int prop, float *values)
+{
+    if(!buf || !buf->ptr3D) return;
+
+    if(prop == SFXBP_POSITION)
+    {
+        reinterpret_cast<Buffer3D *>(buf->ptr3D)->position = Vector3f(values);
+        updatePosition(buf);
+    }
+}
+
+void DS_SoftMixer_SFX_Listener(int, float)
+{
+    // SFXLP_UNITS_PER_METER and SFXLP_DOPPLER are not needed, and changes
+    // are not deferred so SFXLP_UPDATE has nothing to commit.
+}
+
+/**
+ * @param prop  SFXLP_POSITION
+ *              SFXLP_ORIENTATION (yaw and pitch, in degrees)
+ *              SFXLP_REVERB (SRD_* for indices)
+ */
+void DS_SoftMixer_SFX_Listenerv(int prop, float *values)
+{
+    switch(prop)
+    {
+    case SFXLP_POSITION:
+        listenerPos = Vector3f(values);
+        mixer->setListener(listenerPos, listenerYaw);
+        break;
+
+    case SFXLP_ORIENTATION:
+        listenerYaw = values[0];
+        mixer->setListener(listenerPos, listenerYaw);
+        break;
+
+    case SFXLP_REVERB:
+        mixer->setReverb(values[SRD_VOLUME], values[SRD_SPACE], values[SRD_DECAY],
+                         values[SRD_DAMPING]);
+        break;
+
+    default:
+        break;
+    }
+}
+
+/**
+ * Gets a driver property.
+ *
+ * @param prop    Property (SFXIP_*).
+ * @param values  Pointer to return value(s).
+ */
+int DS_SoftMixer_SFX_Getv(int prop, void *values)
+{
+    switch(prop)
+    {
+    case SFXIP_DISABLE_CHANNEL_REFRESH:
+        // Refresh is needed for noticing when sounds have ended.
+        *reinterpret_cast<int *>(values) = false;
+        return true;
+
+    case SFXIP_ANY_SAMPLE_RATE_ACCEPTED:
+        // Samples are resampled to the output rate when loaded.
+        *reinterpret_cast<int *>(values) = true;
+        return true;
+
+    default:
+        return false;
+    }
+}
@@ -31,6 +31,7 @@
 #include "client/cl_player.h"
 #include "client/cl_sound.h"
 #include "client/cl_world.h"
+#include "network/deltacodec.h"
 #include "network/net_main.h"
 #include "network/net_buf.h"
 #include "network/net_msg.h"
@@ -56,8 +57,8 @@ extern int gotFrame;
 
 // PUBLIC DATA DEFINITIONS -------------------------------------------------
 
-// Set to true when the PSV_FIRST_FRAME2 packet is received.
-// Until then, all PSV_FRAME2 packets are ignored (they must be
+// Set to true when the PSV_FIRST_FRAME2/3 packet is received.
+// Until then, all PSV_FRAME2/3 packets are ignored (they must be
 // from the wrong map).
 dd_bool gotFirstFrame;
 
@@ -68,6 +69,9 @@ dd_bool gotFirstFrame;
 // gameTime of the current frame.
 static float frameGameTime = 0;
 
+// Mobj coordinates received in PSV_FRAME3 packets.
+static DeltaOrigins receivedOrigins;
+
 #if 0
 // Ordinal of the latest set received by the client. Used for detecting deltas
 // that arrive out of order. The ordinal is the logical equivalent of the set
@@ -123,7 +127,7 @@ void Cl_ResetFrame()
 {
     gotFrame = false;
 
-    // All frames received before the PSV_FIRST_FRAME2 are ignored.
+    // All frames received before the PSV_FIRST_FRAME2/3 are ignored.
     // They must be from the wrong map.
     gotFirstFrame = false;
 }
@@ -135,14 +139,21 @@ float Cl_FrameGameTime()
 
 void Cl_Frame2Received(int packetType)
 {
+    // Mobj, player and sector deltas are bit-packed in PSV_FRAME3.
+    bool const bitPacked = (packetType == PSV_FRAME3 || packetType == PSV_FIRST_FRAME3);
+    DeltaOrigins *origins = (bitPacked? &receivedOrigins : 0);
+
     // The first thing in the frame is the gameTime.
     frameGameTime = Reader_ReadFloat(msgReader);
 
     // All frames that arrive before the first frame are ignored.
     // They are most likely from the wrong map.
-    if(packetType == PSV_FIRST_FRAME2)
+    if(packetType == PSV_FIRST_FRAME2 || packetType == PSV_FIRST_FRAME3)
     {
         gotFirstFrame = true;
+
+        // The server has forgotten the coordinates it has sent.
+        receivedOrigins.clear();
     }
     else if(!gotFirstFrame)
     {
@@ -158,28 +169,33 @@ void Cl_Frame2Received(int packetType)
 
         switch(deltaType)
         {
-        case DT_CREATE_MOBJ:
+        case DT_CREATE_MOBJ: {
             // The mobj will be created/shown.
-            ClMobj_ReadDelta();
-            break;
+            DeltaReader in(msgReader, origins);
+            ClMobj_ReadDelta(in);
+            break; }
 
-        case DT_MOBJ:
+        case DT_MOBJ: {
             // The mobj will be hidden if it's not yet Created.
-            ClMobj_ReadDelta();
-            break;
+            DeltaReader in(msgReader, origins);
+            ClMobj_ReadDelta(in);
+            break; }
 
-        case DT_NULL_MOBJ:
+        case DT_NULL_MOBJ: {
             // The mobj will be removed.
-            ClMobj_ReadNullDelta();
-            break;
-
-        case DT_PLAYER:
-            ClPlayer_ReadDelta();
-            break;
-
-        case DT_SECTOR:
-            Cl_ReadSectorDelta(deltaType);
-            break;
+            DeltaReader in(msgReader, origins);
+            ClMobj_ReadNullDelta(in);
+            break; }
+
+        case DT_PLAYER: {
+            DeltaReader in(msgReader, origins);
+            ClPlayer_ReadDelta(in);
+            break; }
+
+        case DT_SECTOR: {
+            DeltaReader in(msgReader, origins);
+            Cl_ReadSectorDelta(in, deltaType);
+            break; }
 
         //case DT_SIDE_R6: // Old format.
         case DT_SIDE:
@@ -31,6 +31,7 @@
 #include "network/net_main.h"
 #include "network/net_buf.h"
 #include "network/net_demo.h"
+#include "network/timedemo.h"
 
 #include "world/map.h"
 #include "world/p_players.h"
@@ -114,7 +115,7 @@ void Cl_CleanUp()
     N_ClearMessages();
 }
 
-void Cl_SendHello()
+void Cl_SendHello(int flags)
 {
     LOG_AS("Cl_SendHello");
 
@@ -128,6 +129,11 @@ void Cl_SendHello()
     LOGDEV_NET_VERBOSE("game mode = %s") << buf;
 
     Writer_Write(msgWriter, buf, 16);
+    if(flags)
+    {
+        // Older servers ignore this.
+        Writer_WriteByte(msgWriter, flags);
+    }
     Msg_End();
 
     Net_SendBuffer(0, 0);
@@ -264,9 +270,12 @@ void Cl_GetPackets()
             {
             case PSV_FIRST_FRAME2:
             case PSV_FRAME2:
+            case PSV_FIRST_FRAME3:
+            case PSV_FRAME3: {
+                TimeDemoSample sample(TDS_DELTA_DECODE);
                 Cl_Frame2Received(netBuffer.msg.type);
                 Msg_EndRead();
-                continue; // Get the next packet.
+                continue; } // Get the next packet.
 
             case PSV_SOUND:
                 Cl_Sound();
@@ -365,6 +374,8 @@ void Cl_GetPackets()
 
         case PSV_FRAME2:
         case PSV_FIRST_FRAME2:
+        case PSV_FRAME3:
+        case PSV_FIRST_FRAME3:
         case PSV_SOUND:
             LOGDEV_NET_WARNING("Packet type %i was discarded (client not ready)") << netBuffer.msg.type;
             break;
@@ -28,6 +28,7 @@
 #include "client/cl_player.h"
 #include "client/cl_world.h"
 
+#include "network/deltacodec.h"
 #include "network/net_main.h"
 #include "network/protocol.h"
 
@@ -327,19 +328,19 @@ static dd_bool ClMobj_IsStuckInsideLocalPlayer(mobj_t *mo)
     return false; // Not stuck.
 }
 
-void ClMobj_ReadDelta()
+void ClMobj_ReadDelta(DeltaReader &in)
 {
     /// @todo Do not assume the CURRENT map.
     Map &map = App_WorldSystem().map();
 
-    thid_t const id = Reader_ReadUInt16(msgReader); // Read the ID.
-    int const df    = Reader_ReadUInt16(msgReader); // Flags.
+    thid_t const id = in.readId(); // Read the ID.
+    int const df    = in.isBitPacked()? in.readPackedUInt16() : in.readUInt16(); // Flags.
 
     // More flags?
     byte moreFlags = 0, fastMom = false;
     if(df & MDF_MORE_FLAGS)
     {
-        moreFlags = Reader_ReadByte(msgReader);
+        moreFlags = in.readByte();
 
         // Fast momentum uses 10.6 fixed point instead of the normal 8.8.
         if(moreFlags & MDFE_FAST_MOM)
@@ -398,16 +399,16 @@ void ClMobj_ReadDelta()
     MobjThinker oldState(*mo);
     bool onFloor = false;
 
-    // Coordinates with three bytes.
+    // Coordinates with 16.8 precision.
     if(df & MDF_ORIGIN_X)
     {
-        d->origin[VX] = FIX2FLT((Reader_ReadInt16(msgReader) << FRACBITS) | (Reader_ReadByte(msgReader) << 8));
+        d->origin[VX] = FIX2FLT(in.readCoord(id, VX));
         if(info)
             info->flags |= CLMF_KNOWN_X;
     }
     if(df & MDF_ORIGIN_Y)
     {
-        d->origin[VY] = FIX2FLT((Reader_ReadInt16(msgReader) << FRACBITS) | (Reader_ReadByte(msgReader) << 8));
+        d->origin[VY] = FIX2FLT(in.readCoord(id, VY));
         if(info)
             info->flags |= CLMF_KNOWN_Y;
     }
@@ -415,7 +416,7 @@ void ClMobj_ReadDelta()
     {
         if(!(moreFlags & MDFE_Z_FLOOR))
         {
-            d->origin[VZ] = FIX2FLT((Reader_ReadInt16(msgReader) << FRACBITS) | (Reader_ReadByte(msgReader) << 8));
+            d->origin[VZ] = FIX2FLT(in.readCoord(id, VZ));
             if(info)
             {
                 info->flags |= CLMF_KNOWN_Z;
@@ -423,54 +424,52 @@ void ClMobj_ReadDelta()
                 // The mobj won't stick if an explicit coordinate is supplied.
                 info->flags &= ~(CLMF_STICK_FLOOR | CLMF_STICK_CEILING);
             }
-            d->floorZ = Reader_ReadFloat(msgReader);
+            d->floorZ = in.readFloat();
         }
         else
         {
             onFloor = true;
 
             // Ignore these.
-            Reader_ReadInt16(msgReader);
-            Reader_ReadByte(msgReader);
-            Reader_ReadFloat(msgReader);
+            in.readCoord(id, VZ);
+            in.readFloat();
 
             info->flags |= CLMF_KNOWN_Z;
             //d->pos[VZ] = d->floorZ;
         }
 
-        d->ceilingZ = Reader_ReadFloat(msgReader);
+        d->ceilingZ = in.readFloat();
     }
 
     // Momentum using 8.8 fixed point.
     if(df & MDF_MOM_X)
     {
-        short mom = Reader_ReadInt16(msgReader);
+        short mom = in.readInt16();
         d->mom[MX] = FIX2FLT(fastMom? UNFIXED10_6(mom) : UNFIXED8_8(mom));
     }
     if(df & MDF_MOM_Y)
     {
-        short mom = Reader_ReadInt16(msgReader);
+        short mom = in.readInt16();
         d->mom[MY] = FIX2FLT(fastMom ? UNFIXED10_6(mom) : UNFIXED8_8(mom));
     }
     if(df & MDF_MOM_Z)
     {
-        short mom = Reader_ReadInt16(msgReader);
+        short mom = in.readInt16();
         d->mom[MZ] = FIX2FLT(fastMom ? UNFIXED10_6(mom) : UNFIXED8_8(mom));
     }
 
-    // Angles with 16-bit accuracy.
     if(df & MDF_ANGLE)
-        d->angle = Reader_ReadInt16(msgReader) << 16;
+        d->angle = in.readAngle();
 
     // MDF_SELSPEC is never used without MDF_SELECTOR.
     if(df & MDF_SELECTOR)
-        d->selector = Reader_ReadPackedUInt16(msgReader);
+        d->selector = in.readPackedUInt16();
     if(df & MDF_SELSPEC)
-        d->selector |= Reader_ReadByte(msgReader) << 24;
+        d->selector |= in.readByte() << 24;
 
     if(df & MDF_STATE)
     {
-        int stateIdx = Reader_ReadPackedUInt16(msgReader);
+        int stateIdx = in.readPackedUInt16();
 
         // Translate.
         stateIdx = Cl_LocalMobjState(stateIdx);
@@ -488,34 +487,34 @@ void ClMobj_ReadDelta()
     {
         // Only the flags in the pack mask are affected.
         d->ddFlags &= ~DDMF_PACK_MASK;
-        d->ddFlags |= DDMF_REMOTE | (Reader_ReadUInt32(msgReader) & DDMF_PACK_MASK);
+        d->ddFlags |= DDMF_REMOTE | (in.readUInt32() & DDMF_PACK_MASK);
 
-        d->flags  = Reader_ReadUInt32(msgReader);
-        d->flags2 = Reader_ReadUInt32(msgReader);
-        d->flags3 = Reader_ReadUInt32(msgReader);
+        d->flags  = in.readUInt32();
+        d->flags2 = in.readUInt32();
+        d->flags3 = in.readUInt32();
     }
 
     if(df & MDF_HEALTH)
-        d->health = Reader_ReadInt32(msgReader);
+        d->health = in.readInt32();
 
     if(df & MDF_RADIUS)
-        d->radius = Reader_ReadFloat(msgReader);
+        d->radius = in.readFloat();
 
     if(df & MDF_HEIGHT)
-        d->height = Reader_ReadFloat(msgReader);
+        d->height = in.readFloat();
 
     if(df & MDF_FLOORCLIP)
-        d->floorClip = Reader_ReadFloat(msgReader);
+        d->floorClip = in.readFloat();
 
     if(moreFlags & MDFE_TRANSLUCENCY)
-        d->translucency = Reader_ReadByte(msgReader);
+        d->translucency = in.readByte();
 
     if(moreFlags & MDFE_FADETARGET)
-        d->visTarget = ((short)Reader_ReadByte(msgReader)) - 1;
+        d->visTarget = ((short)in.readByte()) - 1;
 
     if(moreFlags & MDFE_TYPE)
     {
-        d->type = Cl_LocalMobjType(Reader_ReadInt32(msgReader));
+        d->type = Cl_LocalMobjType(in.readInt32());
         d->info = &runtimeDefs.mobjInfo[d->type];
     }
 
@@ -575,7 +574,7 @@ void ClMobj_ReadDelta()
     }
 }
 
-void ClMobj_ReadNullDelta()
+void ClMobj_ReadNullDelta(DeltaReader &in)
 {
     LOG_AS("ClMobj_ReadNullDelta");
 
@@ -583,7 +582,8 @@ void ClMobj_ReadNullDelta()
     Map &map = App_WorldSystem().map();
 
     // The delta only contains an ID.
-    thid_t id = Reader_ReadUInt16(msgReader);
+    thid_t id = in.readId();
+    in.removeOrigin(id);
     LOGDEV_NET_XVERBOSE("Null %i") << id;
 
     mobj_t *mo = map.clMobjFor(id);
@@ -22,6 +22,7 @@
 
 #include "api_client.h"
 
+#include "network/deltacodec.h"
 #include "network/net_main.h"
 #include "network/protocol.h"
 
@@ -281,7 +282,7 @@ void ClPlayer_MoveLocal(coord_t dx, coord_t dy, coord_t z, bool onground)
     ClPlayer_UpdateOrigin(consolePlayer);
 }
 
-void ClPlayer_ReadDelta()
+void ClPlayer_ReadDelta(DeltaReader &in)
 {
     LOG_AS("ClPlayer_ReadDelta2");
 
@@ -292,9 +293,9 @@ void ClPlayer_ReadDelta()
     ushort num;
 
     // The first byte consists of a player number and some flags.
-    num = Reader_ReadByte(msgReader);
+    num = in.readByte();
     df = (num & 0xf0) << 8;
-    df |= Reader_ReadByte(msgReader); // Second byte is just flags.
+    df |= in.readByte(); // Second byte is just flags.
     num &= 0xf; // Clear the upper bits of the number.
 
     clplayerstate_t *s = &clPlayerStates[num];
@@ -303,7 +304,7 @@ void ClPlayer_ReadDelta()
     if(df & PDF_MOBJ)
     {
         mobj_t *old  = map.clMobjFor(s->clMobjId);
-        ushort newId = Reader_ReadUInt16(msgReader);
+        ushort newId = in.readId();
 
         // Make sure the 'new' mobj is different than the old one;
         // there will be linking problems otherwise.
@@ -372,40 +373,40 @@ void ClPlayer_ReadDelta()
 
     if(df & PDF_FORWARDMOVE)
     {
-        s->forwardMove = (char) Reader_ReadByte(msgReader) * 2048;
+        s->forwardMove = (char) in.readByte() * 2048;
     }
 
     if(df & PDF_SIDEMOVE)
     {
-        s->sideMove = (char) Reader_ReadByte(msgReader) * 2048;
+        s->sideMove = (char) in.readByte() * 2048;
     }
 
     if(df & PDF_ANGLE)
     {
-        //s->angle = Reader_ReadByte(msgReader) << 24;
-        DENG_UNUSED(Reader_ReadByte(msgReader));
+        //s->angle = in.readByte() << 24;
+        DENG_UNUSED(in.readByte());
     }
 
     if(df & PDF_TURNDELTA)
     {
-        s->turnDelta = ((char) Reader_ReadByte(msgReader) << 24) / 16;
+        s->turnDelta = ((char) in.readByte() << 24) / 16;
     }
 
     if(df & PDF_FRICTION)
     {
-        s->friction = Reader_ReadByte(msgReader) << 8;
+        s->friction = in.readByte() << 8;
     }
 
     if(df & PDF_EXTRALIGHT)
     {
-        int val = Reader_ReadByte(msgReader);
+        int val = in.readByte();
         ddpl->fixedColorMap = val & 7;
         ddpl->extraLight    = val & 0xf8;
     }
 
     if(df & PDF_FILTER)
     {
-        uint filter = Reader_ReadUInt32(msgReader);
+        uint filter = in.readUInt32();
 
         ddpl->filterColor[CR] = (filter & 0xff) / 255.f;
         ddpl->filterColor[CG] = ((filter >> 8) & 0xff) / 255.f;
@@ -429,12 +430,12 @@ void ClPlayer_ReadDelta()
         for(int i = 0; i < 2; ++i)
         {
             // First the flags.
-            int psdf = Reader_ReadByte(msgReader);
+            int psdf = in.readByte();
             ddpsprite_t *psp = ddpl->pSprites + i;
 
             if(psdf & PSDF_STATEPTR)
             {
-                int idx = Reader_ReadPackedUInt16(msgReader);
+                int idx = in.readPackedUInt16();
                 if(!idx)
                 {
                     psp->statePtr = 0;
@@ -448,23 +449,23 @@ void ClPlayer_ReadDelta()
 
             /*if(psdf & PSDF_LIGHT)
             {
-                psp->light = Reader_ReadByte(msgReader) / 255.0f;
+                psp->light = in.readByte() / 255.0f;
             }*/
 
             if(psdf & PSDF_ALPHA)
             {
-                psp->alpha = Reader_ReadByte(msgReader) / 255.0f;
+                psp->alpha = in.readByte() / 255.0f;
             }
 
             if(psdf & PSDF_STATE)
             {
-                psp->state = Reader_ReadByte(msgReader);
+                psp->state = in.readByte();
             }
 
             if(psdf & PSDF_OFFSET)
             {
-                psp->offset[VX] = (char) Reader_ReadByte(msgReader) * 2;
-                psp->offset[VY] = (char) Reader_ReadByte(msgReader) * 2;
+                psp->offset[VX] = (char) in.readByte() * 2;
+                psp->offset[VY] = (char) in.readByte() * 2;
             }
         }
     }
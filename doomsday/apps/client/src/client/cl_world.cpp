@@ -26,6 +26,7 @@
 #include "api_map.h"
 #include "api_materialarchive.h"
 
+#include "network/deltacodec.h"
 #include "network/net_msg.h"
 #include "network/protocol.h"
 
@@ -150,7 +151,7 @@ int Cl_LocalMobjState(int serverMobjState)
     return xlatMobjState[serverMobjState];
 }
 
-void Cl_ReadSectorDelta(int /*deltaType*/)
+void Cl_ReadSectorDelta(DeltaReader &in, int /*deltaType*/)
 {
     /// @todo Do not assume the CURRENT map.
     Map &map = App_WorldSystem().map();
@@ -163,48 +164,48 @@ void Cl_ReadSectorDelta(int /*deltaType*/)
     float speed[2]  = { 0, 0 };
 
     // Sector index number.
-    Sector *sec = map.sectorPtr(Reader_ReadUInt16(msgReader));
+    Sector *sec = map.sectorPtr(in.readId());
     DENG2_ASSERT(sec);
 
     // Flags.
-    int df = Reader_ReadPackedUInt32(msgReader);
+    int df = in.readPackedUInt32();
 
     if(df & SDF_FLOOR_MATERIAL)
     {
         P_SetPtrp(sec, DMU_FLOOR_OF_SECTOR | DMU_MATERIAL,
-                  Cl_LocalMaterial(Reader_ReadPackedUInt16(msgReader)));
+                  Cl_LocalMaterial(in.readPackedUInt16()));
     }
     if(df & SDF_CEILING_MATERIAL)
     {
         P_SetPtrp(sec, DMU_CEILING_OF_SECTOR | DMU_MATERIAL,
-                  Cl_LocalMaterial(Reader_ReadPackedUInt16(msgReader)));
+                  Cl_LocalMaterial(in.readPackedUInt16()));
     }
 
     if(df & SDF_LIGHT)
-        P_SetFloatp(sec, DMU_LIGHT_LEVEL, Reader_ReadByte(msgReader) / 255.0f);
+        P_SetFloatp(sec, DMU_LIGHT_LEVEL, in.readByte() / 255.0f);
 
     if(df & SDF_FLOOR_HEIGHT)
-        height[PLN_FLOOR] = FIX2FLT(Reader_ReadInt16(msgReader) << 16);
+        height[PLN_FLOOR] = FIX2FLT(in.readInt16() << 16);
     if(df & SDF_CEILING_HEIGHT)
-        height[PLN_CEILING] = FIX2FLT(Reader_ReadInt16(msgReader) << 16);
+        height[PLN_CEILING] = FIX2FLT(in.readInt16() << 16);
     if(df & SDF_FLOOR_TARGET)
-        target[PLN_FLOOR] = FIX2FLT(Reader_ReadInt16(msgReader) << 16);
+        target[PLN_FLOOR] = FIX2FLT(in.readInt16() << 16);
     if(df & SDF_FLOOR_SPEED)
-        speed[PLN_FLOOR] = FIX2FLT(Reader_ReadByte(msgReader) << (df & SDF_FLOOR_SPEED_44 ? 12 : 15));
+        speed[PLN_FLOOR] = FIX2FLT(in.readByte() << (df & SDF_FLOOR_SPEED_44 ? 12 : 15));
     if(df & SDF_CEILING_TARGET)
-        target[PLN_CEILING] = FIX2FLT(Reader_ReadInt16(msgReader) << 16);
+        target[PLN_CEILING] = FIX2FLT(in.readInt16() << 16);
     if(df & SDF_CEILING_SPEED)
-        speed[PLN_CEILING] = FIX2FLT(Reader_ReadByte(msgReader) << (df & SDF_CEILING_SPEED_44 ? 12 : 15));
+        speed[PLN_CEILING] = FIX2FLT(in.readByte() << (df & SDF_CEILING_SPEED_44 ? 12 : 15));
 
     if(df & (SDF_COLOR_RED | SDF_COLOR_GREEN | SDF_COLOR_BLUE))
     {
         Vector3f newColor = sec->lightColor();
         if(df & SDF_COLOR_RED)
-            newColor.x = Reader_ReadByte(msgReader) / 255.f;
+            newColor.x = in.readByte() / 255.f;
         if(df & SDF_COLOR_GREEN)
-            newColor.y = Reader_ReadByte(msgReader) / 255.f;
+            newColor.y = in.readByte() / 255.f;
         if(df & SDF_COLOR_BLUE)
-            newColor.z = Reader_ReadByte(msgReader) / 255.f;
+            newColor.z = in.readByte() / 255.f;
         sec->setLightColor(newColor);
     }
 
@@ -212,11 +213,11 @@ void Cl_ReadSectorDelta(int /*deltaType*/)
     {
         Vector3f newColor = sec->floorSurface().tintColor();
         if(df & SDF_FLOOR_COLOR_RED)
-            newColor.x = Reader_ReadByte(msgReader) / 255.f;
+            newColor.x = in.readByte() / 255.f;
         if(df & SDF_FLOOR_COLOR_GREEN)
-            newColor.y = Reader_ReadByte(msgReader) / 255.f;
+            newColor.y = in.readByte() / 255.f;
         if(df & SDF_FLOOR_COLOR_BLUE)
-            newColor.z = Reader_ReadByte(msgReader) / 255.f;
+            newColor.z = in.readByte() / 255.f;
         sec->floorSurface().setTintColor(newColor);
     }
 
@@ -224,11 +225,11 @@ void Cl_ReadSectorDelta(int /*deltaType*/)
     {
         Vector3f newColor = sec->ceilingSurface().tintColor();
         if(df & SDF_CEIL_COLOR_RED)
-            newColor.x = Reader_ReadByte(msgReader) / 255.f;
+            newColor.x = in.readByte() / 255.f;
         if(df & SDF_CEIL_COLOR_GREEN)
-            newColor.y = Reader_ReadByte(msgReader) / 255.f;
+            newColor.y = in.readByte() / 255.f;
         if(df & SDF_CEIL_COLOR_BLUE)
-            newColor.z = Reader_ReadByte(msgReader) / 255.f;
+            newColor.z = in.readByte() / 255.f;
         sec->ceilingSurface().setTintColor(newColor);
     }
 
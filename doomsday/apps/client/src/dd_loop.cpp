@@ -39,6 +39,7 @@
 
 #ifdef __CLIENT__
 #  include "clientapp.h"
+#  include "network/timedemo.h"
 #  include "ui/busyvisual.h"
 #  include "ui/clientwindow.h"
 #endif
@@ -406,6 +407,14 @@ void Loop_RunTics(void)
         elapsedTime = MAX_FRAME_TIME;
     }
 
+#ifdef __CLIENT__
+    if(TimeDemo_IsRunning())
+    {
+        // Timedemos run exactly one tic per refresh, as fast as possible.
+        elapsedTime = 1.0 / TICSPERSEC;
+    }
+#endif
+
     // Remember when this frame started.
     lastRunTicsTime = nowTime;
 
@@ -429,7 +438,12 @@ void Loop_RunTics(void)
 #endif
 
         // Call all the tickers.
-        baseTicker(ticLength);
+        {
+#ifdef __CLIENT__
+            TimeDemoSample sample(TDS_WORLD_TIC);
+#endif
+            baseTicker(ticLength);
+        }
 
 #ifdef __CLIENT__
         if(processSharpEventsAfterTickers)
@@ -1987,6 +1987,11 @@ static void initialize()
             Con_Executef(CMDS_CMDLINE, false, "net-ip-port %s", CommandLine_Next());
         }
 
+#ifdef __CLIENT__
+        // Demo playback requested on the command line?
+        DD_CheckTimeDemo();
+#endif
+
 #ifdef __SERVER__
         // Automatically start the server.
         N_ServerOpen();
@@ -2191,8 +2196,16 @@ void DD_CheckTimeDemo()
     if(!checked)
     {
         checked = true;
-        if(CommandLine_CheckWith("-timedemo", 1) || // Timedemo mode.
-           CommandLine_CheckWith("-playdemo", 1))   // Play-once mode.
+        if(CommandLine_CheckWith("-timedemo", 1)) // Timedemo mode.
+        {
+            String cmd = String("timedemo %1").arg(CommandLine_Next());
+            if(CommandLine_CheckWith("-timedemo-summary", 1))
+            {
+                cmd += String(" %1").arg(CommandLine_Next());
+            }
+            Con_Execute(CMDS_CMDLINE, cmd.toUtf8().constData(), false, false);
+        }
+        else if(CommandLine_CheckWith("-playdemo", 1)) // Play-once mode.
         {
             Block cmd = String("playdemo %1").arg(CommandLine_Next()).toUtf8();
             Con_Execute(CMDS_CMDLINE, cmd.constData(), false, false);
@@ -31,6 +31,7 @@
 #include <de/NativePath>
 #include <de/RecordValue>
 #include <doomsday/defs/decoration.h>
+#include <doomsday/defs/dedcache.h>
 #include <doomsday/defs/dedfile.h>
 #include <doomsday/defs/dedparser.h>
 #include <doomsday/defs/material.h>
@@ -596,10 +597,8 @@ static void translateMapInfos(QStringList const &mapInfoUrns, String &xlat, Stri
     Str_Free(&parm.paths);
 }
 
-static void readAllDefinitions()
+static void readDefinitionSources()
 {
-    Time begunAt;
-
     /*
      * Start with engine's own top-level definition file.
      */
@@ -711,6 +710,27 @@ static void readAllDefinitions()
     // Last are DD_DEFNS definition lumps from loaded add-ons.
     /// @todo Shouldn't these be processed before definitions on the command line?
     Def_ReadLumpDefs();
+}
+
+static void readAllDefinitions()
+{
+    Time begunAt;
+
+    // Parsing is skipped if the same sources were compiled earlier.
+    String const cacheName = (App_GameLoaded()? App_CurrentGame().id() : String("none")) + ".ddc";
+    DEDCache cache(App::app().nativeHomePath() / "cache" / "defs" / cacheName);
+
+    cache.beginChecking(defs);
+    readDefinitionSources();
+    if(cache.tryLoad(defs))
+    {
+        LOG_RES_VERBOSE("readAllDefinitions: Loaded compiled definitions in %.2f seconds")
+                << begunAt.since();
+        return;
+    }
+
+    cache.parse(defs);
+    cache.save(defs);
 
     LOG_RES_VERBOSE("readAllDefinitions: Completed in %.2f seconds") << begunAt.since();
 }
@@ -48,6 +48,8 @@
 #include "gl/gl_texmanager.h"
 #include "gl/texturecontent.h"
 
+#include "network/timedemo.h"
+
 #include "resource/hq2x.h"
 #include "MaterialAnimator"
 #include "MaterialVariantSpec"
@@ -218,7 +220,10 @@ void GL_DoUpdate()
     // Wait until the right time to show the frame so that the realized
     // frame rate is exactly right.
     glFlush();
-    DD_WaitForOptimalUpdateTime();
+    if(!TimeDemo_IsRunning())
+    {
+        DD_WaitForOptimalUpdateTime();
+    }
 
     // Blit screen to video.
     ClientWindow::main().swapBuffers();
@@ -536,14 +541,14 @@ void GL_SetupFogFromMapInfo(Record const *mapInfo)
     if(!fadeTable.isEmpty())
     {
         LumpIndex const &lumps = App_FileSystem().nameIndex();
-        dint lumpNum = lumps.findLast(fadeTable + ".lmp");
-        if(lumpNum == lumps.findLast("COLORMAP.lmp"))
+        dint lumpNum = lumps.findLast(PathView(fadeTable + ".lmp"));
+        if(lumpNum == lumps.findLast(PathView("COLORMAP.lmp")))
         {
             // We don't want fog in this case.
             GL_UseFog(false);
         }
         // Probably fog ... don't use fullbright sprites.
-        else if(lumpNum == lumps.findLast("FOGMAP.lmp"))
+        else if(lumpNum == lumps.findLast(PathView("FOGMAP.lmp")))
         {
             GL_UseFog(true);
         }
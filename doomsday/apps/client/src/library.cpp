@@ -23,6 +23,7 @@
 #include <de/NativeFile>
 #include <de/LibraryFile>
 #include <de/Library>
+#include <QList>
 
 #include "de_base.h"
 #include "Sector"
@@ -253,9 +254,22 @@ int Library_IterateAvailableLibraries(int (*func)(void *, const char *, const ch
 
     FS::Index const &libs = App::fileSystem().indexFor(DENG2_TYPE_NAME(LibraryFile));
 
+    // The index is unordered. Visit the libraries in name order so that plugins
+    // are always loaded in the same order.
+    QList<LibraryFile *> sorted;
     DENG2_FOR_EACH_CONST(FS::Index, i, libs)
     {
-        LibraryFile &lib = i->second->as<LibraryFile>();
+        sorted << &i->second->as<LibraryFile>();
+    }
+    qSort(sorted.begin(), sorted.end(), [] (LibraryFile const *a, LibraryFile const *b)
+    {
+        if(int diff = a->name().compareWithoutCase(b->name())) return diff < 0;
+        return a->path() < b->path();
+    });
+
+    foreach(LibraryFile *found, sorted)
+    {
+        LibraryFile &lib = *found;
         NativeFile const *src = lib.source()->maybeAs<NativeFile>();
         if(src)
         {
@@ -259,12 +259,13 @@ DENG_EXTERN_C AutoStr *M_ReadFileIntoString(ddstring_t const *path, dd_bool *isC
 
     if(Str_StartsWith(path, "Lumps:"))
     {
-        char const *lumpName       = Str_Text(path) + 6;
+        String const lumpPath      = String(Str_Text(path) + 6) + ".lmp";
         LumpIndex const &lumpIndex = App_FileSystem().nameIndex();
-        if(!lumpIndex.contains(String(lumpName) + ".lmp"))
+        lumpnum_t const lumpNum    = lumpIndex.findLast(PathView(lumpPath));
+        if(lumpNum < 0)
             return 0;
 
-        File1 &lump = lumpIndex[lumpIndex.findLast(String(lumpName) + ".lmp")];
+        File1 &lump = lumpIndex[lumpNum];
         if(isCustom)
         {
             /// @todo Custom status for contained files is not inherited from the container?
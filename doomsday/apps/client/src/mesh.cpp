@@ -95,6 +95,13 @@ Vertex *Mesh::newVertex(Vector2d const &origin)
     return vtx;
 }
 
+void Mesh::addVertex(Vertex &vertex)
+{
+    DENG2_ASSERT(&vertex.mesh() == this);
+    DENG2_ASSERT(!d->vertexs.contains(&vertex));
+    d->vertexs.append(&vertex);
+}
+
 HEdge *Mesh::newHEdge(Vertex &vertex)
 {
     HEdge *hedge = new HEdge(*this, vertex);
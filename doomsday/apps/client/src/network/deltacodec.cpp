@@ -0,0 +1,405 @@
+/**
+ * @file deltacodec.cpp
+ * Reading and writing the contents of frame deltas. @ingroup network
+ *
+ * @authors Copyright © 2015 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#include "network/deltacodec.h"
+
+#include <de/fixedpoint.h>
+#include <cstring>
+
+/// Number of bits in a quantized angle.
+#define ANGLE_BITS          12
+
+/// Number of bits in an absolute coordinate (16.8 fixed point).
+#define COORD_BITS          24
+
+/*
+ * Size classes of signed values. The last class must be able to hold any
+ * value of the field.
+ */
+static int const smallWidths[4] = { 6, 10, 14, 17 };  ///< Int16 fields.
+static int const coordWidths[4] = { 10, 14, 18, 26 }; ///< Relative coordinates.
+
+static inline uint32_t zigZag(int32_t value)
+{
+    return (uint32_t(value) << 1) ^ uint32_t(value >> 31);
+}
+
+static inline int32_t unZigZag(uint32_t value)
+{
+    return int32_t(value >> 1) ^ -int32_t(value & 1);
+}
+
+/// Sign-extends the lowest @a bits bits of @a value.
+static inline int32_t signExtended(uint32_t value, int bits)
+{
+    return int32_t(value << (32 - bits)) >> (32 - bits);
+}
+
+void DeltaOrigins::clear()
+{
+    _origins.clear();
+}
+
+DeltaOrigins::Origin DeltaOrigins::origin(thid_t id) const
+{
+    return _origins.value(id);
+}
+
+void DeltaOrigins::setOrigin(thid_t id, Origin const &origin)
+{
+    if(origin.known)
+    {
+        _origins.insert(id, origin);
+    }
+    else
+    {
+        _origins.remove(id);
+    }
+}
+
+void DeltaOrigins::remove(thid_t id)
+{
+    _origins.remove(id);
+}
+
+DeltaWriter::DeltaWriter(Writer *writer, DeltaOrigins *origins)
+    : _writer(writer), _origins(origins), _bits(0), _count(0)
+{}
+
+DeltaWriter::~DeltaWriter()
+{
+    // The last bits are padded with zeroes.
+    if(_count > 0)
+    {
+        Writer_WriteByte(_writer, byte(_bits));
+    }
+}
+
+bool DeltaWriter::isBitPacked() const
+{
+    return _origins != 0;
+}
+
+void DeltaWriter::writeBits(uint32_t value, int count)
+{
+    DENG_ASSERT(count > 0 && count <= 32);
+    if(count < 32) value &= (uint32_t(1) << count) - 1;
+
+    _bits |= uint64_t(value) << _count;
+    _count += count;
+    while(_count >= 8)
+    {
+        Writer_WriteByte(_writer, byte(_bits));
+        _bits >>= 8;
+        _count -= 8;
+    }
+}
+
+void DeltaWriter::writeVarUInt(uint32_t value)
+{
+    // Seven bits at a time, with a continuation bit.
+    while(value >= 0x80)
+    {
+        writeBits((value & 0x7f) | 0x80, 8);
+        value >>= 7;
+    }
+    writeBits(value, 8);
+}
+
+void DeltaWriter::writeSigned(int32_t value, int const widths[4])
+{
+    uint32_t const bits = zigZag(value);
+    int sizeClass = 0;
+    while(sizeClass < 3 && bits >= (uint32_t(1) << widths[sizeClass])) sizeClass++;
+    writeBits(sizeClass, 2);
+    writeBits(bits, widths[sizeClass]);
+}
+
+void DeltaWriter::writeByte(byte v)
+{
+    if(!isBitPacked())
+    {
+        Writer_WriteByte(_writer, v);
+        return;
+    }
+    writeBits(v, 8);
+}
+
+void DeltaWriter::writeUInt16(uint16_t v)
+{
+    if(!isBitPacked())
+    {
+        Writer_WriteUInt16(_writer, v);
+        return;
+    }
+    writeBits(v, 16);
+}
+
+void DeltaWriter::writeUInt32(uint32_t v)
+{
+    if(!isBitPacked())
+    {
+        Writer_WriteUInt32(_writer, v);
+        return;
+    }
+    writeBits(v, 32);
+}
+
+void DeltaWriter::writeInt32(int32_t v)
+{
+    if(!isBitPacked())
+    {
+        Writer_WriteInt32(_writer, v);
+        return;
+    }
+    writeBits(uint32_t(v), 32);
+}
+
+void DeltaWriter::writeFloat(float v)
+{
+    if(!isBitPacked())
+    {
+        Writer_WriteFloat(_writer, v);
+        return;
+    }
+    uint32_t bits;
+    std::memcpy(&bits, &v, 4);
+    writeBits(bits, 32);
+}
+
+void DeltaWriter::writePackedUInt16(uint16_t v)
+{
+    if(!isBitPacked())
+    {
+        Writer_WritePackedUInt16(_writer, v);
+        return;
+    }
+    writeVarUInt(v);
+}
+
+void DeltaWriter::writePackedUInt32(uint32_t v)
+{
+    if(!isBitPacked())
+    {
+        Writer_WritePackedUInt32(_writer, v);
+        return;
+    }
+    writeVarUInt(v);
+}
+
+void DeltaWriter::writeInt16(int16_t v)
+{
+    if(!isBitPacked())
+    {
+        Writer_WriteInt16(_writer, v);
+        return;
+    }
+    writeSigned(v, smallWidths);
+}
+
+void DeltaWriter::writeId(uint16_t id)
+{
+    if(!isBitPacked())
+    {
+        Writer_WriteUInt16(_writer, id);
+        return;
+    }
+    writeVarUInt(id);
+}
+
+void DeltaWriter::writeAngle(angle_t angle)
+{
+    if(!isBitPacked())
+    {
+        // Angles with 16-bit accuracy.
+        Writer_WriteInt16(_writer, angle >> 16);
+        return;
+    }
+    // Rounded to the nearest bin.
+    writeBits((angle + (1u << (31 - ANGLE_BITS))) >> (32 - ANGLE_BITS), ANGLE_BITS);
+}
+
+void DeltaWriter::writeCoord(thid_t id, int axis, fixed_t value)
+{
+    if(!isBitPacked())
+    {
+        // Coordinates with three bytes.
+        Writer_WriteInt16(_writer, value >> FRACBITS);
+        Writer_WriteByte(_writer, value >> 8);
+        return;
+    }
+
+    int32_t const coord = value >> 8;
+    DeltaOrigins::Origin origin = _origins->origin(id);
+    if(origin.known & (1 << axis))
+    {
+        writeSigned(coord - origin.pos[axis], coordWidths);
+    }
+    else
+    {
+        writeBits(uint32_t(coord), COORD_BITS);
+    }
+    origin.pos[axis] = coord;
+    origin.known |= 1 << axis;
+    _origins->setOrigin(id, origin);
+}
+
+void DeltaWriter::removeOrigin(thid_t id)
+{
+    if(_origins) _origins->remove(id);
+}
+
+DeltaReader::DeltaReader(Reader *reader, DeltaOrigins *origins)
+    : _reader(reader), _origins(origins), _bits(0), _count(0)
+{}
+
+bool DeltaReader::isBitPacked() const
+{
+    return _origins != 0;
+}
+
+uint32_t DeltaReader::readBits(int count)
+{
+    DENG_ASSERT(count > 0 && count <= 32);
+
+    // Bytes are only consumed when needed, so the padding at the end of the
+    // delta is left unread in the accumulator.
+    while(_count < count)
+    {
+        _bits |= uint64_t(Reader_ReadByte(_reader)) << _count;
+        _count += 8;
+    }
+    uint32_t const value = uint32_t(_bits) & (count < 32? (uint32_t(1) << count) - 1 : ~uint32_t(0));
+    _bits >>= count;
+    _count -= count;
+    return value;
+}
+
+uint32_t DeltaReader::readVarUInt()
+{
+    uint32_t value = 0;
+    for(int shift = 0; shift < 35; shift += 7)
+    {
+        uint32_t const group = readBits(8);
+        value |= (group & 0x7f) << shift;
+        if(!(group & 0x80)) break;
+    }
+    return value;
+}
+
+int32_t DeltaReader::readSigned(int const widths[4])
+{
+    int const sizeClass = readBits(2);
+    return unZigZag(readBits(widths[sizeClass]));
+}
+
+byte DeltaReader::readByte()
+{
+    if(!isBitPacked()) return Reader_ReadByte(_reader);
+    return byte(readBits(8));
+}
+
+uint16_t DeltaReader::readUInt16()
+{
+    if(!isBitPacked()) return Reader_ReadUInt16(_reader);
+    return uint16_t(readBits(16));
+}
+
+uint32_t DeltaReader::readUInt32()
+{
+    if(!isBitPacked()) return Reader_ReadUInt32(_reader);
+    return readBits(32);
+}
+
+int32_t DeltaReader::readInt32()
+{
+    if(!isBitPacked()) return Reader_ReadInt32(_reader);
+    return int32_t(readBits(32));
+}
+
+float DeltaReader::readFloat()
+{
+    if(!isBitPacked()) return Reader_ReadFloat(_reader);
+    uint32_t const bits = readBits(32);
+    float v;
+    std::memcpy(&v, &bits, 4);
+    return v;
+}
+
+uint16_t DeltaReader::readPackedUInt16()
+{
+    if(!isBitPacked()) return Reader_ReadPackedUInt16(_reader);
+    return uint16_t(readVarUInt());
+}
+
+uint32_t DeltaReader::readPackedUInt32()
+{
+    if(!isBitPacked()) return Reader_ReadPackedUInt32(_reader);
+    return readVarUInt();
+}
+
+int16_t DeltaReader::readInt16()
+{
+    if(!isBitPacked()) return Reader_ReadInt16(_reader);
+    return int16_t(readSigned(smallWidths));
+}
+
+uint16_t DeltaReader::readId()
+{
+    if(!isBitPacked()) return Reader_ReadUInt16(_reader);
+    return uint16_t(readVarUInt());
+}
+
+angle_t DeltaReader::readAngle()
+{
+    if(!isBitPacked()) return Reader_ReadInt16(_reader) << 16;
+    return readBits(ANGLE_BITS) << (32 - ANGLE_BITS);
+}
+
+fixed_t DeltaReader::readCoord(thid_t id, int axis)
+{
+    if(!isBitPacked())
+    {
+        fixed_t const integer = Reader_ReadInt16(_reader) << FRACBITS;
+        return integer | (Reader_ReadByte(_reader) << 8);
+    }
+
+    DeltaOrigins::Origin origin = _origins->origin(id);
+    int32_t coord;
+    if(origin.known & (1 << axis))
+    {
+        coord = origin.pos[axis] + readSigned(coordWidths);
+    }
+    else
+    {
+        coord = signExtended(readBits(COORD_BITS), COORD_BITS);
+    }
+    origin.pos[axis] = coord;
+    origin.known |= 1 << axis;
+    _origins->setOrigin(id, origin);
+
+    return fixed_t(uint32_t(coord) << 8);
+}
+
+void DeltaReader::removeOrigin(thid_t id)
+{
+    if(_origins) _origins->remove(id);
+}
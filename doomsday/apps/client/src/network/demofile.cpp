@@ -0,0 +1,336 @@
+/**
+ * @file demofile.cpp
+ * Seekable demo files. @ingroup network
+ *
+ * @authors Copyright © 2015 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#include "network/demofile.h"
+
+#include <de/Log>
+#include <de/Reader>
+#include <de/Writer>
+#include <de/math.h>
+#include <QFile>
+#include <QList>
+
+using namespace de;
+
+static char const *HEADER_MAGIC = "DDmo";
+static char const *INDEX_MAGIC  = "DIdx";
+static char const *FOOTER_MAGIC = "DEnd";
+
+static duint32 const FORMAT_VERSION = 1;
+
+static dsize const HEADER_SIZE       = 8;
+static dsize const CHUNK_HEADER_SIZE = 12;
+static dsize const FOOTER_SIZE       = 12;
+
+/// Uncompressed size after which a new chunk is begun.
+static dsize const CHUNK_SIZE = 64 * 1024;
+
+/// Chunk flags.
+static duint32 const CHUNK_KEYFRAME = 0x1;
+
+namespace {
+
+struct Keyframe
+{
+    duint32 tic;
+    duint32 offset; ///< Offset of the chunk in the file.
+};
+
+typedef QList<Keyframe> Keyframes;
+
+} // namespace
+
+DENG2_PIMPL_NOREF(DemoWriter)
+{
+    QFile file;
+    Keyframes index;
+    Block chunk;            ///< Uncompressed packet records.
+    duint32 chunkTic;
+    duint32 chunkFlags;
+    duint32 lastTic;
+
+    Instance(NativePath const &path)
+        : file(path.toString())
+        , chunkTic(0)
+        , chunkFlags(0)
+        , lastTic(0)
+    {
+        if(!file.open(QFile::WriteOnly | QFile::Truncate))
+        {
+            throw OpenError("DemoWriter", "Failed to create " + path.pretty());
+        }
+        Block header(HEADER_MAGIC);
+        Writer(header, header.size()) << FORMAT_VERSION;
+        file.write(header);
+    }
+
+    ~Instance()
+    {
+        flushChunk();
+        writeIndex();
+    }
+
+    void beginChunk(duint32 tic, duint32 flags)
+    {
+        flushChunk();
+        chunkTic   = tic;
+        chunkFlags = flags;
+    }
+
+    void flushChunk()
+    {
+        if(chunk.isEmpty()) return;
+
+        if(chunkFlags & CHUNK_KEYFRAME)
+        {
+            Keyframe const key = { chunkTic, duint32(file.pos()) };
+            index << key;
+        }
+
+        Block const compressed = qCompress(chunk);
+        Block header;
+        Writer(header) << chunkTic << chunkFlags << duint32(compressed.size());
+        file.write(header);
+        file.write(compressed);
+
+        chunk.clear();
+        chunkFlags = 0;
+    }
+
+    void writeIndex()
+    {
+        duint32 const indexOffset = duint32(file.pos());
+
+        Block block(INDEX_MAGIC);
+        Writer writer(block, block.size());
+        writer << duint32(index.size());
+        foreach(Keyframe const &key, index)
+        {
+            writer << key.tic << key.offset;
+        }
+        writer << indexOffset << lastTic;
+        block.append(FOOTER_MAGIC);
+        file.write(block);
+    }
+};
+
+DemoWriter::DemoWriter(NativePath const &path) : d(new Instance(path))
+{}
+
+DemoWriter::~DemoWriter()
+{}
+
+void DemoWriter::beginKeyframe(int tic)
+{
+    d->beginChunk(duint32(tic), CHUNK_KEYFRAME);
+}
+
+void DemoWriter::writePacket(int tic, dbyte type, void const *data, dsize length)
+{
+    if(d->chunk.isEmpty() && !d->chunkFlags)
+    {
+        // Continuing after a full chunk.
+        d->chunkTic = duint32(tic);
+    }
+
+    Writer(d->chunk, d->chunk.size()) << duint32(tic) << duint32(length) << type;
+    d->chunk.append(static_cast<char const *>(data), int(length));
+
+    d->lastTic = duint32(tic);
+
+    if(dsize(d->chunk.size()) >= CHUNK_SIZE)
+    {
+        d->flushChunk();
+    }
+}
+
+DENG2_PIMPL_NOREF(DemoReader)
+{
+    QFile file;
+    Keyframes index;
+    duint32 length;
+    dsize chunksEnd;        ///< Offset where the chunks end.
+    dsize nextChunk;        ///< Offset of the next chunk to load.
+    Block chunk;            ///< Current uncompressed chunk.
+    dsize pos;              ///< Read position in the current chunk.
+
+    Instance(NativePath const &path)
+        : file(path.toString())
+        , length(0)
+        , chunksEnd(0)
+        , nextChunk(HEADER_SIZE)
+        , pos(0)
+    {
+        if(!file.open(QFile::ReadOnly))
+        {
+            throw FormatError("DemoReader", "Failed to open " + path.pretty());
+        }
+        if(!hasHeader(file))
+        {
+            throw FormatError("DemoReader", path.pretty() + " is not a demo file");
+        }
+        chunksEnd = dsize(file.size());
+        if(!readIndex())
+        {
+            LOG_RES_NOTE("Demo \"%s\" has no index; it may be incomplete") << path.pretty();
+            scanChunks();
+        }
+    }
+
+    static bool hasHeader(QFile &file)
+    {
+        file.seek(0);
+        Block const header = file.read(HEADER_SIZE);
+        if(dsize(header.size()) < HEADER_SIZE || header.left(4) != HEADER_MAGIC) return false;
+
+        duint32 version;
+        Reader(header, littleEndianByteOrder, 4) >> version;
+        return version == FORMAT_VERSION;
+    }
+
+    bool readIndex()
+    {
+        if(dsize(file.size()) < HEADER_SIZE + FOOTER_SIZE) return false;
+
+        file.seek(file.size() - FOOTER_SIZE);
+        Block const footer = file.read(FOOTER_SIZE);
+        if(dsize(footer.size()) < FOOTER_SIZE || footer.mid(8) != FOOTER_MAGIC) return false;
+
+        duint32 indexOffset;
+        Reader(footer) >> indexOffset >> length;
+        if(indexOffset < HEADER_SIZE || indexOffset > file.size() - FOOTER_SIZE) return false;
+
+        file.seek(indexOffset);
+        Block const block = file.read(file.size() - FOOTER_SIZE - indexOffset);
+        if(block.size() < 8 || block.left(4) != INDEX_MAGIC) return false;
+
+        Reader reader(block, littleEndianByteOrder, 4);
+        duint32 count;
+        reader >> count;
+        if(reader.remainingSize() < dsize(count) * 8) return false;
+        for(duint32 i = 0; i < count; ++i)
+        {
+            Keyframe key;
+            reader >> key.tic >> key.offset;
+            index << key;
+        }
+        chunksEnd = indexOffset;
+        return true;
+    }
+
+    void scanChunks()
+    {
+        index.clear();
+        for(dsize offset = HEADER_SIZE; offset + CHUNK_HEADER_SIZE <= chunksEnd; )
+        {
+            file.seek(offset);
+            Block const header = file.read(CHUNK_HEADER_SIZE);
+            duint32 tic, flags, size;
+            Reader(header) >> tic >> flags >> size;
+            if(offset + CHUNK_HEADER_SIZE + size > chunksEnd) break; // Truncated.
+
+            if(flags & CHUNK_KEYFRAME)
+            {
+                Keyframe const key = { tic, duint32(offset) };
+                index << key;
+            }
+            length = de::max(length, tic);
+            offset += CHUNK_HEADER_SIZE + size;
+        }
+    }
+
+    bool loadChunk()
+    {
+        chunk.clear();
+        pos = 0;
+        if(nextChunk + CHUNK_HEADER_SIZE > chunksEnd) return false;
+
+        file.seek(nextChunk);
+        Block const header = file.read(CHUNK_HEADER_SIZE);
+        duint32 tic, flags, size;
+        Reader(header) >> tic >> flags >> size;
+        if(nextChunk + CHUNK_HEADER_SIZE + size > chunksEnd) return false;
+
+        chunk = qUncompress(file.read(size));
+        nextChunk += CHUNK_HEADER_SIZE + size;
+        return !chunk.isEmpty();
+    }
+};
+
+DemoReader::DemoReader(NativePath const &path) : d(new Instance(path))
+{}
+
+bool DemoReader::recognize(NativePath const &path)
+{
+    QFile file(path.toString());
+    if(!file.open(QFile::ReadOnly)) return false;
+    return Instance::hasHeader(file);
+}
+
+int DemoReader::length() const
+{
+    return int(d->length);
+}
+
+int DemoReader::keyframeCount() const
+{
+    return d->index.size();
+}
+
+int DemoReader::keyframeTic(int index) const
+{
+    return int(d->index.at(index).tic);
+}
+
+void DemoReader::seekToKeyframe(int index)
+{
+    d->nextChunk = d->index.at(index).offset;
+    d->chunk.clear();
+    d->pos = 0;
+}
+
+int DemoReader::nextTic()
+{
+    // Records are never split between chunks, so a record fits if its
+    // header does.
+    while(d->pos + 9 > dsize(d->chunk.size()))
+    {
+        if(!d->loadChunk()) return -1;
+    }
+    duint32 tic;
+    Reader(d->chunk, littleEndianByteOrder, d->pos) >> tic;
+    return int(tic);
+}
+
+void DemoReader::readPacket(dbyte &type, Block &data)
+{
+    duint32 tic, length;
+    Reader reader(d->chunk, littleEndianByteOrder, d->pos);
+    reader >> tic >> length >> type;
+    if(length > reader.remainingSize())
+    {
+        throw FormatError("DemoReader::readPacket",
+                          QString("Packet at tic %1 is %2 bytes but only %3 remain in the chunk")
+                          .arg(tic).arg(length).arg(reader.remainingSize()));
+    }
+    data = Block(d->chunk, reader.offset(), length);
+    d->pos = reader.offset() + length;
+}
@@ -51,6 +51,26 @@ static size_t numOutBytes;
 // Number of bytes sent over the network (compressed).
 static size_t numSentBytes;
 
+#ifdef __SERVER__
+// Sent messages are recorded here if the -netcapture option is given.
+static FILE *captureFile;
+
+/**
+ * Appends the message in the netbuffer to the capture file. Each message is
+ * written as the number of recipients (1 byte), the size of the message
+ * (4 bytes, little-endian), and the message itself.
+ */
+static void N_CaptureMessage(int recipients)
+{
+    if(!captureFile) return;
+
+    uint const size = netBuffer.headerLength + netBuffer.length;
+    byte header[5] = { byte(recipients), byte(size), byte(size >> 8), byte(size >> 16), byte(size >> 24) };
+    fwrite(header, sizeof(header), 1, captureFile);
+    fwrite(&netBuffer.msg, size, 1, captureFile);
+}
+#endif
+
 Reader* Reader_NewWithNetworkBuffer(void)
 {
     return Reader_NewWithBuffer((const byte*) netBuffer.msg.data, netBuffer.length);
@@ -67,6 +87,13 @@ void N_Init(void)
 
     allowSending = false;
 
+#ifdef __SERVER__
+    if(CommandLine_CheckWith("-netcapture", 1))
+    {
+        captureFile = fopen(CommandLine_Next(), "wb");
+    }
+#endif
+
     //N_SockInit();
     N_MasterInit();
 }
@@ -84,6 +111,14 @@ void N_Shutdown(void)
 
     allowSending = false;
 
+#ifdef __SERVER__
+    if(captureFile)
+    {
+        fclose(captureFile);
+        captureFile = 0;
+    }
+#endif
+
     // Close the handle of the message queue mutex.
     Sys_DestroyMutex(msgMutex);
     msgMutex = 0;
@@ -232,15 +267,14 @@ void N_ClearMessages(void)
  * Send the data in the netbuffer. The message is sent using an
  * unreliable, nonsequential (i.e. fast) method.
  *
- * Handles broadcasts using recursion.
+ * Broadcasts are encoded once for all recipients.
  * Clients can only send stuff to the server.
  */
 void N_SendPacket(int flags)
 {
+    DENG2_UNUSED(flags);
 #ifdef __SERVER__
     uint dest = 0;
-#else
-    DENG2_UNUSED(flags);
 #endif
 
     // Is the network available?
@@ -260,18 +294,42 @@ void N_SendPacket(int flags)
             }
 
             dest = clients[netBuffer.player].nodeID;
+            N_CaptureMessage(1);
         }
         else
         {
-            // Broadcast to all non-local players, using recursive calls.
+            int recipients = 0;
             for(int i = 0; i < DDMAXPLAYERS; ++i)
             {
-                netBuffer.player = i;
-                N_SendPacket(flags);
+                if(clients[i].connected) recipients++;
             }
+            if(!recipients) return;
+
+            N_CaptureMessage(recipients);
+
+            numOutBytes += recipients * (netBuffer.headerLength + netBuffer.length);
+
+            // Broadcast to all connected players. The message is compressed
+            // only once and the same bytes are sent to everyone.
+            de::Socket::EncodedMessage const encoded(
+                    de::ByteRefArray(&netBuffer.msg, netBuffer.headerLength + netBuffer.length));
 
-            // Reset back to -1 to notify of the broadcast.
-            netBuffer.player = NSP_BROADCAST;
+            for(int i = 0; i < DDMAXPLAYERS; ++i)
+            {
+                if(!clients[i].connected) continue;
+
+                // A failure to reach one player must not keep the message
+                // from the others.
+                try
+                {
+                    App_ServerSystem().user(clients[i].nodeID).send(encoded);
+                }
+                catch(de::Error const &er)
+                {
+                    LOGDEV_NET_WARNING("N_SendPacket failed for player %i: %s")
+                            << i << er.asText();
+                }
+            }
             return;
         }
     }
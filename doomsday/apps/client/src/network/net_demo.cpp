@@ -20,6 +20,13 @@
 /**
  * Handling of demo recording and playback.
  * Opening of, writing to, reading from and closing of demo files.
+ *
+ * Demos are recorded in the seekable format of DemoWriter. While recording,
+ * the client periodically asks the server for a keyframe handshake; the
+ * server's reply (followed by the complete world state) is a keyframe where
+ * playback can be started. During normal playback the keyframes just refresh
+ * the world; the map is only reloaded after seeking. Old-style LZSS demos can
+ * still be played back, but not seeked.
  */
 
 // HEADER FILES ------------------------------------------------------------
@@ -31,6 +38,8 @@
 #include "de_network.h"
 #include "de_misc.h"
 
+#include "network/demofile.h"
+#include "network/timedemo.h"
 #include "render/viewports.h"
 #include "render/rend_main.h"
 #include "world/p_players.h"
@@ -59,6 +68,7 @@ typedef struct {
     int             cameratimer;
     int             pausetime;
     float           fov;
+    int             keyframetimer;
 } demotimer_t;
 
 // EXTERNAL FUNCTION PROTOTYPES --------------------------------------------
@@ -69,7 +79,9 @@ D_CMD(DemoLump);
 D_CMD(PauseDemo);
 D_CMD(PlayDemo);
 D_CMD(RecordDemo);
+D_CMD(SeekDemo);
 D_CMD(StopDemo);
+D_CMD(TimeDemo);
 
 void Demo_WriteLocalCamera(int plnum);
 
@@ -83,7 +95,10 @@ extern float netConnectTime;
 
 filename_t demoPath = "demo/";
 
-LZFILE* playdemo = 0;
+/// Seconds between keyframes in recorded demos (zero for none).
+int demoKeyframeInterval = 30;
+
+LZFILE* playdemo = 0; // Old-style demo being played.
 int playback = false;
 int viewangleDelta = 0;
 float lookdirDelta = 0;
@@ -95,6 +110,8 @@ dd_bool demoOnGround;
 
 static demotimer_t writeInfo[DDMAXPLAYERS];
 static demotimer_t readInfo;
+static DemoWriter *demoWriters[DDMAXPLAYERS];
+static DemoReader *demoReader; // Demo being played, if not old-style.
 static float startFOV;
 static int demoStartTic;
 
@@ -106,7 +123,11 @@ void Demo_Register(void)
     C_CMD_FLAGS("pausedemo", NULL, PauseDemo, CMDF_NO_NULLGAME);
     C_CMD_FLAGS("playdemo", "s", PlayDemo, CMDF_NO_NULLGAME);
     C_CMD_FLAGS("recorddemo", NULL, RecordDemo, CMDF_NO_NULLGAME);
+    C_CMD_FLAGS("seekdemo", "s", SeekDemo, CMDF_NO_NULLGAME);
     C_CMD_FLAGS("stopdemo", NULL, StopDemo, CMDF_NO_NULLGAME);
+    C_CMD_FLAGS("timedemo", NULL, TimeDemo, CMDF_NO_NULLGAME);
+
+    C_VAR_INT("demo-keyframe-interval", &demoKeyframeInterval, CVF_NO_MAX, 0, 0);
 }
 
 void Demo_Init(void)
@@ -121,17 +142,14 @@ void Demo_Init(void)
  */
 dd_bool Demo_BeginRecording(const char* fileName, int plrNum)
 {
-    DENG_UNUSED(fileName);
-    DENG_UNUSED(plrNum);
-    return false;
-
-#if 0
     client_t* cl = &clients[plrNum];
     player_t* plr = &ddPlayers[plrNum];
     ddstring_t buf;
 
-    // Is a demo already being recorded for this client?
-    if(cl->recording || playback || (isDedicated && !plrNum) || !plr->shared.inGame)
+    // Is a demo already being recorded for this client? Only the console
+    // player of a client can be recorded.
+    if(cl->recording || playback || !isClient || plrNum != consolePlayer ||
+       !plr->shared.inGame)
         return false;
 
     // Compose the real file name.
@@ -141,42 +159,32 @@ dd_bool Demo_BeginRecording(const char* fileName, int plrNum)
     F_ToNativeSlashes(&buf, &buf);
 
     // Open the demo file.
-    cl->demo = lzOpen(Str_Text(&buf), "wp");
-    Str_Free(&buf);
-    if(!cl->demo)
+    try
     {
+        demoWriters[plrNum] = new DemoWriter(de::NativePath(Str_Text(&buf)));
+    }
+    catch(de::Error const &er)
+    {
+        LOG_NET_ERROR("Cannot record demo: %s") << er.asText();
+        Str_Free(&buf);
         return false; // Couldn't open it!
     }
+    Str_Free(&buf);
 
     cl->recording = true;
     cl->recordPaused = false;
     writeInfo[plrNum].first = true;
     writeInfo[plrNum].canwrite = false;
     writeInfo[plrNum].cameratimer = 0;
+    writeInfo[plrNum].keyframetimer = 0;
     writeInfo[plrNum].fov = -1; // Must be written in the first packet.
 
-    if(isServer)
-    {
-        // Playing demos alters gametic. This'll make sure we're going to
-        // get updates.
-        clients[0].lastTransmit = -1;
-        // Servers need to send a handshake packet.
-        // It only needs to recorded in the demo file, though.
-        allowSending = false;
-        Sv_Handshake(plrNum, false);
-        // Enable sending to network.
-        allowSending = true;
-    }
-    else
-    {
-        // Clients need a Handshake packet.
-        // Request a new one from the server.
-        Cl_SendHello();
-    }
+    // Clients need a Handshake packet.
+    // Request a new one from the server.
+    Cl_SendHello();
 
     // The operation is a success.
     return true;
-#endif
 }
 
 void Demo_PauseRecording(int playerNum)
@@ -220,18 +228,16 @@ void Demo_StopRecording(int playerNum)
     if(!cl->recording)
         return;
 
-    // Close demo file.
-    lzClose(cl->demo);
-    cl->demo = 0;
+    // Close demo file. The index is written at this point.
+    delete demoWriters[playerNum];
+    demoWriters[playerNum] = 0;
     cl->recording = false;
 }
 
 void Demo_WritePacket(int playerNum)
 {
-    LZFILE         *file;
-    demopacket_header_t hdr;
     demotimer_t    *inf = writeInfo + playerNum;
-    byte            ptime;
+    int             tic;
 
     if(playerNum < 0)
     {
@@ -262,40 +268,29 @@ void Demo_WritePacket(int playerNum)
     // This counts as an update. (We know the client is alive.)
     //clients[playerNum].updateCount = UPDATECOUNT;
 
-    file = clients[playerNum].demo;
-
-#if _DEBUG
-    if(!file)
-        App_Error("Demo_WritePacket: No demo file!\n");
-#endif
+    DENG_ASSERT(demoWriters[playerNum] != 0);
 
     if(!inf->first)
     {
-        ptime =
-            (clients[playerNum].recordPaused ? inf->pausetime : DEMOTIC) -
-            inf->begintime;
+        tic = (clients[playerNum].recordPaused ? inf->pausetime : DEMOTIC) -
+              inf->begintime;
     }
     else
     {
-        ptime = 0;
+        tic = 0;
         inf->first = false;
         inf->begintime = DEMOTIC;
     }
-    lzWrite(&ptime, 1, file);
-
-    // The header.
-
-#if _DEBUG
-    if(netBuffer.length >= sizeof(hdr.length))
-        App_Error("Demo_WritePacket: Write buffer too large!\n");
-#endif
 
-    hdr.length = (ushort) 1 + netBuffer.length;
-    lzWrite(&hdr, sizeof(hdr), file);
+    if(netBuffer.msg.type == PSV_HANDSHAKE)
+    {
+        // The server follows the handshake with the complete state of the
+        // world, so playback can begin here.
+        demoWriters[playerNum]->beginKeyframe(tic);
+    }
 
-    // Write the packet itself.
-    lzPutC(netBuffer.msg.type, file);
-    lzWrite(netBuffer.msg.data, (long) netBuffer.length, file);
+    demoWriters[playerNum]->writePacket(tic, netBuffer.msg.type, netBuffer.msg.data,
+                                        netBuffer.length);
 }
 
 void Demo_BroadcastPacket(void)
@@ -335,9 +330,26 @@ dd_bool Demo_BeginPlayback(const char* fileName)
     F_ToNativeSlashes(&buf, &buf);
 
     // Open the demo file.
-    playdemo = lzOpen(Str_Text(&buf), "rp");
+    if(DemoReader::recognize(de::NativePath(Str_Text(&buf))))
+    {
+        try
+        {
+            demoReader = new DemoReader(de::NativePath(Str_Text(&buf)));
+        }
+        catch(de::Error const &er)
+        {
+            LOG_NET_ERROR("Cannot play demo: %s") << er.asText();
+            Str_Free(&buf);
+            return false;
+        }
+    }
+    else
+    {
+        // An old-style demo.
+        playdemo = lzOpen(Str_Text(&buf), "rp");
+    }
     Str_Free(&buf);
-    if(!playdemo)
+    if(!playdemo && !demoReader)
         return false;
 
     // OK, let's begin the demo.
@@ -352,19 +364,12 @@ dd_bool Demo_BeginPlayback(const char* fileName)
     startFOV = 95; //Rend_FieldOfView();
     demoStartTic = DEMOTIC;
     memset(posDelta, 0, sizeof(posDelta));
-    // Start counting frames from here.
-    /*
-    if(ArgCheck("-timedemo"))
-        r_framecounter = 0;
-        */
 
     return true;
 }
 
 void Demo_StopPlayback(void)
 {
-    //float           diff;
-
     if(!playback)
         return;
 
@@ -373,29 +378,76 @@ void Demo_StopPlayback(void)
             << (DEMOTIC - demoStartTic);
 
     playback = false;
-    lzClose(playdemo);
-    playdemo = 0;
+    if(playdemo)
+    {
+        lzClose(playdemo);
+        playdemo = 0;
+    }
+    delete demoReader;
+    demoReader = 0;
     //fieldOfView = startFOV;
     Net_StopGame();
 
-    /*
-    if(ArgCheck("-timedemo"))
-    {
-        diff = Sys_GetSeconds() - netConnectTime;
-        if(!diff)
-            diff = 1;
-        // Print summary and exit.
-        LOG_MSG("Timedemo results: %i game tics in %.1f seconds", r_framecounter, diff);
-        LOG_MSG("%f FPS", r_framecounter / diff);
-        Sys_Quit();
-    }
-    */
+    // Print the results and write the summary.
+    TimeDemo_End();
 
     // "Play demo once" mode?
-    if(CommandLine_Check("-playdemo"))
+    if(CommandLine_Check("-playdemo") || CommandLine_Check("-timedemo"))
         Sys_Quit();
 }
 
+static void endOfDemo()
+{
+    Demo_StopPlayback();
+    // Any interested parties?
+    DD_CallHooks(HOOK_DEMO_STOP, false, 0);
+}
+
+static dd_bool readDemoPacket(int nowtime)
+{
+    if(readInfo.first)
+    {
+        readInfo.first = false;
+        readInfo.begintime = nowtime;
+    }
+
+    int const tic = demoReader->nextTic();
+    if(tic < 0)
+    {
+        endOfDemo();
+        return false;
+    }
+
+    // Check if the packet can be read.
+    if(nowtime - readInfo.begintime < tic)
+        return false; // Can't read yet.
+
+    byte type;
+    de::Block data;
+    try
+    {
+        demoReader->readPacket(type, data);
+    }
+    catch(de::Error const &er)
+    {
+        LOG_NET_ERROR("Demo is corrupt: %s") << er.asText();
+        endOfDemo();
+        return false;
+    }
+    if(data.size() > NETBUFFER_MAXSIZE)
+    {
+        LOG_NET_ERROR("Demo packet is too large (%i bytes); demo is corrupt") << data.size();
+        endOfDemo();
+        return false;
+    }
+
+    netBuffer.length = data.size();
+    netBuffer.player = 0; // From the server.
+    netBuffer.msg.type = type;
+    memcpy(netBuffer.msg.data, data.constData(), data.size());
+    return true;
+}
+
 dd_bool Demo_ReadPacket(void)
 {
     static byte     ptime;
@@ -405,11 +457,12 @@ dd_bool Demo_ReadPacket(void)
     if(!playback)
         return false;
 
+    if(demoReader)
+        return readDemoPacket(nowtime);
+
     if(lzEOF(playdemo))
     {
-        Demo_StopPlayback();
-        // Any interested parties?
-        DD_CallHooks(HOOK_DEMO_STOP, false, 0);
+        endOfDemo();
         return false;
     }
 
@@ -440,6 +493,54 @@ dd_bool Demo_ReadPacket(void)
     return true;
 }
 
+int Demo_PlaybackTic(void)
+{
+    if(!playback || readInfo.first)
+        return 0;
+    return DEMOTIC - readInfo.begintime;
+}
+
+dd_bool Demo_Seek(int tic)
+{
+    if(!playback || !demoReader || !demoReader->keyframeCount())
+        return false; // Old-style demos have no keyframes.
+
+    int const current = Demo_PlaybackTic();
+    int const count = demoReader->keyframeCount();
+
+    // Find the keyframe nearest to the target.
+    int nearest = 0;
+    for(int i = 1; i < count; ++i)
+    {
+        if(abs(demoReader->keyframeTic(i) - tic) < abs(demoReader->keyframeTic(nearest) - tic))
+            nearest = i;
+    }
+    if(tic > current)
+    {
+        // Fast-forwarding never goes back in time.
+        while(nearest < count - 1 && demoReader->keyframeTic(nearest) <= current)
+            nearest++;
+        if(demoReader->keyframeTic(nearest) <= current)
+            return false;
+    }
+
+    // The keyframe begins with a handshake, after which the world is rebuilt
+    // from scratch.
+    Cl_CleanUp();
+    demoReader->seekToKeyframe(nearest);
+
+    readInfo.first = false;
+    readInfo.begintime = DEMOTIC - demoReader->keyframeTic(nearest);
+
+    // The camera will be reset by the keyframe's first camera packet.
+    viewangleDelta = 0;
+    lookdirDelta = 0;
+    demoFrameZ = 1;
+    demoZ = 0;
+    memset(posDelta, 0, sizeof(posDelta));
+    return true;
+}
+
 /**
  * Writes a view angle and coords packet. Doesn't send the packet outside.
  */
@@ -616,13 +717,24 @@ void Demo_Ticker(timespan_t /*time*/)
             ddplayer_t             *ddpl = &plr->shared;
             client_t               *cl = &clients[i];
 
-            if(ddpl->inGame && cl->recording && !cl->recordPaused &&
-               ++writeInfo[i].cameratimer >= LOCALCAM_WRITE_TICS)
+            if(!ddpl->inGame || !cl->recording || cl->recordPaused)
+                continue;
+
+            if(++writeInfo[i].cameratimer >= LOCALCAM_WRITE_TICS)
             {
                 // It's time to write local view angles and coords.
                 writeInfo[i].cameratimer = 0;
                 Demo_WriteLocalCamera(i);
             }
+
+            if(demoKeyframeInterval > 0 && writeInfo[i].canwrite &&
+               ++writeInfo[i].keyframetimer >= SECONDS_TO_TICKS(demoKeyframeInterval))
+            {
+                // Request a new handshake; the server's reply is recorded
+                // as a keyframe. The game goes on uninterrupted.
+                writeInfo[i].keyframetimer = 0;
+                Cl_SendHello(HELLOF_KEYFRAME);
+            }
         }
     }
 }
@@ -667,6 +779,32 @@ D_CMD(RecordDemo)
     return Demo_BeginRecording(argv[1], plnum);
 }
 
+D_CMD(SeekDemo)
+{
+    DENG2_UNUSED2(src, argc);
+
+    if(!playback)
+    {
+        LOG_SCR_ERROR("No demo is being played");
+        return false;
+    }
+
+    // A signed value is relative to the current position.
+    int tic = SECONDS_TO_TICKS(strtod(argv[1], 0));
+    if(argv[1][0] == '+' || argv[1][0] == '-')
+        tic += Demo_PlaybackTic();
+
+    if(!Demo_Seek(tic))
+    {
+        LOG_SCR_ERROR("No keyframe to seek to");
+        return false;
+    }
+
+    LOG_MSG("Demo position is now %.1f seconds")
+            << Demo_PlaybackTic() / float(TICSPERSEC);
+    return true;
+}
+
 D_CMD(PauseDemo)
 {
     DENG2_UNUSED(src);
@@ -725,6 +863,36 @@ D_CMD(StopDemo)
     return true;
 }
 
+D_CMD(TimeDemo)
+{
+    DENG2_UNUSED(src);
+
+    ddstring_t buf;
+
+    if(argc < 2 || argc > 3)
+    {
+        LOG_SCR_NOTE("Usage: %s (fileName) (summaryFile)") << argv[0];
+        LOG_SCR_MSG("The summary is written to \"%stimedemo.json\" by default.") << demoPath;
+        return true;
+    }
+
+    if(!Demo_BeginPlayback(argv[1]))
+        return false;
+
+    // Compose the file name of the summary.
+    Str_InitStd(&buf);
+    if(argc == 3)
+        Str_Set(&buf, argv[2]);
+    else
+        Str_Appendf(&buf, "%stimedemo.json", demoPath);
+    F_ExpandBasePath(&buf, &buf);
+    F_ToNativeSlashes(&buf, &buf);
+
+    TimeDemo_Begin(argv[1], de::NativePath(Str_Text(&buf)), TimeDemo_HeadlessRequested());
+    Str_Free(&buf);
+    return true;
+}
+
 /**
  * Make a demo lump.
  */
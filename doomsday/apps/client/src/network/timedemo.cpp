@@ -0,0 +1,215 @@
+/**
+ * @file timedemo.cpp
+ * Timedemo benchmarking. @ingroup network
+ *
+ * @authors Copyright © 2015 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#include "de_base.h"
+#include "network/timedemo.h"
+
+#include <de/Log>
+#include <de/Time>
+#include <de/math.h>
+#include <QFile>
+#include <QVector>
+#include <algorithm>
+
+#ifdef UNIX
+#  include <sys/resource.h>
+#endif
+
+using namespace de;
+
+static char const *statNames[NUM_TIMEDEMO_STATS] = {
+    /* TDS_WORLD_TIC */     "worldTic",
+    /* TDS_RENDER_PREP */   "renderPrep",
+    /* TDS_DELTA_DECODE */  "deltaDecode"
+};
+
+static bool running;
+static bool headless;
+static String demoName;
+static NativePath summaryPath;
+static double startedAt;
+static int frameCount;
+static QVector<float> samples[NUM_TIMEDEMO_STATS]; ///< Durations in seconds.
+
+static inline double now()
+{
+    return Time::Delta::sinceStartOfProcess();
+}
+
+/**
+ * Returns the peak resident set size of the process in bytes, or zero if it
+ * is not known.
+ */
+static duint64 peakResidentBytes()
+{
+#ifdef UNIX
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage)) return 0;
+#  ifdef MACOSX
+    return duint64(usage.ru_maxrss); // Bytes.
+#  else
+    return duint64(usage.ru_maxrss) * 1024; // Kilobytes.
+#  endif
+#else
+    return 0;
+#endif
+}
+
+static String jsonNumber(double value)
+{
+    return String::number(value, 'f', 4);
+}
+
+static String jsonString(String const &text)
+{
+    String escaped = text;
+    escaped.replace("\\", "\\\\").replace("\"", "\\\"");
+    return "\"" + escaped + "\"";
+}
+
+/// Composes a JSON object of the distribution of sampled durations (in ms).
+static String statSummary(QVector<float> values)
+{
+    if(values.isEmpty())
+    {
+        return "{ \"count\": 0 }";
+    }
+
+    std::sort(values.begin(), values.end());
+    double total = 0;
+    foreach(float v, values) total += v;
+
+    auto percentile = [&values] (int pct) {
+        return values.at(qMin(values.size() - 1, values.size() * pct / 100)) * 1000.0;
+    };
+
+    return String("{ \"count\": %1, \"totalMs\": %2, \"meanMs\": %3, "
+                  "\"p50Ms\": %4, \"p95Ms\": %5, \"p99Ms\": %6, \"maxMs\": %7 }")
+            .arg(values.size())
+            .arg(jsonNumber(total * 1000))
+            .arg(jsonNumber(total * 1000 / values.size()))
+            .arg(jsonNumber(percentile(50)))
+            .arg(jsonNumber(percentile(95)))
+            .arg(jsonNumber(percentile(99)))
+            .arg(jsonNumber(values.last() * 1000.0));
+}
+
+void TimeDemo_Begin(char const *name, NativePath const &path, bool isHeadless)
+{
+    running     = true;
+    headless    = isHeadless;
+    demoName    = name;
+    summaryPath = path;
+    startedAt   = now();
+    frameCount  = 0;
+    for(int i = 0; i < NUM_TIMEDEMO_STATS; ++i)
+    {
+        samples[i].clear();
+    }
+
+    LOG_MSG("Timedemo of \"%s\" started%s") << name << (headless? " (headless)" : "");
+}
+
+void TimeDemo_End()
+{
+    if(!running) return;
+
+    running = false;
+
+    double const elapsed = de::max(now() - startedAt, .001);
+    int const tics = samples[TDS_WORLD_TIC].size();
+    duint64 const peakBytes = peakResidentBytes();
+
+    String summary = "{\n";
+    summary += "  \"demo\": " + jsonString(demoName) + ",\n";
+    summary += String("  \"headless\": %1,\n").arg(headless? "true" : "false");
+    summary += "  \"seconds\": " + jsonNumber(elapsed) + ",\n";
+    summary += String("  \"tics\": %1,\n").arg(tics);
+    summary += String("  \"frames\": %1,\n").arg(frameCount);
+    summary += "  \"ticsPerSecond\": " + jsonNumber(tics / elapsed) + ",\n";
+    summary += "  \"framesPerSecond\": " + jsonNumber(frameCount / elapsed) + ",\n";
+    for(int i = 0; i < NUM_TIMEDEMO_STATS; ++i)
+    {
+        summary += String("  \"%1\": %2,\n").arg(statNames[i]).arg(statSummary(samples[i]));
+    }
+    summary += "  \"memory\": { \"peakResidentBytes\": " +
+            (peakBytes? String::number(peakBytes) : String("null")) + " }\n";
+    summary += "}\n";
+
+    LOG_MSG("Timedemo results: %i tics and %i frames in %.2f seconds (%.1f FPS)")
+            << tics << frameCount << elapsed << frameCount / elapsed;
+
+    QFile file(summaryPath.toString());
+    if(file.open(QFile::WriteOnly | QFile::Truncate | QFile::Text))
+    {
+        file.write(summary.toUtf8());
+        LOG_MSG("Timedemo summary written to \"%s\"") << summaryPath.pretty();
+    }
+    else
+    {
+        LOG_WARNING("Failed to write the timedemo summary to \"%s\"") << summaryPath.pretty();
+    }
+
+    for(int i = 0; i < NUM_TIMEDEMO_STATS; ++i)
+    {
+        samples[i].clear();
+    }
+}
+
+bool TimeDemo_IsRunning()
+{
+    return running;
+}
+
+bool TimeDemo_IsHeadless()
+{
+    return running && headless;
+}
+
+bool TimeDemo_HeadlessRequested()
+{
+    return CommandLine_Exists("-timedemo") && CommandLine_Exists("-headless");
+}
+
+void TimeDemo_NewFrame()
+{
+    if(running) frameCount++;
+}
+
+void TimeDemo_AddSample(timedemostat_t stat, double seconds)
+{
+    if(!running) return;
+
+    DENG2_ASSERT(stat >= 0 && stat < NUM_TIMEDEMO_STATS);
+    samples[stat].append(float(seconds));
+}
+
+TimeDemoSample::TimeDemoSample(timedemostat_t stat)
+    : _stat(stat), _startedAt(running? now() : -1)
+{}
+
+TimeDemoSample::~TimeDemoSample()
+{
+    if(_startedAt >= 0)
+    {
+        TimeDemo_AddSample(_stat, now() - _startedAt);
+    }
+}
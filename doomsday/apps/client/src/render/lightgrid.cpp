@@ -25,6 +25,7 @@
 #include <QSet>
 #include <QVector>
 #include <de/math.h>
+#include <de/FlatHashMap>
 #include <de/Log>
 #include <doomsday/console/var.h>
 
@@ -92,7 +93,7 @@ DENG2_PIMPL(LightGrid)
         QVector<Index> blocks;
         LightCoverage() : primaryBlockCount(0) {}
     };
-    typedef QMap<IBlockLightSource *, LightCoverage> Coverages;
+    typedef FlatHashMap<IBlockLightSource *, LightCoverage> Coverages;
     Coverages coverage;
     bool needUpdateCoverage;
 
@@ -4013,6 +4013,9 @@ static void drawMasked()
     {
         bool primaryHaloDrawn = false;
 
+        // Interpolate and light the models in the background while drawing.
+        Rend_PrepareModels(visSprSortedHead);
+
         // Draw all vissprites back to front.
         // Sprites look better with Z buffer writes turned off.
         for(vissprite_t *spr = visSprSortedHead.next; spr != &visSprSortedHead; spr = spr->next)
@@ -4065,6 +4068,8 @@ static void drawMasked()
             // And we're done...
             H_SetupState(false);
         }
+
+        Rend_ReleasePreparedModels();
     }
 }
 
@@ -45,10 +45,20 @@
 #include <de/binangle.h>
 #include <de/memory.h>
 #include <de/concurrency.h>
+#include <de/Task>
+#include <de/TaskPool>
+#include <QHash>
+#include <QThread>
+#include <QVector>
 #include <cstdlib>
 #include <cmath>
 #include <cstring>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define DENG_MODEL_SSE2
+#  include <emmintrin.h>
+#endif
+
 using namespace de;
 
 #define QATAN2(y,x)         qatan2(y,x)
@@ -79,6 +89,7 @@ float modelSpinSpeed   = 1;
 int maxModelDistance   = 1500;
 float rend_model_lod   = 256;
 byte precacheSkins     = true;
+byte compactModels     = true;
 
 static bool inited;
 
@@ -90,18 +101,77 @@ struct array_t
 #define MAX_ARRAYS (2 + MAX_TEX_UNITS)
 static array_t arrays[MAX_ARRAYS];
 
-// The global vertex render buffer.
-static Vector3f *modelPosCoords;
-static Vector3f *modelNormCoords;
-static Vector4ub *modelColorCoords;
-static Vector2f *modelTexCoords;
+/// Maximum number of vector lights affecting a model (see "rend-model-lights").
+static dint const MAX_MODEL_LIGHTS = 11;
 
-// Global variables for ease of use. (Egads!)
-static Vector3f modelCenter;
-static ModelDetailLevel *activeLod;
+/// Below this many vertices in total, the models of a frame are prepared in the
+/// main thread; the fork/join would cost more.
+static dint const SERIAL_PREPARE_LIMIT = 4096;
+
+/**
+ * Vector light affecting a model, with its direction rotated to model space.
+ */
+struct ModelLight
+{
+    Vector3f direction;
+    dfloat offset;
+    dfloat lightSide;
+    dfloat darkSide;
+    Vector3f color;
+    bool affectedByAmbient;
+};
+
+/**
+ * Preparation of a submodel for drawing: the vertices are interpolated and lit
+ * and the shiny texture coordinates are generated. The parameters are chosen in
+ * the main thread, but the vertex work itself only reads the model resource and
+ * writes to the job's own buffers, so it can be done in a worker thread.
+ */
+struct SubmodelJob
+{
+    enum Lighting { FullBright, Uniform, VectorLights };
+
+    bool visible = false;
+    Model *model = nullptr;
+    ModelFrame const *frame = nullptr;
+    ModelFrame const *nextFrame = nullptr;
+    ModelDef *mfNext = nullptr;
+    ModelDetailLevel const *lod = nullptr;
+    dint numVerts = 0;
+    dfloat inter = 0;
+    dfloat alpha = 0;
+    blendmode_t blending = BM_NORMAL;
+    dint skin = 0;
+    bool mirrored = false;
+
+    Lighting lighting = Uniform;
+    Vector4f ambient;
+    ModelLight lights[MAX_MODEL_LIGHTS];
+    dint lightCount = 0;
+
+    dfloat shininess = 0;
+    Vector4f shinyColor;
+    dfloat shinyYaw = 0;    ///< Rotation of the normals for shiny coords (degrees).
+    dfloat shinyPitch = 0;
+
+    // Output buffers (only ever enlarged).
+    QVector<ModelFrame::Vertex> vertices;
+    QVector<Vector4ub> colors;
+    QVector<Vector2f> texCoords;
+
+    void run();
+};
+
+/// Jobs are reused so that their buffers don't need to be reallocated.
+static QVector<SubmodelJob *> jobs;
+static dint jobsInUse;
+static SubmodelJob *immediateJob; ///< For models drawn without preparation.
+
+/// First job of each prepared vissprite.
+static QHash<vissprite_t const *, dint> preparedModels;
+static bool preparing; ///< Prepare tasks may still be running.
 
 static uint vertexBufferMax; ///< Maximum number of vertices we'll be required to render per submodel.
-static uint vertexBufferSize; ///< Current number of vertices supported by the render buffer.
 #ifdef DENG_DEBUG
 static bool announcedVertexBufferMaxBreach; ///< @c true if an attempt has been made to expand beyond our capability.
 #endif
@@ -129,6 +199,7 @@ void Rend_ModelRegister()
     C_VAR_FLOAT("rend-model-aspect",         &modelAspectMod,       CVF_NO_MAX | CVF_NO_MIN, 0, 0);
     C_VAR_INT  ("rend-model-distance",       &maxModelDistance,     CVF_NO_MAX, 0, 0);
     C_VAR_BYTE ("rend-model-precache",       &precacheSkins,        0, 0, 1);
+    C_VAR_BYTE ("rend-model-compact",        &compactModels,        0, 0, 1);
     C_VAR_FLOAT("rend-model-lod",            &rend_model_lod,       CVF_NO_MAX, 0, 0);
     C_VAR_INT  ("rend-model-mirror-hud",     &mirrorHudModels,      0, 0, 1);
     C_VAR_FLOAT("rend-model-spin-speed",     &modelSpinSpeed,       CVF_NO_MAX | CVF_NO_MIN, 0, 0);
@@ -140,12 +211,9 @@ void Rend_ModelInit()
 {
     if(inited) return; // Already been here.
 
-    modelPosCoords   = 0;
-    modelNormCoords  = 0;
-    modelColorCoords = 0;
-    modelTexCoords   = 0;
+    immediateJob = new SubmodelJob;
 
-    vertexBufferMax = vertexBufferSize = 0;
+    vertexBufferMax = 0;
 #ifdef DENG_DEBUG
     announcedVertexBufferMaxBreach = false;
 #endif
@@ -157,12 +225,11 @@ void Rend_ModelShutdown()
 {
     if(!inited) return;
 
-    M_Free(modelPosCoords); modelPosCoords = 0;
-    M_Free(modelNormCoords); modelNormCoords = 0;
-    M_Free(modelColorCoords); modelColorCoords = 0;
-    M_Free(modelTexCoords); modelTexCoords = 0;
+    Rend_ReleasePreparedModels();
+    qDeleteAll(jobs); jobs.clear();
+    delete immediateJob; immediateJob = 0;
 
-    vertexBufferMax = vertexBufferSize = 0;
+    vertexBufferMax = 0;
 #ifdef DENG_DEBUG
     announcedVertexBufferMaxBreach = false;
 #endif
@@ -197,28 +264,6 @@ bool Rend_ModelExpandVertexBuffers(uint numVertices)
     return true;
 }
 
-/// @return  @c true= Vertex buffer is large enough to handle @a numVertices.
-static bool resizeVertexBuffer(uint numVertices)
-{
-    // Mark the vertex buffer if a resize is necessary.
-    Rend_ModelExpandVertexBuffers(numVertices);
-
-    // Do we need to resize the buffers?
-    if(vertexBufferMax != vertexBufferSize)
-    {
-        /// @todo Align access to this memory along a 4-byte boundary?
-        modelPosCoords   =  (Vector3f *) M_Realloc(modelPosCoords,   sizeof(*modelPosCoords)   * vertexBufferMax);
-        modelNormCoords  =  (Vector3f *) M_Realloc(modelNormCoords,  sizeof(*modelNormCoords)  * vertexBufferMax);
-        modelColorCoords = (Vector4ub *) M_Realloc(modelColorCoords, sizeof(*modelColorCoords) * vertexBufferMax);
-        modelTexCoords   =  (Vector2f *) M_Realloc(modelTexCoords,   sizeof(*modelTexCoords)   * vertexBufferMax);
-
-        vertexBufferSize = vertexBufferMax;
-    }
-
-    // Is the buffer large enough?
-    return vertexBufferSize >= numVertices;
-}
-
 static void disableArrays(int vertices, int colors, int coords)
 {
     DENG_ASSERT_IN_MAIN_THREAD();
@@ -338,15 +383,18 @@ static void drawArrayElement(int index)
 
     if(arrays[AR_VERTEX].enabled)
     {
-        Vector3f const &posCoord = ((Vector3f const *) arrays[AR_VERTEX].data)[index];
+        Vector3f const &posCoord = ((ModelFrame::Vertex const *) arrays[AR_VERTEX].data)[index].pos;
         glVertex3f(posCoord.x, posCoord.y, posCoord.z);
     }
 }
 
 /**
  * Return a pointer to the visible model frame.
+ *
+ * @param mdl  Model of the submodel. The caller has already looked it up from
+ *             the resource system, so the lookup isn't repeated here.
  */
-static ModelFrame &visibleModelFrame(ModelDef &modef, int subnumber, int mobjId)
+static ModelFrame &visibleModelFrame(Model &mdl, ModelDef &modef, int subnumber, int mobjId)
 {
     if(subnumber >= int(modef.subCount()))
     {
@@ -355,6 +403,7 @@ static ModelFrame &visibleModelFrame(ModelDef &modef, int subnumber, int mobjId)
                         .arg(modef.subCount()).arg(subnumber));
     }
     SubmodelDef const &sub = modef.subModelDef(subnumber);
+    DENG2_ASSERT(sub.modelId == mdl.modelId());
 
     int curFrame = sub.frame;
     if(modef.flags & MFF_IDFRAME)
@@ -362,14 +411,14 @@ static ModelFrame &visibleModelFrame(ModelDef &modef, int subnumber, int mobjId)
         curFrame += mobjId % sub.frameRange;
     }
 
-    return App_ResourceSystem().model(sub.modelId).frame(curFrame);
+    return mdl.frame(curFrame);
 }
 
 /**
  * Render a set of 3D model primitives using the given data.
  */
 static void drawPrimitives(rendcmd_t mode, Model::Primitives const &primitives,
-    Vector3f *posCoords, Vector4ub *colorCoords, Vector2f *texCoords = 0)
+    ModelFrame::Vertex *vertices, Vector4ub *colorCoords, Vector2f *texCoords = 0)
 {
     DENG_ASSERT_IN_MAIN_THREAD();
     DENG_ASSERT_GL_CONTEXT_ACTIVE();
@@ -383,17 +432,17 @@ static void drawPrimitives(rendcmd_t mode, Model::Primitives const &primitives,
     {
     case RC_OTHER_COORDS:
         coords[0] = texCoords;
-        configureArrays(posCoords, colorCoords, 1, coords);
+        configureArrays(vertices, colorCoords, 1, coords);
         break;
 
     case RC_BOTH_COORDS:
         coords[0] = NULL;
         coords[1] = texCoords;
-        configureArrays(posCoords, colorCoords, 2, coords);
+        configureArrays(vertices, colorCoords, 2, coords);
         break;
 
     default:
-        configureArrays(posCoords, colorCoords);
+        configureArrays(vertices, colorCoords);
         break;
     }
 
@@ -417,50 +466,185 @@ static void drawPrimitives(rendcmd_t mode, Model::Primitives const &primitives,
     }
 }
 
+static inline void lerpVertex(ModelFrame::Vertex const &start, ModelFrame::Vertex const &end,
+    dfloat inter, bool mirror, ModelFrame::Vertex &out)
+{
+    out.pos  = de::lerp(start.pos,  end.pos,  inter);
+    out.norm = de::lerp(start.norm, end.norm, inter);
+    if(mirror)
+    {
+        out.pos.z  = -out.pos.z;
+        out.norm.y = -out.norm.y;
+    }
+}
+
+#ifdef DENG_MODEL_SSE2
 /**
- * Interpolate linearly between two sets of vertices.
+ * Decodes four compact vertices, one component per register.
  */
-static void Mod_LerpVertices(float inter, int count, ModelFrame const &from,
-    ModelFrame const &to, Vector3f *posOut, Vector3f *normOut)
+static inline void decodePackedVertices(Model::PackedVertex const *packed,
+    __m128 const *offset, __m128 const *scale, __m128 *pos, __m128 *norm)
 {
-    DENG2_ASSERT(&from.model == &to.model); // sanity check.
-    DENG2_ASSERT(!activeLod || &activeLod->model == &from.model); // sanity check.
-    DENG2_ASSERT(from.vertices.count() == to.vertices.count()); // sanity check.
+    // Eight bytes per vertex: four 16-bit lanes (x, y, z, normal).
+    __m128i const v01 = _mm_loadu_si128(reinterpret_cast<__m128i const *>(packed));
+    __m128i const v23 = _mm_loadu_si128(reinterpret_cast<__m128i const *>(packed + 2));
+    __m128i const a   = _mm_unpacklo_epi16(v01, v23);
+    __m128i const b   = _mm_unpackhi_epi16(v01, v23);
+    __m128i const xy  = _mm_unpacklo_epi16(a, b);
+    __m128i const zn  = _mm_unpackhi_epi16(a, b);
+
+    // Sign-extend to 32 bits.
+    __m128i const q[3] = { _mm_srai_epi32(_mm_unpacklo_epi16(xy, xy), 16),
+                           _mm_srai_epi32(_mm_unpackhi_epi16(xy, xy), 16),
+                           _mm_srai_epi32(_mm_unpacklo_epi16(zn, zn), 16) };
+    for(int c = 0; c < 3; ++c)
+    {
+        pos[c] = _mm_add_ps(offset[c], _mm_mul_ps(_mm_cvtepi32_ps(q[c]), scale[c]));
+    }
+
+    // Unfold the octahedral normal.
+    __m128i const n  = _mm_unpackhi_epi16(zn, zn);
+    __m128 const sign = _mm_set1_ps(-0.f);
+    __m128 const toUnit = _mm_set1_ps(1 / 127.f);
+    __m128 x = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(n, 24), 24)), toUnit);
+    __m128 y = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(n, 16), 24)), toUnit);
+    __m128 const z = _mm_sub_ps(_mm_sub_ps(_mm_set1_ps(1), _mm_andnot_ps(sign, x)),
+                                _mm_andnot_ps(sign, y));
+    __m128 const fold = _mm_max_ps(_mm_sub_ps(_mm_setzero_ps(), z), _mm_setzero_ps());
+    x = _mm_sub_ps(x, _mm_or_ps(fold, _mm_and_ps(sign, x)));
+    y = _mm_sub_ps(y, _mm_or_ps(fold, _mm_and_ps(sign, y)));
+
+    __m128 const len = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)),
+                                              _mm_mul_ps(z, z)));
+    norm[0] = _mm_div_ps(x, len);
+    norm[1] = _mm_div_ps(y, len);
+    norm[2] = _mm_div_ps(z, len);
+}
+#endif
+
+/**
+ * Interpolate linearly between two compact frames (see Model::compactFrames()).
+ * The vertices are decoded on the fly, so only a third of the memory is read
+ * compared to full-precision frames.
+ */
+static void Mod_LerpPackedVertices(dfloat inter, dint count, ModelFrame const &from,
+    ModelFrame const &to, ModelDetailLevel const *lod, bool mirror, ModelFrame::Vertex *out)
+{
+    DENG2_ASSERT(from.isCompact() && to.isCompact());
+
+    ModelFrame const &end = (de::fequal(inter, 0)? from : to);
 
-    ModelFrame::VertexBuf::const_iterator startIt = from.vertices.begin();
-    ModelFrame::VertexBuf::const_iterator endIt   = to.vertices.begin();
+    dint i = 0;
+#ifdef DENG_MODEL_SSE2
+    DENG2_UNUSED(lod);
 
-    if(&from == &to || de::fequal(inter, 0))
+    __m128 const t    = _mm_set1_ps(inter);
+    __m128 const flip = (mirror? _mm_set1_ps(-0.f) : _mm_setzero_ps());
+    __m128 const fromOffset[3] = { _mm_set1_ps(from.packOffset.x), _mm_set1_ps(from.packOffset.y), _mm_set1_ps(from.packOffset.z) };
+    __m128 const fromScale[3]  = { _mm_set1_ps(from.packScale.x),  _mm_set1_ps(from.packScale.y),  _mm_set1_ps(from.packScale.z) };
+    __m128 const endOffset[3]  = { _mm_set1_ps(end.packOffset.x),  _mm_set1_ps(end.packOffset.y),  _mm_set1_ps(end.packOffset.z) };
+    __m128 const endScale[3]   = { _mm_set1_ps(end.packScale.x),   _mm_set1_ps(end.packScale.y),   _mm_set1_ps(end.packScale.z) };
+
+    for(; i + 4 <= count; i += 4)
     {
-        for(int i = 0; i < count; ++i, startIt++, posOut++, normOut++)
+        __m128 pa[3], na[3], pb[3], nb[3];
+        decodePackedVertices(from.packed + i, fromOffset, fromScale, pa, na);
+        decodePackedVertices(end.packed  + i, endOffset,  endScale,  pb, nb);
+
+        __m128 p[3], n[3];
+        for(int c = 0; c < 3; ++c)
         {
-            if(!activeLod || activeLod->hasVertex(i))
-            {
-                *posOut  = startIt->pos;
-                *normOut = startIt->norm;
-            }
+            p[c] = _mm_add_ps(pa[c], _mm_mul_ps(_mm_sub_ps(pb[c], pa[c]), t));
+            n[c] = _mm_add_ps(na[c], _mm_mul_ps(_mm_sub_ps(nb[c], na[c]), t));
         }
+        p[2] = _mm_xor_ps(p[2], flip);
+        n[1] = _mm_xor_ps(n[1], flip);
+
+        // Back to interleaved vertices: (pos, norm.x) of each vertex, then
+        // the remaining (norm.y, norm.z) pairs.
+        _MM_TRANSPOSE4_PS(p[0], p[1], p[2], n[0]);
+        __m128 const yz01 = _mm_unpacklo_ps(n[1], n[2]);
+        __m128 const yz23 = _mm_unpackhi_ps(n[1], n[2]);
+
+        float *o = &out[i].pos.x;
+        _mm_storeu_ps(o,      p[0]); _mm_storel_pi(reinterpret_cast<__m64 *>(o + 4),  yz01);
+        _mm_storeu_ps(o + 6,  p[1]); _mm_storeh_pi(reinterpret_cast<__m64 *>(o + 10), yz01);
+        _mm_storeu_ps(o + 12, p[2]); _mm_storel_pi(reinterpret_cast<__m64 *>(o + 16), yz23);
+        _mm_storeu_ps(o + 18, n[0]); _mm_storeh_pi(reinterpret_cast<__m64 *>(o + 22), yz23);
     }
-    else
+    for(; i < count; ++i)
     {
-        for(int i = 0; i < count; ++i, startIt++, endIt++, posOut++, normOut++)
+        lerpVertex(from.vertex(i), end.vertex(i), inter, mirror, out[i]);
+    }
+#else
+    for(; i < count; ++i)
+    {
+        if(!lod || lod->hasVertex(i))
         {
-            if(!activeLod || activeLod->hasVertex(i))
-            {
-                *posOut  = de::lerp(startIt->pos,  endIt->pos,  inter);
-                *normOut = de::lerp(startIt->norm, endIt->norm, inter);
-            }
+            lerpVertex(from.vertex(i), end.vertex(i), inter, mirror, out[i]);
         }
     }
+#endif
 }
 
-static void Mod_MirrorCoords(dint count, Vector3f *coords, dint axis)
+/**
+ * Interpolate linearly between two sets of vertices, optionally mirroring the
+ * results (positions along Z, normals along Y).
+ *
+ * With SSE2 all the vertices are interpolated, whether or not the detail level
+ * uses them; skipping the unused ones is more expensive than processing them.
+ */
+static void Mod_LerpVertices(dfloat inter, dint count, ModelFrame const &from,
+    ModelFrame const &to, ModelDetailLevel const *lod, bool mirror, ModelFrame::Vertex *out)
 {
-    DENG2_ASSERT(coords);
-    for(; count-- > 0; coords++)
+    DENG2_ASSERT(&from.model == &to.model); // sanity check.
+    DENG2_ASSERT(!lod || &lod->model == &from.model); // sanity check.
+    DENG2_ASSERT(from.vertices.count() == to.vertices.count()); // sanity check.
+
+    if(from.isCompact())
     {
-        (*coords)[axis] = -(*coords)[axis];
+        Mod_LerpPackedVertices(inter, count, from, to, lod, mirror, out);
+        return;
     }
+
+    ModelFrame::Vertex const *start = from.vertices.constData();
+    ModelFrame::Vertex const *end   = (de::fequal(inter, 0)? start : to.vertices.constData());
+
+    dint i = 0;
+#ifdef DENG_MODEL_SSE2
+    DENG2_UNUSED(lod);
+
+    // Two vertices are twelve floats, i.e., three registers.
+    __m128 const zero = _mm_setzero_ps();
+    __m128 const flip0 = (mirror? _mm_set_ps(0, -0.f, 0, 0) : zero); // pos.z
+    __m128 const flip1 = (mirror? _mm_set_ps(0, 0, 0, -0.f) : zero); // norm.y
+    __m128 const flip2 = (mirror? _mm_set_ps(0, -0.f, 0, -0.f) : zero);
+    __m128 const t = _mm_set1_ps(inter);
+
+    float const *a = reinterpret_cast<float const *>(start);
+    float const *b = reinterpret_cast<float const *>(end);
+    float *o = reinterpret_cast<float *>(out);
+    for(; i + 2 <= count; i += 2, a += 12, b += 12, o += 12)
+    {
+        __m128 const a0 = _mm_loadu_ps(a), a1 = _mm_loadu_ps(a + 4), a2 = _mm_loadu_ps(a + 8);
+        __m128 const b0 = _mm_loadu_ps(b), b1 = _mm_loadu_ps(b + 4), b2 = _mm_loadu_ps(b + 8);
+        _mm_storeu_ps(o,     _mm_xor_ps(_mm_add_ps(a0, _mm_mul_ps(_mm_sub_ps(b0, a0), t)), flip0));
+        _mm_storeu_ps(o + 4, _mm_xor_ps(_mm_add_ps(a1, _mm_mul_ps(_mm_sub_ps(b1, a1), t)), flip1));
+        _mm_storeu_ps(o + 8, _mm_xor_ps(_mm_add_ps(a2, _mm_mul_ps(_mm_sub_ps(b2, a2), t)), flip2));
+    }
+    for(; i < count; ++i)
+    {
+        lerpVertex(start[i], end[i], inter, mirror, out[i]);
+    }
+#else
+    for(; i < count; ++i)
+    {
+        if(!lod || lod->hasVertex(i))
+        {
+            lerpVertex(start[i], end[i], inter, mirror, out[i]);
+        }
+    }
+#endif
 }
 
 /**
@@ -470,8 +654,6 @@ static void Mod_MirrorCoords(dint count, Vector3f *coords, dint axis)
  * @param yaw     Yaw rotation angle.
  * @param pitch   Pitch rotation angle.
  * @param invert  @c true= flip light normal (for use with inverted models).
- *
- * @todo Construct a rotation matrix once and use it for all lights.
  */
 static Vector3f rotateLightVector(VectorLightData const &vlight, dfloat yaw, dfloat pitch,
     bool invert = false)
@@ -489,54 +671,133 @@ static Vector3f rotateLightVector(VectorLightData const &vlight, dfloat yaw, dfl
     return Vector3f(rotated);
 }
 
-/**
- * Calculate vertex lighting.
- */
-static void Mod_VertexColors(Vector4ub *out, dint count, Vector3f const *normCoords,
-    duint lightListIdx, duint maxLights, Vector4f const &ambient, bool invert,
-    dfloat rotateYaw, dfloat rotatePitch)
+static inline Vector4ub litVertexColor(Vector3f const &normal, ModelLight const *lights,
+    dint lightCount, Vector4f const &ambient)
 {
     Vector4f const saturated(1, 1, 1, 1);
 
-    for(dint i = 0; i < count; ++i, out++, normCoords++)
+    // Accumulate contributions from all affecting lights.
+    Vector3f accum[2];  // Begin with total darkness [color, extra].
+    for(dint i = 0; i < lightCount; ++i)
     {
-        if(activeLod && !activeLod->hasVertex(i))
-            continue;
+        ModelLight const &light = lights[i];
 
-        Vector3f const &normal = *normCoords;
+        dfloat strength = light.direction.dot(normal)
+                        + light.offset;  // Shift a bit towards the light.
 
-        // Accumulate contributions from all affecting lights.
-        dint numProcessed = 0;
-        Vector3f accum[2];  // Begin with total darkness [color, extra].
-        rendSys().forAllVectorLights(lightListIdx, [&maxLights, &invert, &rotateYaw
-                                                      , &rotatePitch, &normal
-                                                      , &accum, &numProcessed] (VectorLightData const &vlight)
+        // Ability to both light and shade.
+        if(strength > 0) strength *= light.lightSide;
+        else             strength *= light.darkSide;
+
+        accum[light.affectedByAmbient? 0 : 1] += light.color * de::clamp(-1.f, strength, 1.f);
+    }
+
+    // Check for ambient and convert to ubyte. Shading may have made the color
+    // negative, which must not wrap around.
+    Vector4f color(accum[0].max(ambient) + accum[1], ambient[3]);
+
+    return (color.min(saturated).max(Vector4f()) * 255).toVector4ub();
+}
+
+#ifdef DENG_MODEL_SSE2
+/**
+ * Loads the normals of four vertices, one component per register.
+ */
+static inline void loadNormals(ModelFrame::Vertex const *vertices, __m128 &x, __m128 &y, __m128 &z)
+{
+    x = _mm_set_ps(vertices[3].norm.x, vertices[2].norm.x, vertices[1].norm.x, vertices[0].norm.x);
+    y = _mm_set_ps(vertices[3].norm.y, vertices[2].norm.y, vertices[1].norm.y, vertices[0].norm.y);
+    z = _mm_set_ps(vertices[3].norm.z, vertices[2].norm.z, vertices[1].norm.z, vertices[0].norm.z);
+}
+#endif
+
+/**
+ * Calculate vertex lighting. The light directions must already be in model space.
+ */
+static void Mod_VertexColors(Vector4ub *out, dint count, ModelFrame::Vertex const *vertices,
+    ModelLight const *lights, dint lightCount, Vector4f const &ambient, ModelDetailLevel const *lod)
+{
+    dint i = 0;
+#ifdef DENG_MODEL_SSE2
+    DENG2_UNUSED(lod);
+
+    // Four vertices at a time.
+    struct LightRegs {
+        __m128 dir[3];
+        __m128 offset;
+        __m128 lightSide;
+        __m128 darkSide;
+        __m128 color[3];
+    } regs[MAX_MODEL_LIGHTS];
+    for(dint k = 0; k < lightCount; ++k)
+    {
+        ModelLight const &light = lights[k];
+        for(int c = 0; c < 3; ++c)
         {
-            numProcessed += 1;
+            regs[k].dir[c]   = _mm_set1_ps(light.direction[c]);
+            regs[k].color[c] = _mm_set1_ps(light.color[c]);
+        }
+        regs[k].offset    = _mm_set1_ps(light.offset);
+        regs[k].lightSide = _mm_set1_ps(light.lightSide);
+        regs[k].darkSide  = _mm_set1_ps(light.darkSide);
+    }
 
-            // We must transform the light vector to model space.
-            Vector3f const lightDirection
-                    = rotateLightVector(vlight, rotateYaw, rotatePitch, invert);
+    __m128 const zero     = _mm_setzero_ps();
+    __m128 const one      = _mm_set1_ps(1);
+    __m128 const minusOne = _mm_set1_ps(-1);
+    __m128 const scale    = _mm_set1_ps(255);
+    __m128 const amb[3]   = { _mm_set1_ps(ambient.x), _mm_set1_ps(ambient.y), _mm_set1_ps(ambient.z) };
+    __m128i const alpha   = _mm_set1_epi32(dint(duint32(de::min(ambient.w, 1.f) * 255) << 24));
 
-            dfloat strength = lightDirection.dot(normal)
-                            + vlight.offset;  // Shift a bit towards the light.
+    for(; i + 4 <= count; i += 4)
+    {
+        __m128 n[3];
+        loadNormals(vertices + i, n[0], n[1], n[2]);
 
-            // Ability to both light and shade.
-            if(strength > 0) strength *= vlight.lightSide;
-            else             strength *= vlight.darkSide;
+        __m128 accum[2][3] = { { zero, zero, zero }, { zero, zero, zero } };
+        for(dint k = 0; k < lightCount; ++k)
+        {
+            LightRegs const &light = regs[k];
 
-            accum[vlight.affectedByAmbient? 0 : 1]
-                += vlight.color * de::clamp(-1.f, strength, 1.f);
+            __m128 strength = _mm_add_ps(_mm_add_ps(_mm_mul_ps(light.dir[0], n[0]),
+                                                    _mm_mul_ps(light.dir[1], n[1])),
+                                         _mm_add_ps(_mm_mul_ps(light.dir[2], n[2]), light.offset));
 
-            // Time to stop?
-            return (maxLights && numProcessed == maxLights);
-        });
+            __m128 const lit = _mm_cmpgt_ps(strength, zero);
+            strength = _mm_mul_ps(strength, _mm_or_ps(_mm_and_ps(lit, light.lightSide),
+                                                      _mm_andnot_ps(lit, light.darkSide)));
+            strength = _mm_max_ps(minusOne, _mm_min_ps(strength, one));
 
-        // Check for ambient and convert to ubyte.
-        Vector4f color(accum[0].max(ambient) + accum[1], ambient[3]);
+            __m128 *acc = accum[lights[k].affectedByAmbient? 0 : 1];
+            for(int c = 0; c < 3; ++c)
+            {
+                acc[c] = _mm_add_ps(acc[c], _mm_mul_ps(light.color[c], strength));
+            }
+        }
 
-        *out = (color.min(saturated) * 255).toVector4ub();
+        // Check for ambient and convert to ubyte.
+        __m128i rgba = alpha;
+        for(int c = 0; c < 3; ++c)
+        {
+            __m128 const color = _mm_min_ps(_mm_add_ps(_mm_max_ps(accum[0][c], amb[c]), accum[1][c]), one);
+            __m128i const value = _mm_cvttps_epi32(_mm_mul_ps(_mm_max_ps(color, zero), scale));
+            rgba = _mm_or_si128(rgba, _mm_slli_epi32(value, 8 * c));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), rgba);
+    }
+    for(; i < count; ++i)
+    {
+        out[i] = litVertexColor(vertices[i].norm, lights, lightCount, ambient);
     }
+#else
+    for(; i < count; ++i)
+    {
+        if(!lod || lod->hasVertex(i))
+        {
+            out[i] = litVertexColor(vertices[i].norm, lights, lightCount, ambient);
+        }
+    }
+#endif
 }
 
 /**
@@ -565,25 +826,123 @@ static void Mod_FixedVertexColors(dint count, Vector4ub *colorCoords, Vector4ub
 
 /**
  * Calculate cylindrically mapped, shiny texture coordinates.
+ *
+ * The normals are rotated (as with M_RotateVector()) so that they approximate
+ * the model's orientation compared to the viewer.
+ *
+ * @param yaw    Yaw rotation of the normals, in degrees.
+ * @param pitch  Pitch rotation of the normals, in degrees.
  */
-static void Mod_ShinyCoords(Vector2f *out, int count, Vector3f const *normCoords,
-    float normYaw, float normPitch, float shinyAng, float shinyPnt, float reactSpeed)
+static void Mod_ShinyCoords(Vector2f *out, dint count, ModelFrame::Vertex const *vertices,
+    dfloat yaw, dfloat pitch, ModelDetailLevel const *lod)
 {
-    for(int i = 0; i < count; ++i, out++, normCoords++)
+    // Rotation around the Z axis (yaw) followed by the Y axis (pitch). Only
+    // the X and Z components of the result are needed.
+    dfloat const cy = std::cos(degreeToRadian(yaw)),   sy = std::sin(degreeToRadian(yaw));
+    dfloat const cp = std::cos(degreeToRadian(pitch)), sp = std::sin(degreeToRadian(pitch));
+    Vector3f const rowX(cp * cy, cp * sy, -sp);
+    Vector3f const rowZ(sp * cy, sp * sy,  cp);
+
+    dint i = 0;
+#ifdef DENG_MODEL_SSE2
+    DENG2_UNUSED(lod);
+
+    __m128 const one = _mm_set1_ps(1);
+    __m128 const rx[3] = { _mm_set1_ps(rowX.x), _mm_set1_ps(rowX.y), _mm_set1_ps(rowX.z) };
+    __m128 const rz[3] = { _mm_set1_ps(rowZ.x), _mm_set1_ps(rowZ.y), _mm_set1_ps(rowZ.z) };
+    for(; i + 4 <= count; i += 4)
     {
-        if(activeLod && !activeLod->hasVertex(i))
-            continue;
+        __m128 n[3];
+        loadNormals(vertices + i, n[0], n[1], n[2]);
 
-        float rotatedNormal[3] = { normCoords->x, normCoords->y, normCoords->z };
+        __m128 const s = _mm_add_ps(_mm_add_ps(_mm_mul_ps(rx[0], n[0]), _mm_mul_ps(rx[1], n[1])),
+                                    _mm_add_ps(_mm_mul_ps(rx[2], n[2]), one));
+        __m128 const t = _mm_add_ps(_mm_add_ps(_mm_mul_ps(rz[0], n[0]), _mm_mul_ps(rz[1], n[1])),
+                                    _mm_mul_ps(rz[2], n[2]));
 
-        // Rotate the normal vector so that it approximates the
-        // model's orientation compared to the viewer.
-        M_RotateVector(rotatedNormal,
-                       (shinyPnt + normYaw) * 360 * reactSpeed,
-                       (shinyAng + normPitch - .5f) * 180 * reactSpeed);
+        // Interleave to (s, t) pairs.
+        _mm_storeu_ps(&out[i].x,     _mm_unpacklo_ps(s, t));
+        _mm_storeu_ps(&out[i + 2].x, _mm_unpackhi_ps(s, t));
+    }
+    for(; i < count; ++i)
+    {
+        out[i] = Vector2f(rowX.dot(vertices[i].norm) + 1, rowZ.dot(vertices[i].norm));
+    }
+#else
+    for(; i < count; ++i)
+    {
+        if(!lod || lod->hasVertex(i))
+        {
+            out[i] = Vector2f(rowX.dot(vertices[i].norm) + 1, rowZ.dot(vertices[i].norm));
+        }
+    }
+#endif
+}
+
+void SubmodelJob::run()
+{
+    if(!visible) return;
+
+    if(vertices.size() < numVerts)
+    {
+        vertices.resize(numVerts);
+        colors.resize(numVerts);
+        texCoords.resize(numVerts);
+    }
+
+    // Interpolate vertices and normals.
+    Mod_LerpVertices(inter, numVerts, *frame, *nextFrame, lod, mirrored, vertices.data());
+
+    // Calculate lighting.
+    switch(lighting)
+    {
+    case FullBright:
+        Mod_FullBrightVertexColors(numVerts, colors.data(), alpha);
+        break;
+
+    case Uniform:
+        Mod_FixedVertexColors(numVerts, colors.data(), (ambient * 255).toVector4ub());
+        break;
+
+    case VectorLights:
+        Mod_VertexColors(colors.data(), numVerts, vertices.constData(), lights, lightCount,
+                         ambient, lod);
+        break;
+    }
+
+    if(shininess > 0)
+    {
+        Mod_ShinyCoords(texCoords.data(), numVerts, vertices.constData(), shinyYaw, shinyPitch, lod);
+    }
+}
+
+/**
+ * Prepares submodels in a worker thread.
+ */
+class PrepareSubmodelsTask : public Task
+{
+public:
+    PrepareSubmodelsTask(SubmodelJob *const *first, SubmodelJob *const *last)
+        : _first(first), _last(last)
+    {}
 
-        *out = Vector2f(rotatedNormal[0] + 1, rotatedNormal[2]);
+    void runTask()
+    {
+        for(SubmodelJob *const *job = _first; job != _last; ++job)
+        {
+            (*job)->run();
+        }
     }
+
+private:
+    SubmodelJob *const *_first;
+    SubmodelJob *const *_last;
+};
+
+static TaskPool &prepareTasks()
+{
+    static TaskPool pool;
+    return pool;
 }
 
 static int chooseSelSkin(ModelDef &mf, int submodel, int selector)
@@ -661,18 +1020,25 @@ static inline MaterialVariantSpec const &modelSkinMaterialSpec()
                                  1, -2, -1, true, true, false, false);
 }
 
-static void drawSubmodel(uint number, vissprite_t const &spr)
+/**
+ * Chooses the frames, detail level, lighting and shininess for drawing a
+ * submodel. Must be called in the main thread.
+ *
+ * @return  @c true if the submodel will be visible.
+ */
+static bool setupSubmodelJob(SubmodelJob &job, uint number, vissprite_t const &spr)
 {
     drawmodelparams_t const &parm = *VS_MODEL(&spr);
-    int const zSign = (spr.pose.mirrored? -1 : 1);
     ModelDef *mf = parm.mf, *mfNext = parm.nextMF;
     SubmodelDef const &smf = mf->subModelDef(number);
 
     Model &mdl = App_ResourceSystem().model(smf.modelId);
 
+    job.visible = false;
+
     // Do not bother with infinitely small models...
     if(mf->scale == Vector3f(0, 0, 0))
-        return;
+        return false;
 
     float alpha = spr.light.ambientColor[CA];
 
@@ -685,7 +1051,7 @@ static void drawSubmodel(uint number, vissprite_t const &spr)
     }
 
     // Would this be visible?
-    if(alpha <= 0) return;
+    if(alpha <= 0) return false;
 
     blendmode_t blending = smf.blendMode;
     // Is the submodel-defined blend mode in effect?
@@ -707,7 +1073,7 @@ static void drawSubmodel(uint number, vissprite_t const &spr)
         inter = (parm.inter - mf->interMark) / (endPos - mf->interMark);
     }
 
-    ModelFrame *frame = &visibleModelFrame(*mf, number, parm.id);
+    ModelFrame *frame = &visibleModelFrame(mdl, *mf, number, parm.id);
     ModelFrame *nextFrame = 0;
     // Do we have a sky/particle model here?
     if(parm.alwaysInterpolate)
@@ -724,7 +1090,7 @@ static void drawSubmodel(uint number, vissprite_t const &spr)
         {
             if(mfNext->hasSub(number) && mfNext->subModelId(number) == smf.modelId)
             {
-                nextFrame = &visibleModelFrame(*mfNext, number, parm.id);
+                nextFrame = &visibleModelFrame(mdl, *mfNext, number, parm.id);
             }
         }
     }
@@ -744,51 +1110,14 @@ static void drawSubmodel(uint number, vissprite_t const &spr)
     int numVerts = mdl.vertexCount();
 
     // Ensure our vertex render buffers can accommodate this.
-    if(!resizeVertexBuffer(numVerts))
+    if(!Rend_ModelExpandVertexBuffers(numVerts))
     {
         // No can do, we aint got the power!
-        return;
-    }
-
-    // Setup transformation.
-    glMatrixMode(GL_MODELVIEW);
-    glPushMatrix();
-
-    // Model space => World space
-    glTranslatef(spr.pose.origin[VX] + spr.pose.srvo[VX] +
-                   de::lerp(mf->offset.x, mfNext->offset.x, inter),
-                 spr.pose.origin[VZ] + spr.pose.srvo[VZ] +
-                   de::lerp(mf->offset.y, mfNext->offset.y, inter),
-                 spr.pose.origin[VY] + spr.pose.srvo[VY] + zSign *
-                   de::lerp(mf->offset.z, mfNext->offset.z, inter));
-
-    if(spr.pose.extraYawAngle || spr.pose.extraPitchAngle)
-    {
-        // Sky models have an extra rotation.
-        glScalef(1, 200 / 240.0f, 1);
-        glRotatef(spr.pose.extraYawAngle, 1, 0, 0);
-        glRotatef(spr.pose.extraPitchAngle, 0, 0, 1);
-        glScalef(1, 240 / 200.0f, 1);
-    }
-
-    // Model rotation.
-    glRotatef(spr.pose.viewAligned? spr.pose.yawAngleOffset : spr.pose.yaw,
-              0, 1, 0);
-    glRotatef(spr.pose.viewAligned? spr.pose.pitchAngleOffset : spr.pose.pitch,
-              0, 0, 1);
-
-    // Scaling and model space offset.
-    glScalef(de::lerp(mf->scale.x, mfNext->scale.x, inter),
-             de::lerp(mf->scale.y, mfNext->scale.y, inter),
-             de::lerp(mf->scale.z, mfNext->scale.z, inter));
-    if(spr.pose.extraScale)
-    {
-        // Particle models have an extra scale.
-        glScalef(spr.pose.extraScale, spr.pose.extraScale, spr.pose.extraScale);
+        return false;
     }
-    glTranslatef(smf.offset.x, smf.offset.y, smf.offset.z);
 
     // Determine the suitable LOD.
+    ModelDetailLevel *lod = 0;
     if(mdl.lodCount() > 1 && rend_model_lod != 0)
     {
         float lodFactor = rend_model_lod * DENG_GAMEVIEW_WIDTH / 640.0f / (Rend_FieldOfView() / 90.0f);
@@ -798,73 +1127,75 @@ static void drawSubmodel(uint number, vissprite_t const &spr)
         }
 
         // Determine the LOD we will be using.
-        activeLod = &mdl.lod(de::clamp<int>(0, lodFactor * spr.pose.distance, mdl.lodCount() - 1));
-    }
-    else
-    {
-        activeLod = 0;
+        lod = &mdl.lod(de::clamp<int>(0, lodFactor * spr.pose.distance, mdl.lodCount() - 1));
     }
 
-    // Interpolate vertices and normals.
-    Mod_LerpVertices(inter, numVerts, *frame, *nextFrame,
-                     modelPosCoords, modelNormCoords);
-
-    if(zSign < 0)
-    {
-        Mod_MirrorCoords(numVerts, modelPosCoords, 2);
-        Mod_MirrorCoords(numVerts, modelNormCoords, 1);
-    }
+    job.model     = &mdl;
+    job.frame     = frame;
+    job.nextFrame = nextFrame;
+    job.mfNext    = mfNext;
+    job.lod       = lod;
+    job.numVerts  = numVerts;
+    job.inter     = inter;
+    job.alpha     = alpha;
+    job.blending  = blending;
+    job.skin      = useSkin;
+    job.mirrored  = spr.pose.mirrored;
 
     // Coordinates to the center of the model (game coords).
-    modelCenter = Vector3f(spr.pose.origin[VX], spr.pose.origin[VY], spr.pose.midZ())
+    Vector3f const modelCenter = Vector3f(spr.pose.origin[VX], spr.pose.origin[VY], spr.pose.midZ())
             + Vector3d(spr.pose.srvo) + Vector3f(mf->offset.x, mf->offset.z, mf->offset.y);
 
-    // Calculate lighting.
-    Vector4f ambient;
+    // Lighting.
+    job.lightCount = 0;
     if(smf.testFlag(MFF_FULLBRIGHT) && !smf.testFlag(MFF_DIM))
     {
         // Submodel-specific lighting override.
-        ambient = Vector4f(1, 1, 1, 1);
-        Mod_FullBrightVertexColors(numVerts, modelColorCoords, alpha);
+        job.lighting = SubmodelJob::FullBright;
+        job.ambient  = Vector4f(1, 1, 1, 1);
     }
     else if(!spr.light.vLightListIdx)
     {
         // Lit uniformly.
-        ambient = Vector4f(spr.light.ambientColor, alpha);
-        Mod_FixedVertexColors(numVerts, modelColorCoords,
-                              (ambient * 255).toVector4ub());
+        job.lighting = SubmodelJob::Uniform;
+        job.ambient  = Vector4f(spr.light.ambientColor, alpha);
     }
     else
     {
-        // Lit normally.
-        ambient = Vector4f(spr.light.ambientColor, alpha);
+        // Lit normally. The light vectors are transformed to model space
+        // once here, rather than separately for each vertex.
+        job.lighting = SubmodelJob::VectorLights;
+        job.ambient  = Vector4f(spr.light.ambientColor, alpha);
+
+        dint const maxLights = de::min(modelLight + 1, MAX_MODEL_LIGHTS);
+        bool const invert = (mf->scale[VY] < 0);
+        rendSys().forAllVectorLights(spr.light.vLightListIdx, [&job, &spr, &maxLights, &invert]
+                                     (VectorLightData const &vlight)
+        {
+            ModelLight &light = job.lights[job.lightCount++];
+            light.direction         = rotateLightVector(vlight, -spr.pose.yaw, -spr.pose.pitch, invert);
+            light.offset            = vlight.offset;
+            light.lightSide         = vlight.lightSide;
+            light.darkSide          = vlight.darkSide;
+            light.color             = vlight.color;
+            light.affectedByAmbient = vlight.affectedByAmbient;
 
-        Mod_VertexColors(modelColorCoords, numVerts,
-                         modelNormCoords, spr.light.vLightListIdx, modelLight + 1,
-                         ambient, (mf->scale[VY] < 0), -spr.pose.yaw, -spr.pose.pitch);
+            // Time to stop?
+            return (job.lightCount == maxLights);
+        });
     }
 
-    TextureVariant *shinyTexture = 0;
-    float shininess = 0;
+    job.shininess = 0;
     if(mf->def.hasSub(number))
     {
-        shininess = float(de::clamp(0.0, mf->def.sub(number).getd("shiny") * modelShinyFactor, 1.0));
-        // Ensure we've prepared the shiny skin.
-        if(shininess > 0)
+        job.shininess = float(de::clamp(0.0, mf->def.sub(number).getd("shiny") * modelShinyFactor, 1.0));
+        if(!smf.shinySkin)
         {
-            if(Texture *tex = mf->subModelDef(number).shinySkin)
-            {
-                shinyTexture = tex->prepareVariant(Rend_ModelShinyTextureSpec());
-            }
-            else
-            {
-                shininess = 0;
-            }
+            job.shininess = 0;
         }
     }
 
-    Vector4f color;
-    if(shininess > 0)
+    if(job.shininess > 0)
     {
         // Calculate shiny coordinates.
         Vector3f shinyColor = mf->def.sub(number).get("shinyColor");
@@ -902,21 +1233,89 @@ static void drawSubmodel(uint number, vissprite_t const &spr)
             shinyPnt = QATAN2(delta.y, delta.x) / (2 * PI);
         }
 
-        Mod_ShinyCoords(modelTexCoords, numVerts,
-                        modelNormCoords, normYaw, normPitch, shinyAng, shinyPnt,
-                        mf->def.sub(number).getf("shinyReact"));
+        float const reactSpeed = mf->def.sub(number).getf("shinyReact");
+        job.shinyYaw   = (shinyPnt + normYaw) * 360 * reactSpeed;
+        job.shinyPitch = (shinyAng + normPitch - .5f) * 180 * reactSpeed;
 
         // Shiny color.
         if(smf.testFlag(MFF_SHINY_LIT))
         {
-            color = Vector4f(ambient * shinyColor, shininess);
+            job.shinyColor = Vector4f(job.ambient * shinyColor, job.shininess);
         }
         else
         {
-            color = Vector4f(shinyColor, shininess);
+            job.shinyColor = Vector4f(shinyColor, job.shininess);
         }
     }
 
+    job.visible = true;
+    return true;
+}
+
+/**
+ * Draws a prepared submodel.
+ */
+static void drawSubmodel(uint number, vissprite_t const &spr, SubmodelJob &job)
+{
+    DENG2_ASSERT(job.visible);
+
+    drawmodelparams_t const &parm = *VS_MODEL(&spr);
+    int const zSign = (spr.pose.mirrored? -1 : 1);
+    ModelDef *mf = parm.mf, *mfNext = job.mfNext;
+    SubmodelDef const &smf = mf->subModelDef(number);
+
+    Model &mdl = *job.model;
+    float const inter = job.inter;
+    float const alpha = job.alpha;
+    blendmode_t const blending = job.blending;
+    float const shininess = job.shininess;
+    Vector4f const &color = job.shinyColor;
+
+    // Setup transformation.
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+
+    // Model space => World space
+    glTranslatef(spr.pose.origin[VX] + spr.pose.srvo[VX] +
+                   de::lerp(mf->offset.x, mfNext->offset.x, inter),
+                 spr.pose.origin[VZ] + spr.pose.srvo[VZ] +
+                   de::lerp(mf->offset.y, mfNext->offset.y, inter),
+                 spr.pose.origin[VY] + spr.pose.srvo[VY] + zSign *
+                   de::lerp(mf->offset.z, mfNext->offset.z, inter));
+
+    if(spr.pose.extraYawAngle || spr.pose.extraPitchAngle)
+    {
+        // Sky models have an extra rotation.
+        glScalef(1, 200 / 240.0f, 1);
+        glRotatef(spr.pose.extraYawAngle, 1, 0, 0);
+        glRotatef(spr.pose.extraPitchAngle, 0, 0, 1);
+        glScalef(1, 240 / 200.0f, 1);
+    }
+
+    // Model rotation.
+    glRotatef(spr.pose.viewAligned? spr.pose.yawAngleOffset : spr.pose.yaw,
+              0, 1, 0);
+    glRotatef(spr.pose.viewAligned? spr.pose.pitchAngleOffset : spr.pose.pitch,
+              0, 0, 1);
+
+    // Scaling and model space offset.
+    glScalef(de::lerp(mf->scale.x, mfNext->scale.x, inter),
+             de::lerp(mf->scale.y, mfNext->scale.y, inter),
+             de::lerp(mf->scale.z, mfNext->scale.z, inter));
+    if(spr.pose.extraScale)
+    {
+        // Particle models have an extra scale.
+        glScalef(spr.pose.extraScale, spr.pose.extraScale, spr.pose.extraScale);
+    }
+    glTranslatef(smf.offset.x, smf.offset.y, smf.offset.z);
+
+    // Ensure we've prepared the shiny skin.
+    TextureVariant *shinyTexture = 0;
+    if(shininess > 0)
+    {
+        shinyTexture = smf.shinySkin->prepareVariant(Rend_ModelShinyTextureSpec());
+    }
+
     TextureVariant *skinTexture = 0;
     if(renderTextures == 2)
     {
@@ -932,7 +1331,7 @@ static void drawSubmodel(uint number, vissprite_t const &spr)
     else
     {
         skinTexture = 0;
-        if(Texture *tex = mdl.skin(useSkin).texture)
+        if(Texture *tex = mdl.skin(job.skin).texture)
         {
             skinTexture = tex->prepareVariant(Rend_ModelDiffuseTextureSpec(mdl.flags().testFlag(Model::NoTextureCompression)));
         }
@@ -952,7 +1351,11 @@ static void drawSubmodel(uint number, vissprite_t const &spr)
     glEnable(GL_TEXTURE_2D);
 
     Model::Primitives const &primitives =
-        activeLod? activeLod->primitives : mdl.primitives();
+        job.lod? job.lod->primitives : mdl.primitives();
+
+    ModelFrame::Vertex *vertices = job.vertices.data();
+    Vector4ub *colorCoords = job.colors.data();
+    Vector2f *texCoords = job.texCoords.data();
 
     // Render using multiple passes?
     if(!modelShinyMultitex || shininess <= 0 || alpha < 1 ||
@@ -967,7 +1370,7 @@ static void drawSubmodel(uint number, vissprite_t const &spr)
             GL_BindTexture(renderTextures? skinTexture : 0);
 
             drawPrimitives(RC_COMMAND_COORDS, primitives,
-                           modelPosCoords, modelColorCoords);
+                           vertices, colorCoords);
         }
 
         if(shininess > 0)
@@ -981,7 +1384,7 @@ static void drawSubmodel(uint number, vissprite_t const &spr)
                 GL_BlendMode(BM_NORMAL);
 
             // Shiny color.
-            Mod_FixedVertexColors(numVerts, modelColorCoords,
+            Mod_FixedVertexColors(job.numVerts, colorCoords,
                                   (color * 255).toVector4ub());
 
             if(numTexUnits > 1 && modelShinyMultitex)
@@ -998,7 +1401,7 @@ static void drawSubmodel(uint number, vissprite_t const &spr)
                 GL_BindTexture(renderTextures? skinTexture : 0);
 
                 drawPrimitives(RC_BOTH_COORDS, primitives,
-                               modelPosCoords, modelColorCoords, modelTexCoords);
+                               vertices, colorCoords, texCoords);
 
                 selectTexUnits(1);
                 GL_ModulateTexture(1);
@@ -1010,7 +1413,7 @@ static void drawSubmodel(uint number, vissprite_t const &spr)
                 GL_BindTexture(renderTextures? shinyTexture : 0);
 
                 drawPrimitives(RC_OTHER_COORDS, primitives,
-                               modelPosCoords, modelColorCoords, modelTexCoords);
+                               vertices, colorCoords, texCoords);
             }
         }
     }
@@ -1035,7 +1438,7 @@ static void drawSubmodel(uint number, vissprite_t const &spr)
         GL_BindTexture(renderTextures? skinTexture : 0);
 
         drawPrimitives(RC_BOTH_COORDS, primitives,
-                       modelPosCoords, modelColorCoords, modelTexCoords);
+                       vertices, colorCoords, texCoords);
 
         selectTexUnits(1);
         GL_ModulateTexture(1);
@@ -1061,6 +1464,85 @@ static void drawSubmodel(uint number, vissprite_t const &spr)
     GL_BlendMode(BM_NORMAL);
 }
 
+/**
+ * Waits until the models being prepared in the background are ready.
+ */
+static void finishPreparingModels()
+{
+    if(preparing)
+    {
+        prepareTasks().waitForDone();
+        preparing = false;
+    }
+}
+
+void Rend_PrepareModels(vissprite_t const &sortedHead)
+{
+    DENG2_ASSERT(inited);
+    DENG_ASSERT_IN_MAIN_THREAD();
+
+    Rend_ReleasePreparedModels();
+
+    // Set up a job for each of the submodels.
+    dint totalVerts = 0;
+    for(vissprite_t const *spr = sortedHead.next; spr != &sortedHead; spr = spr->next)
+    {
+        if(spr->type != VSPR_MODEL) continue;
+
+        drawmodelparams_t const &parm = *VS_MODEL(spr);
+        if(!parm.mf) continue;
+
+        preparedModels.insert(spr, jobsInUse);
+        for(uint i = 0; i < parm.mf->subCount(); ++i)
+        {
+            if(!parm.mf->subModelId(i)) continue;
+
+            if(jobsInUse == jobs.size())
+            {
+                jobs.append(new SubmodelJob);
+            }
+            SubmodelJob &job = *jobs[jobsInUse++];
+            if(setupSubmodelJob(job, i, *spr))
+            {
+                totalVerts += job.numVerts;
+            }
+        }
+    }
+
+    SubmodelJob *const *begin = jobs.constData();
+    if(totalVerts < SERIAL_PREPARE_LIMIT)
+    {
+        PrepareSubmodelsTask(begin, begin + jobsInUse).runTask();
+        return;
+    }
+
+    // Split the work into a few tasks with roughly equal numbers of vertices.
+    dint const taskCount = de::max(1, QThread::idealThreadCount()) * 2;
+    dint const perTask   = totalVerts / taskCount + 1;
+    dint first = 0;
+    dint verts = 0;
+    for(dint i = 0; i < jobsInUse; ++i)
+    {
+        if(jobs[i]->visible) verts += jobs[i]->numVerts;
+
+        if(verts >= perTask || i == jobsInUse - 1)
+        {
+            prepareTasks().start(new PrepareSubmodelsTask(begin + first, begin + i + 1),
+                                 TaskPool::HighPriority);
+            first = i + 1;
+            verts = 0;
+        }
+    }
+    preparing = true;
+}
+
+void Rend_ReleasePreparedModels()
+{
+    finishPreparingModels();
+    preparedModels.clear();
+    jobsInUse = 0;
+}
+
 void Rend_DrawModel(vissprite_t const &spr)
 {
     drawmodelparams_t const &parm = *VS_MODEL(&spr);
@@ -1071,11 +1553,29 @@ void Rend_DrawModel(vissprite_t const &spr)
 
     if(!parm.mf) return;
 
+    // Has the model been prepared already?
+    dint nextJob = preparedModels.value(&spr, -1);
+    if(nextJob >= 0)
+    {
+        finishPreparingModels();
+    }
+
     // Render all the submodels of this model.
     for(uint i = 0; i < parm.mf->subCount(); ++i)
     {
         if(parm.mf->subModelId(i))
         {
+            SubmodelJob *job = immediateJob;
+            if(nextJob >= 0)
+            {
+                job = jobs[nextJob++];
+            }
+            else if(setupSubmodelJob(*job, i, spr))
+            {
+                job->run();
+            }
+            if(!job->visible) continue;
+
             bool disableZ = (parm.mf->flags & MFF_DISABLE_Z_WRITE ||
                              parm.mf->testSubFlag(i, MFF_DISABLE_Z_WRITE));
 
@@ -1084,7 +1584,7 @@ void Rend_DrawModel(vissprite_t const &spr)
                 glDepthMask(GL_FALSE);
             }
 
-            drawSubmodel(i, spr);
+            drawSubmodel(i, spr, *job);
 
             if(disableZ)
             {
@@ -440,6 +440,7 @@ DENG2_PIMPL(RenderSystem)
                 .define(SReg::ConfigVariable, "render.pixelDensity")
                 .define(SReg::IntCVar,   "rend-model-mirror-hud", 0)
                 .define(SReg::IntCVar,   "rend-model-precache", 1)
+                .define(SReg::IntCVar,   "rend-model-compact", 1)
                 .define(SReg::IntCVar,   "rend-sprite-precache", 1)
                 .define(SReg::IntCVar,   "rend-light-multitex", 1)
                 .define(SReg::IntCVar,   "rend-model-shiny-multitex", 1)
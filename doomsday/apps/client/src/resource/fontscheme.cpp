@@ -219,9 +219,9 @@ bool FontScheme::has(Path const &path) const
 
 FontScheme::Manifest const &FontScheme::find(Path const &path) const
 {
-    if(has(path))
+    if(FontScheme::Manifest const *found = d->index.tryFind(path, Index::NoBranch | Index::MatchFull))
     {
-        return d->index.find(path, Index::NoBranch | Index::MatchFull);
+        return *found;
     }
     /// @throw NotFoundError Failed to locate a matching manifest.
     throw NotFoundError("FontScheme::find", "Failed to locate a manifest matching \"" + path.asText() + "\"");
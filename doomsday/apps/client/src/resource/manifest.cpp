@@ -154,7 +154,7 @@ static lumpnum_t lumpNumForIdentityKey(LumpIndex const &lumpIndex, String idKey)
         name += ".lmp";
     }
 
-    lumpnum_t lumpNum = lumpIndex.findLast(Path(name));
+    lumpnum_t lumpNum = lumpIndex.findLast(PathView(name));
     if(lumpNum < 0) return -1;
 
     // Check the condition.
@@ -87,9 +87,9 @@ bool MaterialScheme::has(Path const &path) const
 
 MaterialManifest const &MaterialScheme::find(Path const &path) const
 {
-    if(has(path))
+    if(MaterialManifest const *found = d->index.tryFind(path, Index::NoBranch | Index::MatchFull))
     {
-        return d->index.find(path, Index::NoBranch | Index::MatchFull);
+        return *found;
     }
     /// @throw NotFoundError Failed to locate a matching manifest.
     throw NotFoundError("MaterialScheme::find", "Failed to locate a manifest matching \"" + path.asText() + "\"");
@@ -28,14 +28,58 @@
 #include <de/Range>
 #include <de/memory.h>
 #include <QtAlgorithms>
+#include <cmath>
 
 using namespace de;
 
+/**
+ * Octahedral encoding of a unit vector: the vector is projected onto the
+ * octahedron |x| + |y| + |z| = 1, whose lower half is folded over the upper
+ * half so that the X and Y components alone identify the vector.
+ */
+static void packNormal(Vector3f const &normal, dint8 *packed)
+{
+    float const l1 = std::fabs(normal.x) + std::fabs(normal.y) + std::fabs(normal.z);
+    float x = (l1 > 0? normal.x / l1 : 0);
+    float y = (l1 > 0? normal.y / l1 : 0);
+    if(normal.z < 0)
+    {
+        float const foldedX = (1 - std::fabs(y)) * (x >= 0? 1 : -1);
+        float const foldedY = (1 - std::fabs(x)) * (y >= 0? 1 : -1);
+        x = foldedX;
+        y = foldedY;
+    }
+    packed[0] = dint8(std::floor(de::clamp(-1.f, x, 1.f) * 127 + .5f));
+    packed[1] = dint8(std::floor(de::clamp(-1.f, y, 1.f) * 127 + .5f));
+}
+
+static Vector3f unpackNormal(dint8 const *packed)
+{
+    float x = packed[0] / 127.f;
+    float y = packed[1] / 127.f;
+    float const z = 1 - std::fabs(x) - std::fabs(y);
+    float const fold = de::max(-z, 0.f);
+    x += (x >= 0? -fold : fold);
+    y += (y >= 0? -fold : fold);
+    return Vector3f(x, y, z).normalize();
+}
+
 bool Model::DetailLevel::hasVertex(int number) const
 {
     return model.lodVertexUsage().testBit(number * model.lodCount() + level);
 }
 
+Model::Frame::Vertex Model::Frame::vertex(int index) const
+{
+    if(!packed) return vertices.at(index);
+
+    PackedVertex const &pv = packed[index];
+    Vertex vtx;
+    vtx.pos  = packOffset + Vector3f(pv.pos[0], pv.pos[1], pv.pos[2]) * packScale;
+    vtx.norm = unpackNormal(pv.norm);
+    return vtx;
+}
+
 void Model::Frame::bounds(Vector3f &retMin, Vector3f &retMax) const
 {
     retMin = min;
@@ -146,6 +190,7 @@ DENG2_PIMPL(Model)
     Skins skins;
     Frames frames;
     int numVertices;
+    QVector<PackedVertex> packedVertices; ///< Compact storage of all frames.
 
     DetailLevels lods;
     QBitArray lodVertexUsage;
@@ -750,6 +795,50 @@ void Model::clearAllFrames()
     LOG_AS("Model");
     qDeleteAll(d->frames);
     d->frames.clear();
+    d->packedVertices.clear();
+}
+
+void Model::compactFrames()
+{
+    if(hasCompactFrames() || d->frames.isEmpty()) return;
+
+    int const count = d->numVertices;
+    d->packedVertices.resize(count * d->frames.count());
+
+    PackedVertex *packed = d->packedVertices.data();
+    foreach(Frame *frame, d->frames)
+    {
+        DENG2_ASSERT(frame->vertices.count() == count);
+
+        // Positions are quantized within the bounds of the frame.
+        Vector3f const halfSize = (frame->max - frame->min) / 2;
+        frame->packOffset = (frame->min + frame->max) / 2;
+        frame->packScale  = halfSize / 32767;
+
+        Vector3f const invScale(halfSize.x > 0? 32767 / halfSize.x : 0,
+                                halfSize.y > 0? 32767 / halfSize.y : 0,
+                                halfSize.z > 0? 32767 / halfSize.z : 0);
+
+        frame->packed = packed;
+        foreach(Frame::Vertex const &vtx, frame->vertices)
+        {
+            Vector3f const q = (vtx.pos - frame->packOffset) * invScale;
+            for(int i = 0; i < 3; ++i)
+            {
+                packed->pos[i] = dint16(de::clamp(-32767, int(std::floor(q[i] + .5f)), 32767));
+            }
+            packNormal(vtx.norm, packed->norm);
+            packed++;
+        }
+
+        // Release the full-precision vertices.
+        frame->vertices = Frame::VertexBuf();
+    }
+}
+
+bool Model::hasCompactFrames() const
+{
+    return !d->packedVertices.isEmpty();
 }
 
 int Model::skinNumber(String name) const
@@ -1357,7 +1357,7 @@ DENG2_PIMPL(ResourceSystem)
         LOG_RES_VERBOSE("Initializing Flat textures...");
 
         LumpIndex const &index = fileSys().nameIndex();
-        lumpnum_t firstFlatMarkerLumpNum = index.findFirst(Path("F_START.lmp"));
+        lumpnum_t firstFlatMarkerLumpNum = index.findFirst(PathView("F_START.lmp"));
         if(firstFlatMarkerLumpNum >= 0)
         {
             lumpnum_t lumpNum;
@@ -1865,6 +1865,12 @@ DENG2_PIMPL(ResourceSystem)
 
                         defineAllSkins(*mdl);
 
+                        // Quantize the frames to save memory?
+                        if(compactModels)
+                        {
+                            mdl->compactFrames();
+                        }
+
                         // Enlarge the vertex buffers in preparation for drawing of this model.
                         if(!Rend_ModelExpandVertexBuffers(mdl->vertexCount()))
                         {
@@ -2521,14 +2527,13 @@ patchid_t ResourceSystem::declarePatch(String encodedName)
     catch(MissingManifestError const &)
     {} // Ignore this error.
 
-    Path lumpPath = uri.path() + ".lmp";
-    if(!d->fileSys().nameIndex().contains(lumpPath))
+    lumpnum_t const lumpNum = d->fileSys().nameIndex().findLast(PathView(uri.path().toStringRef() + ".lmp"));
+    if(lumpNum < 0)
     {
         LOG_RES_WARNING("Failed to locate lump for \"%s\"") << uri;
         return 0;
     }
 
-    lumpnum_t const lumpNum = d->fileSys().nameIndex().findLast(lumpPath);
     File1 &file = d->fileSys().lump(lumpNum);
 
     Texture::Flags flags;
@@ -2833,7 +2838,7 @@ TextureManifest &ResourceSystem::textureManifest(de::Uri const &uri) const
     else
     {
         // No, this is a URI.
-        String const &path = uri.path();
+        Path const &path = uri.path();
 
         // Does the user want a manifest in a specific scheme?
         if(!uri.scheme().isEmpty())
@@ -3055,7 +3060,7 @@ FontManifest &ResourceSystem::fontManifest(de::Uri const &uri) const
     else
     {
         // No, this is a URI.
-        String const &path = uri.path();
+        Path const &path = uri.path();
 
         // Does the user want a manifest in a specific scheme?
         if(!uri.scheme().isEmpty())
@@ -265,9 +265,9 @@ bool TextureScheme::has(Path const &path) const
 
 TextureManifest const &TextureScheme::find(Path const &path) const
 {
-    if(has(path))
+    if(TextureManifest const *found = d->index.tryFind(path, Index::NoBranch | Index::MatchFull))
     {
-        return d->index.find(path, Index::NoBranch | Index::MatchFull);
+        return *found;
     }
     /// @throw NotFoundError Failed to locate a matching manifest.
     throw NotFoundError("TextureScheme::find", "Failed to locate a manifest matching \"" + path.asText() + "\"");
@@ -43,6 +43,7 @@
 #include "gl/gl_main.h"
 #include "gl/sys_opengl.h"
 #include "gl/gl_defer.h"
+#include "network/timedemo.h"
 
 #include <de/GLState>
 
@@ -72,13 +73,22 @@ DENG2_PIMPL(GameWidget)
 
         if(cannotDraw) return;
 
+        TimeDemo_NewFrame();
+
         if(App_GameLoaded())
         {
             // Notify the world that a new render frame has begun.
-            App_WorldSystem().beginFrame(CPP_BOOL(R_NextViewer()));
-
-            R_RenderViewPorts(Player3DViewLayer);
-            R_RenderViewPorts(ViewBorderLayer);
+            {
+                TimeDemoSample sample(TDS_RENDER_PREP);
+                App_WorldSystem().beginFrame(CPP_BOOL(R_NextViewer()));
+            }
+
+            // Headless timedemos only prepare the frames.
+            if(!TimeDemo_IsHeadless())
+            {
+                R_RenderViewPorts(Player3DViewLayer);
+                R_RenderViewPorts(ViewBorderLayer);
+            }
 
             // End any open DGL sequence.
             DGL_End();
@@ -42,6 +42,7 @@
 #include "world/dmuargs.h"
 #include "world/entitydatabase.h"
 #include "world/maputil.h"
+#include "world/reject.h"
 #include "world/worldsystem.h"
 #include "BspLeaf"
 #include "ConvexSubspace"
@@ -1748,6 +1749,17 @@ DENG_EXTERN_C dd_bool P_CheckLineSight(const_pvec3d_t from, const_pvec3d_t to, c
     if(App_WorldSystem().hasMap())
     {
         Map &map = App_WorldSystem().map();
+
+        // Trivial rejection: are the sectors mutually invisible? (Not applicable
+        // if the ray may pass through one-sided lines.)
+        if(!(flags & (LS_PASSOVER | LS_PASSUNDER | LS_PASSLEFT)) && map.hasReject())
+        {
+            Sector const *fromSector = map.bspLeafAt(Vector2d(from)).sectorPtr();
+            Sector const *toSector   = map.bspLeafAt(Vector2d(to)).sectorPtr();
+            if(fromSector && toSector && !map.reject().mightSee(*fromSector, *toSector))
+                return false;
+        }
+
         return LineSightTest(from, to, bottomSlope, topSlope, flags).trace(map.bspTree());
     }
     return false; // Continue iteration.
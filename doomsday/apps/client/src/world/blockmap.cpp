@@ -22,6 +22,7 @@
 #include "world/blockmap.h"
 
 #include <cmath>
+#include <deque>
 #include <de/memoryzone.h>
 #include <de/vector1.h>
 #include <de/Vector>
@@ -194,7 +195,9 @@ DENG2_PIMPL(Blockmap)
             }
         }
     };
-    typedef QList<Node> Nodes;
+    /// Nodes link to each other with pointers, so they must not move in memory.
+    /// A deque also avoids allocating each node individually (unlike QList).
+    typedef std::deque<Node> Nodes;
 
     AABoxd bounds;    ///< Map space units.
     uint cellSize;    ///< Map space units.
@@ -304,8 +307,8 @@ DENG2_PIMPL(Blockmap)
 
     Node *newNode(Cell const &at, uint size)
     {
-        nodes.append(Node(at, size));
-        return &nodes.last();
+        nodes.emplace_back(at, size);
+        return &nodes.back();
     }
 
     Node *findLeaf(Node *node, Cell const &at, bool canSubdivide)
@@ -347,7 +350,7 @@ DENG2_PIMPL(Blockmap)
 
     inline Node *findLeaf(Cell const &at, bool canCreate = false)
     {
-        return findLeaf(&nodes.first(), at, canCreate);
+        return findLeaf(&nodes.front(), at, canCreate);
     }
 
     /**
@@ -728,8 +731,8 @@ void Blockmap::drawDebugVisual() const
     /*
      * Draw the Quadtree.
      */
-    glColor4f(1.f, 1.f, 1.f, 1.f / d->nodes.first().size);
-    foreach(Instance::Node const &node, d->nodes)
+    glColor4f(1.f, 1.f, 1.f, 1.f / d->nodes.front().size);
+    for(Instance::Node const &node : d->nodes)
     {
         // Only leafs with user data.
         if(!node.isLeaf()) continue;
@@ -174,9 +174,9 @@ struct Continuity
 
 DENG2_PIMPL_NOREF(ConvexSubspaceProxy)
 {
-    typedef QSet<LineSegmentSide *> Segments;
+    typedef QList<LineSegmentSide *> Segments;
 
-    Segments segments;                ///< All line segments.
+    Segments segments;                ///< All line segments (in the order added).
     OrderedSegments orderedSegments;  ///< All line segments in clockwise order, with angle info.
     bool needRebuildOrderedSegments;  ///< @c true= the ordered segment list needs to be rebuilt.
     BspLeaf *bspLeaf;                 ///< BSP leaf attributed to the subspace (if any).
@@ -321,7 +321,15 @@ void ConvexSubspaceProxy::addSegments(QList<LineSegmentSide *> const &newSegment
 {
     int sizeBefore = d->segments.size();
 
-    d->segments.unite(QSet<LineSegmentSide *>::fromList(newSegments));
+    // The order is retained so that the geometry does not depend on where the
+    // segments happen to be allocated.
+    for(LineSegmentSide *seg : newSegments)
+    {
+        if(!d->segments.contains(seg))
+        {
+            d->segments.append(seg);
+        }
+    }
 
     if(d->segments.size() != sizeBefore)
     {
@@ -341,12 +349,10 @@ void ConvexSubspaceProxy::addSegments(QList<LineSegmentSide *> const &newSegment
 
 void ConvexSubspaceProxy::addOneSegment(LineSegmentSide const &newSegment)
 {
-    int sizeBefore = d->segments.size();
-
-    d->segments.insert(const_cast<LineSegmentSide *>(&newSegment));
-
-    if(d->segments.size() != sizeBefore)
+    if(!d->segments.contains(const_cast<LineSegmentSide *>(&newSegment)))
     {
+        d->segments.append(const_cast<LineSegmentSide *>(&newSegment));
+
         // We'll need to rebuild the ordered segment list.
         d->needRebuildOrderedSegments = true;
     }
@@ -356,6 +362,23 @@ void ConvexSubspaceProxy::addOneSegment(LineSegmentSide const &newSegment)
     }
 }
 
+void ConvexSubspaceProxy::replaceSegment(LineSegmentSide const &segment,
+    QList<LineSegmentSide *> const &replacements)
+{
+    int const index = d->segments.indexOf(const_cast<LineSegmentSide *>(&segment));
+    DENG2_ASSERT(index >= 0);
+    if(index < 0) return;
+
+    d->segments.removeAt(index);
+    for(int i = 0; i < replacements.count(); ++i)
+    {
+        d->segments.insert(index + i, replacements.at(i));
+    }
+
+    // We'll need to rebuild the ordered segment list.
+    d->needRebuildOrderedSegments = true;
+}
+
 void ConvexSubspaceProxy::buildGeometry(BspLeaf &leaf, Mesh &mesh) const
 {
     LOG_AS("ConvexSubspaceProxy::buildGeometry");
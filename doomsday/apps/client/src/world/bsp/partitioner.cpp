@@ -25,14 +25,32 @@
 #include "world/bsp/partitioner.h"
 
 #include <algorithm>
+#include <atomic>
+#include <list>
+#include <memory>
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
 #include <QHash>
 #include <QList>
+#include <QPair>
 #include <QtAlgorithms>
+#include <QVarLengthArray>
+#include <QVector>
 #include <de/vector1.h>
+#include <de/FlatHashMap>
 #include <de/Log>
+#include <de/NativePath>
+#include <de/Reader>
+#include <de/Task>
+#include <de/TaskPool>
+#include <de/Waitable>
+#include <de/Writer>
 
 #include "BspLeaf"
 #include "BspNode"
+#include "ConvexSubspace"
+#include "Face"
 #include "Line"
 #include "Sector"
 #include "Vertex"
@@ -51,12 +69,24 @@ using namespace bsp;
 typedef QList<Line *>              Lines;
 typedef QList<LineSegment *>       LineSegments;
 typedef QList<LineSegmentSide *>   LineSegmentSides;
-typedef QList<ConvexSubspaceProxy> SubspaceProxys;
-typedef QHash<Vertex *, EdgeTips>  EdgeTipSetMap;
+typedef std::list<ConvexSubspaceProxy> SubspaceProxys;  ///< Spliced when merging (addresses are kept).
+typedef FlatHashMap<Vertex *, EdgeTips> EdgeTipSetMap;
+
+/// Identifies a node cache file ("BSPc").
+static duint32 const NODECACHE_MAGIC   = 0x63505342;
+
+/// Increment when the partitioning algorithm or cache format changes.
+static dint32 const NODECACHE_VERSION = 2;
+
+/// Both half-spaces of a partition must have at least this many line segments
+/// for them to be built as separate subtrees (possibly concurrently). This does
+/// not depend on the number of threads, so neither does the output.
+static int const SUBTREE_MIN_SEGMENTS = 512;
 
 DENG2_PIMPL(Partitioner)
 {
     int splitCostFactor = 7;     ///< Cost of splitting a line segment.
+    bool concurrent = true;      ///< Build large half-spaces in tasks.
 
     Lines lines;                 ///< Set of map lines to build from (in index order, not owned).
     Mesh *mesh = nullptr;        ///< Provider of map geometries (cf. Factory).
@@ -64,12 +94,126 @@ DENG2_PIMPL(Partitioner)
     int segmentCount = 0;        ///< Running total of segments built.
     int vertexCount  = 0;        ///< Running total of vertexes built.
 
-    LineSegments lineSegments;   ///< Line segments in the plane.
-    SubspaceProxys subspaces;    ///< Proxy subspaces in the plane.
-    EdgeTipSetMap edgeTipSets;   ///< One set for each vertex.
-
     BspTree *bspRoot = nullptr;  ///< The BSP tree under construction.
-    HPlane hplane;               ///< Current space half-plane (partitioner state).
+
+    NativePath cachePath;        ///< Node cache folder (empty if disabled).
+
+    struct UnclosedSector
+    {
+        dint32 sector;
+        Vector2d nearPoint;
+    };
+
+    /**
+     * Working state for building one subtree. The two half-spaces of a large
+     * partition are built as subtrees of their own so that neither touches the
+     * line segments, edge tips or half-plane of the other. The results are then
+     * merged into the state of the parent (see buildHalfSpaces()).
+     */
+    struct SubtreeBuild
+    {
+        SubtreeBuild *parent;          ///< Build the subtree was split off from (if any).
+
+        LineSegments lineSegments;     ///< Line segments built in the subtree (owned).
+        SubspaceProxys subspaces;      ///< Proxy subspaces in the plane.
+        QList<Vertex *> vertexes;      ///< Built but not yet added to the mesh (owned).
+        int vertexCount = 0;           ///< Running total of vertexes built.
+
+        /// Sets of the vertexes whose tips were added to here. Sets are copied
+        /// from the parent when first added to.
+        EdgeTipSetMap edgeTipSets;
+        QList<QPair<Vertex *, EdgeTip>> newEdgeTips;  ///< Tips added, in order (for the parent).
+
+        /// Pieces of the line segments cloned by separateHalfSpaces(), mapped to the clone.
+        QHash<LineSegment *, LineSegment *> clonePieces;
+
+        QList<UnclosedSector> unclosedSectors;  ///< Found during the build (for the cache).
+
+        HPlane hplane;                 ///< Current space half-plane.
+        std::unique_ptr<PartitionEvaluator> evaluator;  ///< Reused for each partition choice.
+        bool onPoolThread;             ///< Built by a task of the pool.
+
+        SubtreeBuild(SubtreeBuild *parent = nullptr)
+            : parent(parent)
+            , onPoolThread(parent && parent->onPoolThread)
+        {}
+
+        ~SubtreeBuild()
+        {
+            // Line segments first, as they observe the vertexes.
+            qDeleteAll(lineSegments);
+            qDeleteAll(vertexes);
+        }
+    };
+    std::unique_ptr<SubtreeBuild> rootBuild;  ///< State of the whole build.
+
+    /**
+     * A line segment with a side in one half-space of a partition and the twin
+     * of that side somewhere else (see separateHalfSpaces()).
+     */
+    struct Crossing
+    {
+        LineSegment *segment;
+        LineSegment *clones[2];  ///< Standing in for each side of the segment (if any).
+    };
+    typedef QList<Crossing> Crossings;
+
+    /**
+     * One half-space of a partition, built as a subtree of its own. Shared by
+     * the task building it and the thread waiting for the result, as the latter
+     * builds it itself if no pool thread has picked up the task yet (so that
+     * the threads of the pool are never all left waiting for queued tasks).
+     */
+    struct HalfSpace
+    {
+        Instance &inst;
+        SubtreeBuild build;
+        LineSegmentBlockTreeNode &node;
+        BspTree *tree = nullptr;
+        String error;                   ///< Set if the build failed.
+        std::atomic<bool> claimed;
+        Waitable done;
+
+        HalfSpace(Instance &inst, SubtreeBuild &parent, LineSegmentBlockTreeNode &node)
+            : inst(inst), build(&parent), node(node), claimed(false)
+        {}
+
+        /// Returns @c true if the caller gets to build the half-space.
+        bool claim() { return !claimed.exchange(true); }
+
+        void buildSubtree()
+        {
+            try
+            {
+                tree = inst.partitionSpace(build, node);
+            }
+            catch(Error const &er)
+            {
+                error = er.asText();
+            }
+        }
+    };
+
+    class HalfSpaceTask : public Task
+    {
+    public:
+        HalfSpaceTask(std::shared_ptr<HalfSpace> const &halfSpace) : _halfSpace(halfSpace)
+        {}
+
+        void runTask()
+        {
+            // Already built by the waiting thread?
+            if(!_halfSpace->claim()) return;
+
+            _halfSpace->build.onPoolThread = true;
+            _halfSpace->buildSubtree();
+            _halfSpace->done.post();
+        }
+
+    private:
+        std::shared_ptr<HalfSpace> _halfSpace;
+    };
+    TaskPool subtreeTasks;
 
     struct LineSegmentBlockTree
     {
@@ -103,7 +247,7 @@ DENG2_PIMPL(Partitioner)
         }
     };
 
-    Instance(Public *i) : Base(i) {}
+    Instance(Public *i) : Base(i), rootBuild(new SubtreeBuild) {}
     ~Instance() { clear(); }
 
     static int clearBspElementWorker(BspTree &subtree, void *)
@@ -125,35 +269,33 @@ DENG2_PIMPL(Partitioner)
         //clearBspTree();
 
         lines.clear();
+        rootBuild.reset(new SubtreeBuild);
         mesh = nullptr;
-        qDeleteAll(lineSegments);
-        lineSegments.clear();
-        subspaces.clear();
-        edgeTipSets.clear();
-        hplane.clearIntercepts();
 
         segmentCount = vertexCount = 0;
     }
 
     /**
-     * Returns a newly allocated Vertex at the given map space @a origin from the
-     * map geometry mesh (ownership is @em not given to the caller).
+     * Returns a newly allocated Vertex at the given map space @a origin. It is
+     * added to the map geometry mesh once the build is complete (ownership is
+     * @em not given to the caller).
      */
-    Vertex *makeVertex(Vector2d const &origin)
+    Vertex *makeVertex(SubtreeBuild &build, Vector2d const &origin)
     {
-        Vertex *vtx = mesh->newVertex(origin);
-        vertexCount += 1; // We built another one.
+        Vertex *vtx = new Vertex(*mesh, origin);
+        build.vertexes << vtx;
+        build.vertexCount += 1; // We built another one.
         return vtx;
     }
 
     /**
      * @return The new line segment (front is from @a start to @a end).
      */
-    LineSegment *makeLineSegment(Vertex &start, Vertex &end, Sector *frontSec,
-        Sector *backSec, LineSide *frontSide, Line *partitionLine = nullptr)
+    LineSegment *makeLineSegment(SubtreeBuild &build, Vertex &start, Vertex &end,
+        Sector *frontSec, Sector *backSec, LineSide *frontSide, Line *partitionLine = nullptr)
     {
         LineSegment *newSeg = new LineSegment(start, end);
-        lineSegments << newSeg;
+        build.lineSegments << newSeg;
 
         LineSegmentSide &front = newSeg->front();
         front.setMapSide(frontSide);
@@ -251,24 +393,48 @@ DENG2_PIMPL(Partitioner)
     }
 
     /**
-     * Returns the EdgeTips set associated with @a vertex.
+     * Returns the EdgeTips set associated with @a vertex in the @a build (the
+     * set may be inherited from a parent build, or empty).
+     */
+    static EdgeTips const &edgeTipSet(SubtreeBuild const &build, Vertex const &vertex)
+    {
+        static EdgeTips const noTips;
+        for(SubtreeBuild const *cur = &build; cur; cur = cur->parent)
+        {
+            auto found = cur->edgeTipSets.constFind(const_cast<Vertex *>(&vertex));
+            if(found != cur->edgeTipSets.constEnd())
+            {
+                return found.value();
+            }
+        }
+        return noTips;
+    }
+
+    /**
+     * Add @a tip to the EdgeTips set associated with @a vertex in the @a build.
      */
-    EdgeTips &edgeTipSet(Vertex const &vertex)
+    void addEdgeTip(SubtreeBuild &build, Vertex &vertex, EdgeTip const &tip)
     {
-        EdgeTipSetMap::iterator found = edgeTipSets.find(const_cast<Vertex *>(&vertex));
-        if(found == edgeTipSets.end())
+        EdgeTipSetMap::iterator found = build.edgeTipSets.find(&vertex);
+        if(found == build.edgeTipSets.end())
+        {
+            // Time to construct a new set (the parent's is left as it is).
+            found = build.edgeTipSets.insert(&vertex, build.parent? edgeTipSet(*build.parent, vertex)
+                                                                  : EdgeTips());
+        }
+        found.value() << tip;
+
+        if(build.parent)
         {
-            // Time to construct a new set.
-            found = edgeTipSets.insert(const_cast<Vertex *>(&vertex), EdgeTips());
+            build.newEdgeTips << qMakePair(&vertex, tip);
         }
-        return found.value();
     }
 
     /**
      * Create all initial line segments. We can be certain there are no zero-length
      * lines as these are screened earlier.
      */
-    void createInitialLineSegments(LineSegmentBlockTreeNode &rootNode)
+    void createInitialLineSegments(SubtreeBuild &build, LineSegmentBlockTreeNode &rootNode)
     {
         for(Line *line : lines)
         {
@@ -281,7 +447,7 @@ DENG2_PIMPL(Partitioner)
                 backSec = line->_bspWindowSector;
             }
 
-            LineSegment *seg = makeLineSegment(line->from(), line->to(),
+            LineSegment *seg = makeLineSegment(build, line->from(), line->to(),
                                                frontSec, backSec, &line->front());
 
             if(seg->front().hasSector())
@@ -293,11 +459,25 @@ DENG2_PIMPL(Partitioner)
                 linkLineSegmentInBlockTree(rootNode, seg->back());
             }
 
-            edgeTipSet(line->from()) << EdgeTip(seg->front());
-            edgeTipSet(line->to())   << EdgeTip(seg->back());
+            addEdgeTip(build, line->from(), EdgeTip(seg->front()));
+            addEdgeTip(build, line->to(),   EdgeTip(seg->back()));
         }
     }
 
+    /**
+     * Returns the line segment cloned by separateHalfSpaces() of which @a seg
+     * is a piece, if any.
+     */
+    static LineSegment *cloneOf(SubtreeBuild const &build, LineSegment &seg)
+    {
+        for(SubtreeBuild const *cur = &build; cur; cur = cur->parent)
+        {
+            if(LineSegment *clone = cur->clonePieces.value(&seg))
+                return clone;
+        }
+        return nullptr;
+    }
+
     /**
      * Splits the given line segment at the point (x,y). The new line segment
      * is returned. The old line segment is shortened (the original start vertex
@@ -306,7 +486,7 @@ DENG2_PIMPL(Partitioner)
      *
      * @note If the line segment has a twin it is also split.
      */
-    LineSegmentSide &splitLineSegment(LineSegmentSide &frontLeft,
+    LineSegmentSide &splitLineSegment(SubtreeBuild &build, LineSegmentSide &frontLeft,
         Vector2d const &point, bool updateEdgeTips = true)
     {
         DENG2_ASSERT(point != frontLeft.from().origin() &&
@@ -315,20 +495,39 @@ DENG2_PIMPL(Partitioner)
         //LOG_DEBUG("Splitting line segment %p at %s")
         //        << &frontLeft << point.asText();
 
-        Vertex *newVert = makeVertex(point);
+        return splitLineSegment(build, frontLeft, *makeVertex(build, point), updateEdgeTips);
+    }
+
+    /**
+     * Splits the given line segment at the existing vertex @a newVert (which
+     * must lie on the segment).
+     *
+     * @see splitLineSegment()
+     */
+    LineSegmentSide &splitLineSegment(SubtreeBuild &build, LineSegmentSide &frontLeft,
+        Vertex &newVert, bool updateEdgeTips = true)
+    {
+        DENG2_ASSERT(newVert.origin() != frontLeft.from().origin() &&
+                     newVert.origin() != frontLeft.to().origin());
 
         LineSegment &oldSeg = frontLeft.line();
-        LineSegment &newSeg = *makeLineSegment(oldSeg.from(), oldSeg.to(),
+        LineSegment &newSeg = *makeLineSegment(build, oldSeg.from(), oldSeg.to(),
                                                oldSeg.front().sectorPtr(),
                                                oldSeg.back().sectorPtr(),
                                                oldSeg.front().mapSidePtr(),
                                                oldSeg.front().partitionMapLine());
 
+        // The pieces of a clone are accounted for when merging the half-spaces.
+        if(LineSegment *clone = cloneOf(build, oldSeg))
+        {
+            build.clonePieces.insert(&newSeg, clone);
+        }
+
         // Perform the split, updating vertex and relative segment links.
         LineSegmentSide &frontRight = newSeg.side(frontLeft.lineSideId());
 
-        oldSeg.replaceVertex(frontLeft.lineSideId() ^ LineSegment::To, *newVert);
-        newSeg.replaceVertex(frontLeft.lineSideId(),                   *newVert);
+        oldSeg.replaceVertex(frontLeft.lineSideId() ^ LineSegment::To, newVert);
+        newSeg.replaceVertex(frontLeft.lineSideId(),                   newVert);
 
         LineSegmentSide &backRight = frontLeft.back();
         LineSegmentSide &backLeft  = frontRight.back();
@@ -354,17 +553,15 @@ DENG2_PIMPL(Partitioner)
 
         if(updateEdgeTips)
         {
-            /// @todo Optimize: Avoid clearing tips by implementing update logic.
-            edgeTipSet(oldSeg.from()).clearByLineSegment(oldSeg);
-            edgeTipSet(oldSeg.to()  ).clearByLineSegment(oldSeg);
-
-            edgeTipSet(newSeg.from()).clearByLineSegment(newSeg);
-            edgeTipSet(newSeg.to()  ).clearByLineSegment(newSeg);
-
-            edgeTipSet(oldSeg.from()) << EdgeTip(oldSeg.front());
-            edgeTipSet(oldSeg.to())   << EdgeTip(oldSeg.back());
-            edgeTipSet(newSeg.from()) << EdgeTip(newSeg.front());
-            edgeTipSet(newSeg.to())   << EdgeTip(newSeg.back());
+            // Only the new vertex needs tips. The existing tips at the other
+            // vertexes still describe the pieces (the angles and the sectors
+            // are those of the old segment).
+            LineSegment *pieces[2] = { &oldSeg, &newSeg };
+            for(LineSegment *piece : pieces)
+            {
+                if(&piece->from() == &newVert) addEdgeTip(build, newVert, EdgeTip(piece->front()));
+                if(&piece->to()   == &newVert) addEdgeTip(build, newVert, EdgeTip(piece->back()));
+            }
         }
 
         return frontRight;
@@ -375,8 +572,8 @@ DENG2_PIMPL(Partitioner)
      * partition plane. Takes advantage of some common situations like
      * horizontal and vertical lines to choose a 'nicer' intersection point.
      */
-    Vector2d intersectPartition(LineSegmentSide const &seg, coord_t fromDist,
-                                coord_t toDist) const
+    static Vector2d intersectPartition(HPlane const &hplane, LineSegmentSide const &seg,
+                                       coord_t fromDist, coord_t toDist)
     {
         // Horizontal partition vs vertical line segment.
         if(hplane.slopeType() == ST_HORIZONTAL && seg.slopeType() == ST_VERTICAL)
@@ -404,9 +601,9 @@ DENG2_PIMPL(Partitioner)
     }
 
     /// @todo refactor away
-    inline void interceptPartition(LineSegmentSide &seg, int edge)
+    inline void interceptPartition(SubtreeBuild &build, LineSegmentSide &seg, int edge)
     {
-        hplane.intercept(seg, edge, edgeTipSet(seg.vertex(edge)));
+        build.hplane.intercept(seg, edge, edgeTipSet(build, seg.vertex(edge)));
     }
 
     /**
@@ -425,16 +622,18 @@ DENG2_PIMPL(Partitioner)
      * @param rights  Set of line segments on the right side of the partition.
      * @param lefts   Set of line segments on the left side of the partition.
      */
-    void divideOneSegment(LineSegmentSide &seg, LineSegmentBlockTreeNode &rights,
-                          LineSegmentBlockTreeNode &lefts)
+    void divideOneSegment(SubtreeBuild &build, LineSegmentSide &seg,
+                          LineSegmentBlockTreeNode &rights, LineSegmentBlockTreeNode &lefts)
     {
+        HPlane const &hplane = build.hplane;
+
         coord_t fromDist, toDist;
         LineRelationship rel = hplane.relationship(seg, &fromDist, &toDist);
         switch(rel)
         {
         case Collinear: {
-            interceptPartition(seg, LineSegment::From);
-            interceptPartition(seg, LineSegment::To);
+            interceptPartition(build, seg, LineSegment::From);
+            interceptPartition(build, seg, LineSegment::To);
 
             // Direction (vs that of the partition plane) determines in which
             // subset this line segment belongs.
@@ -454,7 +653,7 @@ DENG2_PIMPL(Partitioner)
             {
                 // Direction determines which edge of the line segment interfaces
                 // with the new half-plane intercept.
-                interceptPartition(seg, (fromDist < DIST_EPSILON? LineSegment::From : LineSegment::To));
+                interceptPartition(build, seg, (fromDist < DIST_EPSILON? LineSegment::From : LineSegment::To));
             }
             linkLineSegmentInBlockTree(rights, seg);
             break;
@@ -463,15 +662,15 @@ DENG2_PIMPL(Partitioner)
         case LeftIntercept:
             if(rel == LeftIntercept)
             {
-                interceptPartition(seg, (fromDist > -DIST_EPSILON? LineSegment::From : LineSegment::To));
+                interceptPartition(build, seg, (fromDist > -DIST_EPSILON? LineSegment::From : LineSegment::To));
             }
             linkLineSegmentInBlockTree(lefts, seg);
             break;
 
         case Intersects: {
             // Calculate the intersection point and split this line segment.
-            Vector2d point = intersectPartition(seg, fromDist, toDist);
-            LineSegmentSide &newFrontRight = splitLineSegment(seg, point);
+            Vector2d point = intersectPartition(hplane, seg, fromDist, toDist);
+            LineSegmentSide &newFrontRight = splitLineSegment(build, seg, point);
 
             // Ensure the new back left segment is inserted into the same block as
             // the old back right segment.
@@ -480,7 +679,7 @@ DENG2_PIMPL(Partitioner)
                 linkLineSegmentInBlockTree(*backLeftBlock, newFrontRight.back());
             }
 
-            interceptPartition(seg, LineSegment::To);
+            interceptPartition(build, seg, LineSegment::To);
 
             // Direction determines which subset the line segments are added to.
             if(fromDist < 0)
@@ -506,8 +705,8 @@ DENG2_PIMPL(Partitioner)
      * @param rights  Set of line segments on the right side of the partition.
      * @param lefts   Set of line segments on the left side of the partition.
      */
-    void divideSegments(LineSegmentBlockTreeNode &node, LineSegmentBlockTreeNode &rights,
-                        LineSegmentBlockTreeNode &lefts)
+    void divideSegments(SubtreeBuild &build, LineSegmentBlockTreeNode &node,
+                        LineSegmentBlockTreeNode &rights, LineSegmentBlockTreeNode &lefts)
     {
         /**
          * @todo Revise this algorithm so that @var segments is not modified
@@ -532,7 +731,7 @@ DENG2_PIMPL(Partitioner)
                     // Disassociate the line segment from the block tree.
                     seg->setBlockTreeNode(nullptr);
 
-                    divideOneSegment(*seg, rights, lefts);
+                    divideOneSegment(build, *seg, rights, lefts);
                 }
 
                 if(prev == cur->parentPtr())
@@ -578,9 +777,11 @@ DENG2_PIMPL(Partitioner)
      * @param rights  Set of line segments on the right of the partition.
      * @param lefts   Set of line segments on the left of the partition.
      */
-    void addPartitionLineSegments(LineSegmentBlockTreeNode &rights,
+    void addPartitionLineSegments(SubtreeBuild &build, LineSegmentBlockTreeNode &rights,
                                   LineSegmentBlockTreeNode &lefts)
     {
+        HPlane &hplane = build.hplane;
+
         LOG_TRACE("Building line segments along partition %s")
                 << hplane.partition().asText();
 
@@ -621,7 +822,7 @@ DENG2_PIMPL(Partitioner)
                 if(!cur.lineSegmentIsSelfReferencing())
                 {
                     Vector2d nearPoint = (cur.vertex().origin() + next.vertex().origin()) / 2;
-                    notifyUnclosedSectorFound(*cur.after(), nearPoint);
+                    build.unclosedSectors.append(UnclosedSector{ cur.after()->indexInMap(), nearPoint });
                 }
                 continue;
             }
@@ -631,7 +832,7 @@ DENG2_PIMPL(Partitioner)
                 if(!next.lineSegmentIsSelfReferencing())
                 {
                     Vector2d nearPoint = (cur.vertex().origin() + next.vertex().origin()) / 2;
-                    notifyUnclosedSectorFound(*next.before(), nearPoint);
+                    build.unclosedSectors.append(UnclosedSector{ next.before()->indexInMap(), nearPoint });
                 }
                 continue;
             }
@@ -673,12 +874,12 @@ DENG2_PIMPL(Partitioner)
 
             DENG2_ASSERT(sector);
 
-            LineSegment &newSeg = *makeLineSegment(fromVertex, toVertex,
+            LineSegment &newSeg = *makeLineSegment(build, fromVertex, toVertex,
                                                    sector, sector, nullptr /*no map line*/,
                                                    partSeg? &partSeg->mapLine() : nullptr);
 
-            edgeTipSet(newSeg.from()) << EdgeTip(newSeg.front());
-            edgeTipSet(newSeg.to())   << EdgeTip(newSeg.back());
+            addEdgeTip(build, newSeg.from(), EdgeTip(newSeg.front()));
+            addEdgeTip(build, newSeg.to(),   EdgeTip(newSeg.back()));
 
             // Add each new line segment to the appropriate set.
             linkLineSegmentInBlockTree(rights, newSeg.front());
@@ -841,9 +1042,15 @@ DENG2_PIMPL(Partitioner)
         return bounds;
     }
 
-    LineSegmentSide *choosePartition(LineSegmentBlockTreeNode &candidateSet)
+    LineSegmentSide *choosePartition(SubtreeBuild &build, LineSegmentBlockTreeNode &candidateSet)
     {
-        return PartitionEvaluator(splitCostFactor).choose(candidateSet);
+        if(!build.evaluator)
+        {
+            build.evaluator.reset(new PartitionEvaluator(splitCostFactor));
+        }
+        // A pool thread waiting for costing tasks could leave them queued forever.
+        build.evaluator->setConcurrent(!build.onPoolThread);
+        return build.evaluator->choose(candidateSet);
     }
 
     /**
@@ -861,12 +1068,13 @@ DENG2_PIMPL(Partitioner)
      * If the line segments on the right side are convex create another leaf
      * else put the line segments into the right list.
      *
-     * @param node  Tree node for the block containing the line segments to
-     *              be partitioned.
+     * @param build  State of the build of the subtree.
+     * @param node   Tree node for the block containing the line segments to
+     *               be partitioned.
      *
      * @return  Newly created BSP subtree; otherwise @c nullptr (degenerate).
      */
-    BspTree *partitionSpace(LineSegmentBlockTreeNode &node)
+    BspTree *partitionSpace(SubtreeBuild &build, LineSegmentBlockTreeNode &node)
     {
         LOG_AS("Partitioner::partitionSpace");
 
@@ -875,24 +1083,24 @@ DENG2_PIMPL(Partitioner)
         BspTree *leftBspTree   = nullptr;
 
         // Pick a line segment to use as the next partition plane.
-        if(LineSegmentSide *partSeg = choosePartition(node))
+        if(LineSegmentSide *partSeg = choosePartition(build, node))
         {
             // Reconfigure the half-plane for the next round of partitioning.
-            hplane.configure(*partSeg);
+            build.hplane.configure(*partSeg);
 
             /*
             LOG_TRACE("%s, segment side %p %i (segment #%i) %s %s")
-                    << hplane.partition().asText()
+                    << build.hplane.partition().asText()
                     << partSeg
                     << partSeg->lineSideId()
-                    << lineSegments.indexOf(&partSeg->line())
+                    << build.lineSegments.indexOf(&partSeg->line())
                     << partSeg->from().origin().asText()
                     << partSeg->to().origin().asText();
             */
 
             // Take a copy of the current partition - we'll need this for any
             // BspNode we produce later.
-            Partition partition(hplane.partition());
+            Partition partition(build.hplane.partition());
 
             // Create left and right block trees.
             /// @todo There should be no need to use additional independent
@@ -903,10 +1111,10 @@ DENG2_PIMPL(Partitioner)
             // Partition the line segements into two subsets according to their
             // spacial relationship with the half-plane (splitting any which
             // intersect).
-            divideSegments(node, rightTree, leftTree);
+            divideSegments(build, node, rightTree, leftTree);
             node.clear();
 
-            addPartitionLineSegments(rightTree, leftTree);
+            addPartitionLineSegments(build, rightTree, leftTree);
 
             // Take a copy of the geometry bounds for each child/sub space
             // - we'll need this for any BspNode we produce later.
@@ -914,8 +1122,16 @@ DENG2_PIMPL(Partitioner)
             AABoxd leftBounds  = segmentBounds(leftTree);
 
             // Recurse on each suspace, first the right space then left.
-            rightBspTree = partitionSpace(rightTree);
-            leftBspTree  = partitionSpace(leftTree);
+            if(rightTree.rootNode->userData()->totalCount() >= SUBTREE_MIN_SEGMENTS &&
+               leftTree.rootNode->userData()->totalCount()  >= SUBTREE_MIN_SEGMENTS)
+            {
+                buildHalfSpaces(build, rightTree, leftTree, rightBspTree, leftBspTree);
+            }
+            else
+            {
+                rightBspTree = partitionSpace(build, rightTree);
+                leftBspTree  = partitionSpace(build, leftTree);
+            }
 
             // Collapse degenerates upward.
             if(!rightBspTree || !leftBspTree)
@@ -930,8 +1146,8 @@ DENG2_PIMPL(Partitioner)
             LineSegmentSides segments = collectAllSegments(node);
             node.clear();
 
-            subspaces.append(ConvexSubspaceProxy());
-            ConvexSubspaceProxy &convexSet = subspaces.last();
+            build.subspaces.push_back(ConvexSubspaceProxy());
+            ConvexSubspaceProxy &convexSet = build.subspaces.back();
 
             convexSet.addSegments(segments);
 
@@ -962,6 +1178,340 @@ DENG2_PIMPL(Partitioner)
         return subtree;
     }
 
+    /**
+     * Build the subtrees of both half-spaces of a partition separately: the
+     * right half-space in a task (unless building serially) while the left one
+     * is built on the calling thread. The results are then merged into @a build
+     * in the same order as if the subtrees had been built one after the other.
+     */
+    void buildHalfSpaces(SubtreeBuild &build, LineSegmentBlockTreeNode &rights,
+                         LineSegmentBlockTreeNode &lefts, BspTree *&rightBspTree,
+                         BspTree *&leftBspTree)
+    {
+        Crossings const crossings = separateHalfSpaces(build, rights, lefts);
+
+        auto right = std::make_shared<HalfSpace>(*this, build, rights);
+        HalfSpace left(*this, build, lefts);
+
+        if(concurrent)
+        {
+            subtreeTasks.start(new HalfSpaceTask(right));
+        }
+
+        left.claim();
+        left.buildSubtree();
+
+        if(right->claim())
+        {
+            // Not picked up by the pool (yet); build it here instead.
+            right->buildSubtree();
+        }
+        else
+        {
+            right->done.wait();
+        }
+
+        joinHalfSpaces(build, crossings, right->build, left.build);
+
+        mergeSubtreeBuild(build, right->build);
+        mergeSubtreeBuild(build, left.build);
+
+        rightBspTree = right->tree;
+        leftBspTree  = left.tree;
+
+        if(!right->error.isEmpty()) throw Error("Partitioner::buildHalfSpaces", right->error);
+        if(!left.error.isEmpty())   throw Error("Partitioner::buildHalfSpaces", left.error);
+    }
+
+    /**
+     * Collect (without unlinking) all line segments at or beneath @a node.
+     */
+    static void collectSegments(LineSegmentBlockTreeNode const &node, LineSegmentSides &segments)
+    {
+        segments << node.userData()->all();
+        if(node.hasRight()) collectSegments(node.right(), segments);
+        if(node.hasLeft())  collectSegments(node.left(),  segments);
+    }
+
+    static LineSegmentBlockTreeNode const &blockTreeRoot(LineSegmentBlockTreeNode const &node)
+    {
+        LineSegmentBlockTreeNode const *root = &node;
+        while(root->parentPtr()) root = root->parentPtr();
+        return *root;
+    }
+
+    /**
+     * Splitting a line segment also splits its twin, so before the half-spaces
+     * of a partition can be built separately, any segment that has a side in a
+     * half-space and the twin of that side elsewhere (in the other half-space,
+     * in a subspace or still waiting to be partitioned) must be dealt with.
+     * Each such side is replaced in its block tree by the matching side of a
+     * clone of the segment, the other side of which is left out of the build.
+     * The original segment is not touched while the half-spaces are built, and
+     * is split to match the clones afterwards (see joinHalfSpaces()).
+     *
+     * @return  The line segments that were cloned.
+     */
+    Crossings separateHalfSpaces(SubtreeBuild &build, LineSegmentBlockTreeNode &rights,
+                                 LineSegmentBlockTreeNode &lefts)
+    {
+        // Find the crossing sides before any are replaced.
+        LineSegmentSides crossingSides;
+        LineSegmentBlockTreeNode *halves[2] = { &rights, &lefts };
+        for(LineSegmentBlockTreeNode *half : halves)
+        {
+            LineSegmentSides segments;
+            collectSegments(*half, segments);
+
+            for(LineSegmentSide *seg : segments)
+            {
+                LineSegmentSide const &twin = seg->back();
+                if(twin.convexSubspace() ||
+                   (twin.blockTreeNodePtr() &&
+                    &blockTreeRoot(*(LineSegmentBlockTreeNode *)twin.blockTreeNodePtr()) != half))
+                {
+                    crossingSides << seg;
+                }
+            }
+        }
+
+        Crossings crossings;
+        QHash<LineSegment *, int> crossingIds;
+        for(LineSegmentSide *seg : crossingSides)
+        {
+            LineSegment &orig = seg->line();
+
+            int id = crossingIds.value(&orig, -1);
+            if(id < 0)
+            {
+                id = crossings.count();
+                crossingIds.insert(&orig, id);
+                crossings << Crossing{ &orig, { nullptr, nullptr } };
+            }
+
+            LineSegment *clone = makeLineSegment(build, orig.from(), orig.to(),
+                                                 orig.front().sectorPtr(),
+                                                 orig.back().sectorPtr(),
+                                                 orig.front().mapSidePtr(),
+                                                 orig.front().partitionMapLine());
+            build.clonePieces.insert(clone, clone);
+            crossings[id].clones[seg->lineSideId()] = clone;
+
+            // The clone takes the place of the side in the block tree.
+            LineSegmentSide &standIn = clone->side(seg->lineSideId());
+            auto *node = (LineSegmentBlockTreeNode *)seg->blockTreeNodePtr();
+            node->userData()->replace(*seg, standIn);
+            standIn.setBlockTreeNode(node);
+            seg->setBlockTreeNode(nullptr);
+        }
+
+        return crossings;
+    }
+
+    /**
+     * Once both half-spaces have been built, the line segments cloned by
+     * separateHalfSpaces() are split at the vertexes where their clones were
+     * split, and the pieces take the place of the pieces of the clones in the
+     * convex subspaces. Vertexes made on both sides of the partition at the
+     * same point are welded together.
+     */
+    void joinHalfSpaces(SubtreeBuild &build, Crossings const &crossings,
+                        SubtreeBuild &right, SubtreeBuild &left)
+    {
+        if(crossings.isEmpty()) return;
+
+        SubtreeBuild *halves[2] = { &right, &left };
+
+        // Collect the pieces of each clone.
+        QHash<LineSegment *, LineSegments> clonePieces;
+        for(Crossing const &crossing : crossings)
+        for(LineSegment *clone : crossing.clones)
+        {
+            if(clone) clonePieces.insert(clone, LineSegments() << clone);
+        }
+        for(SubtreeBuild *half : halves)
+        for(LineSegment *seg : half->lineSegments)
+        {
+            LineSegment *clone = half->clonePieces.value(seg);
+            if(clone && clone != seg && clonePieces.contains(clone))
+            {
+                clonePieces[clone] << seg;
+            }
+        }
+
+        // Determine where to split each segment.
+        QList<QList<Vertex *>> splitPoints;
+        QHash<Vertex *, Vertex *> welds;
+        for(Crossing const &crossing : crossings)
+        {
+            LineSegment &orig = *crossing.segment;
+            Vector2d const direction = orig.toOrigin() - orig.fromOrigin();
+
+            struct SplitPoint
+            {
+                ddouble distance;
+                Vertex *vertex;
+                int side;
+            };
+            QList<SplitPoint> points;
+            for(int side = 0; side < 2; ++side)
+            {
+                if(!crossing.clones[side]) continue;
+
+                // The pieces keep the direction of the clone, so each vertex
+                // between two pieces is the end of exactly one of them.
+                for(LineSegment *piece : clonePieces[crossing.clones[side]])
+                {
+                    Vertex &vtx = piece->to();
+                    if(&vtx == &orig.to()) continue;
+
+                    points << SplitPoint{ (vtx.origin() - orig.fromOrigin()).dot(direction), &vtx, side };
+                }
+            }
+            std::stable_sort(points.begin(), points.end(), [] (SplitPoint const &a, SplitPoint const &b) {
+                return a.distance < b.distance;
+            });
+
+            QList<Vertex *> vertexes;
+            int lastSide = -1;
+            for(SplitPoint const &point : points)
+            {
+                if(!vertexes.isEmpty() && point.side != lastSide &&
+                   (point.vertex->origin() - vertexes.last()->origin()).length() < DIST_EPSILON)
+                {
+                    // Made on both sides; use the one already there.
+                    welds.insert(point.vertex, vertexes.last());
+                    continue;
+                }
+                vertexes << point.vertex;
+                lastSide = point.side;
+            }
+            splitPoints << vertexes;
+        }
+
+        if(!welds.isEmpty())
+        {
+            for(SubtreeBuild *half : halves)
+            {
+                for(LineSegment *seg : half->lineSegments)
+                for(int edge = 0; edge < 2; ++edge)
+                {
+                    if(Vertex *welded = welds.value(&seg->vertex(edge)))
+                    {
+                        seg->replaceVertex(edge, *welded);
+                    }
+                }
+                for(QPair<Vertex *, EdgeTip> &added : half->newEdgeTips)
+                {
+                    if(Vertex *welded = welds.value(added.first))
+                    {
+                        added.first = welded;
+                    }
+                }
+                for(int i = half->vertexes.count() - 1; i >= 0; --i)
+                {
+                    if(welds.contains(half->vertexes.at(i)))
+                    {
+                        delete half->vertexes.takeAt(i);
+                        half->vertexCount -= 1;
+                    }
+                }
+            }
+        }
+
+        for(int i = 0; i < crossings.count(); ++i)
+        {
+            Crossing const &crossing = crossings.at(i);
+
+            // Split the segment into pieces matching the clones.
+            LineSegments pieces;
+            pieces << crossing.segment;
+            for(Vertex *vtx : splitPoints.at(i))
+            {
+                LineSegmentSide &rest = splitLineSegment(build, pieces.last()->front(), *vtx,
+                                                         false /*the tips are already there*/);
+
+                // A twin waiting to be partitioned gets the new piece in the same block.
+                for(int side = 0; side < 2; ++side)
+                {
+                    LineSegmentSide &split = pieces.last()->side(side);
+                    if(auto *block = (LineSegmentBlockTreeNode *)split.blockTreeNodePtr())
+                    {
+                        linkLineSegmentInBlockTree(*block, rest.line().side(side));
+                    }
+                }
+                pieces << &rest.line();
+            }
+
+            // Replace the pieces of the clones in the convex subspaces.
+            for(int side = 0; side < 2; ++side)
+            {
+                if(!crossing.clones[side]) continue;
+
+                for(LineSegment *clonePiece : clonePieces[crossing.clones[side]])
+                {
+                    // Skip to the piece starting where the clone piece does.
+                    int next = 0;
+                    while(&pieces.at(next)->from() != &clonePiece->from()) next++;
+
+                    LineSegmentSides replacements;
+                    forever
+                    {
+                        LineSegment *piece = pieces.at(next++);
+                        replacements << &piece->side(side);
+                        if(&piece->to() == &clonePiece->to()) break;
+                    }
+                    if(side == LineSegment::Back)
+                    {
+                        std::reverse(replacements.begin(), replacements.end());
+                    }
+
+                    LineSegmentSide &standIn = clonePiece->side(side);
+                    ConvexSubspaceProxy *convexSet = standIn.convexSubspace();
+                    DENG2_ASSERT(convexSet);
+                    if(!convexSet) continue;
+
+                    convexSet->replaceSegment(standIn, replacements);
+                    for(LineSegmentSide *seg : replacements)
+                    {
+                        seg->setConvexSubspace(convexSet);
+                    }
+                    standIn.setConvexSubspace(nullptr);
+                }
+            }
+        }
+    }
+
+    /**
+     * Merge the results of building a half-space into the @a parent build.
+     */
+    void mergeSubtreeBuild(SubtreeBuild &parent, SubtreeBuild &half)
+    {
+        parent.lineSegments += half.lineSegments;
+        half.lineSegments.clear();
+
+        parent.subspaces.splice(parent.subspaces.end(), half.subspaces);
+
+        parent.vertexes += half.vertexes;
+        half.vertexes.clear();
+        parent.vertexCount += half.vertexCount;
+
+        for(QPair<Vertex *, EdgeTip> const &added : half.newEdgeTips)
+        {
+            addEdgeTip(parent, *added.first, added.second);
+        }
+
+        for(auto it = half.clonePieces.constBegin(); it != half.clonePieces.constEnd(); ++it)
+        {
+            parent.clonePieces.insert(it.key(), it.value());
+        }
+
+        parent.unclosedSectors += half.unclosedSectors;
+
+        // The evaluator's task pool belongs to this thread.
+        half.evaluator.reset();
+    }
+
     /**
      * Split any overlapping line segments in the convex subspaces, creating new
      * line segments (and vertices) as required. A subspace may well include such
@@ -972,7 +1522,7 @@ DENG2_PIMPL(Partitioner)
      */
     void splitOverlappingSegments()
     {
-        for(ConvexSubspaceProxy const &subspace : subspaces)
+        for(ConvexSubspaceProxy const &subspace : rootBuild->subspaces)
         {
             /*
              * The subspace provides a specially ordered list of the segments to
@@ -1017,7 +1567,7 @@ DENG2_PIMPL(Partitioner)
                            point == a.segment->to().origin())
                             continue;
 
-                        splitLineSegment(*a.segment, point, false /*don't update edge tips*/);
+                        splitLineSegment(*rootBuild, *a.segment, point, false /*don't update edge tips*/);
                     }
                 }
 
@@ -1026,9 +1576,22 @@ DENG2_PIMPL(Partitioner)
         }
     }
 
+    /**
+     * Give the vertexes built during the partitioning to the mesh.
+     */
+    void addNewVertexesToMesh()
+    {
+        for(Vertex *vtx : rootBuild->vertexes)
+        {
+            mesh->addVertex(*vtx);
+        }
+        rootBuild->vertexes.clear();
+        vertexCount = rootBuild->vertexCount;
+    }
+
     void buildSubspaceGeometries()
     {
-        for(ConvexSubspaceProxy const &subspace : subspaces)
+        for(ConvexSubspaceProxy const &subspace : rootBuild->subspaces)
         {
             /// @todo Move BSP leaf construction here?
             BspLeaf &bspLeaf = *subspace.bspLeaf();
@@ -1051,7 +1614,7 @@ DENG2_PIMPL(Partitioner)
          * Finalize the built geometry by adding a twin half-edge for any
          * which don't yet have one.
          */
-        for(ConvexSubspaceProxy const &convexSet : subspaces)
+        for(ConvexSubspaceProxy const &convexSet : rootBuild->subspaces)
         for(OrderedSegment const &oseg : convexSet.segments())
         {
             LineSegmentSide *seg = oseg.segment;
@@ -1082,19 +1645,640 @@ DENG2_PIMPL(Partitioner)
         }
     }
 
-#ifdef DENG2_DEBUG
-    void printSegments(LineSegmentSides const &allSegs)
+    /**
+     * Partition the geometry of the lines, producing the BSP tree and the convex
+     * subspaces (but no map geometry yet).
+     */
+    BspTree *partitionLines()
     {
-        for(LineSegmentSide const *seg : allSegs)
+        // Determine the bounds of the line geometry.
+        AABoxd bounds;
+        bool isFirst = true;
+        for(Line *line : lines)
         {
-            LOG_DEBUG("Build: %s line segment %p sector: %d %s -> %s")
-                    << (seg->hasMapSide()? "map" : "part")
-                    << seg
-                    << (seg->hasSector()? seg->sector().indexInMap() : -1)
-                    << seg->from().origin().asText() << seg->to().origin().asText();
+            if(isFirst)
+            {
+                // The first line's bounds are used as is.
+                V2d_CopyBox(bounds.arvec2, line->aaBox().arvec2);
+                isFirst = false;
+            }
+            else
+            {
+                // Expand the bounding box.
+                V2d_UniteBox(bounds.arvec2, line->aaBox().arvec2);
+            }
         }
-    }
-#endif
+
+        LineSegmentBlockTree blockTree(blockmapBounds(bounds));
+
+        createInitialLineSegments(*rootBuild, blockTree);
+
+        BspTree *root = partitionSpace(*rootBuild, blockTree);
+
+        // At this point we know that *something* useful was built.
+        splitOverlappingSegments();
+
+        return root;
+    }
+
+    static AABox blockmapBounds(AABoxd const &mapBounds)
+    {
+        AABox mapBoundsi;
+        mapBoundsi.minX = int( de::floor(mapBounds.minX) );
+        mapBoundsi.minY = int( de::floor(mapBounds.minY) );
+        mapBoundsi.maxX = int(  de::ceil(mapBounds.maxX) );
+        mapBoundsi.maxY = int(  de::ceil(mapBounds.maxY) );
+
+        AABox blockBounds;
+        blockBounds.minX = mapBoundsi.minX - (mapBoundsi.minX & 0x7);
+        blockBounds.minY = mapBoundsi.minY - (mapBoundsi.minY & 0x7);
+        int bw = ((mapBoundsi.maxX - blockBounds.minX) / 128) + 1;
+        int bh = ((mapBoundsi.maxY - blockBounds.minY) / 128) + 1;
+
+        blockBounds.maxX = blockBounds.minX + 128 * M_CeilPow2(bw);
+        blockBounds.maxY = blockBounds.minY + 128 * M_CeilPow2(bh);
+        return blockBounds;
+    }
+
+    static bool lineIndexLessThan(Line const *a, Line const *b)
+    {
+         return a->indexInMap() < b->indexInMap();
+    }
+
+    /**
+     * Copy the set of lines and sort by index to ensure deterministically
+     * predictable output.
+     */
+    void setLines(LineSet const &lineSet)
+    {
+        lines = lineSet.toList();
+        qSort(lines.begin(), lines.end(), lineIndexLessThan);
+
+        // Initialize vertex info for the initial set of vertexes.
+        rootBuild->edgeTipSets.reserve(lines.count() * 2);
+    }
+
+    /**
+     * Checksum of the partitioned geometry (cf. Partitioner::partitionChecksum()).
+     */
+    Block partitionChecksum(BspTree const *root) const
+    {
+        QHash<BspLeaf const *, ConvexSubspaceProxy const *> leafSubspaces;
+        for(ConvexSubspaceProxy const &subspace : rootBuild->subspaces)
+        {
+            leafSubspaces.insert(subspace.bspLeaf(), &subspace);
+        }
+
+        Block data;
+        Writer writer(data);
+        writer << dint32(rootBuild->vertexCount) << dint32(rootBuild->subspaces.size());
+        for(UnclosedSector const &unclosed : rootBuild->unclosedSectors)
+        {
+            writer << unclosed.sector << unclosed.nearPoint.x << unclosed.nearPoint.y;
+        }
+        writeChecksumTree(writer, root, leafSubspaces);
+
+        return QCryptographicHash::hash(data, QCryptographicHash::Md5);
+    }
+
+    static void writeChecksumTree(Writer &writer, BspTree const *tree,
+        QHash<BspLeaf const *, ConvexSubspaceProxy const *> const &leafSubspaces)
+    {
+        if(!tree || !tree->userData())
+        {
+            writer << duchar(0);
+            return;
+        }
+        if(tree->isLeaf())
+        {
+            ConvexSubspaceProxy const *subspace = leafSubspaces.value(&tree->userData()->as<BspLeaf>());
+            writer << duchar(1) << dint32(subspace? subspace->segmentCount() : -1);
+            if(!subspace) return;
+
+            for(OrderedSegment const &oseg : subspace->segments())
+            {
+                LineSegmentSide const &seg = *oseg.segment;
+                writer << seg.from().origin().x << seg.from().origin().y
+                       << seg.to  ().origin().x << seg.to  ().origin().y
+                       << dint32(seg.hasSector()? seg.sector().indexInMap() : -1)
+                       << dint32(seg.hasMapSide()? seg.mapLine().indexInMap() : -1);
+            }
+            return;
+        }
+
+        auto const &node = tree->userData()->as<BspNode>();
+        writer << duchar(2)
+               << node.partition().direction.x << node.partition().direction.y
+               << node.partition().origin.x    << node.partition().origin.y;
+        writeAABox(writer, node.rightAABox());
+        writeAABox(writer, node.leftAABox());
+        writeChecksumTree(writer, tree->rightPtr(), leafSubspaces);
+        writeChecksumTree(writer, tree->leftPtr(),  leafSubspaces);
+    }
+
+
+    /**
+     * Determine the node cache file for the current input geometry. The name
+     * is a checksum of everything the partitioner consumes, so any change to
+     * the lines, their vertexes or sectors (or to the split cost factor)
+     * produces a different file.
+     */
+    NativePath cacheFilePath() const
+    {
+        Block data;
+        Writer writer(data);
+        writer << NODECACHE_VERSION << dint32(splitCostFactor) << dint32(mesh->vertexCount());
+        for(Line const *line : lines)
+        {
+            Sector const *backSec = line->backSectorPtr();
+            if(!backSec) backSec = line->_bspWindowSector;
+
+            writer << dint32(line->indexInMap())
+                   << dint32(line->from().indexInMap()) << line->fromOrigin().x << line->fromOrigin().y
+                   << dint32(line->to  ().indexInMap()) << line->toOrigin  ().x << line->toOrigin  ().y
+                   << dint32(line->hasFrontSector()? line->frontSectorPtr()->indexInMap() : -1)
+                   << dint32(backSec? backSec->indexInMap() : -1);
+        }
+        String const name = String::fromLatin1(QCryptographicHash::hash(data, QCryptographicHash::Md5).toHex());
+        return cachePath / (name + ".bsp");
+    }
+
+    static void writeAABox(Writer &writer, AABoxd const &box)
+    {
+        writer << box.minX << box.minY << box.maxX << box.maxY;
+    }
+
+    static void readAABox(Reader &reader, AABoxd &box)
+    {
+        reader >> box.minX >> box.minY >> box.maxX >> box.maxY;
+    }
+
+    /**
+     * Write the results of the build to the node cache. Everything needed to
+     * reconstruct the output is included: new vertexes, the face geometry of
+     * each convex subspace (including any "extra" meshes), half-edge twins,
+     * the BSP tree itself and any unclosed sectors found along the way.
+     */
+    void writeCache(NativePath const &path, dint firstNewVertex)
+    {
+        Block data;
+        Writer writer(data);
+
+        writer << NODECACHE_MAGIC << NODECACHE_VERSION
+               << dint32(segmentCount) << dint32(vertexCount);
+
+        QHash<Vertex const *, dint32> vertexIds;
+        for(dint i = 0; i < mesh->vertexCount(); ++i)
+        {
+            vertexIds.insert(mesh->vertexs().at(i), i);
+        }
+
+        writer << dint32(firstNewVertex) << dint32(mesh->vertexCount() - firstNewVertex);
+        for(dint i = firstNewVertex; i < mesh->vertexCount(); ++i)
+        {
+            Vector2d const &origin = mesh->vertexs().at(i)->origin();
+            writer << origin.x << origin.y;
+        }
+
+        writer << dint32(rootBuild->unclosedSectors.count());
+        for(UnclosedSector const &unclosed : rootBuild->unclosedSectors)
+        {
+            writer << unclosed.sector << unclosed.nearPoint.x << unclosed.nearPoint.y;
+        }
+
+        // Number the BSP leafs and the half-edges of their face geometries.
+        QHash<BspLeaf const *, dint32> leafIds;
+        QHash<HEdge const *, dint32> hedgeIds;
+        QList<HEdge const *> hedges;
+
+        writer << dint32(rootBuild->subspaces.size());
+        for(ConvexSubspaceProxy const &subspace : rootBuild->subspaces)
+        {
+            BspLeaf const &leaf = *subspace.bspLeaf();
+            leafIds.insert(&leaf, leafIds.count());
+
+            // The primary face (if any) comes first.
+            QList<Face const *> faces;
+            if(leaf.hasSubspace())
+            {
+                faces << &leaf.subspace().poly();
+            }
+            for(OrderedSegment const &oseg : subspace.segments())
+            {
+                if(!oseg.segment->hasHEdge()) continue;
+                Face const *face = &oseg.segment->hedge().face();
+                if(!faces.contains(face)) faces << face;
+            }
+
+            writer << dint32(leaf.sectorPtr()? leaf.sectorPtr()->indexInMap() : -1)
+                   << duchar(leaf.hasSubspace()) << dint32(faces.count());
+
+            for(Face const *face : faces)
+            {
+                writer << dint32(face->hedgeCount());
+
+                HEdge const *base  = face->hedge();
+                HEdge const *hedge = base;
+                do
+                {
+                    hedgeIds.insert(hedge, hedges.count());
+                    hedges << hedge;
+
+                    writer << vertexIds[&hedge->vertex()];
+                    if(hedge->hasMapElement())
+                    {
+                        LineSide const &side = hedge->mapElementAs<LineSideSegment>().lineSide();
+                        writer << dint32(side.line().indexInMap()) << duchar(side.sideId());
+                    }
+                    else
+                    {
+                        writer << dint32(-1) << duchar(0);
+                    }
+                } while((hedge = &hedge->next()) != base);
+            }
+        }
+
+        // Half-edge twins. Twins without a face are created on load.
+        for(HEdge const *hedge : hedges)
+        {
+            if(!hedge->hasTwin())
+            {
+                writer << dint32(-1);
+            }
+            else if(!hedge->twin().hasFace())
+            {
+                writer << dint32(-2) << vertexIds[&hedge->twin().vertex()];
+            }
+            else
+            {
+                writer << hedgeIds[&hedge->twin()];
+            }
+        }
+
+        writeTree(writer, bspRoot, leafIds);
+
+        QDir().mkpath(cachePath.toString());
+        QFile file(path.toString());
+        if(!file.open(QFile::WriteOnly | QFile::Truncate))
+        {
+            LOG_MAP_WARNING("Failed to write node cache \"%s\"") << path.pretty();
+            return;
+        }
+        file.write(data);
+    }
+
+    static void writeTree(Writer &writer, BspTree const *tree,
+                          QHash<BspLeaf const *, dint32> const &leafIds)
+    {
+        if(!tree || !tree->userData())
+        {
+            writer << duchar(0);
+            return;
+        }
+        if(tree->isLeaf())
+        {
+            writer << duchar(1) << leafIds[&tree->userData()->as<BspLeaf>()];
+            return;
+        }
+
+        auto const &node = tree->userData()->as<BspNode>();
+        writer << duchar(2)
+               << node.partition().direction.x << node.partition().direction.y
+               << node.partition().origin.x    << node.partition().origin.y;
+        writeAABox(writer, node.rightAABox());
+        writeAABox(writer, node.leftAABox());
+        writeTree(writer, tree->rightPtr(), leafIds);
+        writeTree(writer, tree->leftPtr(),  leafIds);
+    }
+
+    /// Cached data is parsed in full before any map geometry is produced.
+    struct CachedHEdge
+    {
+        dint32 vertex;
+        dint32 line;
+        duchar side;
+        dint32 twin;
+        dint32 twinVertex;
+    };
+    struct CachedFace
+    {
+        dint32 firstHEdge;
+        dint32 hedgeCount;
+    };
+    struct CachedLeaf
+    {
+        dint32 sector;
+        bool hasSubspace;
+        QList<CachedFace> faces;
+    };
+    struct CachedTreeNode
+    {
+        duchar type;
+        dint32 leaf;
+        Partition partition;
+        AABoxd rightBounds, leftBounds;
+    };
+
+    void readTree(Reader &reader, QList<CachedTreeNode> &nodes, dint leafCount)
+    {
+        CachedTreeNode node;
+        reader >> node.type;
+        switch(node.type)
+        {
+        case 0: break;
+
+        case 1:
+            reader >> node.leaf;
+            if(node.leaf < 0 || node.leaf >= leafCount) throw Error("Partitioner::readTree", "Invalid leaf");
+            break;
+
+        case 2:
+            reader >> node.partition.direction.x >> node.partition.direction.y
+                   >> node.partition.origin.x    >> node.partition.origin.y;
+            readAABox(reader, node.rightBounds);
+            readAABox(reader, node.leftBounds);
+            break;
+
+        default:
+            throw Error("Partitioner::readTree", "Invalid tree node");
+        }
+        nodes << node;
+
+        if(node.type == 2)
+        {
+            readTree(reader, nodes, leafCount);  // right
+            readTree(reader, nodes, leafCount);  // left
+        }
+    }
+
+    BspTree *buildTree(QList<CachedTreeNode> const &nodes, dint &cursor,
+                       QList<BspLeaf *> const &leafs)
+    {
+        CachedTreeNode const &node = nodes.at(cursor++);
+        if(node.type == 0) return nullptr;
+        if(node.type == 1) return new BspTree(leafs.at(node.leaf));
+
+        auto *bspNode = new BspNode(node.partition, node.rightBounds, node.leftBounds);
+        BspTree *rightBspTree = buildTree(nodes, cursor, leafs);
+        BspTree *leftBspTree  = buildTree(nodes, cursor, leafs);
+
+        BspTree *subtree = new BspTree(bspNode, nullptr/*no parent*/, rightBspTree, leftBspTree);
+        if(rightBspTree) rightBspTree->setParent(subtree);
+        if(leftBspTree)  leftBspTree->setParent(subtree);
+        return subtree;
+    }
+
+    /**
+     * Attempt to reproduce a previous build from the node cache.
+     *
+     * @return  Root of the reconstructed BSP; otherwise @c nullptr if the
+     * cache is missing, outdated or malformed (nothing is changed).
+     */
+    BspTree *readCache(NativePath const &path)
+    {
+        QFile file(path.toString());
+        if(!file.open(QFile::ReadOnly)) return nullptr;
+
+        Block const data(file.readAll());
+        Reader reader(data);
+
+        Map &map = lines.first()->map();
+        dint32 const vertexLimit = mesh->vertexCount();
+
+        duint32 magic;
+        dint32 version, cachedSegmentCount, cachedVertexCount;
+        dint32 firstNewVertex, newVertexCount;
+        QList<Vector2d> newVertexes;
+        QList<UnclosedSector> cachedUnclosed;
+        QList<CachedLeaf> leafs;
+        QList<CachedHEdge> hedges;
+        QList<CachedTreeNode> nodes;
+
+        try
+        {
+            reader >> magic >> version;
+            if(magic != NODECACHE_MAGIC || version != NODECACHE_VERSION)
+                return nullptr;
+
+            reader >> cachedSegmentCount >> cachedVertexCount;
+
+            reader >> firstNewVertex >> newVertexCount;
+            if(firstNewVertex != vertexLimit || newVertexCount < 0)
+                return nullptr;
+            for(dint i = 0; i < newVertexCount; ++i)
+            {
+                Vector2d origin;
+                reader >> origin.x >> origin.y;
+                newVertexes << origin;
+            }
+            dint32 const vertexTotal = vertexLimit + newVertexCount;
+
+            dint32 count;
+            reader >> count;
+            for(dint i = 0; i < count; ++i)
+            {
+                UnclosedSector unclosed;
+                reader >> unclosed.sector >> unclosed.nearPoint.x >> unclosed.nearPoint.y;
+                if(!map.sectorPtr(unclosed.sector)) throw Error("Partitioner::readCache", "Invalid sector");
+                cachedUnclosed << unclosed;
+            }
+
+            reader >> count;
+            for(dint i = 0; i < count; ++i)
+            {
+                CachedLeaf leaf;
+                duchar hasSubspace;
+                dint32 faceCount;
+                reader >> leaf.sector >> hasSubspace >> faceCount;
+                leaf.hasSubspace = hasSubspace != 0;
+                if(leaf.sector >= 0 && !map.sectorPtr(leaf.sector))
+                    throw Error("Partitioner::readCache", "Invalid sector");
+                if(leaf.hasSubspace && faceCount < 1)
+                    throw Error("Partitioner::readCache", "Missing subspace face");
+
+                for(dint k = 0; k < faceCount; ++k)
+                {
+                    CachedFace face;
+                    face.firstHEdge = hedges.count();
+                    reader >> face.hedgeCount;
+                    if(face.hedgeCount < 1) throw Error("Partitioner::readCache", "Invalid face");
+
+                    for(dint m = 0; m < face.hedgeCount; ++m)
+                    {
+                        CachedHEdge hedge;
+                        reader >> hedge.vertex >> hedge.line >> hedge.side;
+                        if(hedge.vertex < 0 || hedge.vertex >= vertexTotal ||
+                           (hedge.line >= 0 && !map.linePtr(hedge.line)) || hedge.side > 1)
+                            throw Error("Partitioner::readCache", "Invalid half-edge");
+                        hedge.twin = hedge.twinVertex = -1;
+                        hedges << hedge;
+                    }
+                    leaf.faces << face;
+                }
+                leafs << leaf;
+            }
+
+            for(CachedHEdge &hedge : hedges)
+            {
+                reader >> hedge.twin;
+                if(hedge.twin == -2)
+                {
+                    reader >> hedge.twinVertex;
+                    if(hedge.twinVertex < 0 || hedge.twinVertex >= vertexTotal)
+                        throw Error("Partitioner::readCache", "Invalid half-edge twin");
+                }
+                else if(hedge.twin < -1 || hedge.twin >= hedges.count())
+                {
+                    throw Error("Partitioner::readCache", "Invalid half-edge twin");
+                }
+            }
+
+            readTree(reader, nodes, leafs.count());
+        }
+        catch(Error const &er)
+        {
+            LOG_MAP_WARNING("Ignoring node cache \"%s\": %s") << path.pretty() << er.asText();
+            return nullptr;
+        }
+
+        /*
+         * The cached data is valid; reconstruct the geometry.
+         */
+        for(Vector2d const &origin : newVertexes)
+        {
+            mesh->newVertex(origin);
+        }
+
+        QVector<HEdge *> builtHEdges(hedges.count());
+        QList<BspLeaf *> builtLeafs;
+        for(CachedLeaf const &cached : leafs)
+        {
+            BspLeaf *leaf = new BspLeaf(cached.sector >= 0? map.sectorPtr(cached.sector) : nullptr);
+            builtLeafs << leaf;
+
+            QVarLengthArray<Mesh *, 2> extraMeshes;
+            for(dint k = 0; k < cached.faces.count(); ++k)
+            {
+                CachedFace const &cachedFace = cached.faces.at(k);
+
+                // The primary face is built from the map mesh; any others are "extra" meshes.
+                Mesh *faceMesh = mesh;
+                if(k > 0 || !cached.hasSubspace)
+                {
+                    faceMesh = new Mesh;
+                    extraMeshes.append(faceMesh);
+                }
+
+                Face *face   = faceMesh->newFace();
+                HEdge *prev  = nullptr;
+                for(dint m = 0; m < cachedFace.hedgeCount; ++m)
+                {
+                    dint const id = cachedFace.firstHEdge + m;
+                    CachedHEdge const &cachedHEdge = hedges.at(id);
+
+                    HEdge *hedge = faceMesh->newHEdge(*mesh->vertexs().at(cachedHEdge.vertex));
+                    builtHEdges[id] = hedge;
+
+                    if(cachedHEdge.line >= 0)
+                    {
+                        map.line(cachedHEdge.line).side(cachedHEdge.side).addSegment(*hedge);
+                    }
+
+                    /// @todo Face should encapsulate.
+                    face->_hedgeCount += 1;
+                    hedge->setFace(face);
+
+                    if(prev)
+                    {
+                        prev->setNext(hedge);
+                        hedge->setPrev(prev);
+                    }
+                    else
+                    {
+                        face->setHEdge(hedge);
+                    }
+                    prev = hedge;
+                }
+
+                // Close the ring.
+                prev->setNext(face->hedge());
+                face->hedge()->setPrev(prev);
+
+                face->updateAABox();
+                face->updateCenter();
+
+                if(k == 0 && cached.hasSubspace)
+                {
+                    // Assign a new convex subspace to the BSP leaf (takes ownership).
+                    leaf->setSubspace(ConvexSubspace::newFromConvexPoly(*face));
+                }
+            }
+
+            if(leaf->hasSubspace())
+            {
+                // Assign any extra meshes to the subspace (takes ownership).
+                for(Mesh *extraMesh : extraMeshes)
+                {
+                    leaf->subspace().assignExtraMesh(*extraMesh);
+                }
+            }
+        }
+
+        // Link the twins.
+        for(dint i = 0; i < hedges.count(); ++i)
+        {
+            HEdge *hedge = builtHEdges[i];
+            CachedHEdge const &cachedHEdge = hedges.at(i);
+            if(hedge->hasTwin() || cachedHEdge.twin == -1) continue;
+
+            HEdge *twin = (cachedHEdge.twin == -2? hedge->mesh().newHEdge(*mesh->vertexs().at(cachedHEdge.twinVertex))
+                                                 : builtHEdges[cachedHEdge.twin]);
+            hedge->setTwin(twin);
+            twin->setTwin(hedge);
+        }
+
+#ifdef __CLIENT__
+        // Segment geometry is derived from the half-edges.
+        for(HEdge *hedge : builtHEdges)
+        {
+            if(!hedge->hasMapElement()) continue;
+
+            LineSideSegment &seg = hedge->mapElementAs<LineSideSegment>();
+            seg.setLineSideOffset(Vector2d(seg.lineSide().from().origin() - hedge->origin()).length());
+            if(hedge->hasTwin())
+            {
+                seg.setLength(Vector2d(hedge->twin().origin() - hedge->origin()).length());
+            }
+        }
+#endif
+
+        dint cursor = 0;
+        BspTree *root = buildTree(nodes, cursor, builtLeafs);
+
+        segmentCount = cachedSegmentCount;
+        vertexCount  = cachedVertexCount;
+
+        for(UnclosedSector const &unclosed : cachedUnclosed)
+        {
+            notifyUnclosedSectorFound(map.sector(unclosed.sector), unclosed.nearPoint);
+        }
+
+        return root;
+    }
+
+#ifdef DENG2_DEBUG
+    void printSegments(LineSegmentSides const &allSegs)
+    {
+        for(LineSegmentSide const *seg : allSegs)
+        {
+            LOG_DEBUG("Build: %s line segment %p sector: %d %s -> %s")
+                    << (seg->hasMapSide()? "map" : "part")
+                    << seg
+                    << (seg->hasSector()? seg->sector().indexInMap() : -1)
+                    << seg->from().origin().asText() << seg->to().origin().asText();
+        }
+    }
+#endif
 };
 
 Partitioner::Partitioner(int splitCostFactor) : d(new Instance(this))
@@ -1107,73 +2291,78 @@ void Partitioner::setSplitCostFactor(int newFactor)
     d->splitCostFactor = newFactor;
 }
 
-static AABox blockmapBounds(AABoxd const &mapBounds)
-{
-    AABox mapBoundsi;
-    mapBoundsi.minX = int( de::floor(mapBounds.minX) );
-    mapBoundsi.minY = int( de::floor(mapBounds.minY) );
-    mapBoundsi.maxX = int(  de::ceil(mapBounds.maxX) );
-    mapBoundsi.maxY = int(  de::ceil(mapBounds.maxY) );
-
-    AABox blockBounds;
-    blockBounds.minX = mapBoundsi.minX - (mapBoundsi.minX & 0x7);
-    blockBounds.minY = mapBoundsi.minY - (mapBoundsi.minY & 0x7);
-    int bw = ((mapBoundsi.maxX - blockBounds.minX) / 128) + 1;
-    int bh = ((mapBoundsi.maxY - blockBounds.minY) / 128) + 1;
-
-    blockBounds.maxX = blockBounds.minX + 128 * M_CeilPow2(bw);
-    blockBounds.maxY = blockBounds.minY + 128 * M_CeilPow2(bh);
-    return blockBounds;
-}
-
-static bool lineIndexLessThan(Line const *a, Line const *b)
-{
-     return a->indexInMap() < b->indexInMap();
-}
-
 Partitioner::BspTree *Partitioner::makeBspTree(LineSet const &lines, Mesh &mesh)
 {
     d->clear();
-
-    // Copy the set of lines and sort by index to ensure deterministically
-    // predictable output.
-    d->lines = lines.toList();
-    qSort(d->lines.begin(), d->lines.end(), lineIndexLessThan);
-
+    d->setLines(lines);
     d->mesh = &mesh;
 
-    // Initialize vertex info for the initial set of vertexes.
-    d->edgeTipSets.reserve(d->lines.count() * 2);
-
-    // Determine the bounds of the line geometry.
-    AABoxd bounds;
-    bool isFirst = true;
-    for(Line *line : d->lines)
+    // Perhaps this geometry has been partitioned before?
+    NativePath cacheFile;
+    if(!d->cachePath.isEmpty() && !d->lines.isEmpty())
     {
-        if(isFirst)
+        cacheFile = d->cacheFilePath();
+        if((d->bspRoot = d->readCache(cacheFile)))
         {
-            // The first line's bounds are used as is.
-            V2d_CopyBox(bounds.arvec2, line->aaBox().arvec2);
-            isFirst = false;
+            LOGDEV_MAP_VERBOSE("Loaded BSP from node cache \"%s\"") << cacheFile.pretty();
+            return d->bspRoot;
         }
-        else
+    }
+
+    dint const firstNewVertex = mesh.vertexCount();
+
+    d->bspRoot = d->partitionLines();
+    d->addNewVertexesToMesh();
+    d->buildSubspaceGeometries();
+
+    if(!d->lines.isEmpty())
+    {
+        Map &map = d->lines.first()->map();
+        for(Instance::UnclosedSector const &unclosed : d->rootBuild->unclosedSectors)
         {
-            // Expand the bounding box.
-            V2d_UniteBox(bounds.arvec2, line->aaBox().arvec2);
+            d->notifyUnclosedSectorFound(map.sector(unclosed.sector), unclosed.nearPoint);
         }
     }
 
-    Instance::LineSegmentBlockTree blockTree(blockmapBounds(bounds));
+    if(!cacheFile.isEmpty() && d->bspRoot)
+    {
+        d->writeCache(cacheFile, firstNewVertex);
+    }
 
-    d->createInitialLineSegments(blockTree);
+    return d->bspRoot;
+}
 
-    d->bspRoot = d->partitionSpace(blockTree);
+Block Partitioner::partitionChecksum(LineSet const &lines)
+{
+    d->clear();
+    d->setLines(lines);
 
-    // At this point we know that *something* useful was built.
-    d->splitOverlappingSegments();
-    d->buildSubspaceGeometries();
+    // The vertexes are never added to this mesh.
+    Mesh scratch;
+    d->mesh = &scratch;
 
-    return d->bspRoot;
+    BspTree *root = d->partitionLines();
+    Block const checksum = d->partitionChecksum(root);
+
+    // Discard everything that was built.
+    if(root)
+    {
+        root->traversePostOrder(Instance::clearBspElementWorker);
+        delete root;
+    }
+    d->clear();
+
+    return checksum;
+}
+
+void Partitioner::setConcurrent(bool yes)
+{
+    d->concurrent = yes;
+}
+
+void Partitioner::setCachePath(NativePath const &folder)
+{
+    d->cachePath = folder;
 }
 
 int Partitioner::segmentCount()
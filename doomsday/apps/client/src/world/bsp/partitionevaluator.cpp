@@ -22,18 +22,27 @@
  */
 
 #include "world/bsp/partitionevaluator.h"
-#include <QList>
+#include <QThread>
+#include <QVector>
+#include <de/FlatHashMap>
 #include <de/Log>
 #include <de/Task>
 #include <de/TaskPool>
 #include "world/bsp/partitioner.h"
-#include "world/worldsystem.h" // validCount
+#include "Line"
 
 namespace de {
 namespace bsp {
 
 namespace internal
 {
+    /// Below this many segment tests (candidates * segments) the candidates
+    /// are costed on the calling thread; the fork/join would cost more.
+    static int const SERIAL_COSTING_LIMIT = 16384;
+
+    /// Minimum number of candidates costed by each task.
+    static int const MIN_CANDIDATES_PER_TASK = 8;
+
     struct PartitionCost
     {
         int total     = 0;
@@ -172,37 +181,48 @@ using namespace internal;
 DENG2_PIMPL_NOREF(PartitionEvaluator)
 {
     int splitCostFactor = 7;
+    bool concurrent = true;  ///< Candidates may be costed in tasks.
 
     LineSegmentBlockTreeNode *rootNode = nullptr; ///< Current block tree root node.
+    FlatHashSet<Line const *> testedLines;        ///< Lines with a candidate this round.
 
     struct PartitionCandidate
     {
-        LineSegmentSide *line;  ///< Candidate partition line.
-        PartitionCost cost;     ///< Running cost metric total.
+        LineSegmentSide *line = nullptr;  ///< Candidate partition line.
+        PartitionCost cost;               ///< Running cost metric total.
 
+        PartitionCandidate() {}
         PartitionCandidate(LineSegmentSide &partition) : line(&partition)
         {}
     };
-    typedef QList<PartitionCandidate *> Candidates;
+    typedef QVector<PartitionCandidate> Candidates;
     Candidates candidates;
 
-    PartitionCandidate *nextCandidate()
-    {
-        DENG2_ASSERT(costTaskPool.isDone());
-        if(candidates.isEmpty()) return nullptr;
-        return candidates.takeFirst();
-    }
-
+    /**
+     * Evaluates the costs of a contiguous range of the candidates. Each range
+     * is independent of the others, so the ranges may be costed concurrently.
+     */
     class CostTask : public Task
     {
     public:
         Instance &evaluator;
-        PartitionCandidate &candidate;
+        PartitionCandidate *first;
+        PartitionCandidate *last;
+        PartitionCandidate *candidate = nullptr;  ///< Currently being costed.
 
-        CostTask(Instance &evaluator, PartitionCandidate &candidate)
-            : evaluator(evaluator), candidate(candidate)
+        CostTask(Instance &evaluator, PartitionCandidate *first, PartitionCandidate *last)
+            : evaluator(evaluator), first(first), last(last)
         {}
 
+        void runTask()
+        {
+            for(candidate = first; candidate != last; ++candidate)
+            {
+                evaluateCandidate();
+            }
+        }
+
+    private:
         /**
          * Evaluate the cost of the partition candidate.
          *
@@ -210,10 +230,10 @@ DENG2_PIMPL_NOREF(PartitionEvaluator)
          * determined) then @var partition is zeroed. Otherwise the candidate is
          * suitable and @var cost contains valid costing metrics.
          */
-        void runTask()
+        void evaluateCandidate()
         {
-            LineSegmentSide **partition = &candidate.line;
-            PartitionCost &cost         = candidate.cost;
+            LineSegmentSide **partition = &candidate->line;
+            PartitionCost &cost         = candidate->cost;
 
             costForBlock(*evaluator.rootNode);
 
@@ -244,11 +264,10 @@ DENG2_PIMPL_NOREF(PartitionEvaluator)
             }
         }
 
-    private:
         void costForSegment(LineSegmentSide const &seg)
         {
-            LineSegmentSide **partition = &candidate.line;
-            PartitionCost &cost         = candidate.cost;
+            LineSegmentSide **partition = &candidate->line;
+            PartitionCost &cost         = candidate->cost;
             int const splitCostFactor   = evaluator.splitCostFactor;
 
             /// Determine the relationship between @a seg and the partition plane.
@@ -331,8 +350,8 @@ DENG2_PIMPL_NOREF(PartitionEvaluator)
         void costForBlock(LineSegmentBlockTreeNode const &node)
         {
             LineSegmentBlock const &block    = *node.userData();
-            LineSegmentSide const *partition = candidate.line;
-            PartitionCost &cost              = candidate.cost;
+            LineSegmentSide const *partition = candidate->line;
+            PartitionCost &cost              = candidate->cost;
 
             /// @todo Why are we extending the bounding box for this test? Also,
             /// there is no need to convert from integer to floating-point each
@@ -377,15 +396,32 @@ DENG2_PIMPL_NOREF(PartitionEvaluator)
     TaskPool costTaskPool;
 
     /**
-     * @param line  Partition line to evaluate.
+     * Determine the costs of all the candidates. Small sets are costed on the
+     * calling thread, larger ones are split into a few tasks (rather than one
+     * task per candidate) to keep the fork/join overhead low.
      */
-    void beginPartitionCosting(LineSegmentSide *line)
+    void costCandidates()
     {
-        DENG2_ASSERT(line && line->hasMapSide());
-        // Run a new partition cost task.
-        PartitionCandidate *newCandidate = new PartitionCandidate(*line);
-        candidates << newCandidate;
-        costTaskPool.start(new CostTask(*this, *newCandidate));
+        int const count = candidates.count();
+        if(!count) return;
+
+        PartitionCandidate *begin = candidates.data();
+
+        int const segmentCount = rootNode->userData()->totalCount();
+        if(!concurrent || count * segmentCount < SERIAL_COSTING_LIMIT)
+        {
+            CostTask(*this, begin, begin + count).runTask();
+            return;
+        }
+
+        int const taskCount = de::max(1, QThread::idealThreadCount()) * 2;
+        int const perTask   = de::max(MIN_CANDIDATES_PER_TASK, (count + taskCount - 1) / taskCount);
+        for(int first = 0; first < count; first += perTask)
+        {
+            costTaskPool.start(new CostTask(*this, begin + first,
+                                            begin + de::min(first + perTask, count)));
+        }
+        costTaskPool.waitForDone();
     }
 };
 
@@ -394,16 +430,22 @@ PartitionEvaluator::PartitionEvaluator(int splitCostFactor) : d(new Instance)
     d->splitCostFactor = splitCostFactor;
 }
 
+void PartitionEvaluator::setConcurrent(bool yes)
+{
+    d->concurrent = yes;
+}
+
 LineSegmentSide *PartitionEvaluator::choose(LineSegmentBlockTreeNode &node)
 {
     LOG_AS("PartitionEvaluator");
 
     d->rootNode = &node;
 
-    // Increment valid count so we can avoid testing the line segments
-    // produced from a single line more than once per round of partition
-    // selection.
-    validCount++;
+    // Remember the lines already tested so we can avoid testing the line
+    // segments produced from a single line more than once per round of
+    // partition selection. (The lines themselves are not marked as several
+    // half-spaces may be partitioned at the same time.)
+    d->testedLines.clear();
 
     // Iterative pre-order traversal.
     LineSegmentBlockTreeNode const *cur  = d->rootNode;
@@ -430,14 +472,14 @@ LineSegmentSide *PartitionEvaluator::choose(LineSegmentBlockTreeNode &node)
                 // Optimization: Only the first line segment produced from a
                 // given line is tested per round of partition costing because
                 // they are all collinear.
-                if(candidate->mapLine().validCount() == validCount)
+                if(d->testedLines.contains(&candidate->mapLine()))
                     continue; // Skip this.
 
                 // Don't consider further segments of the candidate.
-                candidate->mapLine().setValidCount(validCount);
+                d->testedLines.insert(&candidate->mapLine());
 
-                // Determine candidate suitability and cost.
-                d->beginPartitionCosting(candidate);
+                // Determine candidate suitability and cost (later).
+                d->candidates << Instance::PartitionCandidate(*candidate);
             }
 
             if(prev == cur->parentPtr())
@@ -468,28 +510,26 @@ LineSegmentSide *PartitionEvaluator::choose(LineSegmentBlockTreeNode &node)
         }
     }
 
+    d->costCandidates();
+
+    // Choose the least costly candidate (the first, if several are equal).
     LineSegmentSide *best = nullptr;
-    if(!d->candidates.isEmpty())
+    PartitionCost bestCost;
+    for(Instance::PartitionCandidate const &candidate : d->candidates)
     {
-        d->costTaskPool.waitForDone();
-        PartitionCost bestCost;
-        while(Instance::PartitionCandidate *candidate = d->nextCandidate())
-        {
-            //LOG_DEBUG("%p: %s") << candidate->line << candidate->cost.asText();
-
-            if(candidate->line && (!best || candidate->cost < bestCost))
-            {
-                // We have a new better choice.
-                best     = candidate->line;
-                bestCost = candidate->cost;
-            }
+        //LOG_DEBUG("%p: %s") << candidate.line << candidate.cost.asText();
 
-            delete candidate;
+        if(candidate.line && (!best || candidate.cost < bestCost))
+        {
+            // We have a new better choice.
+            best     = candidate.line;
+            bestCost = candidate.cost;
         }
-
-        //LOG_DEBUG("best %p score: %d.%02d")
-        //        << best << bestCost.total / 100 << bestCost.total % 100;
     }
+    d->candidates.clear();
+
+    //LOG_DEBUG("best %p score: %d.%02d")
+    //        << best << bestCost.total / 100 << bestCost.total % 100;
 
     return best;
 }
@@ -50,6 +50,14 @@ void LineSegmentBlock::link(LineSegmentSide &seg)
     d->segments.prepend(&seg);
 }
 
+void LineSegmentBlock::replace(LineSegmentSide &seg, LineSegmentSide &replacement)
+{
+    DENG2_ASSERT(seg.hasMapSide() == replacement.hasMapSide());
+    int const index = d->segments.indexOf(&seg);
+    DENG2_ASSERT(index >= 0);
+    d->segments[index] = &replacement;
+}
+
 void LineSegmentBlock::addRef(LineSegmentSide const &seg)
 {
     if(seg.hasMapSide()) d->mapCount++;
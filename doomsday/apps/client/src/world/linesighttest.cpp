@@ -29,6 +29,8 @@
 #include "Face"
 
 #include "world/worldsystem.h"  /// For validCount, @todo Remove me.
+#include "world/map.h"
+#include "world/sightlinetable.h"
 #include "BspLeaf"
 #include "BspNode"
 #include "ConvexSubspace"
@@ -68,12 +70,15 @@ DENG2_PIMPL_NOREF(LineSightTest)
         }
     } ray;
 
+    SightLineTable::Ray tableRay;  ///< The ray, prepared for the SightLineTable.
+
     Instance(Vector3d const &from, Vector3d const to, dfloat bottomSlope, dfloat topSlope)
         : from       (from)
         , to         (to)
         , bottomSlope(bottomSlope)
         , topSlope   (topSlope)
         , ray        (from, to)
+        , tableRay   (Vector2d(from.x, from.y), Vector2d(to.x, to.y))
     {}
 
     /**
@@ -84,9 +89,6 @@ DENG2_PIMPL_NOREF(LineSightTest)
      */
     bool crossLine(LineSide &side)
     {
-#define RTOP                    0x1  ///< Top range.
-#define RBOTTOM                 0x2  ///< Bottom range.
-
         Line &line = side.line();
 
         if(line.validCount() == validCount)
@@ -102,6 +104,20 @@ DENG2_PIMPL_NOREF(LineSightTest)
            line.aaBox().maxY < ray.aabox.minY)
             return true;
 
+        return crossOverlappingLine(side);
+    }
+
+    /**
+     * Same as crossLine() but for a line @a side whose bounds are known to
+     * overlap those of the ray, and which has already been marked as visited.
+     */
+    bool crossOverlappingLine(LineSide &side)
+    {
+#define RTOP                    0x1  ///< Top range.
+#define RBOTTOM                 0x2  ///< Bottom range.
+
+        Line &line = side.line();
+
         fixed_t const lineV1OriginX[2]  = { DBL2FIX(line.fromOrigin().x), DBL2FIX(line.fromOrigin().y) };
         fixed_t const lineV2OriginX[2]  = { DBL2FIX(line.toOrigin  ().x), DBL2FIX(line.toOrigin  ().y) };
 
@@ -242,6 +258,24 @@ DENG2_PIMPL_NOREF(LineSightTest)
         });
         if(blocked) return false;
 
+        // Check lines for the edges of the subspace geometry (and the extra meshes).
+        Map const &map = subspace.map();
+        if(map.hasSightLineTable())
+        {
+            // Lines which cannot be crossed by the ray are rejected in bulk.
+            blocked = map.sightLineTable().forAllCrossing(subspace, tableRay,
+                                                          [this] (LineSide &side)
+            {
+                Line &line = side.line();
+                if(line.validCount() == validCount)
+                    return LoopContinue;  // Ignore
+
+                line.setValidCount(validCount);
+                return crossOverlappingLine(side)? LoopContinue : LoopAbort;
+            });
+            return !blocked;
+        }
+
         // Check lines for the edges of the subspace geometry.
         HEdge *base  = subspace.poly().hedge();
         HEdge *hedge = base;
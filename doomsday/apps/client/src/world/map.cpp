@@ -51,6 +51,8 @@
 #include "world/lineowner.h"
 #include "world/p_object.h"
 #include "world/polyobjdata.h"
+#include "world/reject.h"
+#include "world/sightlinetable.h"
 #include "world/sky.h"
 #include "world/thinkers.h"
 #ifdef __CLIENT__
@@ -75,6 +77,7 @@
 #  include "render/skydrawable.h"
 #endif
 
+#include <de/App>
 #include <de/Rectangle>
 #include <de/aabox.h>
 #include <de/vector1.h>
@@ -87,6 +90,7 @@
 #include <array>
 
 static int bspSplitFactor = 7;  ///< cvar
+static byte bspCache = true;    ///< cvar
 
 #ifdef __CLIENT__
 static int lgMXSample  = 1;  ///< 5 samples per block. Cvar.
@@ -185,6 +189,9 @@ DENG2_PIMPL(Map)
     std::unique_ptr<LineBlockmap> lineBlockmap;
     std::unique_ptr<Blockmap> subspaceBlockmap;
 
+    std::unique_ptr<Reject> reject;
+    std::unique_ptr<SightLineTable> sightLineTable;
+
 #ifdef __CLIENT__
     struct ContactBlockmap : public Blockmap
     {
@@ -335,6 +342,9 @@ DENG2_PIMPL(Map)
         self.removeAllBiasSources();
 #endif
 
+        // Stop any reject building still in progress.
+        reject.reset();
+
         // Delete thinkers before the map elements, because thinkers may reference them
         // in their private data destructors.
         thinkers.reset();
@@ -601,6 +611,10 @@ DENG2_PIMPL(Map)
             // Configure a space partitioner.
             bsp::Partitioner partitioner(bspSplitFactor);
             partitioner.audienceForUnclosedSectorFound += this;
+            if(bspCache)
+            {
+                partitioner.setCachePath(App::app().nativeHomePath() / "cache" / "bsp");
+            }
 
             // Build a new BSP tree.
             bsp.tree = partitioner.makeBspTree(linesToBuildFor, mesh);
@@ -2076,6 +2090,36 @@ Thinkers &Map::thinkers() const
     throw MissingThinkersError("Map::thinkers", "Thinkers not initialized");
 }
 
+bool Map::hasReject() const
+{
+    return bool(d->reject);
+}
+
+Reject const &Map::reject() const
+{
+    if(bool(d->reject))
+    {
+        return *d->reject;
+    }
+    /// @throw MissingRejectError  The reject data is not yet initialized.
+    throw MissingRejectError("Map::reject", "Reject not initialized");
+}
+
+bool Map::hasSightLineTable() const
+{
+    return bool(d->sightLineTable);
+}
+
+SightLineTable const &Map::sightLineTable() const
+{
+    if(bool(d->sightLineTable))
+    {
+        return *d->sightLineTable;
+    }
+    /// @throw MissingSightLineTableError  The table is not yet built.
+    throw MissingSightLineTableError("Map::sightLineTable", "Sight line table not built");
+}
+
 Sky &Map::sky() const
 {
     return d->sky;
@@ -2270,6 +2314,12 @@ void Map::initPolyobjs()
     }
 }
 
+void Map::initReject()
+{
+    LOG_AS("Map::initReject");
+    d->reject.reset(new Reject(*this));
+}
+
 dint Map::ambientLightLevel() const
 {
     return _ambientLightLevel;
@@ -3135,8 +3185,8 @@ void Map::update()
     // Reapply values defined in MapInfo (they may have changed).
     Record const &inf = mapInfo();
 
-    _ambientLightLevel = inf.getf("ambient") * 255;
-    _globalGravity     = inf.getf("gravity");
+    _ambientLightLevel = inf.getf(defn::MapInfo::AMBIENT) * 255;
+    _globalGravity     = inf.getf(defn::MapInfo::GRAVITY);
     _effectiveGravity  = _globalGravity;
 
 #ifdef __CLIENT__
@@ -3145,7 +3195,7 @@ void Map::update()
     /// a representation on server side and a logical entity which the renderer
     /// visualizes. We also need multiple concurrent skies for BOOM support.
     defn::Sky skyDef;
-    if(Record const *def = defs.skies.tryFind("id", inf.gets("skyId")))
+    if(Record const *def = defs.skies.tryFind("id", inf.gets(defn::MapInfo::SKY_ID)))
     {
         skyDef = *def;
     }
@@ -3395,16 +3445,87 @@ D_CMD(InspectMap)
 #undef TABBED
 }
 
+/**
+ * Partition the lines of the current map serially and then concurrently,
+ * reporting the time taken by each and whether the results are identical.
+ */
+D_CMD(BenchmarkBsp)
+{
+    DENG2_UNUSED3(src, argc, argv);
+
+    LOG_AS("benchmarkbsp (Cmd)");
+
+    if(!App_WorldSystem().hasMap())
+    {
+        LOG_SCR_WARNING("No map is currently loaded");
+        return false;
+    }
+
+    Map &map = App_WorldSystem().map();
+
+    // The same lines as when the map's BSP was built.
+    QSet<Line *> lines;
+    map.forAllLines([&lines] (Line &line)
+    {
+        lines.insert(&line);
+        return LoopContinue;
+    });
+    map.forAllPolyobjs([&lines] (Polyobj &pob)
+    {
+        for(Line *line : pob.lines())
+        {
+            lines.remove(line);
+        }
+        return LoopContinue;
+    });
+
+    try
+    {
+        bsp::Partitioner partitioner(bspSplitFactor);
+
+        partitioner.setConcurrent(false);
+        Time begunAt;
+        Block const serial = partitioner.partitionChecksum(lines);
+        TimeDelta const serialTime = begunAt.since();
+
+        partitioner.setConcurrent(true);
+        begunAt = Time();
+        Block const concurrent = partitioner.partitionChecksum(lines);
+        TimeDelta const concurrentTime = begunAt.since();
+
+        LOG_SCR_MSG("Partitioned %i lines with split cost factor %i: "
+                    "%.2f seconds serially, %.2f seconds concurrently")
+                << lines.count() << bspSplitFactor << serialTime << concurrentTime;
+
+        if(serial != concurrent)
+        {
+            LOG_SCR_WARNING("The serial and concurrent builds differ (%s != %s)")
+                    << serial.toHex().constData() << concurrent.toHex().constData();
+            return false;
+        }
+        LOG_SCR_MSG("The builds are identical");
+    }
+    catch(Error const &er)
+    {
+        LOG_SCR_ERROR("Failed to partition the map: %s") << er.asText();
+        return false;
+    }
+
+    return true;
+}
+
 void Map::consoleRegister() // static
 {
     Mobj_ConsoleRegister();
 
     C_VAR_INT("bsp-factor",                 &bspSplitFactor, CVF_NO_MAX, 0, 0);
+    C_VAR_BYTE("bsp-cache",                 &bspCache,       0, 0, 1);
 #ifdef __CLIENT__
     C_VAR_INT("rend-bias-grid-multisample", &lgMXSample,     0, 0, 7);
 #endif
 
     C_CMD("inspectmap", "", InspectMap);
+    C_CMD("benchmarkbsp", "", BenchmarkBsp);
 }
 
 /// Runtime map editing -----------------------------------------------------
@@ -3924,6 +4045,9 @@ bool Map::endEditing()
     // We can now initialize the convex subspace blockmap.
     d->initSubspaceBlockmap();
 
+    // Pack the lines of each subspace for line of sight testing.
+    d->sightLineTable.reset(new SightLineTable(*this));
+
     // Prepare the thinker lists.
     d->thinkers.reset(new Thinkers);
 
@@ -1,12 +1,6 @@
-/** @file reject.h World map sector LOS reject LUT building.
+/** @file reject.cpp World map sector LOS reject LUT building.
  *
- * @authors Copyright © 2007-2013 Daniel Swanson <danij@dengine.net>
- * @authors Copyright © 2000-2007 Andrew Apted <ajapted@gmail.com>
- * @authors Copyright © 1998-2000 Colin Reed <cph@moria.org.uk>
- * @authors Copyright © 1998-2000 Lee Killough <killough@rsn.hp.com>
- *
- * Based on glBSP 2.24 (in turn, based on BSP 2.3).
- * @see http://sourceforge.net/projects/glbsp/
+ * @authors Copyright © 2007-2015 Daniel Swanson <danij@dengine.net>
  *
  * @par License
  * GPL: http://www.gnu.org/licenses/gpl.html
@@ -23,92 +17,483 @@
  * 02110-1301 USA</small>
  */
 
-#if 0 // Needs updating.
-#include <cmath>
-
 #include "de_base.h"
+#include "world/reject.h"
+
+#include <atomic>
+#include <vector>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <de/App>
+#include <de/Log>
+#include <de/Task>
+#include <de/TaskPool>
+#include <de/Time>
+#include <de/Vector>
+
+#include "Face"
+#include "ConvexSubspace"
+#include "Line"
+#include "Sector"
 #include "world/map.h"
 
-using namespace de;
+namespace de {
 
-void BuildRejectForMap(Map const &map)
+namespace internal
 {
-    int *secGroups = M_Malloc(sizeof(int) * map.sectorCount());
-    int group = 0;
+    /// Increment when the build algorithm changes (invalidates cached data).
+    static dint const REJECT_VERSION = 1;
+
+    static char const REJECT_MAGIC[4] = { 'R', 'J', 'C', 'T' };
+
+    /// Portal winding points this close to a clipping line are retained.
+    static ddouble const CLIP_EPSILON = 1.0 / 8;
+
+    /// Maximum number of flood steps per source sector before falling back
+    /// to a plain reachability flood.
+    static dint const FLOOD_BUDGET = 1 << 18;
+
+    /// Maximum length of a portal chain before falling back.
+    static dint const FLOOD_MAX_DEPTH = 256;
+
+    /// Number of source sectors processed by each worker task.
+    static dint const SECTORS_PER_TASK = 32;
+
+    static inline ddouble cross(Vector2d const &a, Vector2d const &b)
+    {
+        return a.x * b.y - a.y * b.x;
+    }
+
+    /**
+     * A portal between the convex subspaces of two different sectors.
+     */
+    struct Portal
+    {
+        Vector2d from, to;
+        dint leftSector;   ///< Index of the sector to the left of from => to.
+        dint rightSector;  ///< Index of the sector to the right of from => to.
+    };
+
+    /**
+     * Portal oriented in the direction of travel. Points "ahead" of the
+     * winding lie to the left of a => b.
+     */
+    struct Winding
+    {
+        Vector2d a, b;
+
+        /**
+         * Clip the winding so that only the part to the left of the line
+         * through @a origin in @a direction remains.
+         *
+         * @return  @c false if nothing remains.
+         */
+        bool clip(Vector2d const &origin, Vector2d const &direction)
+        {
+            ddouble const len = direction.length();
+            if(len < CLIP_EPSILON) return true; // Degenerate; retain everything.
+
+            ddouble const fa = cross(direction, a - origin) / len + CLIP_EPSILON;
+            ddouble const fb = cross(direction, b - origin) / len + CLIP_EPSILON;
+
+            if(fa >= 0 && fb >= 0) return true;
+            if(fa <  0 && fb <  0) return false;
+
+            Vector2d const mid = a + (b - a) * (fa / (fa - fb));
+            if(fa < 0) a = mid;
+            else       b = mid;
+            return true;
+        }
+    };
+}
+
+using namespace internal;
+
+DENG2_PIMPL_NOREF(Reject)
+{
+    dint sectorCount = 0;
+    dint rowSize     = 0;  ///< In bytes.
+
+    std::vector<Portal> portals;
+    std::vector<std::vector<dint>> sectorPortals;  ///< Portal indices, by sector.
+
+    std::vector<duint8> visible;  ///< Row per source sector; bit set if visible.
+    std::atomic<bool> ready;
+    std::atomic<bool> abort;
+    std::atomic<dint> pendingTasks;
+
+    QByteArray checksum;
+    TaskPool tasks;
+
+    Instance() : ready(false), abort(false), pendingTasks(0) {}
+
+    ~Instance()
+    {
+        abort = true;
+        tasks.waitForDone();
+    }
+
+    static bool isPassable(HEdge const &hedge)
+    {
+        // Partition mini-segments never block.
+        if(!hedge.hasMapElement()) return true;
+
+        LineSide const &side = hedge.mapElementAs<LineSideSegment>().lineSide();
+        // The passable side of a one-way window?
+        if(!side.hasSections()) return true;
+        return side.hasSector() && side.back().hasSector();
+    }
+
+    /**
+     * Sample the portals of the map. Only the data needed for building is
+     * copied so that the map itself need not be referenced by the workers.
+     */
+    void samplePortals(Map const &map)
+    {
+        sectorCount = map.sectorCount();
+        rowSize     = (sectorCount + 7) / 8;
+
+        map.forAllSubspaces([this] (ConvexSubspace &subspace)
+        {
+            if(!subspace.hasCluster()) return LoopContinue;
+
+            dint const sectorIndex = subspace.sector().indexInMap();
+            Vector2d const &center = subspace.poly().center();
+
+            HEdge *base  = subspace.poly().hedge();
+            HEdge *hedge = base;
+            do
+            {
+                if(!hedge->hasTwin() || !hedge->twin().hasFace()) continue;
+
+                auto &backSubspace = hedge->twin().face().mapElementAs<ConvexSubspace>();
+                if(!backSubspace.hasCluster()) continue;
+
+                // Each pair is processed once, from the lower sector index.
+                dint const backIndex = backSubspace.sector().indexInMap();
+                if(backIndex <= sectorIndex) continue;
+
+                if(!isPassable(*hedge) && !isPassable(hedge->twin())) continue;
+
+                Portal portal;
+                portal.from = hedge->origin();
+                portal.to   = hedge->twin().origin();
+                if((portal.to - portal.from).length() < CLIP_EPSILON) continue;
+
+                if(cross(portal.to - portal.from, center - portal.from) > 0)
+                {
+                    portal.leftSector  = sectorIndex;
+                    portal.rightSector = backIndex;
+                }
+                else
+                {
+                    portal.leftSector  = backIndex;
+                    portal.rightSector = sectorIndex;
+                }
+                portals.push_back(portal);
+
+            } while((hedge = &hedge->next()) != base);
+
+            return LoopContinue;
+        });
+
+        sectorPortals.resize(sectorCount);
+        for(dint i = 0; i < dint(portals.size()); ++i)
+        {
+            sectorPortals[portals[i].leftSector ].push_back(i);
+            sectorPortals[portals[i].rightSector].push_back(i);
+        }
+
+        // The checksum identifies the map geometry in the cache.
+        QCryptographicHash hash(QCryptographicHash::Md5);
+        hash.addData(reinterpret_cast<char const *>(&REJECT_VERSION), sizeof(REJECT_VERSION));
+        hash.addData(reinterpret_cast<char const *>(&sectorCount), sizeof(sectorCount));
+        for(Portal const &portal : portals)
+        {
+            ddouble const coords[4] = { portal.from.x, portal.from.y, portal.to.x, portal.to.y };
+            dint const sides[2]     = { portal.leftSector, portal.rightSector };
+            hash.addData(reinterpret_cast<char const *>(coords), sizeof(coords));
+            hash.addData(reinterpret_cast<char const *>(sides), sizeof(sides));
+        }
+        checksum = hash.result().toHex();
+    }
+
+    /// Returns the winding of @a portal when leaving @a sector through it.
+    Winding windingFrom(Portal const &portal, dint sector) const
+    {
+        // Ahead is the left side of the winding.
+        if(portal.rightSector == sector) return Winding{ portal.from, portal.to };
+        return Winding{ portal.to, portal.from };
+    }
+
+    static inline dint otherSector(Portal const &portal, dint sector)
+    {
+        return portal.leftSector == sector? portal.rightSector : portal.leftSector;
+    }
 
-    for(uint i = 0; i < map.sectorCount(); ++i)
+    inline void markVisible(duint8 *row, dint sector)
     {
-        Sector &sector = map.sectors[i];
-        secGroups[i] = group++;
-        sector.rejNext = sector.rejPrev = &sector;
+        row[sector >> 3] |= 1 << (sector & 7);
     }
 
-    for(uint i = 0; i < map.lineCount(); ++i)
+    struct Flood
     {
-        Line *line = &map.lines[i];
+        Instance &inst;
+        duint8 *row;
+        std::vector<bool> inPath;
+        dint steps = 0;
+
+        Flood(Instance &inst, duint8 *row)
+            : inst(inst), row(row), inPath(inst.portals.size(), false)
+        {}
+
+        /**
+         * Continue through the portals of @a sector, which was entered via
+         * @a pass (having previously left the source sector via @a source).
+         *
+         * @return  @c false if the flood was abandoned.
+         */
+        bool flow(dint sector, Winding const &source, Winding const *pass, dint depth)
+        {
+            if(depth > FLOOD_MAX_DEPTH) return false;
+
+            for(dint portalIndex : inst.sectorPortals[sector])
+            {
+                if(inPath[portalIndex]) continue;
+
+                if(++steps > FLOOD_BUDGET || inst.abort) return false;
+
+                Portal const &portal = inst.portals[portalIndex];
+                Winding target = inst.windingFrom(portal, sector);
+
+                // Must lie ahead of the source.
+                if(!target.clip(source.a, source.b - source.a)) continue;
 
-        if(!line->hasFrontSector() || !line->hasBackSector())
-            continue;
+                if(pass)
+                {
+                    // Must lie ahead of the pass.
+                    if(!target.clip(pass->a, pass->b - pass->a)) continue;
 
-        Sector *sec1 = line->frontSectorPtr();
-        Sector *sec2 = line->backSectorPtr();
+                    // Must lie within the anti-penumbra of the source and pass.
+                    if(!target.clip(source.a, pass->b - source.a)) continue;
+                    if(!target.clip(pass->a,  source.b - pass->a)) continue;
+                }
 
-        if(!sec1 || !sec2 || sec1 == sec2)
-            continue;
+                dint const next = otherSector(portal, sector);
+                inst.markVisible(row, next);
 
-        // Already in the same group?
-        if(secGroups[sec1->index] == secGroups[sec2->index])
-            continue;
+                inPath[portalIndex] = true;
+                bool const completed = flow(next, source, &target, depth + 1);
+                inPath[portalIndex] = false;
+                if(!completed) return false;
+            }
+            return true;
+        }
+    };
 
-        // Swap sectors so that the smallest group is added to the biggest
-        // group. This is based on the assumption that sector numbers in
-        // wads will generally increase over the set of lines, and so
-        // (by swapping) we'll tend to add small groups into larger
-        // groups, thereby minimising the updates to 'rej_group' fields
-        // that is required when merging.
-        Sector *p = 0;
-        if(secGroups[sec1->index] > secGroups[sec2->index])
+    /**
+     * Mark everything reachable from @a source as visible (used when the
+     * anti-penumbra flood would take too long).
+     */
+    void floodReachable(dint source, duint8 *row)
+    {
+        std::vector<bool> visited(sectorCount, false);
+        std::vector<dint> stack;
+        stack.push_back(source);
+        visited[source] = true;
+        while(!stack.empty())
         {
-            p = sec1;
-            sec1 = sec2;
-            sec2 = p;
+            dint const sector = stack.back();
+            stack.pop_back();
+            markVisible(row, sector);
+
+            for(dint portalIndex : sectorPortals[sector])
+            {
+                dint const next = otherSector(portals[portalIndex], sector);
+                if(visited[next]) continue;
+                visited[next] = true;
+                stack.push_back(next);
+            }
         }
+    }
 
-        // Update the group numbers in the second group
-        secGroups[sec2->index] = secGroups[sec1->index];
-        for(p = sec2->rejNext; p != sec2; p = p->rejNext)
+    void buildRow(dint source)
+    {
+        duint8 *row = &visible[source * rowSize];
+        markVisible(row, source);
+
+        Flood flood(*this, row);
+        for(dint portalIndex : sectorPortals[source])
         {
-            secGroups[p->index] = secGroups[sec1->index];
+            Portal const &portal = portals[portalIndex];
+            dint const next = otherSector(portal, source);
+            markVisible(row, next);
+
+            Winding const winding = windingFrom(portal, source);
+            flood.inPath[portalIndex] = true;
+            bool const completed = flood.flow(next, winding, nullptr, 1);
+            flood.inPath[portalIndex] = false;
+
+            if(!completed)
+            {
+                if(abort) return;
+                floodReachable(source, row);
+                return;
+            }
         }
+    }
+
+    /**
+     * Called by the last task to finish: make the matrix symmetric (if A can
+     * see B then B can see A) and store it in the cache.
+     */
+    void finish(Time const &begunAt)
+    {
+        for(dint i = 0; i < sectorCount; ++i)
+        for(dint k = i + 1; k < sectorCount; ++k)
+        {
+            bool const ik = visible[i * rowSize + (k >> 3)] & (1 << (k & 7));
+            bool const ki = visible[k * rowSize + (i >> 3)] & (1 << (i & 7));
+            if(ik != ki)
+            {
+                markVisible(&visible[i * rowSize], k);
+                markVisible(&visible[k * rowSize], i);
+            }
+        }
+
+        writeCache();
+        ready = true;
+
+        LOGDEV_MAP_VERBOSE("Reject built for %i sectors (%i portals) in %.2f seconds")
+            << sectorCount << portals.size() << begunAt.since();
+    }
+
+    class BuildTask : public Task
+    {
+    public:
+        Instance &inst;
+        dint first, last;
+        Time begunAt;
+
+        BuildTask(Instance &inst, dint first, dint last, Time const &begunAt)
+            : inst(inst), first(first), last(last), begunAt(begunAt)
+        {}
+
+        void runTask()
+        {
+            for(dint i = first; i < last && !inst.abort; ++i)
+            {
+                inst.buildRow(i);
+            }
+            if(--inst.pendingTasks == 0 && !inst.abort)
+            {
+                inst.finish(begunAt);
+            }
+        }
+    };
+
+    void beginBuild()
+    {
+        visible.assign(sectorCount * rowSize, 0);
 
-        // Merge 'em baby...
-        sec1->rejNext->rejPrev = sec2;
-        sec2->rejNext->rejPrev = sec1;
+        Time begunAt;
+        dint const taskCount = (sectorCount + SECTORS_PER_TASK - 1) / SECTORS_PER_TASK;
+        pendingTasks = taskCount;
+        for(dint i = 0; i < taskCount; ++i)
+        {
+            tasks.start(new BuildTask(*this, i * SECTORS_PER_TASK,
+                                      de::min((i + 1) * SECTORS_PER_TASK, sectorCount),
+                                      begunAt));
+        }
+    }
 
-        p = sec1->rejNext;
-        sec1->rejNext = sec2->rejNext;
-        sec2->rejNext = p;
+    NativePath cachePath() const
+    {
+        return App::app().nativeHomePath() / "cache" / "reject" / (String::fromLatin1(checksum) + ".rej");
     }
 
-    size_t rejectSize = (map.sectorCount() * map.sectorCount() + 7) / 8;
-    byte *matrix = Z_Calloc(rejectSize, PU_MAPSTATIC, 0);
+    bool readCache()
+    {
+        QFile file(cachePath().toString());
+        if(!file.open(QFile::ReadOnly)) return false;
+
+        QDataStream is(&file);
+        char magic[4];
+        qint32 version, count;
+        if(is.readRawData(magic, 4) != 4) return false;
+        is >> version >> count;
+        if(memcmp(magic, REJECT_MAGIC, 4) || version != REJECT_VERSION || count != sectorCount)
+        {
+            return false;
+        }
+
+        visible.resize(sectorCount * rowSize);
+        if(is.readRawData(reinterpret_cast<char *>(visible.data()), int(visible.size()))
+           != int(visible.size()))
+        {
+            visible.clear();
+            return false;
+        }
+        return true;
+    }
 
-    for(int view = 0; view < map.sectorCount(); ++view)
-    for(int target = 0; target < view; ++target)
+    void writeCache()
     {
-        if(secGroups[view] == secGroups[target])
-            continue;
+        NativePath const path = cachePath();
+        QDir().mkpath(path.fileNamePath().toString());
 
-        // For symmetry, do two bits at a time.
-        int p1 = view * map.sectorCount() + target;
-        int p2 = target * map.sectorCount() + view;
+        QFile file(path.toString());
+        if(!file.open(QFile::WriteOnly | QFile::Truncate))
+        {
+            LOG_MAP_WARNING("Failed to write reject cache \"%s\"") << path.pretty();
+            return;
+        }
+        QDataStream os(&file);
+        os.writeRawData(REJECT_MAGIC, 4);
+        os << qint32(REJECT_VERSION) << qint32(sectorCount);
+        os.writeRawData(reinterpret_cast<char const *>(visible.data()), int(visible.size()));
+    }
+};
 
-        matrix[p1 >> 3] |= (1 << (p1 & 7));
-        matrix[p2 >> 3] |= (1 << (p2 & 7));
+Reject::Reject(Map const &map) : d(new Instance)
+{
+    LOG_AS("Reject");
+
+    d->samplePortals(map);
+    if(!d->sectorCount) return;
+
+    if(d->readCache())
+    {
+        LOGDEV_MAP_VERBOSE("Loaded cached reject for %i sectors") << d->sectorCount;
+        d->ready = true;
+        return;
     }
 
-    M_Free(secGroups);
+    d->beginBuild();
+}
 
-    return matrix;
+bool Reject::isReady() const
+{
+    return d->ready;
 }
-#endif
+
+dint Reject::sectorCount() const
+{
+    return d->sectorCount;
+}
+
+bool Reject::mightSee(Sector const &a, Sector const &b) const
+{
+    if(!d->ready) return true;
+
+    dint const from = a.indexInMap();
+    dint const to   = b.indexInMap();
+    if(from < 0 || from >= d->sectorCount || to < 0 || to >= d->sectorCount)
+        return true;
+
+    return (d->visible[from * d->rowSize + (to >> 3)] & (1 << (to & 7))) != 0;
+}
+
+} // namespace de
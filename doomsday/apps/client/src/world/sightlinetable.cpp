@@ -0,0 +1,243 @@
+/** @file sightlinetable.cpp  Packed line geometry for line of sight testing.
+ *
+ * @authors Copyright © 2015 Daniel Swanson <danij@dengine.net>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#include "de_base.h"
+#include "world/sightlinetable.h"
+
+#include <cmath>
+#include <vector>
+#include "Face"
+#include "ConvexSubspace"
+#include "world/map.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define DENG_SIGHTLINE_SSE2
+#  include <emmintrin.h>
+#endif
+
+namespace de {
+
+/**
+ * Error allowance of the side test of an end point @a dx, @a dy away from the
+ * ray origin. LineSightTest works with single precision coordinates converted to
+ * 16.16 fixed-point and truncated to 8 fractional bits before multiplying, so its
+ * cross products may be off by about (|dx| + |dy| + |dir.x| + |dir.y|) / 128, plus
+ * one unit for each truncated product. Twice that is allowed here.
+ */
+static inline ddouble sideSlack(ddouble dx, ddouble dy)
+{
+    return (std::fabs(dx) + std::fabs(dy)) / 64;
+}
+
+/// Offsets at least this large overflow in 16.16 fixed-point; such lines are
+/// always left for LineSightTest to decide.
+static ddouble const FIXED_LIMIT = 32767;
+
+SightLineTable::Ray::Ray(Vector2d const &from, Vector2d const &to)
+    : fromX(from.x)
+    , fromY(from.y)
+    , dirX (to.x - from.x)
+    , dirY (to.y - from.y)
+    , slack(std::fabs(dirX) < FIXED_LIMIT && std::fabs(dirY) < FIXED_LIMIT?
+            sideSlack(dirX, dirY) + 4 : HUGE_VAL)
+{
+    ddouble v1[2] = { from.x, from.y };
+    V2d_InitBox(box.arvec2, v1);
+
+    ddouble v2[2] = { to.x, to.y };
+    V2d_AddToBox(box.arvec2, v2);
+}
+
+DENG2_PIMPL_NOREF(SightLineTable)
+{
+    // Line end points (structure of arrays).
+    std::vector<ddouble> fromX, fromY, toX, toY;
+    std::vector<LineSide *> sides;
+
+    std::vector<dint> firstEntry;  ///< Indexed by subspace; one extra for the end.
+
+    void add(LineSide &side)
+    {
+        Line const &line = side.line();
+        fromX.push_back(line.fromOrigin().x);
+        fromY.push_back(line.fromOrigin().y);
+        toX  .push_back(line.toOrigin  ().x);
+        toY  .push_back(line.toOrigin  ().y);
+        sides.push_back(&side);
+    }
+
+    /**
+     * Returns @c true if entry @a i may be crossed by @a ray: the bounds of the
+     * line overlap those of the ray and its end points are not clearly on the
+     * same side of it.
+     */
+    inline bool mayCross(dint i, Ray const &ray) const
+    {
+        ddouble const ax = fromX[i] - ray.fromX, ay = fromY[i] - ray.fromY;
+        ddouble const bx = toX  [i] - ray.fromX, by = toY  [i] - ray.fromY;
+
+        // Bounds of the line (relative to the ray origin).
+        if(de::min(ax, bx) > ray.box.maxX - ray.fromX || de::max(ax, bx) < ray.box.minX - ray.fromX ||
+           de::min(ay, by) > ray.box.maxY - ray.fromY || de::max(ay, by) < ray.box.minY - ray.fromY)
+            return false;
+
+        if(de::max(de::max(std::fabs(ax), std::fabs(ay)), de::max(std::fabs(bx), std::fabs(by))) >= FIXED_LIMIT)
+            return true;
+
+        ddouble const sa = ay * ray.dirX - ax * ray.dirY;
+        ddouble const sb = by * ray.dirX - bx * ray.dirY;
+        ddouble const ma = sideSlack(ax, ay) + ray.slack;
+        ddouble const mb = sideSlack(bx, by) + ray.slack;
+
+        return !((sa > ma && sb > mb) || (sa < -ma && sb < -mb));
+    }
+};
+
+SightLineTable::SightLineTable(Map const &map) : d(new Instance)
+{
+    d->firstEntry.resize(map.subspaceCount() + 1, 0);
+
+    std::vector<ConvexSubspace *> subspaces(map.subspaceCount());
+    map.forAllSubspaces([&subspaces] (ConvexSubspace &subspace)
+    {
+        subspaces[subspace.indexInMap()] = &subspace;
+        return LoopContinue;
+    });
+
+    for(dsize i = 0; i < subspaces.size(); ++i)
+    {
+        d->firstEntry[i] = dint(d->sides.size());
+
+        ConvexSubspace const &subspace = *subspaces[i];
+
+        // Lines for the edges of the subspace geometry.
+        HEdge *base  = subspace.poly().hedge();
+        HEdge *hedge = base;
+        do
+        {
+            if(hedge->hasMapElement())
+            {
+                d->add(hedge->mapElementAs<LineSideSegment>().lineSide());
+            }
+        } while((hedge = &hedge->next()) != base);
+
+        // Lines for the extra meshes.
+        subspace.forAllExtraMeshes([this] (Mesh &mesh)
+        {
+            for(HEdge *hedge : mesh.hedges())
+            {
+                if(hedge->hasMapElement())
+                {
+                    d->add(hedge->mapElementAs<LineSideSegment>().lineSide());
+                }
+            }
+            return LoopContinue;
+        });
+    }
+    d->firstEntry.back() = dint(d->sides.size());
+}
+
+dint SightLineTable::entryCount() const
+{
+    return dint(d->sides.size());
+}
+
+void SightLineTable::range(ConvexSubspace const &subspace, dint &first, dint &last) const
+{
+    dint const index = subspace.indexInMap();
+    if(index < 0 || index + 1 >= dint(d->firstEntry.size()))
+    {
+        first = last = 0;
+        return;
+    }
+    first = d->firstEntry[index];
+    last  = d->firstEntry[index + 1];
+}
+
+duint SightLineTable::crossingMask(dint first, dint last, Ray const &ray) const
+{
+    DENG2_ASSERT(last - first <= BATCH_SIZE);
+
+    duint mask = 0;
+    dint i = first;
+
+#ifdef DENG_SIGHTLINE_SSE2
+    // Two entries at a time; the same arithmetic as Instance::mayCross().
+    __m128d const signBit = _mm_set1_pd(-0.0);
+    __m128d const rayX    = _mm_set1_pd(ray.fromX);
+    __m128d const rayY    = _mm_set1_pd(ray.fromY);
+    __m128d const dirX    = _mm_set1_pd(ray.dirX);
+    __m128d const dirY    = _mm_set1_pd(ray.dirY);
+    __m128d const slack   = _mm_set1_pd(ray.slack);
+    __m128d const scale   = _mm_set1_pd(1.0 / 64);
+    __m128d const limit   = _mm_set1_pd(FIXED_LIMIT);
+    __m128d const boxMinX = _mm_set1_pd(ray.box.minX - ray.fromX);
+    __m128d const boxMinY = _mm_set1_pd(ray.box.minY - ray.fromY);
+    __m128d const boxMaxX = _mm_set1_pd(ray.box.maxX - ray.fromX);
+    __m128d const boxMaxY = _mm_set1_pd(ray.box.maxY - ray.fromY);
+
+    for(; i + 2 <= last; i += 2)
+    {
+        __m128d const ax = _mm_sub_pd(_mm_loadu_pd(&d->fromX[i]), rayX);
+        __m128d const ay = _mm_sub_pd(_mm_loadu_pd(&d->fromY[i]), rayY);
+        __m128d const bx = _mm_sub_pd(_mm_loadu_pd(&d->toX  [i]), rayX);
+        __m128d const by = _mm_sub_pd(_mm_loadu_pd(&d->toY  [i]), rayY);
+
+        __m128d miss = _mm_or_pd(_mm_cmpgt_pd(_mm_min_pd(ax, bx), boxMaxX),
+                                 _mm_cmplt_pd(_mm_max_pd(ax, bx), boxMinX));
+        miss = _mm_or_pd(miss, _mm_cmpgt_pd(_mm_min_pd(ay, by), boxMaxY));
+        miss = _mm_or_pd(miss, _mm_cmplt_pd(_mm_max_pd(ay, by), boxMinY));
+
+        __m128d const sa = _mm_sub_pd(_mm_mul_pd(ay, dirX), _mm_mul_pd(ax, dirY));
+        __m128d const sb = _mm_sub_pd(_mm_mul_pd(by, dirX), _mm_mul_pd(bx, dirY));
+        __m128d const absAx = _mm_andnot_pd(signBit, ax), absAy = _mm_andnot_pd(signBit, ay);
+        __m128d const absBx = _mm_andnot_pd(signBit, bx), absBy = _mm_andnot_pd(signBit, by);
+        __m128d const ma = _mm_add_pd(_mm_mul_pd(_mm_add_pd(absAx, absAy), scale), slack);
+        __m128d const mb = _mm_add_pd(_mm_mul_pd(_mm_add_pd(absBx, absBy), scale), slack);
+        __m128d const big = _mm_cmpge_pd(_mm_max_pd(_mm_max_pd(absAx, absAy),
+                                                    _mm_max_pd(absBx, absBy)), limit);
+
+        __m128d const left  = _mm_and_pd(_mm_cmpgt_pd(sa, ma), _mm_cmpgt_pd(sb, mb));
+        __m128d const right = _mm_and_pd(_mm_cmplt_pd(sa, _mm_xor_pd(ma, signBit)),
+                                         _mm_cmplt_pd(sb, _mm_xor_pd(mb, signBit)));
+
+        __m128d const side  = _mm_andnot_pd(big, _mm_or_pd(left, right));
+
+        duint const rejected = duint(_mm_movemask_pd(_mm_or_pd(miss, side)));
+        mask |= (rejected ^ 3) << (i - first);
+    }
+#endif
+
+    for(; i < last; ++i)
+    {
+        if(d->mayCross(i, ray))
+        {
+            mask |= 1 << (i - first);
+        }
+    }
+    return mask;
+}
+
+LineSide &SightLineTable::side(dint index) const
+{
+    DENG2_ASSERT(index >= 0 && index < dint(d->sides.size()));
+    return *d->sides[index];
+}
+
+} // namespace de
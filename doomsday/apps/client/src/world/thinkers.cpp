@@ -37,7 +37,8 @@
 #include "world/p_object.h"
 
 #include <de/memoryzone.h>
-#include <QList>
+#include <de/FlatHashMap>
+#include <de/SmallVector>
 #include <QtAlgorithms>
 
 dd_bool Thinker_IsMobjFunc(thinkfunc_t func)
@@ -115,14 +116,14 @@ struct ThinkerList
     }
 };
 
-typedef QHash<thid_t, mobj_t *> MobjHash;
+typedef FlatHashMap<thid_t, mobj_t *> MobjHash;
 
 DENG2_PIMPL(Thinkers)
 {
     dint idtable[2048];     ///< 65536 bits telling which IDs are in use.
     dushort iddealer = 0;
 
-    QList<ThinkerList *> lists;
+    SmallVector<ThinkerList *, 32> lists; ///< Searched linearly; there are only a few.
 
     MobjHash mobjIdLookup;  ///< public only
 
@@ -474,14 +474,14 @@ DENG2_PIMPL(WorldSystem)
         // See what MapInfo says about this map.
         Record const &mapInfo = map->mapInfo();
 
-        map->_ambientLightLevel = mapInfo.getf("ambient") * 255;
-        map->_globalGravity     = mapInfo.getf("gravity");
+        map->_ambientLightLevel = mapInfo.getf(defn::MapInfo::AMBIENT) * 255;
+        map->_globalGravity     = mapInfo.getf(defn::MapInfo::GRAVITY);
         map->_effectiveGravity  = map->_globalGravity;
 
 #ifdef __CLIENT__
         // Reconfigure the sky.
         defn::Sky skyDef;
-        if(Record const *def = defs.skies.tryFind("id", mapInfo.gets("skyId")))
+        if(Record const *def = defs.skies.tryFind("id", mapInfo.gets(defn::MapInfo::SKY_ID)))
         {
             skyDef = *def;
         }
@@ -573,6 +573,7 @@ DENG2_PIMPL(WorldSystem)
 #endif
 
         map->initPolyobjs();
+        map->initReject();
         S_SetupForChangedMap();
 
 #ifdef __SERVER__
@@ -628,7 +629,7 @@ DENG2_PIMPL(WorldSystem)
          */
 
         // Run any commands specified in MapInfo.
-        String execute = mapInfo.gets("execute");
+        String execute = mapInfo.gets(defn::MapInfo::EXECUTE);
         if(!execute.isEmpty())
         {
             Con_Execute(CMDS_SCRIPT, execute.toUtf8().constData(), true, false);
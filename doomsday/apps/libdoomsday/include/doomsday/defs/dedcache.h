@@ -0,0 +1,154 @@
+/** @file dedcache.h  Cache of compiled DED definitions.
+ *
+ * @authors Copyright © 2015 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#ifndef LIBDOOMSDAY_DEDCACHE_H
+#define LIBDOOMSDAY_DEDCACHE_H
+
+#include "../libdoomsday.h"
+#include "ded.h"
+
+#include <de/Block>
+#include <de/NativePath>
+#include <QList>
+
+/**
+ * Binary image of parsed DED definitions, stored in a native file so that the
+ * definitions do not need to be parsed again on the next startup.
+ *
+ * The image is identified by a key composed of the contents of every source
+ * that was parsed (including Included files), the game, the command line
+ * (which affects conditional includes), and the definitions that existed
+ * before parsing began (e.g., generated materials). Reading the definitions
+ * is therefore done in two steps: first the sources are only read and hashed,
+ * and if the key does not match the stored image, the sources read in the
+ * first step are parsed:
+ *
+ * @code
+ * DEDCache cache(path);
+ * cache.beginChecking(defs);
+ * readSources(); // DED_ReadData() etc.
+ * if(!cache.tryLoad(defs))
+ * {
+ *     cache.parse(defs);
+ *     cache.save(defs);
+ * }
+ * @endcode
+ *
+ * Directives that have effects outside the definitions (ModelPath) are stored
+ * in the image as well, and are applied again when the image is loaded.
+ *
+ * DEDArray elements are stored in their native memory layout, so the key also
+ * describes the layout of the stored structs. An image written by a build
+ * with a different layout is not used.
+ *
+ * @ingroup data
+ */
+class LIBDOOMSDAY_PUBLIC DEDCache
+{
+public:
+    /// A parsed source of definitions.
+    struct Source
+    {
+        de::String path;
+        de::Block hash;     ///< Hash of the source text.
+        bool custom;        ///< Source is a user supplied add-on.
+        bool included;      ///< Read via an Include directive.
+        de::Block text;     ///< Source text. Only kept until the sources are parsed.
+
+        bool operator == (Source const &other) const {
+            return path == other.path && hash == other.hash &&
+                   custom == other.custom && included == other.included;
+        }
+    };
+    typedef QList<Source> Sources;
+
+public:
+    /**
+     * @param nativePath  File where the compiled definitions are stored.
+     */
+    DEDCache(de::NativePath const &nativePath);
+
+    /**
+     * Begins the checking pass. Until tryLoad() is called, sources given to
+     * DED_ReadData() are only hashed and kept for parse(), not parsed.
+     *
+     * @param ded  Definitions as they are before any sources are parsed.
+     */
+    void beginChecking(ded_t const &ded);
+
+    /**
+     * Ends the checking pass and loads the compiled definitions, if they were
+     * compiled from the same sources.
+     *
+     * @param ded  Definitions. Replaced with the compiled ones if loaded.
+     *
+     * @return @c true, if the definitions were loaded.
+     */
+    bool tryLoad(ded_t &ded);
+
+    /**
+     * Parses the sources read during the checking pass, in the order they were
+     * read. The included files are recorded. Must be called after tryLoad()
+     * has failed.
+     *
+     * @param ded  Definitions where the parsed definitions are added.
+     */
+    void parse(ded_t &ded);
+
+    /**
+     * Writes the compiled definitions to the file.
+     *
+     * @param ded  Parsed definitions.
+     */
+    void save(ded_t const &ded);
+
+    /**
+     * Notifies the cache being used that a source is about to be parsed.
+     * Called by DED_ReadData().
+     *
+     * @param path      Path of the source.
+     * @param text      Source text (null-terminated).
+     * @param custom    The source is a user supplied add-on.
+     * @param included  The source is being read via an Include directive.
+     *
+     * @return @c true, if the source should be parsed; @c false if only the
+     * sources are being checked.
+     */
+    static bool recordSource(de::String const &path, char const *text, bool custom, bool included);
+
+    /**
+     * Notifies the cache being used that a ModelPath directive was parsed, so
+     * that it can be applied again when the compiled definitions are loaded.
+     * Called by DED_AddModelPath().
+     *
+     * @param nativeDirPath  Native path of the model directory.
+     */
+    static void recordModelPath(de::String const &nativeDirPath);
+
+    /**
+     * Computes the hash of a definition source text.
+     *
+     * @param text  Null-terminated text.
+     */
+    static de::Block hashSource(char const *text);
+
+private:
+    DENG2_PRIVATE(d)
+};
+
+#endif // LIBDOOMSDAY_DEDCACHE_H
@@ -24,6 +24,7 @@
 
 #include "../libdoomsday.h"
 #include "ded.h"
+#include <de/Block>
 #include <de/String>
 
 LIBDOOMSDAY_PUBLIC void Def_ReadProcessDED(ded_t *defs, de::String path);
@@ -49,6 +50,23 @@ LIBDOOMSDAY_PUBLIC int DED_ReadData(ded_t *ded, char const *buffer, de::String s
  */
 int DED_Read(ded_t *ded, de::String path);
 
+/**
+ * Adds a directory to the search paths of models (ModelPath directive).
+ *
+ * @param nativeDirPath  Native path of the directory.
+ */
+void DED_AddModelPath(de::String const &nativeDirPath);
+
+/**
+ * Reads the text of a definition file without parsing it.
+ *
+ * @param path  Path of the file, as given to Def_ReadProcessDED().
+ * @param text  The contents of the file are written here.
+ *
+ * @return  @c true, if the file was found.
+ */
+bool DED_ReadSource(de::String path, de::Block &text);
+
 void DED_SetError(de::String const &message);
 
 LIBDOOMSDAY_PUBLIC char const *DED_Error();
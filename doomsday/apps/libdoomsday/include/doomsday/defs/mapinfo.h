@@ -21,6 +21,7 @@
 
 #include "definition.h"
 #include <de/RecordAccessor>
+#include <de/RecordKey>
 
 /// @todo These values should be tweaked a bit.
 #define DEFAULT_FOG_START       0
@@ -37,6 +38,13 @@ namespace defn {
  */
 class LIBDOOMSDAY_PUBLIC MapInfo : public Definition
 {
+public:
+    // Keys of the fields looked up while a map is running.
+    static de::RecordKey const AMBIENT;
+    static de::RecordKey const GRAVITY;
+    static de::RecordKey const SKY_ID;
+    static de::RecordKey const EXECUTE;
+
 public:
     MapInfo()                     : Definition() {}
     MapInfo(MapInfo const &other) : Definition(other) {}
@@ -185,6 +185,7 @@ public:
      * Returns @c true iff the index contains one or more lumps with a matching @a path.
      */
     bool contains(Path const &path) const;
+    bool contains(PathView const &path) const;
 
     /**
      * Finds all indices for lumps with a matching @a path.
@@ -197,6 +198,7 @@ public:
      * @see findFirst(), findLast()
      */
     int findAll(Path const &path, FoundIndices &found) const;
+    int findAll(PathView const &path, FoundIndices &found) const;
 
     /**
      * Returns the index of the @em first loaded lump with a matching @a path.
@@ -205,6 +207,7 @@ public:
      * @see findLast(), findAll()
      */
     lumpnum_t findFirst(Path const &path) const;
+    lumpnum_t findFirst(PathView const &path) const;
 
     /**
      * Returns the index of the @em last loaded lump with a matching @a path.
@@ -213,6 +216,7 @@ public:
      * @see findFirst(), findAll()
      */
     lumpnum_t findLast(Path const &path) const;
+    lumpnum_t findLast(PathView const &path) const;
 
     /**
      * Lookup a file at specific offset in the index.
@@ -32,6 +32,20 @@
  */
 LIBDOOMSDAY_PUBLIC int WAV_CheckFormat(const char* data);
 
+/**
+ * Reads the format of a WAV sample from a memory buffer without loading the
+ * sample data. All parameters must be passed, no NULLs are allowed.
+ *
+ * @param data        Source data.
+ * @param datalength  Length of the source data.
+ * @param bits        Bits per sample is written here.
+ * @param rate        Sample rate is written here.
+ * @param samples     Number of samples is written here.
+ *
+ * @return @c true, if the data is a mono PCM sample that WAV_MemoryLoad() can load.
+ */
+LIBDOOMSDAY_PUBLIC dd_bool WAV_MemoryInfo(const byte* data, size_t datalength, int* bits, int* rate, int* samples);
+
 /**
  * Loads a WAV sample from a memory buffer. All parameters must be passed, no
  * NULLs are allowed.
@@ -0,0 +1,661 @@
+/** @file dedcache.cpp  Cache of compiled DED definitions.
+ *
+ * @authors Copyright © 2015 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#include "doomsday/defs/dedcache.h"
+#include "doomsday/defs/dedfile.h"
+
+#include <de/App>
+#include <de/ByteRefArray>
+#include <de/DirectoryFeed>
+#include <de/Log>
+#include <de/Reader>
+#include <de/Writer>
+#include <de/game/Game>
+#include <de/memory.h>
+#include <QCryptographicHash>
+#include <QFile>
+#include <QStringList>
+#include <cstring>
+#include <type_traits>
+
+using namespace de;
+
+static duint32 const IMAGE_MAGIC = 0x43444544; // "DEDC"
+
+/**
+ * Revision of the image format. Increase this also when the parser or the
+ * members of the definition structs change, because images written earlier
+ * would then no longer produce the same definitions.
+ */
+static duint16 const IMAGE_VERSION = 2;
+
+/// The cache whose pass is in progress.
+static DEDCache *activeCache;
+
+/*
+ * Serialization of the definitions. DEDArray elements are written as is, followed
+ * by the data they own (which are restored in place of the copied pointers).
+ */
+
+static void writeUri(Writer &to, de::Uri const *uri)
+{
+    to << dbyte(uri? 1 : 0);
+    if(uri) *uri >> to;
+}
+
+static de::Uri *readUri(Reader &from)
+{
+    dbyte present;
+    from >> present;
+    if(!present) return nullptr;
+
+    de::Uri *uri = new de::Uri;
+    *uri << from;
+    return uri;
+}
+
+static void writeText(Writer &to, char const *text)
+{
+    to << dbyte(text? 1 : 0);
+    if(text) to << Block(text);
+}
+
+static char *readText(Reader &from)
+{
+    dbyte present;
+    from >> present;
+    if(!present) return nullptr;
+
+    Block text;
+    from >> text;
+    char *str = (char *) M_Malloc(text.size() + 1);
+    std::memcpy(str, text.constData(), text.size());
+    str[text.size()] = 0;
+    return str;
+}
+
+template <typename PODType> static void writeArray(Writer &, DEDArray<PODType> const &);
+template <typename PODType> static void readArray(Reader &, DEDArray<PODType> &);
+
+// Elements that own nothing.
+static void writeOwned(Writer &, ded_mobj_t const &) {}
+static void readOwned (Reader &, ded_mobj_t &) {}
+static void writeOwned(Writer &, ded_sprid_t const &) {}
+static void readOwned (Reader &, ded_sprid_t &) {}
+static void writeOwned(Writer &, ded_ptcstage_t const &) {}
+static void readOwned (Reader &, ded_ptcstage_t &) {}
+static void writeOwned(Writer &, ded_sectortype_t const &) {}
+static void readOwned (Reader &, ded_sectortype_t &) {}
+
+static void writeOwned(Writer &to, ded_uri_t const &e) { writeUri(to, e.uri); }
+static void readOwned (Reader &from, ded_uri_t &e) { e.uri = readUri(from); }
+
+static void writeOwned(Writer &to, ded_state_t const &e) { writeText(to, e.execute); }
+static void readOwned (Reader &from, ded_state_t &e) { e.execute = readText(from); }
+
+static void writeOwned(Writer &to, ded_light_t const &e)
+{
+    writeUri(to, e.up);
+    writeUri(to, e.down);
+    writeUri(to, e.sides);
+    writeUri(to, e.flare);
+}
+
+static void readOwned(Reader &from, ded_light_t &e)
+{
+    e.up    = readUri(from);
+    e.down  = readUri(from);
+    e.sides = readUri(from);
+    e.flare = readUri(from);
+}
+
+static void writeOwned(Writer &to, ded_sound_t const &e) { writeUri(to, e.ext); }
+static void readOwned (Reader &from, ded_sound_t &e) { e.ext = readUri(from); }
+
+static void writeOwned(Writer &to, ded_text_t const &e) { writeText(to, e.text); }
+static void readOwned (Reader &from, ded_text_t &e) { e.text = readText(from); }
+
+static void writeOwned(Writer &to, ded_tenviron_t const &e) { writeArray(to, e.materials); }
+static void readOwned (Reader &from, ded_tenviron_t &e) { readArray(from, e.materials); }
+
+static void writeOwned(Writer &to, ded_value_t const &e)
+{
+    writeText(to, e.id);
+    writeText(to, e.text);
+}
+
+static void readOwned(Reader &from, ded_value_t &e)
+{
+    e.id   = readText(from);
+    e.text = readText(from);
+}
+
+static void writeOwned(Writer &to, ded_linetype_t const &e)
+{
+    writeUri(to, e.actMaterial);
+    writeUri(to, e.deactMaterial);
+}
+
+static void readOwned(Reader &from, ded_linetype_t &e)
+{
+    e.actMaterial   = readUri(from);
+    e.deactMaterial = readUri(from);
+}
+
+static void writeOwned(Writer &to, ded_detailtexture_t const &e)
+{
+    writeUri(to, e.material1);
+    writeUri(to, e.material2);
+    writeUri(to, e.stage.texture);
+}
+
+static void readOwned(Reader &from, ded_detailtexture_t &e)
+{
+    e.material1     = readUri(from);
+    e.material2     = readUri(from);
+    e.stage.texture = readUri(from);
+}
+
+static void writeOwned(Writer &to, ded_ptcgen_t const &e)
+{
+    writeUri(to, e.material);
+    writeUri(to, e.map);
+    writeArray(to, e.stages);
+}
+
+static void readOwned(Reader &from, ded_ptcgen_t &e)
+{
+    e.stateNext = nullptr; // Linked at runtime.
+    e.material  = readUri(from);
+    e.map       = readUri(from);
+    readArray(from, e.stages);
+}
+
+static void writeOwned(Writer &to, ded_reflection_t const &e)
+{
+    writeUri(to, e.material);
+    writeUri(to, e.stage.texture);
+    writeUri(to, e.stage.maskTexture);
+}
+
+static void readOwned(Reader &from, ded_reflection_t &e)
+{
+    e.material          = readUri(from);
+    e.stage.texture     = readUri(from);
+    e.stage.maskTexture = readUri(from);
+}
+
+static void writeOwned(Writer &to, ded_group_member_t const &e) { writeUri(to, e.material); }
+static void readOwned (Reader &from, ded_group_member_t &e) { e.material = readUri(from); }
+
+static void writeOwned(Writer &to, ded_group_t const &e) { writeArray(to, e.members); }
+static void readOwned (Reader &from, ded_group_t &e) { readArray(from, e.members); }
+
+static void writeOwned(Writer &to, ded_compositefont_mappedcharacter_t const &e) { writeUri(to, e.path); }
+static void readOwned (Reader &from, ded_compositefont_mappedcharacter_t &e) { e.path = readUri(from); }
+
+static void writeOwned(Writer &to, ded_compositefont_t const &e)
+{
+    writeUri(to, e.uri);
+    writeArray(to, e.charMap);
+}
+
+static void readOwned(Reader &from, ded_compositefont_t &e)
+{
+    e.uri = readUri(from);
+    readArray(from, e.charMap);
+}
+
+template <typename PODType>
+static void writeLayout(Writer &to)
+{
+    to << duint32(sizeof(PODType)) << duint32(std::alignment_of<PODType>::value);
+}
+
+/**
+ * Describes the memory layout of the elements that are stored as is. It depends
+ * on the compiler and its options as well as the definition structs.
+ */
+static Block layoutSignature()
+{
+    Block sig;
+    Writer to(sig);
+    to << dbyte(sizeof(void *)) << dbyte(sizeof(ded_count_t));
+    writeLayout<ded_mobj_t>(to);
+    writeLayout<ded_state_t>(to);
+    writeLayout<ded_sprid_t>(to);
+    writeLayout<ded_light_t>(to);
+    writeLayout<ded_sound_t>(to);
+    writeLayout<ded_text_t>(to);
+    writeLayout<ded_tenviron_t>(to);
+    writeLayout<ded_uri_t>(to);
+    writeLayout<ded_value_t>(to);
+    writeLayout<ded_detailtexture_t>(to);
+    writeLayout<ded_ptcgen_t>(to);
+    writeLayout<ded_ptcstage_t>(to);
+    writeLayout<ded_reflection_t>(to);
+    writeLayout<ded_group_t>(to);
+    writeLayout<ded_group_member_t>(to);
+    writeLayout<ded_linetype_t>(to);
+    writeLayout<ded_sectortype_t>(to);
+    writeLayout<ded_compositefont_t>(to);
+    writeLayout<ded_compositefont_mappedcharacter_t>(to);
+    return sig;
+}
+
+template <typename PODType>
+static void writeArray(Writer &to, DEDArray<PODType> const &array)
+{
+    to << dint32(array.size());
+    for(int i = 0; i < array.size(); ++i)
+    {
+        to.writePresetSize(ByteRefArray(&array[i], sizeof(PODType)));
+        writeOwned(to, array[i]);
+    }
+}
+
+/**
+ * Reads the elements of an array. The current contents of @a array are not
+ * released: it is either empty or a plain copy from the image.
+ */
+template <typename PODType>
+static void readArray(Reader &from, DEDArray<PODType> &array)
+{
+    array.elements = nullptr;
+    array.count    = ded_count_t();
+
+    dint32 count;
+    from >> count;
+    if(count <= 0) return;
+
+    for(int i = 0; i < count; ++i)
+    {
+        // Only fully restored elements are put in the array, so it can be
+        // released normally even if reading fails. Like in DEDArray itself,
+        // element constructors and destructors are not called.
+        typename std::aligned_storage<sizeof(PODType), std::alignment_of<PODType>::value>::type elem;
+        ByteRefArray elemBytes(&elem, sizeof(PODType));
+        from.readPresetSize(elemBytes);
+        readOwned(from, *reinterpret_cast<PODType *>(&elem));
+        std::memcpy(array.append(), &elem, sizeof(PODType));
+    }
+}
+
+static void writeRegister(Writer &to, DEDRegister const &reg)
+{
+    to << dint32(reg.size());
+    for(int i = 0; i < reg.size(); ++i)
+    {
+        to << reg[i];
+    }
+}
+
+static void readRegister(Reader &from, DEDRegister &reg)
+{
+    dint32 count;
+    from >> count;
+    while(count-- > 0)
+    {
+        // The register indexes the definition as its members are added.
+        from >> reg.append();
+    }
+}
+
+static void writeDefinitions(Writer &to, ded_t const &ded)
+{
+    to << dint32(ded.version) << dint32(ded.modelFlags) << ded.modelScale << ded.modelOffset;
+
+    writeRegister(to, ded.flags);
+    writeRegister(to, ded.episodes);
+    writeRegister(to, ded.materials);
+    writeRegister(to, ded.models);
+    writeRegister(to, ded.skies);
+    writeRegister(to, ded.musics);
+    writeRegister(to, ded.mapInfos);
+    writeRegister(to, ded.finales);
+    writeRegister(to, ded.decorations);
+
+    writeArray(to, ded.mobjs);
+    writeArray(to, ded.states);
+    writeArray(to, ded.sprites);
+    writeArray(to, ded.lights);
+    writeArray(to, ded.sounds);
+    writeArray(to, ded.text);
+    writeArray(to, ded.textureEnv);
+    writeArray(to, ded.values);
+    writeArray(to, ded.details);
+    writeArray(to, ded.ptcGens);
+    writeArray(to, ded.reflections);
+    writeArray(to, ded.groups);
+    writeArray(to, ded.lineTypes);
+    writeArray(to, ded.sectorTypes);
+    writeArray(to, ded.compositeFonts);
+}
+
+/// @param ded  Empty definitions.
+static void readDefinitions(Reader &from, ded_t &ded)
+{
+    dint32 version, modelFlags;
+    from >> version >> modelFlags >> ded.modelScale >> ded.modelOffset;
+    ded.version    = version;
+    ded.modelFlags = modelFlags;
+
+    readRegister(from, ded.flags);
+    readRegister(from, ded.episodes);
+    readRegister(from, ded.materials);
+    readRegister(from, ded.models);
+    readRegister(from, ded.skies);
+    readRegister(from, ded.musics);
+    readRegister(from, ded.mapInfos);
+    readRegister(from, ded.finales);
+    readRegister(from, ded.decorations);
+
+    readArray(from, ded.mobjs);
+    readArray(from, ded.states);
+    readArray(from, ded.sprites);
+    readArray(from, ded.lights);
+    readArray(from, ded.sounds);
+    readArray(from, ded.text);
+    readArray(from, ded.textureEnv);
+    readArray(from, ded.values);
+    readArray(from, ded.details);
+    readArray(from, ded.ptcGens);
+    readArray(from, ded.reflections);
+    readArray(from, ded.groups);
+    readArray(from, ded.lineTypes);
+    readArray(from, ded.sectorTypes);
+    readArray(from, ded.compositeFonts);
+}
+
+static void writeSources(Writer &to, DEDCache::Sources const &sources)
+{
+    to << duint32(sources.size());
+    foreach(DEDCache::Source const &src, sources)
+    {
+        to << src.path << src.hash << dbyte(src.custom? 1 : 0) << dbyte(src.included? 1 : 0);
+    }
+}
+
+static DEDCache::Sources readSources(Reader &from)
+{
+    DEDCache::Sources sources;
+    duint32 count;
+    from >> count;
+    while(count-- > 0)
+    {
+        DEDCache::Source src;
+        dbyte custom, included;
+        from >> src.path >> src.hash >> custom >> included;
+        src.custom   = (custom != 0);
+        src.included = (included != 0);
+        sources << src;
+    }
+    return sources;
+}
+
+DENG2_PIMPL_NOREF(DEDCache)
+{
+    enum Pass { NoPass, Checking, Parsing };
+
+    NativePath nativePath;
+    Pass pass = NoPass;
+    Block initial;    ///< Definitions before parsing.
+    Block context;    ///< Hash of everything but the sources that affects the result.
+    Sources checked;  ///< All sources, recorded during the checking pass.
+    Sources included; ///< Included sources, recorded during the parsing pass.
+    QStringList modelPaths; ///< Recorded during the parsing pass.
+
+    ~Instance()
+    {
+        endPass();
+    }
+
+    void beginPass(Pass newPass)
+    {
+        DENG2_ASSERT(!activeCache || activeCache->d.get() == this);
+        pass = newPass;
+    }
+
+    void endPass()
+    {
+        pass = NoPass;
+        if(activeCache && activeCache->d.get() == this)
+        {
+            activeCache = nullptr;
+        }
+    }
+
+    /**
+     * Checks that the image was compiled from the same sources, in the same
+     * context.
+     */
+    bool readKey(Reader &from) const
+    {
+        duint32 magic;
+        duint16 version;
+        from >> magic >> version;
+        if(magic != IMAGE_MAGIC || version != IMAGE_VERSION) return false;
+        from.withHeader();
+
+        Block layout, imageContext;
+        from >> layout >> imageContext;
+        if(layout != layoutSignature() || imageContext != context)
+        {
+            return false;
+        }
+
+        if(readSources(from) != checked) return false;
+
+        // Included files were not read during the checking pass.
+        foreach(Source const &src, readSources(from))
+        {
+            Block text;
+            if(!DED_ReadSource(src.path, text) || hashSource(text.constData()) != src.hash)
+            {
+                LOG_RES_VERBOSE("\"%s\" has changed") << NativePath(src.path).pretty();
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+DEDCache::DEDCache(NativePath const &nativePath) : d(new Instance)
+{
+    d->nativePath = nativePath;
+}
+
+void DEDCache::beginChecking(ded_t const &ded)
+{
+    activeCache = this;
+    d->beginPass(Instance::Checking);
+    d->checked.clear();
+
+    // Conditional includes depend on the game and the command line.
+    Block ctx;
+    Writer writer(ctx);
+    writer << (App::game().isNull()? String() : App::game().id());
+    for(int i = 0; i < App::commandLine().count(); ++i)
+    {
+        writer << App::commandLine().at(i);
+    }
+
+    // The sources may modify existing definitions.
+    d->initial.clear();
+    Writer initialWriter(d->initial);
+    writeDefinitions(initialWriter, ded);
+    writer << d->initial;
+
+    d->context = QCryptographicHash::hash(ctx, QCryptographicHash::Md5);
+}
+
+bool DEDCache::tryLoad(ded_t &ded)
+{
+    LOG_AS("DEDCache");
+    DENG2_ASSERT(d->pass == Instance::Checking);
+
+    d->endPass();
+
+    QFile file(d->nativePath);
+    if(!file.open(QFile::ReadOnly)) return false;
+
+    // The image is read straight from the mapped file.
+    dsize const size = dsize(file.size());
+    uchar const *mapped = file.map(0, file.size());
+    if(!mapped) return false;
+
+    ByteRefArray const image(mapped, size);
+    Reader from(image);
+    try
+    {
+        if(!d->readKey(from)) return false;
+    }
+    catch(Error const &er)
+    {
+        LOG_RES_VERBOSE("Ignoring %s: %s") << d->nativePath.pretty() << er.asText();
+        return false;
+    }
+
+    try
+    {
+        ded.clear();
+        readDefinitions(from, ded);
+
+        QStringList modelPaths;
+        duint32 count;
+        from >> count;
+        while(count-- > 0)
+        {
+            String path;
+            from >> path;
+            modelPaths << path;
+        }
+        d->checked.clear(); // Texts not needed any more.
+
+        // Apply the directives that were parsed when the image was compiled.
+        foreach(String const &path, modelPaths)
+        {
+            DED_AddModelPath(path);
+        }
+
+        LOG_RES_VERBOSE("Loaded compiled definitions from %s") << d->nativePath.pretty();
+        return true;
+    }
+    catch(Error const &er)
+    {
+        LOG_RES_WARNING("Failed to load %s: %s") << d->nativePath.pretty() << er.asText();
+
+        // Back to where we were.
+        ded.clear();
+        Reader initialReader(d->initial);
+        readDefinitions(initialReader, ded);
+    }
+    return false;
+}
+
+void DEDCache::parse(ded_t &ded)
+{
+    LOG_AS("DEDCache");
+    DENG2_ASSERT(d->pass == Instance::NoPass);
+
+    activeCache = this;
+    d->beginPass(Instance::Parsing);
+    d->included.clear();
+    d->modelPaths.clear();
+
+    for(int i = 0; i < d->checked.size(); ++i)
+    {
+        Source &src = d->checked[i];
+        if(!DED_ReadData(&ded, src.text.constData(), src.path, src.custom))
+        {
+            App_FatalError("DEDCache::parse: %s\n", DED_Error());
+        }
+        src.text.clear(); // Not needed any more.
+    }
+
+    d->endPass();
+}
+
+void DEDCache::save(ded_t const &ded)
+{
+    LOG_AS("DEDCache");
+    DENG2_ASSERT(d->pass == Instance::NoPass);
+
+    Block image;
+    Writer to(image);
+    to << IMAGE_MAGIC << IMAGE_VERSION;
+    to.withHeader();
+    to << layoutSignature() << d->context;
+    writeSources(to, d->checked);
+    writeSources(to, d->included);
+    writeDefinitions(to, ded);
+    to << duint32(d->modelPaths.size());
+    foreach(String const &path, d->modelPaths)
+    {
+        to << path;
+    }
+
+    NativePath const dir = d->nativePath.fileNamePath();
+    if(!dir.isEmpty() && !DirectoryFeed::exists(dir))
+    {
+        DirectoryFeed::createDir(dir);
+    }
+
+    QFile file(d->nativePath);
+    if(!file.open(QFile::WriteOnly | QFile::Truncate))
+    {
+        LOG_RES_WARNING("Failed to write %s") << d->nativePath.pretty();
+        return;
+    }
+    file.write(image);
+}
+
+bool DEDCache::recordSource(String const &path, char const *text, bool custom, bool included)
+{
+    if(!activeCache) return true;
+
+    Instance &inst = *activeCache->d;
+    if(inst.pass == Instance::Checking)
+    {
+        // The text is kept so that the sources need not be read again if
+        // they have to be parsed.
+        Source const src = { path, hashSource(text), custom, included, Block(text) };
+        inst.checked << src;
+        return false;
+    }
+    if(inst.pass == Instance::Parsing && included)
+    {
+        Source const src = { path, hashSource(text), custom, included, Block() };
+        inst.included << src;
+    }
+    return true;
+}
+
+void DEDCache::recordModelPath(String const &nativeDirPath)
+{
+    if(activeCache && activeCache->d->pass == Instance::Parsing)
+    {
+        activeCache->d->modelPaths << nativeDirPath;
+    }
+}
+
+Block DEDCache::hashSource(char const *text)
+{
+    return QCryptographicHash::hash(QByteArray::fromRawData(text, qstrlen(text)),
+                                    QCryptographicHash::Md5);
+}
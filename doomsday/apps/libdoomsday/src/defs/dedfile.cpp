@@ -22,6 +22,7 @@
 
 #include <de/App>
 #include <de/Log>
+#include "doomsday/defs/dedcache.h"
 #include "doomsday/defs/dedparser.h"
 #include "doomsday/filesys/fs_main.h"
 #include "doomsday/filesys/fs_util.h"
@@ -29,6 +30,7 @@
 using namespace de;
 
 static char dedReadError[512];
+static int dedReadDepth; ///< Nonzero while parsing (includes are nested).
 
 void DED_SetError(String const &message)
 {
@@ -137,7 +139,55 @@ int DED_Read(ded_t *ded, String path)
 
 int DED_ReadData(ded_t *ded, char const *buffer, String sourceFile, bool sourceIsCustom)
 {
-    return DEDParser(ded).parse(buffer, sourceFile, sourceIsCustom);
+    if(!DEDCache::recordSource(sourceFile, buffer, sourceIsCustom, dedReadDepth > 0))
+    {
+        return true; // Not parsed now.
+    }
+
+    dedReadDepth++;
+    int const result = DEDParser(ded).parse(buffer, sourceFile, sourceIsCustom);
+    dedReadDepth--;
+    return result;
+}
+
+void DED_AddModelPath(String const &nativeDirPath)
+{
+    de::Uri newSearchPath = de::Uri::fromNativeDirPath(NativePath(nativeDirPath));
+    FS1::Scheme &scheme = App_FileSystem().scheme(ResourceClass::classForId(RC_MODEL).defaultScheme());
+    scheme.addSearchPath(reinterpret_cast<de::Uri const &>(newSearchPath), FS1::ExtraPaths);
+
+    DEDCache::recordModelPath(nativeDirPath);
+}
+
+bool DED_ReadSource(String path, Block &text)
+{
+    try
+    {
+        App::rootFolder().locate<File const>(path) >> text;
+        return true;
+    }
+    catch(...)
+    {
+        // Try FS1 as fallback.
+    }
+
+    try
+    {
+        // Relative paths are relative to the native working directory.
+        String fullPath = (NativePath::workPath() / NativePath(path).expand()).withSeparators('/');
+        QScopedPointer<FileHandle> hndl(&App_FileSystem().openFile(fullPath, "rb"));
+
+        hndl->seek(0, SeekEnd);
+        text.resize(hndl->tell());
+        hndl->rewind();
+        hndl->read((uint8_t *)text.data(), text.size());
+        App_FileSystem().releaseFile(hndl->file());
+        return true;
+    }
+    catch(FS1::NotFoundError const &)
+    {} // Ignore.
+
+    return false;
 }
 
 char const *DED_Error()
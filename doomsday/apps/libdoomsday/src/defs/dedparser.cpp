@@ -887,9 +887,7 @@ DENG2_PIMPL(DEDParser)
                 READSTR(label);
                 CHECKSC;
 
-                de::Uri newSearchPath = de::Uri::fromNativeDirPath(NativePath(label));
-                FS1::Scheme& scheme = App_FileSystem().scheme(ResourceClass::classForId(RC_MODEL).defaultScheme());
-                scheme.addSearchPath(reinterpret_cast<de::Uri const&>(newSearchPath), FS1::ExtraPaths);
+                DED_AddModelPath(label);
             }
 
             if(ISTOKEN("Header"))
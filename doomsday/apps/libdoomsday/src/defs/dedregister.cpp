@@ -22,6 +22,7 @@
 #include <de/DictionaryValue>
 #include <de/TextValue>
 #include <de/RecordValue>
+#include <de/RecordKey>
 #include <QSet>
 #include <QMap>
 
@@ -36,7 +37,9 @@ DENG2_PIMPL(DEDRegister)
     Record *names;
     struct Key {
         LookupFlags flags;
-        Key(LookupFlags const &f = DefaultLookup) : flags(f) {}
+        RecordKey lookupName; ///< Name of the lookup dictionary in the register.
+        explicit Key(String const &name = String(), LookupFlags const &f = DefaultLookup)
+            : flags(f), lookupName(name + "Lookup") {}
     };
     typedef QMap<String, Key> Keys;
     Keys keys;
@@ -78,8 +81,9 @@ DENG2_PIMPL(DEDRegister)
 
     void addKey(String const &name, LookupFlags const &flags)
     {
-        keys.insert(name, Key(flags));
-        names->addDictionary(name + "Lookup");
+        Key const key(name, flags);
+        keys.insert(name, key);
+        names->addDictionary(key.lookupName.name());
     }
 
     ArrayValue &order()
@@ -94,12 +98,19 @@ DENG2_PIMPL(DEDRegister)
 
     DictionaryValue &lookup(String const &keyName)
     {
-        return (*names)[keyName + "Lookup"].value<DictionaryValue>();
+        DENG2_ASSERT(keys.contains(keyName));
+        return (*names)[keys.constFind(keyName).value().lookupName].value<DictionaryValue>();
     }
 
     DictionaryValue const &lookup(String const &keyName) const
     {
-        return (*names)[keyName + "Lookup"].value<DictionaryValue>();
+        DENG2_ASSERT(keys.contains(keyName));
+        return lookup(keys.constFind(keyName).value());
+    }
+
+    DictionaryValue const &lookup(Key const &key) const
+    {
+        return (*names)[key.lookupName].value<DictionaryValue>();
     }
 
     template <typename Type>
@@ -115,7 +126,7 @@ DENG2_PIMPL(DEDRegister)
             value = value.lower();
         }
 
-        return operation(lookup(key), value);
+        return operation(lookup(foundKey.value()), value);
     }
 
     Record const *tryFind(String const &key, String const &value) const
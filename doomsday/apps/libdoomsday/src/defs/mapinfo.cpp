@@ -27,6 +27,11 @@ using namespace de;
 
 namespace defn {
 
+RecordKey const MapInfo::AMBIENT("ambient");
+RecordKey const MapInfo::GRAVITY("gravity");
+RecordKey const MapInfo::SKY_ID ("skyId");
+RecordKey const MapInfo::EXECUTE("execute");
+
 void MapInfo::resetToDefaults()
 {
     Definition::resetToDefaults();
@@ -725,7 +725,7 @@ lumpnum_t FS1::lumpNumForName(String name)
     }
 
     // Perform the search.
-    return d->primaryIndex.findLast(Path(name));
+    return d->primaryIndex.findLast(PathView(name));
 }
 
 void FS1::releaseFile(File1 &file)
@@ -485,6 +485,35 @@ DENG2_PIMPL(LumpIndex)
         flagDuplicateLumps(pruneFlags);
         pruneFlaggedLumps(pruneFlags);
     }
+
+    /**
+     * Calls @a func for each lump whose path matches @a path, in reverse load
+     * order (the most recently loaded first). Iteration stops if @a func returns
+     * @c false.
+     */
+    template <typename PathType, typename Func>
+    void forMatchingLumps(PathType const &path, Func func)
+    {
+        if(path.isEmpty() || lumps.empty()) return;
+
+        pruneDuplicatesIfNeeded();
+        buildLumpsByPathIfNeeded();
+
+        // Perform the search.
+        DENG2_ASSERT(!lumpsByPath.isNull());
+        ushort hash = path.lastSegment().hash() % lumpsByPath->size();
+        for(int idx = (*lumpsByPath)[hash].head; idx != -1;
+            idx = (*lumpsByPath)[idx].nextInLoadOrder)
+        {
+            File1 const &lump          = *lumps[idx];
+            PathTree::Node const &node = lump.directoryNode();
+
+            if(!node.comparePath(path, 0))
+            {
+                if(!func(idx)) return;
+            }
+        }
+    }
 };
 
 LumpIndex::LumpIndex(bool pathsAreUnique) : d(new Instance(this))
@@ -604,7 +633,12 @@ bool LumpIndex::catalogues(File1 &file)
 
 bool LumpIndex::contains(Path const &path) const
 {
-    return findFirst(path) >= 0;
+    return findLast(path) >= 0;
+}
+
+bool LumpIndex::contains(PathView const &path) const
+{
+    return findLast(path) >= 0;
 }
 
 int LumpIndex::findAll(Path const &path, FoundIndices &found) const
@@ -612,79 +646,62 @@ int LumpIndex::findAll(Path const &path, FoundIndices &found) const
     LOG_AS("LumpIndex::findAll");
 
     found.clear();
+    d->forMatchingLumps(path, [&found] (lumpnum_t idx) {
+        found.push_front(idx);
+        return true;
+    });
+    return int(found.size());
+}
 
-    if(path.isEmpty() || d->lumps.empty()) return 0;
-
-    d->pruneDuplicatesIfNeeded();
-    d->buildLumpsByPathIfNeeded();
-
-    // Perform the search.
-    DENG2_ASSERT(!d->lumpsByPath.isNull());
-    ushort hash = path.lastSegment().hash() % d->lumpsByPath->size();
-    for(int idx = (*d->lumpsByPath)[hash].head; idx != -1;
-        idx = (*d->lumpsByPath)[idx].nextInLoadOrder)
-    {
-        File1 const &lump          = *d->lumps[idx];
-        PathTree::Node const &node = lump.directoryNode();
-
-        if(!node.comparePath(path, 0))
-        {
-            found.push_front(idx);
-        }
-    }
+int LumpIndex::findAll(PathView const &path, FoundIndices &found) const
+{
+    LOG_AS("LumpIndex::findAll");
 
+    found.clear();
+    d->forMatchingLumps(path, [&found] (lumpnum_t idx) {
+        found.push_front(idx);
+        return true;
+    });
     return int(found.size());
 }
 
 lumpnum_t LumpIndex::findLast(Path const &path) const
 {
-    if(path.isEmpty() || d->lumps.empty()) return -1;
-
-    d->pruneDuplicatesIfNeeded();
-    d->buildLumpsByPathIfNeeded();
-
-    // Perform the search.
-    DENG2_ASSERT(!d->lumpsByPath.isNull());
-    ushort hash = path.lastSegment().hash() % d->lumpsByPath->size();
-    for(int idx = (*d->lumpsByPath)[hash].head; idx != -1;
-        idx = (*d->lumpsByPath)[idx].nextInLoadOrder)
-    {
-        File1 const &lump          = *d->lumps[idx];
-        PathTree::Node const &node = lump.directoryNode();
-
-        if(!node.comparePath(path, 0))
-        {
-            return idx; // This is the lump we are looking for.
-        }
-    }
+    lumpnum_t latest = -1; // Not found.
+    d->forMatchingLumps(path, [&latest] (lumpnum_t idx) {
+        latest = idx; // This is the lump we are looking for.
+        return false;
+    });
+    return latest;
+}
 
-    return -1; // Not found.
+lumpnum_t LumpIndex::findLast(PathView const &path) const
+{
+    lumpnum_t latest = -1; // Not found.
+    d->forMatchingLumps(path, [&latest] (lumpnum_t idx) {
+        latest = idx; // This is the lump we are looking for.
+        return false;
+    });
+    return latest;
 }
 
 lumpnum_t LumpIndex::findFirst(Path const &path) const
 {
-    if(path.isEmpty() || d->lumps.empty()) return -1;
-
-    d->pruneDuplicatesIfNeeded();
-    d->buildLumpsByPathIfNeeded();
-
     lumpnum_t earliest = -1; // Not found.
+    d->forMatchingLumps(path, [&earliest] (lumpnum_t idx) {
+        earliest = idx; // This is now the first lump loaded.
+        return true;
+    });
+    return earliest;
+}
 
-    // Perform the search.
-    DENG2_ASSERT(!d->lumpsByPath.isNull());
-    ushort hash = path.lastSegment().hash() % d->lumpsByPath->size();
-    for(int idx = (*d->lumpsByPath)[hash].head; idx != -1;
-        idx = (*d->lumpsByPath)[idx].nextInLoadOrder)
-    {
-        File1 const &lump          = *d->lumps[idx];
-        PathTree::Node const &node = lump.directoryNode();
-
-        if(!node.comparePath(path, 0))
-        {
-            earliest = idx; // This is now the first lump loaded.
-        }
-    }
-
+lumpnum_t LumpIndex::findFirst(PathView const &path) const
+{
+    lumpnum_t earliest = -1; // Not found.
+    d->forMatchingLumps(path, [&earliest] (lumpnum_t idx) {
+        earliest = idx; // This is now the first lump loaded.
+        return true;
+    });
     return earliest;
 }
 
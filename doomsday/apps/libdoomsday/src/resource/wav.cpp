@@ -73,6 +73,53 @@ int WAV_CheckFormat(const char* data)
     return !strncmp(data, "RIFF", 4) && !strncmp(data + 8, "WAVE", 4);
 }
 
+dd_bool WAV_MemoryInfo(const byte* data, size_t datalength, int* bits, int* rate, int* samples)
+{
+    const byte* end = data + datalength;
+    chunk_hdr_t riff_chunk;
+    wav_format_t wave_format;
+    dd_bool gotFormat = false;
+
+    if(datalength < sizeof(riff_hdr_t) + 4 || !WAV_CheckFormat((const char*)data))
+        return false;
+
+    // Skip the RIFF header and "WAVE".
+    data += sizeof(riff_hdr_t) + 4;
+
+    // Only the chunk headers and the format are read; the samples are skipped.
+    while(end - data >= (ptrdiff_t) sizeof(riff_chunk))
+    {
+        WReadAndAdvance(data, &riff_chunk, sizeof(riff_chunk));
+        riff_chunk.len = DD_ULONG(riff_chunk.len);
+
+        if(!strncmp(riff_chunk.id, "fmt ", 4))
+        {
+            if(end - data < (ptrdiff_t) sizeof(wave_format)) return false;
+            memcpy(&wave_format, data, sizeof(wave_format));
+
+            if(DD_USHORT(wave_format.wFormatTag) != WAVE_FORMAT_PCM ||
+               DD_USHORT(wave_format.wChannels) != 1)
+                return false;
+
+            *bits = DD_USHORT(wave_format.wBitsPerSample);
+            *rate = DD_ULONG(wave_format.dwSamplesPerSec);
+            if(*bits != 8 && *bits != 16) return false;
+            gotFormat = true;
+        }
+        else if(!strncmp(riff_chunk.id, "data", 4))
+        {
+            if(!gotFormat || !wave_format.wBlockAlign) return false;
+
+            *samples = riff_chunk.len / DD_USHORT(wave_format.wBlockAlign);
+            return true;
+        }
+
+        if((size_t) (end - data) < riff_chunk.len) break;
+        data += riff_chunk.len;
+    }
+    return false;
+}
+
 void* WAV_MemoryLoad(const byte* data, size_t datalength, int* bits, int* rate, int* samples)
 {
     const byte* end = data + datalength;
@@ -341,10 +341,11 @@ enum // Line.data references
 #define CHSF_DEACTIVATE_WHEN_DONE   0x1
 #define CHSF_LOOP                   0x2
 
-typedef struct {
-    thinker_t       thinker;
-    Line*           line;
-} xlthinker_t;
+// Line scheduler states.
+enum {
+    XLS_AWAKE, // Thinks every tic.
+    XLS_ASLEEP // Waits for an event or a timer.
+};
 
 // State data for each line.
 typedef struct {
@@ -358,6 +359,12 @@ typedef struct {
     float           fdata;
     int             chIdx; // Chain sequence index.
     float           chTimer; // Chain sequence timer.
+
+    // Scheduler state (not serialized).
+    int             schedState; // XLS_* state.
+    dd_bool         listed; // In the list of awake lines.
+    int             thinkTime; // Map time of the last think (or tic accounted for).
+    int             wakeTime; // Map time of the scheduled wake-up (-1 if none).
 } xgline_t;
 
 // The XG line Classes
@@ -379,7 +386,22 @@ void XL_Init(void);
 // Called when reseting engine state.
 void XL_Update(void);
 
-void XL_Thinker(void *xlThinkerPtr);
+/**
+ * XG lines get to think. Only lines that are awake are processed; idle lines are
+ * asleep until an event or their next timed action wakes them up.
+ */
+void XL_Ticker(void);
+
+/**
+ * Wakes up a sleeping XG line so that it thinks again on the next tic. Must be
+ * called before the state of the line is modified from outside its own thinking.
+ */
+void XL_WakeLine(Line *line);
+
+/**
+ * Brings the timers of a sleeping XG line up to date with the current map time.
+ */
+void XL_UpdateLineTimers(Line *line);
 
 /**
  * Looks for line type definition and sets the line type if one is found.
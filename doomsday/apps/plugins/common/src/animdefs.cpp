@@ -311,9 +311,9 @@ void P_InitPicAnims()
 #if __JHEXEN__
     AnimDefsParser(AutoStr_FromText("Lumps:ANIMDEFS"));
 #else
-    if(CentralLumpIndex().contains("ANIMATED.lmp"))
+    if(CentralLumpIndex().contains(PathView("ANIMATED.lmp")))
     {
-        File1 &lump = CentralLumpIndex()[CentralLumpIndex().findLast("ANIMATED.lmp")];
+        File1 &lump = CentralLumpIndex()[CentralLumpIndex().findLast(PathView("ANIMATED.lmp"))];
 
         // Support this BOOM extension by reading the data and then registering
         // the new animations into Doomsday using the animation groups feature.
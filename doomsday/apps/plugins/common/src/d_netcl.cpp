@@ -110,6 +110,15 @@ void NetCl_UpdateGameState(reader_s *msg)
             << Str_Text(Uri_ToString(gsMapUri))
             << gsRules.asText();
 
+    // Demo keyframes repeat the current map. It only needs to be loaded again
+    // if the demo was seeked (which unloads the map and resets the game).
+    if((gsFlags & GSF_CHANGE_MAP) && (gsFlags & GSF_DEMO) && Get(DD_GAME_READY) &&
+       COMMON_GAMESESSION->hasBegun() &&
+       COMMON_GAMESESSION->mapUri() == *reinterpret_cast<de::Uri *>(gsMapUri))
+    {
+        gsFlags &= ~GSF_CHANGE_MAP;
+    }
+
     // Do we need to change the map?
     if(gsFlags & GSF_CHANGE_MAP)
     {
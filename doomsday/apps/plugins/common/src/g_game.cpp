@@ -418,7 +418,7 @@ void R_LoadColorPalettes()
 #define PALENTRIES          (256)
 #define PALID               (0)
 
-    File1 &playpal = CentralLumpIndex()[CentralLumpIndex().findLast(String(PALLUMPNAME) + ".lmp")];
+    File1 &playpal = CentralLumpIndex()[CentralLumpIndex().findLast(PathView(String(PALLUMPNAME) + ".lmp"))];
 
     customPal = playpal.hasCustom(); // Remember whether we are using a custom palette.
 
@@ -459,9 +459,9 @@ void R_LoadColorPalettes()
                     << lumpName << cl << i;
 
             lumpName += ".lmp";
-            if(CentralLumpIndex().contains(lumpName))
+            if(CentralLumpIndex().contains(PathView(lumpName)))
             {
-                File1 &lump = CentralLumpIndex()[CentralLumpIndex().findLast(lumpName)];
+                File1 &lump = CentralLumpIndex()[CentralLumpIndex().findLast(PathView(lumpName))];
                 uint8_t const *mappings = lump.cache();
                 Str_Appendf(Str_Clear(&xlatId), "%i", 7 * cl + i);
                 R_CreateColorPaletteTranslation(palId, &xlatId, mappings);
@@ -215,9 +215,9 @@ static void prepareFogTexture()
     // Already prepared?
     if(fogEffectData.texture) return;
 
-    if(CentralLumpIndex().contains("menufog.lmp"))
+    if(CentralLumpIndex().contains(PathView("menufog.lmp")))
     {
-        de::File1 &lump       = CentralLumpIndex()[CentralLumpIndex().findLast("menufog.lmp")];
+        de::File1 &lump       = CentralLumpIndex()[CentralLumpIndex().findLast(PathView("menufog.lmp"))];
         uint8_t const *pixels = lump.cache();
         /// @todo fixme: Do not assume dimensions.
         fogEffectData.texture = DGL_NewTextureWithParams(DGL_LUMINANCE, 64, 64,
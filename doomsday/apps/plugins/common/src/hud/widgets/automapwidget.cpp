@@ -1046,7 +1046,7 @@ DENG2_PIMPL(AutomapWidget)
 
         dfloat bgColor[3];
 #if __JHERETIC__ || __JHEXEN__
-        if(!CentralLumpIndex().contains("AUTOPAGE.lmp"))
+        if(!CentralLumpIndex().contains(PathView("AUTOPAGE.lmp")))
         {
             bgColor[0] = .55f; bgColor[1] = .45f; bgColor[2] = .35f;
         }
@@ -1274,11 +1274,11 @@ void AutomapWidget::prepareAssets()  // static
     LumpIndex const &lumpIndex = CentralLumpIndex();
 
     if(autopageLumpNum >= 0)
-        autopageLumpNum = lumpIndex.findLast("autopage.lmp");
+        autopageLumpNum = lumpIndex.findLast(PathView("autopage.lmp"));
 
     if(!amMaskTexture)
     {
-        lumpnum_t lumpNum = lumpIndex.findLast("mapmask.lmp");
+        lumpnum_t lumpNum = lumpIndex.findLast(PathView("mapmask.lmp"));
         if(lumpNum >= 0)
         {
             File1 &file = lumpIndex[lumpNum];
@@ -209,9 +209,9 @@ void P_InitSwitchList()
 
     // Has a custom SWITCHES lump been loaded?
     de::File1 *lump = 0;
-    if(CentralLumpIndex().contains("SWITCHES.lmp"))
+    if(CentralLumpIndex().contains(de::PathView("SWITCHES.lmp")))
     {
-        lump = &CentralLumpIndex()[CentralLumpIndex().findLast("SWITCHES.lmp")];
+        lump = &CentralLumpIndex()[CentralLumpIndex().findLast(de::PathView("SWITCHES.lmp"))];
         App_Log(DE2_RES_VERBOSE, "Processing lump %s::SWITCHES", F_PrettyPath(lump->container().composePath().toUtf8().constData()));
         sList = (switchlist_t *) lump->cache();
     }
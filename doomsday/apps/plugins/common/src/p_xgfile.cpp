@@ -283,7 +283,7 @@ void XG_ReadTypes()
     num_sectypes = 0;
     Z_Free(sectypes); sectypes = 0;
 
-    XG_ReadXGLump(CentralLumpIndex().findLast("DDXGDATA.lmp"));
+    XG_ReadXGLump(CentralLumpIndex().findLast(PathView("DDXGDATA.lmp")));
 }
 
 linetype_t *XG_GetLumpLine(int id)
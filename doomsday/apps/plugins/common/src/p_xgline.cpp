@@ -26,6 +26,8 @@
 #include <stdarg.h>
 #include <stdio.h>
 #include <string.h>
+#include <algorithm>
+#include <vector>
 
 #include "common.h"
 
@@ -48,6 +50,8 @@ using namespace de;
 
 #define XLTIMER_STOPPED 1    // Timer stopped.
 
+#define XL_WHEEL_SIZE   256  // Number of timer wheel slots (power of two).
+
 #define EVTYPESTR(evtype) (evtype == XLE_CHAIN? "CHAIN" \
         : evtype == XLE_CROSS? "CROSS" \
         : evtype == XLE_USE? "USE" \
@@ -137,6 +141,22 @@ static linetype_t typebuffer;
 static char msgbuf[80];
 ThinkerT<mobj_s> dummyThing;
 
+/*
+ * Line scheduler: lines that are awake think every tic. Idle lines are put to
+ * sleep and are woken up either by an event that concerns them or by the timer
+ * wheel, when their next timed action is due.
+ */
+struct xlwakeup_t
+{
+    Line *line;
+    int time;
+};
+typedef std::vector<Line *> XLines;
+typedef std::vector<xlwakeup_t> XLWakeups;
+
+static XLines xlAwake;
+static XLWakeups xlWheel[XL_WHEEL_SIZE];
+
 struct mobj_s *XG_DummyThing()
 {
     return dummyThing;
@@ -747,7 +767,7 @@ void XG_Init(void)
 
 void XG_Ticker(void)
 {
-    // Nothing to do.
+    XL_Ticker(); // Think for lines.
 }
 
 /**
@@ -894,14 +914,80 @@ float XG_RandomPercentFloat(float value, int percent)
     return value * (1 + i);
 }
 
-int findXLThinker(thinker_t *th, void *context)
+/**
+ * Adds @a line to the list of awake lines, unless already there.
+ */
+static void listAwakeLine(Line *line, xgline_t &xg)
 {
-    xlthinker_t *xl = (xlthinker_t *) th;
+    xg.schedState = XLS_AWAKE;
+    xg.wakeTime   = -1;
 
-    if(xl->line == (Line *) context)
-        return true; // Stop iteration, we've found it.
+    if(!xg.listed)
+    {
+        xg.listed = true;
+        xlAwake.push_back(line);
+    }
+}
 
-    return false; // Continue iteration.
+/**
+ * Puts @a line to sleep. If @a wakeTime is not negative, the line will be woken
+ * up by the timer wheel at that map time.
+ */
+static void sleepLine(Line *line, xgline_t &xg, int wakeTime)
+{
+    xg.schedState = XLS_ASLEEP;
+    xg.wakeTime   = wakeTime;
+
+    if(wakeTime >= 0)
+    {
+        xlwakeup_t const wakeup = { line, wakeTime };
+        xlWheel[wakeTime & (XL_WHEEL_SIZE - 1)].push_back(wakeup);
+    }
+}
+
+static void clearSchedule()
+{
+    xlAwake.clear();
+    for(int i = 0; i < XL_WHEEL_SIZE; ++i)
+    {
+        xlWheel[i].clear();
+    }
+}
+
+void XL_UpdateLineTimers(Line *line)
+{
+    if(!line) return;
+
+    xgline_t *xg = P_ToXLine(line)->xg;
+    if(!xg || xg->schedState != XLS_ASLEEP) return;
+
+    // The tics that have passed since the last think. Timers don't run while
+    // the line is disabled (it can't be (re)enabled without waking it up).
+    int const elapsed = (mapTime - 1) - xg->thinkTime;
+    if(elapsed > 0)
+    {
+        if(!xg->disabled && xg->timer >= 0)
+        {
+            xg->timer       += elapsed;
+            xg->tickerTimer += elapsed;
+        }
+        xg->thinkTime = mapTime - 1;
+    }
+}
+
+void XL_WakeLine(Line *line)
+{
+    // Clients rely on the server, they don't do XG themselves.
+    if(IS_CLIENT) return;
+
+    // Dummies (used for chains) are never scheduled.
+    if(!line || P_IsDummy(line)) return;
+
+    xgline_t *xg = P_ToXLine(line)->xg;
+    if(!xg || xg->schedState != XLS_ASLEEP) return;
+
+    XL_UpdateLineTimers(line);
+    listAwakeLine(line, *xg);
 }
 
 void XL_SetLineType(Line *line, int id)
@@ -918,6 +1004,12 @@ void XL_SetLineType(Line *line, int id)
         if(!xline->xg)
         {
             xline->xg = (xgline_t *)Z_Calloc(sizeof(xgline_t), PU_MAP, 0);
+            xline->xg->schedState = XLS_ASLEEP;
+            xline->xg->thinkTime  = -1;
+        }
+        else
+        {
+            XL_WakeLine(line);
         }
 
         // Init the extended line state.
@@ -935,19 +1027,10 @@ void XL_SetLineType(Line *line, int id)
                 << xgClasses[xline->xg->info.lineClass].className
                 << id);
 
-        // If there is not already an xlthinker for this line, create one.
-        if(!Thinker_Iterate(XL_Thinker, findXLThinker, line))
+        // The line thinks at least once with its new type.
+        if(!IS_CLIENT && !P_IsDummy(line))
         {
-            // Not created one yet.
-            /*xlthinker_t *xl = (xlthinker_t *)Z_Calloc(sizeof(*xl), PU_MAP, 0);
-
-            xl->thinker.function = XL_Thinker;*/
-
-            ThinkerT<xlthinker_t> xl(Thinker::AllocateMemoryZone);
-            xl.function = XL_Thinker;
-            xl->line = line;
-
-            Thinker_Add(xl.Thinker::take());
+            listAwakeLine(line, *xline->xg);
         }
     }
     else if(id)
@@ -959,6 +1042,7 @@ void XL_SetLineType(Line *line, int id)
 void XL_Init()
 {
     dummyThing.Thinker::zap();
+    clearSchedule();
 
     // Clients rely on the server, they don't do XG themselves.
     if(IS_CLIENT) return;
@@ -1498,6 +1582,7 @@ int XLTrav_QuickActivate(Line *line, dd_bool /*ceiling*/, void *context, void *
         xline_t *xline = P_ToXLine(line);
         if(xline->xg)
         {
+            XL_WakeLine(line);
             xline->xg->active = (context? true : false);
             xline->xg->timer  = XLTIMER_STOPPED; // Stop timer.
         }
@@ -1565,6 +1650,7 @@ int XL_DoChainSequence(Line *line, dd_bool /*ceiling*/, void * /*context*/,
         {
             linetype_t *info = static_cast<linetype_t *>(context2);
 
+            XL_WakeLine(line);
             xline->xg->chIdx = 1; // This is the first.
             // Start counting the first interval.
             xline->xg->chTimer =
@@ -1811,6 +1897,7 @@ int XLTrav_LineCount(Line *line, dd_bool /*ceiling*/, void * /*context*/,
         xline_t *xline = P_ToXLine(line);
         if(xline->xg)
         {
+            XL_WakeLine(line);
             if(info->iparm[2])
             {
                 xline->xg->info.actCount = info->iparm[3];
@@ -2138,6 +2225,7 @@ int XLTrav_DisableLine(Line *line, dd_bool /*ceiling*/, void *context,
         {
             xline_t *origLine = P_ToXLine((Line *) context);
 
+            XL_WakeLine(line);
             xline->xg->disabled = origLine->xg->active;
         }
     }
@@ -2155,6 +2243,7 @@ int XLTrav_EnableLine(Line *line, dd_bool /*ceiling*/, void *context,
         {
             xline_t *origLine = P_ToXLine((Line*) context);
 
+            XL_WakeLine(line);
             xline->xg->disabled = !origLine->xg->active;
         }
     }
@@ -2329,6 +2418,8 @@ void XL_ActivateLine(dd_bool activating, linetype_t *info, Line *line, int siden
            << sidenum << xline->special);
 
     DENG2_ASSERT(xline->xg);
+    XL_WakeLine(line);
+
     xgline_t &xgline = *xline->xg;
     if(xgline.disabled)
     {
@@ -2532,6 +2623,9 @@ int XL_LineEvent(int evtype, int linetype, Line* line, int sidenum,
     info = &xg->info;
     active = xg->active;
 
+    // Something is happening to the line, so it must be awake.
+    XL_WakeLine(line);
+
     if(activator_thing)
         activator = activator_thing->player;
 
@@ -2863,28 +2957,12 @@ void XL_DoChain(Line *line, int chain, dd_bool activating, mobj_t *actThing)
 }
 
 /**
- * XG lines get to think.
+ * An XG line gets to think.
  */
-void XL_Thinker(void *xlThinkerPtr)
+static void XL_Think(Line *line, xgline_t *xg)
 {
-    DENG2_ASSERT(xlThinkerPtr);
-    LOG_AS("XL_Thinker");
-
-    xlthinker_t *xl = static_cast<xlthinker_t *>(xlThinkerPtr);
-    Line *line      = xl->line;
-
-    // Clients rely on the server, they don't do XG themselves.
-    if(IS_CLIENT) return;
-
-    if(!xl->line) return;
-
-    // Not an xline? Most perculiar...
-    xline_t *xline = P_ToXLine(line);
-    if(!xline) return;
-
-    // Not an extended line?
-    xgline_t *xg = xline->xg;
-    if(!xg) return;
+    DENG2_ASSERT(line && xg);
+    LOG_AS("XL_Think");
 
     // If disabled do nothing.
     if(xg->disabled) return;
@@ -3050,6 +3128,138 @@ void XL_Thinker(void *xlThinkerPtr)
     }
 }
 
+/**
+ * Determines when @a xg next needs to think. A line only has to think on tics
+ * when its ticker fires, its activation timer expires, or something keeps
+ * changing continuously (chain sequences, material movement). Everything else
+ * happens in response to events, which wake up the line.
+ *
+ * @return  Map time of the next required think, or -1 if only an event can
+ *          make the line do something.
+ */
+static int XL_NextThinkTime(xgline_t const *xg)
+{
+    linetype_t const *info = &xg->info;
+    int const nextTic = mapTime + 1;
+
+    // Nothing happens while disabled.
+    if(xg->disabled) return -1;
+
+    // Continuous activity?
+    if(info->materialMoveSpeed) return nextTic;
+    if(xg->active && info->lineClass == LTC_CHAIN_SEQUENCE) return nextTic;
+
+    // Stopped timers won't expire.
+    bool const timersRun = (xg->timer >= 0);
+    int wakeTime = -1;
+
+    // Ticker activation and forced functions.
+    if((info->flags & LTF_TICKER) ||
+       ((((info->flags2 & LTF2_WHEN_ACTIVE) && xg->active) ||
+         ((info->flags2 & LTF2_WHEN_INACTIVE) && !xg->active)) &&
+        (!(info->flags2 & LTF2_WHEN_LAST) || info->actCount == 1)))
+    {
+        if(info->tickerEnd > 0 && TIC2FLT(nextTic) > info->tickerEnd)
+        {
+            // The ticker period is over for good.
+        }
+        else if(!timersRun)
+        {
+            if(xg->tickerTimer > info->tickerInterval) return nextTic;
+        }
+        else
+        {
+            // When will the ticker timer exceed the interval?
+            int tickerTime = mapTime + info->tickerInterval - xg->tickerTimer + 1;
+
+            // The ticker period may begin later (wake up a tic early, to be safe).
+            if(info->tickerEnd > 0)
+            {
+                tickerTime = de::max(tickerTime, FLT2TIC(info->tickerStart) - 1);
+            }
+            wakeTime = de::max(tickerTime, nextTic);
+        }
+    }
+
+    // Automatic (de)activation.
+    if(info->actTime >= 0 &&
+       (((info->actType == LTACT_COUNTED_OFF ||
+          info->actType == LTACT_FLIP_COUNTED_OFF) && xg->active) ||
+        ((info->actType == LTACT_COUNTED_ON ||
+          info->actType == LTACT_FLIP_COUNTED_ON) && !xg->active)))
+    {
+        if(!timersRun) return nextTic;
+
+        int const actTime = de::max(mapTime + FLT2TIC(info->actTime) - xg->timer + 1, nextTic);
+        wakeTime = (wakeTime < 0? actTime : de::min(wakeTime, actTime));
+    }
+
+    return wakeTime;
+}
+
+void XL_Ticker(void)
+{
+    // Clients rely on the server, they don't do XG themselves.
+    if(IS_CLIENT) return;
+
+    // Wake up the lines whose timers expire on this tic.
+    XLWakeups &slot = xlWheel[mapTime & (XL_WHEEL_SIZE - 1)];
+    for(std::size_t i = 0; i < slot.size(); )
+    {
+        xlwakeup_t const wakeup = slot[i];
+        if(wakeup.time > mapTime)
+        {
+            ++i; // Due on a later revolution.
+            continue;
+        }
+
+        // Remove from the slot.
+        slot[i] = slot.back();
+        slot.pop_back();
+
+        // Ignore stale wake-ups (the line was woken or rescheduled meanwhile).
+        xgline_t *xg = P_ToXLine(wakeup.line)->xg;
+        if(xg && xg->schedState == XLS_ASLEEP && xg->wakeTime == wakeup.time)
+        {
+            XL_WakeLine(wakeup.line);
+        }
+    }
+
+    // Lines woken up during thinking are appended to the list and get to think
+    // on this tic as well.
+    for(std::size_t i = 0; i < xlAwake.size(); ++i)
+    {
+        Line *line   = xlAwake[i];
+        xgline_t *xg = P_ToXLine(line)->xg;
+
+        if(!xg || xg->schedState != XLS_AWAKE) continue;
+        if(xg->thinkTime == mapTime) continue; // Already done.
+
+        xg->thinkTime = mapTime;
+        XL_Think(line, xg);
+
+        // The line may have been re-typed or removed while thinking.
+        xg = P_ToXLine(line)->xg;
+        if(!xg) continue;
+
+        // Can we go to sleep until the next thing happens?
+        int const nextTime = XL_NextThinkTime(xg);
+        if(nextTime != mapTime + 1)
+        {
+            sleepLine(line, *xg, nextTime);
+        }
+    }
+
+    // Drop the lines that went to sleep.
+    xlAwake.erase(std::remove_if(xlAwake.begin(), xlAwake.end(), [] (Line *line)
+    {
+        xgline_t *xg = P_ToXLine(line)->xg;
+        if(xg && xg->schedState == XLS_AWAKE) return false;
+        if(xg) xg->listed = false;
+        return true;
+    }), xlAwake.end());
+}
+
 /**
  * During update, definitions are re-read, so the pointers need to be
  * updated. However, this is a bit messy operation, prone to errors.
@@ -3060,6 +3270,8 @@ void XL_Update(void)
     int i;
     xline_t *xline;
 
+    clearSchedule();
+
     // It's all PU_MAP memory, so we can just lose it.
     for(i = 0; i < numlines; ++i)
     {
@@ -48,6 +48,9 @@ void SV_WriteXGLine(Line *li, MapStateWriter *msw)
     xgline_t *xg = xline->xg;
     linetype_t *info = &xg->info;
 
+    // A sleeping line's timers only catch up when it wakes.
+    XL_UpdateLineTimers(li);
+
     Writer_WriteInt32(writer, info->id);
     Writer_WriteInt32(writer, info->actCount);
 
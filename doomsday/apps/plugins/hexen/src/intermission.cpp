@@ -319,7 +319,7 @@ void IN_Drawer()
                                    Get(DD_WINDOW_WIDTH), Get(DD_WINDOW_HEIGHT), scalemode_t(cfg.common.inludeScaleMode));
     GL_BeginBorderedProjection(&bp);
 
-    lumpnum_t lumpNum = common::CentralLumpIndex().findLast("INTERPIC.lmp");
+    lumpnum_t lumpNum = common::CentralLumpIndex().findLast(PathView("INTERPIC.lmp"));
     if(lumpNum >= 0)
     {
         DGL_Color4f(1, 1, 1, 1);
@@ -56,6 +56,12 @@ public:
      */
     de::Address const address() const;
 
+    /**
+     * Returns the protocol version (SV_VERSION) of the user's client, as given
+     * when joining the game.
+     */
+    int protocolVersion() const;
+
     /**
      * Determines if the user has joined the game in progress at the server.
      */
@@ -76,6 +82,12 @@ public:
     // Implements Transmitter.
     void send(de::IByteArray const &data);
 
+    /**
+     * Sends a message that has already been encoded, for instance one that
+     * is being broadcast to all users.
+     */
+    void send(de::Socket::EncodedMessage const &message);
+
 signals:
     void userDestroyed();
 
@@ -52,7 +52,7 @@ void            Sv_StartNetGame(void);
 void            Sv_StopNetGame(void);
 dd_bool         Sv_PlayerArrives(nodeid_t nodeID, char const *name);
 void            Sv_PlayerLeaves(nodeid_t nodeID);
-void            Sv_Handshake(int playernum, dd_bool newplayer);
+void            Sv_Handshake(int playernum, dd_bool newplayer, dd_bool keyframe);
 void            Sv_GetPackets(void);
 
 /**
@@ -259,6 +259,7 @@ void            Sv_InitPools(void);
 void            Sv_ShutdownPools(void);
 void            Sv_DrainPool(uint clientNumber);
 void            Sv_InitPoolForClient(uint clientNumber);
+void            Sv_RefreshPoolForClient(uint clientNumber);
 void            Sv_MobjRemoved(thid_t id);
 void            Sv_PlayerRemoved(uint clientNumber);
 void            Sv_GenerateFrameDeltas(void);
@@ -50,6 +50,7 @@ DENG2_PIMPL(RemoteUser)
     Instance(Public *i, Socket *sock)
         : Base(i),
           socket(sock),
+          protocolVersion(0),
           state(Unjoined)
     {
         DENG2_ASSERT(socket != 0);
@@ -185,6 +186,10 @@ DENG2_PIMPL(RemoteUser)
                 // Successful! Send a reply.
                 self << ByteRefArray("Enter", 5);
 
+                // Clients understand messages compressed as a continuous
+                // deflate stream since protocol version 25.
+                socket->setStreamCompression(protocolVersion >= 25);
+
                 // Inform the higher levels of this occurence.
                 netevent_t netEvent;
                 netEvent.type = NE_CLIENT_ENTRY;
@@ -247,6 +252,14 @@ void RemoteUser::send(IByteArray const &data)
     }
 }
 
+void RemoteUser::send(Socket::EncodedMessage const &message)
+{
+    if(d->state != Disconnected && d->socket->isOpen())
+    {
+        d->socket->send(message);
+    }
+}
+
 void RemoteUser::handleIncomingPackets()
 {
     LOG_AS("RemoteUser");
@@ -294,6 +307,11 @@ void RemoteUser::socketDisconnected()
     deleteLater();
 }
 
+int RemoteUser::protocolVersion() const
+{
+    return d->protocolVersion;
+}
+
 bool RemoteUser::isJoined() const
 {
     return d->state == Joined;
@@ -28,6 +28,8 @@
 #include "de_play.h"
 
 #include "def_main.h"
+#include "network/deltacodec.h"
+#include "serversystem.h"
 
 // MACROS ------------------------------------------------------------------
 
@@ -77,6 +79,9 @@ static int totalFrameCount;
 
 static int lastTransmitTic = 0;
 
+// Mobj coordinates most recently sent to each client in PSV_FRAME3 packets.
+static DeltaOrigins sentOrigins[DDMAXPLAYERS];
+
 // CODE --------------------------------------------------------------------
 
 /**
@@ -186,7 +191,7 @@ if(totalFrameCount > 0)
 /**
  * The delta is written to the message buffer.
  */
-void Sv_WriteMobjDelta(const void* deltaPtr)
+void Sv_WriteMobjDelta(const void* deltaPtr, DeltaWriter &out)
 {
     const mobjdelta_t*  delta = reinterpret_cast<mobjdelta_t const *>(deltaPtr);
     const dt_mobj_t*    d = &delta->mo;
@@ -257,109 +262,99 @@ void Sv_WriteMobjDelta(const void* deltaPtr)
     DENG_ASSERT((df & 0xffff) != 0);    // don't write empty deltas
 
     // First the mobj ID number and flags.
-    Writer_WriteUInt16(msgWriter, delta->delta.id);
-    Writer_WriteUInt16(msgWriter, df & 0xffff);
+    out.writeId(delta->delta.id);
+    if(out.isBitPacked())
+        out.writePackedUInt16(df & 0xffff);
+    else
+        out.writeUInt16(df & 0xffff);
 
     // More flags?
     if(df & MDF_MORE_FLAGS)
     {
-        Writer_WriteByte(msgWriter, moreFlags);
+        out.writeByte(moreFlags);
     }
 
-    // Coordinates with three bytes.
+    // Coordinates with 16.8 precision.
     if(df & MDF_ORIGIN_X)
-    {
-        fixed_t vx = FLT2FIX(d->origin[VX]);
-
-        Writer_WriteInt16(msgWriter, vx >> FRACBITS);
-        Writer_WriteByte(msgWriter, vx >> 8);
-    }
+        out.writeCoord(delta->delta.id, VX, FLT2FIX(d->origin[VX]));
     if(df & MDF_ORIGIN_Y)
-    {
-        fixed_t vy = FLT2FIX(d->origin[VY]);
-
-        Writer_WriteInt16(msgWriter, vy >> FRACBITS);
-        Writer_WriteByte(msgWriter, vy >> 8);
-    }
+        out.writeCoord(delta->delta.id, VY, FLT2FIX(d->origin[VY]));
 
     if(df & MDF_ORIGIN_Z)
     {
-        fixed_t vz = FLT2FIX(d->origin[VZ]);
-        Writer_WriteInt16(msgWriter, vz >> FRACBITS);
-        Writer_WriteByte(msgWriter, vz >> 8);
+        out.writeCoord(delta->delta.id, VZ, FLT2FIX(d->origin[VZ]));
 
-        Writer_WriteFloat(msgWriter, d->floorZ);
-        Writer_WriteFloat(msgWriter, d->ceilingZ);
+        out.writeFloat(d->floorZ);
+        out.writeFloat(d->ceilingZ);
     }
 
     // Momentum using 8.8 fixed point.
     if(df & MDF_MOM_X)
     {
         fixed_t mx = FLT2FIX(d->mom[MX]);
-        Writer_WriteInt16(msgWriter, moreFlags & MDFE_FAST_MOM ? FIXED10_6(mx) : FIXED8_8(mx));
+        out.writeInt16(moreFlags & MDFE_FAST_MOM ? FIXED10_6(mx) : FIXED8_8(mx));
     }
 
     if(df & MDF_MOM_Y)
     {
         fixed_t my = FLT2FIX(d->mom[MY]);
-        Writer_WriteInt16(msgWriter, moreFlags & MDFE_FAST_MOM ? FIXED10_6(my) : FIXED8_8(my));
+        out.writeInt16(moreFlags & MDFE_FAST_MOM ? FIXED10_6(my) : FIXED8_8(my));
     }
 
     if(df & MDF_MOM_Z)
     {
         fixed_t mz = FLT2FIX(d->mom[MZ]);
-        Writer_WriteInt16(msgWriter, moreFlags & MDFE_FAST_MOM ? FIXED10_6(mz) : FIXED8_8(mz));
+        out.writeInt16(moreFlags & MDFE_FAST_MOM ? FIXED10_6(mz) : FIXED8_8(mz));
     }
 
-    // Angles with 16-bit accuracy.
     if(df & MDF_ANGLE)
-        Writer_WriteInt16(msgWriter, d->angle >> 16);
+        out.writeAngle(d->angle);
 
     if(df & MDF_SELECTOR)
-        Writer_WritePackedUInt16(msgWriter, d->selector);
+        out.writePackedUInt16(d->selector);
     if(df & MDF_SELSPEC)
-        Writer_WriteByte(msgWriter, d->selector >> 24);
+        out.writeByte(d->selector >> 24);
 
     if(df & MDF_STATE)
     {
         assert(d->state != 0);
-        Writer_WritePackedUInt16(msgWriter, runtimeDefs.states.indexOf(d->state));
+        out.writePackedUInt16(runtimeDefs.states.indexOf(d->state));
     }
 
     if(df & MDF_FLAGS)
     {
-        Writer_WriteUInt32(msgWriter, d->ddFlags & DDMF_PACK_MASK);
-        Writer_WriteUInt32(msgWriter, d->flags);
-        Writer_WriteUInt32(msgWriter, d->flags2);
-        Writer_WriteUInt32(msgWriter, d->flags3);
+        out.writeUInt32(d->ddFlags & DDMF_PACK_MASK);
+        out.writeUInt32(d->flags);
+        out.writeUInt32(d->flags2);
+        out.writeUInt32(d->flags3);
     }
 
     if(df & MDF_HEALTH)
-        Writer_WriteInt32(msgWriter, d->health);
+        out.writeInt32(d->health);
 
     if(df & MDF_RADIUS)
-        Writer_WriteFloat(msgWriter, d->radius);
+        out.writeFloat(d->radius);
 
     if(df & MDF_HEIGHT)
-        Writer_WriteFloat(msgWriter, d->height);
+        out.writeFloat(d->height);
 
     if(df & MDF_FLOORCLIP)
-        Writer_WriteFloat(msgWriter, d->floorClip);
+        out.writeFloat(d->floorClip);
 
     if(df & MDFC_TRANSLUCENCY)
-        Writer_WriteByte(msgWriter, d->translucency);
+        out.writeByte(d->translucency);
 
     if(df & MDFC_FADETARGET)
-        Writer_WriteByte(msgWriter, (byte)(d->visTarget +1));
+        out.writeByte((byte)(d->visTarget +1));
 
     if(df & MDFC_TYPE)
-        Writer_WriteInt32(msgWriter, d->type);
+        out.writeInt32(d->type);
 }
 
 /**
  * The delta is written to the message buffer.
  */
-void Sv_WritePlayerDelta(const void* deltaPtr)
+void Sv_WritePlayerDelta(const void* deltaPtr, DeltaWriter &out)
 {
     const playerdelta_t* delta = reinterpret_cast<playerdelta_t const *>(deltaPtr);
     const dt_player_t*  d = &delta->player;
@@ -368,23 +363,23 @@ void Sv_WritePlayerDelta(const void* deltaPtr)
     int                 psdf, i, k;
 
     // First the player number. Upper three bits contain flags.
-    Writer_WriteByte(msgWriter, delta->delta.id | (df >> 8));
+    out.writeByte(delta->delta.id | (df >> 8));
 
     // Flags. What elements are included in the delta?
-    Writer_WriteByte(msgWriter, df & 0xff);
+    out.writeByte(df & 0xff);
 
     if(df & PDF_MOBJ)
-        Writer_WriteUInt16(msgWriter, d->mobj);
+        out.writeId(d->mobj);
     if(df & PDF_FORWARDMOVE)
-        Writer_WriteByte(msgWriter, d->forwardMove);
+        out.writeByte(d->forwardMove);
     if(df & PDF_SIDEMOVE)
-        Writer_WriteByte(msgWriter, d->sideMove);
+        out.writeByte(d->sideMove);
     /*if(df & PDF_ANGLE)
-        Writer_WriteByte(msgWriter, d->angle >> 24);*/
+        out.writeByte(d->angle >> 24);*/
     if(df & PDF_TURNDELTA)
-        Writer_WriteByte(msgWriter, (d->turnDelta * 16) >> 24);
+        out.writeByte((d->turnDelta * 16) >> 24);
     if(df & PDF_FRICTION)
-        Writer_WriteByte(msgWriter, FLT2FIX(d->friction) >> 8);
+        out.writeByte(FLT2FIX(d->friction) >> 8);
     if(df & PDF_EXTRALIGHT)
     {
         // Three bits is enough for fixedcolormap.
@@ -394,11 +389,11 @@ void Sv_WritePlayerDelta(const void* deltaPtr)
         if(i > 7)
             i = 7;
         // Write the five upper bytes of extraLight.
-        Writer_WriteByte(msgWriter, i | (d->extraLight & 0xf8));
+        out.writeByte(i | (d->extraLight & 0xf8));
     }
     if(df & PDF_FILTER)
     {
-        Writer_WriteUInt32(msgWriter, d->filter);
+        out.writeUInt32(d->filter);
         LOGDEV_NET_XVERBOSE_DEBUGONLY("Sv_WritePlayerDelta: Plr %i, filter %08x", delta->delta.id << d->filter);
     }
     if(df & PDF_PSPRITES)       // Only set if there's something to write.
@@ -408,10 +403,10 @@ void Sv_WritePlayerDelta(const void* deltaPtr)
             psdf = df >> (16 + i * 8);
             psp = d->psp + i;
             // First the flags.
-            Writer_WriteByte(msgWriter, psdf);
+            out.writeByte(psdf);
             if(psdf & PSDF_STATEPTR)
             {
-                Writer_WritePackedUInt16(msgWriter, psp->statePtr? (runtimeDefs.states.indexOf(psp->statePtr) + 1) : 0);
+                out.writePackedUInt16(psp->statePtr? (runtimeDefs.states.indexOf(psp->statePtr) + 1) : 0);
             }
             /*if(psdf & PSDF_LIGHT)
             {
@@ -420,7 +415,7 @@ void Sv_WritePlayerDelta(const void* deltaPtr)
                     k = 0;
                 if(k > 255)
                     k = 255;
-                Writer_WriteByte(msgWriter, k);
+                out.writeByte(k);
             }*/
             if(psdf & PSDF_ALPHA)
             {
@@ -429,16 +424,16 @@ void Sv_WritePlayerDelta(const void* deltaPtr)
                     k = 0;
                 if(k > 255)
                     k = 255;
-                Writer_WriteByte(msgWriter, k);
+                out.writeByte(k);
             }
             if(psdf & PSDF_STATE)
             {
-                Writer_WriteByte(msgWriter, psp->state);
+                out.writeByte(psp->state);
             }
             if(psdf & PSDF_OFFSET)
             {
-                Writer_WriteByte(msgWriter, CLAMPED_CHAR(psp->offset[VX] / 2));
-                Writer_WriteByte(msgWriter, CLAMPED_CHAR(psp->offset[VY] / 2));
+                out.writeByte(CLAMPED_CHAR(psp->offset[VX] / 2));
+                out.writeByte(CLAMPED_CHAR(psp->offset[VY] / 2));
             }
         }
     }
@@ -447,7 +442,7 @@ void Sv_WritePlayerDelta(const void* deltaPtr)
 /**
  * The delta is written to the message buffer.
  */
-void Sv_WriteSectorDelta(const void* deltaPtr)
+void Sv_WriteSectorDelta(const void* deltaPtr, DeltaWriter &out)
 {
     const sectordelta_t* delta = reinterpret_cast<sectordelta_t const *>(deltaPtr);
     const dt_sector_t*  d = &delta->sector;
@@ -478,62 +473,62 @@ void Sv_WriteSectorDelta(const void* deltaPtr)
     }
 
     // Sector number first.
-    Writer_WriteUInt16(msgWriter, delta->delta.id);
+    out.writeId(delta->delta.id);
 
     // Flags.
-    Writer_WritePackedUInt32(msgWriter, df);
+    out.writePackedUInt32(df);
 
     if(df & SDF_FLOOR_MATERIAL)
-        Writer_WritePackedUInt16(msgWriter, Sv_IdForMaterial(d->planes[PLN_FLOOR].surface.material));
+        out.writePackedUInt16(Sv_IdForMaterial(d->planes[PLN_FLOOR].surface.material));
     if(df & SDF_CEILING_MATERIAL)
-        Writer_WritePackedUInt16(msgWriter, Sv_IdForMaterial(d->planes[PLN_CEILING].surface.material));
+        out.writePackedUInt16(Sv_IdForMaterial(d->planes[PLN_CEILING].surface.material));
     if(df & SDF_LIGHT)
     {
         // Must fit into a byte.
         int lightlevel = (int) (255.0f * d->lightLevel);
         lightlevel = (lightlevel < 0 ? 0 : lightlevel > 255 ? 255 : lightlevel);
 
-        Writer_WriteByte(msgWriter, (byte) lightlevel);
+        out.writeByte((byte) lightlevel);
     }
     if(df & SDF_FLOOR_HEIGHT)
     {
-        Writer_WriteInt16(msgWriter, FLT2FIX(d->planes[PLN_FLOOR].height) >> 16);
+        out.writeInt16(FLT2FIX(d->planes[PLN_FLOOR].height) >> 16);
     }
     if(df & SDF_CEILING_HEIGHT)
     {
         LOGDEV_NET_XVERBOSE_DEBUGONLY("Sv_WriteSectorDelta: (%i) Absolute ceiling height=%f",
                                      delta->delta.id << d->planes[PLN_CEILING].height);
 
-        Writer_WriteInt16(msgWriter, FLT2FIX(d->planes[PLN_CEILING].height) >> 16);
+        out.writeInt16(FLT2FIX(d->planes[PLN_CEILING].height) >> 16);
     }
     if(df & SDF_FLOOR_TARGET)
-        Writer_WriteInt16(msgWriter, FLT2FIX(d->planes[PLN_FLOOR].target) >> 16);
+        out.writeInt16(FLT2FIX(d->planes[PLN_FLOOR].target) >> 16);
     if(df & SDF_FLOOR_SPEED)    // 7.1/4.4 fixed-point
-        Writer_WriteByte(msgWriter, floorspd);
+        out.writeByte(floorspd);
     if(df & SDF_CEILING_TARGET)
-        Writer_WriteInt16(msgWriter, FLT2FIX(d->planes[PLN_CEILING].target) >> 16);
+        out.writeInt16(FLT2FIX(d->planes[PLN_CEILING].target) >> 16);
     if(df & SDF_CEILING_SPEED)  // 7.1/4.4 fixed-point
-        Writer_WriteByte(msgWriter, ceilspd);
+        out.writeByte(ceilspd);
     if(df & SDF_COLOR_RED)
-        Writer_WriteByte(msgWriter, (byte) (255 * d->rgb[0]));
+        out.writeByte((byte) (255 * d->rgb[0]));
     if(df & SDF_COLOR_GREEN)
-        Writer_WriteByte(msgWriter, (byte) (255 * d->rgb[1]));
+        out.writeByte((byte) (255 * d->rgb[1]));
     if(df & SDF_COLOR_BLUE)
-        Writer_WriteByte(msgWriter, (byte) (255 * d->rgb[2]));
+        out.writeByte((byte) (255 * d->rgb[2]));
 
     if(df & SDF_FLOOR_COLOR_RED)
-        Writer_WriteByte(msgWriter, (byte) (255 * d->planes[PLN_FLOOR].surface.rgba[0]));
+        out.writeByte((byte) (255 * d->planes[PLN_FLOOR].surface.rgba[0]));
     if(df & SDF_FLOOR_COLOR_GREEN)
-        Writer_WriteByte(msgWriter, (byte) (255 * d->planes[PLN_FLOOR].surface.rgba[1]));
+        out.writeByte((byte) (255 * d->planes[PLN_FLOOR].surface.rgba[1]));
     if(df & SDF_FLOOR_COLOR_BLUE)
-        Writer_WriteByte(msgWriter, (byte) (255 * d->planes[PLN_FLOOR].surface.rgba[2]));
+        out.writeByte((byte) (255 * d->planes[PLN_FLOOR].surface.rgba[2]));
 
     if(df & SDF_CEIL_COLOR_RED)
-        Writer_WriteByte(msgWriter, (byte) (255 * d->planes[PLN_CEILING].surface.rgba[0]));
+        out.writeByte((byte) (255 * d->planes[PLN_CEILING].surface.rgba[0]));
     if(df & SDF_CEIL_COLOR_GREEN)
-        Writer_WriteByte(msgWriter, (byte) (255 * d->planes[PLN_CEILING].surface.rgba[1]));
+        out.writeByte((byte) (255 * d->planes[PLN_CEILING].surface.rgba[1]));
     if(df & SDF_CEIL_COLOR_BLUE)
-        Writer_WriteByte(msgWriter, (byte) (255 * d->planes[PLN_CEILING].surface.rgba[2]));
+        out.writeByte((byte) (255 * d->planes[PLN_CEILING].surface.rgba[2]));
 }
 
 /**
@@ -717,8 +712,11 @@ if(type >= NUM_DELTA_TYPES)
 
 /**
  * The delta is written to the message buffer.
+ *
+ * @param origins  Mobj coordinates previously sent to the client, if the delta
+ *                 is written in the bit-packed PSV_FRAME3 format.
  */
-void Sv_WriteDelta(const delta_t* delta)
+void Sv_WriteDelta(const delta_t* delta, DeltaOrigins* origins)
 {
     byte                type = delta->type;
 #ifdef _NETDEBUG
@@ -739,7 +737,11 @@ void Sv_WriteDelta(const delta_t* delta)
         {
             // This'll be the entire delta. No more data is needed.
             Sv_WriteDeltaHeader(DT_NULL_MOBJ, delta);
-            Writer_WriteUInt16(msgWriter, delta->id);
+            {
+                DeltaWriter out(msgWriter, origins);
+                out.writeId(delta->id);
+                out.removeOrigin(delta->id);
+            }
 #ifdef _NETDEBUG
             goto writeDeltaLength;
 #else
@@ -753,17 +755,20 @@ void Sv_WriteDelta(const delta_t* delta)
 
     switch(delta->type)
     {
-    case DT_MOBJ:
-        Sv_WriteMobjDelta(delta);
-        break;
+    case DT_MOBJ: {
+        DeltaWriter out(msgWriter, origins);
+        Sv_WriteMobjDelta(delta, out);
+        break; }
 
-    case DT_PLAYER:
-        Sv_WritePlayerDelta(delta);
-        break;
+    case DT_PLAYER: {
+        DeltaWriter out(msgWriter, origins);
+        Sv_WritePlayerDelta(delta, out);
+        break; }
 
-    case DT_SECTOR:
-        Sv_WriteSectorDelta(delta);
-        break;
+    case DT_SECTOR: {
+        DeltaWriter out(msgWriter, origins);
+        Sv_WriteSectorDelta(delta, out);
+        break; }
 
     case DT_SIDE:
         Sv_WriteSideDelta(delta);
@@ -828,6 +833,25 @@ byte Sv_GetNewResendID(pool_t* pool)
     return id;
 }
 
+/**
+ * Determines whether the client of a player understands the bit-packed
+ * PSV_FRAME3 packets. Demo recordings and local players get PSV_FRAME2.
+ */
+static dd_bool Sv_UsesBitPackedFrames(int plrNum)
+{
+    if(!clients[plrNum].connected)
+        return false;
+
+    try
+    {
+        return App_ServerSystem().user(clients[plrNum].nodeID).protocolVersion() >= 26;
+    }
+    catch(de::Error const &)
+    {
+        return false;
+    }
+}
+
 /**
  * Send a sv_frame packet to the specified player. The amount of data sent
  * depends on the player's bandwidth rating.
@@ -866,9 +890,22 @@ void Sv_SendFrame(int plrNum)
     if(pool->isFirst)
         maxFrameSize = MAX_FIRST_FRAME_SIZE;
 
+    // Mobj coordinates are sent relative to the previously sent ones.
+    // The first frame starts over.
+    DeltaOrigins *origins = 0;
+    if(Sv_UsesBitPackedFrames(plrNum))
+    {
+        origins = &sentOrigins[plrNum];
+        if(pool->isFirst)
+            origins->clear();
+    }
+
     // If this is the first frame after a map change, use the special
     // first frame packet type.
-    Msg_Begin(pool->isFirst ? PSV_FIRST_FRAME2 : PSV_FRAME2);
+    if(origins)
+        Msg_Begin(pool->isFirst ? PSV_FIRST_FRAME3 : PSV_FRAME3);
+    else
+        Msg_Begin(pool->isFirst ? PSV_FIRST_FRAME2 : PSV_FRAME2);
 
     // First send the gameTime of this frame.
     Writer_WriteFloat(msgWriter, gameTime);
@@ -887,7 +924,13 @@ void Sv_SendFrame(int plrNum)
             delta->resend = Sv_GetNewResendID(pool);
         }
 
-        Sv_WriteDelta(delta);
+        // Remember the mobj's previously sent coordinates in case the delta
+        // needs to be canceled.
+        DeltaOrigins::Origin oldOrigin;
+        if(origins && delta->type == DT_MOBJ)
+            oldOrigin = origins->origin(delta->id);
+
+        Sv_WriteDelta(delta, origins);
 
         // Did we go over the limit?
         if(Writer_Size(msgWriter) > maxFrameSize)
@@ -902,6 +945,8 @@ void Sv_SendFrame(int plrNum)
 
             // Cancel the last delta.
             Writer_SetPos(msgWriter, lastStart);
+            if(origins && delta->type == DT_MOBJ)
+                origins->setOrigin(delta->id, oldOrigin);
 
             // Restore the resend dealer.
             if(oldResend)
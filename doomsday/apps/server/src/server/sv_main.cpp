@@ -338,6 +338,7 @@ void Sv_HandlePacket(void)
     char               *msg;
     char                buf[17];
     size_t              len;
+    int                 helloFlags;
 
     LOG_AS("Sv_HandlePacket");
 
@@ -372,6 +373,7 @@ void Sv_HandlePacket(void)
         // This is OK.
         sender->id = id;
 
+        helloFlags = 0;
         if(netBuffer.msg.type == PCL_HELLO2)
         {
             // Check the game mode (max 16 chars).
@@ -382,6 +384,12 @@ void Sv_HandlePacket(void)
                 N_TerminateClient(from);
                 break;
             }
+
+            // Older clients don't send any flags.
+            if(!Reader_AtEnd(msgReader))
+            {
+                helloFlags = Reader_ReadByte(msgReader);
+            }
         }
 
         // The client requests a handshake.
@@ -397,7 +405,7 @@ void Sv_HandlePacket(void)
             gx.NetPlayerEvent(from, DDPE_ARRIVAL, 0);
 
             // Send the handshake packets.
-            Sv_Handshake(from, true);
+            Sv_Handshake(from, true, false);
 
             // Note the time when the player entered.
             sender->enterTime = Timer_RealSeconds();
@@ -405,8 +413,9 @@ void Sv_HandlePacket(void)
         else if(ddpl->inGame)
         {
             // The player is already in the game but requests a new
-            // handshake. Perhaps it's starting to record a demo.
-            Sv_Handshake(from, false);
+            // handshake. Perhaps it's starting to record a demo, or
+            // needs a keyframe for one.
+            Sv_Handshake(from, false, (helloFlags & HELLOF_KEYFRAME) != 0);
         }
         break;
 
@@ -759,15 +768,21 @@ void Sv_PlayerLeaves(unsigned int nodeID)
 
 /**
  * The player will be sent the introductory handshake packets.
+ *
+ * @param newPlayer  The player has just arrived.
+ * @param keyframe   The player is recording a demo and needs the world state
+ *                   for a keyframe. The player is not moved and the deltas
+ *                   already queued for it are kept.
  */
-void Sv_Handshake(int plrNum, dd_bool newPlayer)
+void Sv_Handshake(int plrNum, dd_bool newPlayer, dd_bool keyframe)
 {
     StringArray* ar;
     int i;
     uint playersInGame = 0;
 
     LOG_AS("Sv_Handshake");
-    LOG_NET_VERBOSE("Shaking hands with player %i (newPlayer:%b)") << plrNum << newPlayer;
+    LOG_NET_VERBOSE("Shaking hands with player %i (newPlayer:%b keyframe:%b)")
+            << plrNum << newPlayer << keyframe;
 
     for(i = 0; i < DDMAXPLAYERS; ++i)
         if(clients[i].connected)
@@ -827,6 +842,13 @@ void Sv_Handshake(int plrNum, dd_bool newPlayer)
         }
     }
 
+    if(keyframe)
+    {
+        // The client keeps playing; only the demo needs the whole world.
+        Sv_RefreshPoolForClient(plrNum);
+        return;
+    }
+
     if(!newPlayer)
     {
         // This is not a new player (just a re-handshake) but we'll
@@ -192,6 +192,20 @@ void Sv_InitPoolForClient(uint clientNumber)
     pools[clientNumber].isFirst = true;
 }
 
+/**
+ * Called when a client in the game needs the entire world state again, for
+ * instance for a demo keyframe.
+ */
+void Sv_RefreshPoolForClient(uint clientNumber)
+{
+    // Deltas against the initial state describe the entire world. They are
+    // merged with the ones already in the pool, so nothing pending is lost.
+    Sv_GenerateNewDeltas(&initialRegister, clientNumber, false);
+
+    // The next frame starts over, like after Sv_InitPoolForClient().
+    pools[clientNumber].isFirst = true;
+}
+
 /**
  * @return              Pointer to the console's delta pool.
  */
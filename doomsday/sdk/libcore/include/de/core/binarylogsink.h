@@ -0,0 +1,112 @@
+/** @file binarylogsink.h  Log sink that writes entries in binary form.
+ *
+ * @authors Copyright © 2015 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * LGPL: http://www.gnu.org/licenses/lgpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details. You should have received a copy of
+ * the GNU Lesser General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#ifndef LIBDENG2_BINARYLOGSINK_H
+#define LIBDENG2_BINARYLOGSINK_H
+
+#include "../LogSink"
+#include "../File"
+#include "../ISerializable"
+#include "../Time"
+
+namespace de {
+
+/**
+ * Log sink that writes entries to a File without formatting them as text.
+ * The entry metadata, section, format and the raw argument values are
+ * serialized as-is, so the entries can be filtered and formatted later with
+ * an offline tool (see "logtool").
+ *
+ * The file is append-only. It begins with a header (see MAGIC) followed by
+ * the serialization protocol version. The rest of the file is a sequence of
+ * records, each starting with a record type (dbyte) and the size of the
+ * payload (duint32). Every INDEX_INTERVAL entries, and when the sink is
+ * closed, an Index record is written that summarizes the preceding block of
+ * entries. This allows a reader to skip entire blocks that can't match its
+ * filter without deserializing any of the entries.
+ *
+ * @ingroup core
+ */
+class DENG2_PUBLIC BinaryLogSink : public LogSink
+{
+public:
+    /// Identifies binary log files ("DLOG").
+    static duint32 const MAGIC = 0x474f4c44;
+
+    /// Version of the file layout (not of the entry serialization).
+    static duint16 const FORMAT_VERSION = 1;
+
+    /// Number of entries in a block summarized by an Index record.
+    static dint const INDEX_INTERVAL = 1024;
+
+    enum RecordType {
+        EntryRecord     = 1,    ///< Serialized LogEntry.
+        IndexRecord     = 2,    ///< Summary of the preceding block (Index).
+        PlainTextRecord = 3     ///< Plain text message (String).
+    };
+
+    /**
+     * Summary of a block of consecutive entry records.
+     */
+    struct DENG2_PUBLIC Index : public ISerializable
+    {
+        duint64 previous;       ///< Offset of the previous Index record (zero if none).
+        duint64 blockStart;     ///< Offset of the first record of the block.
+        duint32 entryCount;     ///< Number of entries in the block.
+        duint32 userContext;    ///< Union of the domain bits of non-developer entries.
+        duint32 devContext;     ///< Union of the domain bits of developer entries.
+        dbyte   highestLevel;   ///< Highest level of the entries.
+        Time    first;          ///< Time of the first entry.
+        Time    last;           ///< Time of the last entry.
+
+        Index();
+
+        /// Includes @a entry in the summary.
+        void add(LogEntry const &entry);
+
+        /**
+         * Determines whether any entries of the block can pass a filter.
+         *
+         * @param minLevel  Minimum entry level.
+         * @param domains   Domain bits (LogEntry::DomainMask). Zero for any domain.
+         * @param allowDev  Developer entries are acceptable.
+         */
+        bool mayContain(LogEntry::Level minLevel, duint32 domains, bool allowDev) const;
+
+        // Implements ISerializable.
+        void operator >> (Writer &to) const;
+        void operator << (Reader &from);
+    };
+
+public:
+    BinaryLogSink(File &outputFile);
+
+    ~BinaryLogSink();
+
+    LogSink &operator << (LogEntry const &entry);
+    LogSink &operator << (String const &plainText);
+
+    void flush();
+
+private:
+    DENG2_PRIVATE(d)
+};
+
+} // namespace de
+
+#endif // LIBDENG2_BINARYLOGSINK_H
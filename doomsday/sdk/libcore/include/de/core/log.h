@@ -611,6 +611,9 @@ private:
     Flags _defaultFlags;
     bool _disabled;
     Args _args;
+    LogEntry *_nextPending; ///< Link in the LogBuffer's queue of new entries.
+
+    friend class LogBuffer;
 };
 
 QTextStream &operator << (QTextStream &stream, LogEntry::Arg const &arg);
@@ -734,6 +737,13 @@ class DENG2_PUBLIC LogEntryStager
 public:
     LogEntryStager(duint32 metadata, String const &format);
 
+    /**
+     * Stages an entry whose format is a plain C string (e.g., a literal). The
+     * format is converted to a String only if the entry passes the filter, so
+     * disabled entries cost little more than a metadata check.
+     */
+    LogEntryStager(duint32 metadata, char const *format);
+
     /// Appends a new argument to the entry.
     template <typename ValueType>
     inline LogEntryStager &operator << (ValueType const &v) {
@@ -746,6 +756,9 @@ public:
 
     ~LogEntryStager();
 
+private:
+    void begin(duint32 metadata);
+
 private:
     bool _disabled;
     duint32 _metadata;
@@ -35,8 +35,15 @@ class LogSink;
  * Central buffer for log entries.
  *
  * Log entries may be created in any thread, and they get collected into a
- * central LogBuffer. The buffer is flushed whenever a new entry triggers the
- * flush condition, which means flushing may occur in any thread.
+ * central LogBuffer. Adding an entry does not block: new entries are placed in
+ * a lock-free queue that is emptied when the buffer is flushed.
+ *
+ * When auto-flushing is enabled, a background thread flushes entries to the
+ * standard output/error streams and the output file. Entries are formatted to
+ * text only if a sink accepts them, so this work is never done in the threads
+ * producing the entries. Sinks added with addSink() are flushed by a timer in
+ * the thread that owns the buffer (usually the main thread), because they may
+ * not be usable from other threads.
  *
  * The application owns an instance of LogBuffer.
  *
@@ -163,7 +170,9 @@ public:
     };
 
     /**
-     * Sets the path of the file used for writing log entries to.
+     * Sets the path of the file used for writing log entries to. If the file
+     * name extension is ".dlog", the entries are written in binary form (see
+     * BinaryLogSink) instead of plain text.
      *
      * @param path      Path of the file.
      * @param behavior  What to do with existing unflushed entries.
@@ -215,6 +224,9 @@ public slots:
      */
     void flush();
 
+private slots:
+    void autoFlush();
+
 private:
     DENG2_PRIVATE(d)
 
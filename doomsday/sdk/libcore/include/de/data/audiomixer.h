@@ -0,0 +1,216 @@
+/** @file audiomixer.h  Software mixer for sound effects.
+ *
+ * @authors Copyright © 2015 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * LGPL: http://www.gnu.org/licenses/lgpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details. You should have received a copy of
+ * the GNU Lesser General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#ifndef LIBDENG2_AUDIOMIXER_H
+#define LIBDENG2_AUDIOMIXER_H
+
+#include "../libcore.h"
+#include "../Vector"
+
+#include <QVector>
+
+namespace de {
+
+/**
+ * Mixes any number of mono voices into a stereo output.
+ *
+ * Each voice plays a sound given as floating-point samples at the sample rate
+ * of the mixer; the pitch of the voice can be changed, in which case the
+ * samples are interpolated. A voice is either panned explicitly (2D), or it
+ * has a position in the world and the mixer derives the stereo panning and
+ * distance attenuation from the position of the listener (3D). Changes in
+ * gain are ramped over a few milliseconds so that they don't cause clicks.
+ *
+ * The mixed output is passed through a small reverberator whose parameters
+ * correspond to the acoustic properties of the listener's surroundings.
+ *
+ * When many voices are playing, they are mixed in groups in the mixer's own
+ * threads. The gain and panning is applied with SSE2 instructions when the
+ * CPU supports them.
+ *
+ * All methods are thread-safe: the parameters of voices may be changed while
+ * another thread is rendering output.
+ *
+ * @ingroup data
+ */
+class DENG2_PUBLIC AudioMixer
+{
+public:
+    /// Stereo frames are interleaved: left, right, left, right...
+    class ISink
+    {
+    public:
+        virtual ~ISink() {}
+
+        /**
+         * Receives mixed output.
+         *
+         * @param frames  Interleaved stereo samples.
+         * @param count   Number of stereo frames.
+         */
+        virtual void consume(float const *frames, dsize count) = 0;
+    };
+
+    /**
+     * Collects all the mixed output in memory.
+     */
+    class DENG2_PUBLIC MemorySink : public ISink
+    {
+    public:
+        void consume(float const *frames, dsize count);
+        QVector<float> const &samples() const;
+        dsize frameCount() const;
+        void clear();
+
+    private:
+        QVector<float> _samples;
+    };
+
+public:
+    /**
+     * @param sampleRate  Output sample rate. Samples of all voices must be
+     *                    at this rate.
+     */
+    AudioMixer(int sampleRate);
+
+    int sampleRate() const;
+
+    /**
+     * Creates a new, silent voice.
+     *
+     * @return Identifier of the voice.
+     */
+    int createVoice();
+
+    void destroyVoice(int voice);
+
+    /**
+     * Number of voices that currently exist.
+     */
+    int voiceCount() const;
+
+    /**
+     * Sets the sound played by a voice. The voice is stopped.
+     *
+     * @param voice    Voice.
+     * @param samples  Mono samples at the sample rate of the mixer. The data
+     *                 is shared, not copied.
+     */
+    void setSamples(int voice, QVector<float> const &samples);
+
+    /**
+     * Starts playing a voice from the beginning of its sound.
+     *
+     * @param voice    Voice.
+     * @param looping  Repeat the sound until stopped.
+     */
+    void play(int voice, bool looping = false);
+
+    void stop(int voice);
+
+    /**
+     * Determines if a voice is playing. A voice that is not looping stops by
+     * itself when the end of the sound has been mixed.
+     */
+    bool isPlaying(int voice) const;
+
+    /// @param volume  Gain of the voice (0...1).
+    void setVolume(int voice, float volume);
+
+    /// @param pitch  Playback rate relative to the sample rate (1 = normal).
+    void setPitch(int voice, float pitch);
+
+    /// @param pan  Stereo position of a 2D voice: -1 (left) ... +1 (right).
+    void setPan(int voice, float pan);
+
+    /**
+     * Makes the voice positional: its panning and attenuation are determined
+     * by its position relative to the listener.
+     *
+     * @param voice     Voice.
+     * @param position  Position in world coordinates (X and Y are on the
+     *                  horizontal plane, Z is up).
+     * @param relative  The position is relative to the listener instead
+     *                  of absolute.
+     */
+    void setPosition(int voice, Vector3f const &position, bool relative = false);
+
+    /**
+     * Sets the range of distance attenuation of a positional voice. There is
+     * no attenuation closer than @a minDistance and beyond @a maxDistance the
+     * voice is silent.
+     */
+    void setDistanceRange(int voice, float minDistance, float maxDistance);
+
+    /**
+     * Makes the voice non-positional again (2D).
+     */
+    void clearPosition(int voice);
+
+    /**
+     * Sets the position and orientation of the listener of positional voices.
+     *
+     * @param position  Position in world coordinates.
+     * @param yaw       Facing direction on the horizontal plane, in degrees:
+     *                  0 is toward +X, 90 toward +Y.
+     */
+    void setListener(Vector3f const &position, float yaw);
+
+    /**
+     * Sets the parameters of the reverberation. All are in range 0...1.
+     *
+     * @param volume   Level of the reverberated sound; zero disables reverb.
+     * @param space    Size of the space.
+     * @param decay    Length of the reverberation tail.
+     * @param damping  Attenuation of high frequencies in the tail.
+     */
+    void setReverb(float volume, float space, float decay, float damping);
+
+    /**
+     * Sets how many voices are mixed by one thread. If more voices than this
+     * are playing, the mixing is divided among several threads.
+     */
+    void setVoicesPerThread(int count);
+
+    /**
+     * Mixes the next frames of output.
+     *
+     * @param frames  Interleaved stereo samples. There must be room for
+     *                2 * @a count values.
+     * @param count   Number of stereo frames to mix.
+     */
+    void render(float *frames, dsize count);
+
+    /**
+     * Mixes the next frames of output and gives them to a sink.
+     */
+    void render(ISink &sink, dsize count);
+
+    /**
+     * Name of the instruction set used for applying gain (for diagnostics and
+     * benchmarks).
+     */
+    static char const *kernelName();
+
+private:
+    DENG2_PRIVATE(d)
+};
+
+} // namespace de
+
+#endif // LIBDENG2_AUDIOMIXER_H
@@ -0,0 +1,486 @@
+/** @file flathashmap.h  Open-addressing hash map and set.
+ *
+ * @authors Copyright (c) 2015 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * LGPL: http://www.gnu.org/licenses/lgpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details. You should have received a copy of
+ * the GNU Lesser General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#ifndef LIBDENG2_FLATHASHMAP_H
+#define LIBDENG2_FLATHASHMAP_H
+
+#include "../libcore.h"
+#include "../math.h"
+
+#include <QHash>
+#include <QList>
+#include <algorithm>
+#include <vector>
+#include <utility>
+
+namespace de {
+
+/**
+ * Default hash function of FlatHashMap and FlatHashSet. Uses qHash(), so any
+ * type usable as a QHash key can be used as a key of the flat containers.
+ */
+template <typename Key>
+struct FlatHash
+{
+    duint32 operator () (Key const &key) const { return duint32(qHash(key)); }
+};
+
+namespace internal {
+
+/**
+ * Hash table shared by FlatHashMap and FlatHashSet. The entries are kept in a
+ * contiguous array in no particular order; a separate power-of-two table of
+ * slots maps hashes to entry positions using linear probing. Removing an entry
+ * moves the last entry into its place, and the probe sequence is repaired by
+ * shifting the following slots backwards (no tombstones).
+ */
+template <typename Key, typename Entry, typename KeyOf, typename Hash>
+class FlatHashTable
+{
+public:
+    typedef std::vector<Entry> Entries;
+
+    enum { MinTableSize = 16 };
+
+    FlatHashTable() : _mask(0) {}
+
+    inline dint size() const { return dint(_entries.size()); }
+    inline Entries &entries() { return _entries; }
+    inline Entries const &entries() const { return _entries; }
+
+    void clear()
+    {
+        _entries.clear();
+        _hashes.clear();
+        // The table keeps its size; it will likely be needed again.
+        std::fill(_slots.begin(), _slots.end(), Slot());
+    }
+
+    void reserve(dint count)
+    {
+        _entries.reserve(count);
+        _hashes.reserve(count);
+
+        // Keep the load factor at or below 3/4.
+        dsize needed = MinTableSize;
+        while(needed * 3 < dsize(count) * 4) needed <<= 1;
+        if(needed > _slots.size())
+        {
+            rebuild(needed);
+        }
+    }
+
+    static inline duint32 hashOf(Key const &key)
+    {
+        // Qt's hashes are often weak in the low bits (e.g., pointers), and
+        // the home slot is taken from the low bits: mix them thoroughly.
+        duint32 h = Hash()(key);
+        h ^= h >> 16;
+        h *= 0x85ebca6b;
+        h ^= h >> 13;
+        h *= 0xc2b2ae35;
+        h ^= h >> 16;
+        return h;
+    }
+
+    /**
+     * Locates the entry with a key.
+     *
+     * @return Position of the entry in entries(), or -1 if not found.
+     */
+    dint find(Key const &key) const
+    {
+        return find(key, hashOf(key));
+    }
+
+    /**
+     * Locates the entry with a key whose hash has already been computed with
+     * hashOf().
+     */
+    dint find(Key const &key, duint32 hash) const
+    {
+        dint const slot = findSlot(key, hash);
+        return slot >= 0? _slots[slot].pos : -1;
+    }
+
+    /**
+     * Adds a new entry. The key must not already be in the table.
+     *
+     * @return Position of the new entry.
+     */
+    template <typename EntryType>
+    dint insert(EntryType &&entry)
+    {
+        duint32 const hash = hashOf(KeyOf()(entry));
+        if(dsize(size() + 1) * 4 > _slots.size() * 3)
+        {
+            rebuild(de::max(dsize(MinTableSize), _slots.size() * 2));
+        }
+        dint const pos = size();
+        _entries.push_back(std::forward<EntryType>(entry));
+        _hashes.push_back(hash);
+        insertToSlots(hash, pos);
+        return pos;
+    }
+
+    /**
+     * Removes the entry with a key. The last entry is moved to the position
+     * of the removed one.
+     *
+     * @return @c true, if an entry was removed.
+     */
+    bool remove(Key const &key)
+    {
+        dint const slot = findSlot(key, hashOf(key));
+        if(slot < 0) return false;
+
+        dint const pos = _slots[slot].pos;
+        removeSlot(slot);
+
+        dint const last = size() - 1;
+        if(pos != last)
+        {
+            // Point the last entry's slot to its new position.
+            dint i = _hashes[last] & _mask;
+            while(_slots[i].pos != last) i = (i + 1) & _mask;
+            _slots[i].pos = pos;
+
+            _entries[pos] = std::move(_entries[last]);
+            _hashes[pos]  = _hashes[last];
+        }
+        _entries.pop_back();
+        _hashes.pop_back();
+        return true;
+    }
+
+private:
+    struct Slot
+    {
+        duint32 hash;
+        dint pos; ///< Position in the entries; -1 if the slot is free.
+
+        Slot() : hash(0), pos(-1) {}
+    };
+
+    dint findSlot(Key const &key, duint32 hash) const
+    {
+        if(_slots.empty()) return -1;
+
+        Slot const *slots = &_slots[0];
+        for(dint i = hash & _mask; slots[i].pos >= 0; i = (i + 1) & _mask)
+        {
+            if(slots[i].hash == hash && KeyOf()(_entries[slots[i].pos]) == key)
+            {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    void insertToSlots(duint32 hash, dint pos)
+    {
+        dint i = hash & _mask;
+        while(_slots[i].pos >= 0) i = (i + 1) & _mask;
+        _slots[i].hash = hash;
+        _slots[i].pos  = pos;
+    }
+
+    void removeSlot(dint pos)
+    {
+        // Shift back the following slots of the probe sequence, unless they
+        // would end up before their home slot.
+        for(dint next = (pos + 1) & _mask; _slots[next].pos >= 0; next = (next + 1) & _mask)
+        {
+            dint const home = _slots[next].hash & _mask;
+            bool const reachable = (pos <= next? (pos < home && home <= next)
+                                               : (pos < home || home <= next));
+            if(!reachable)
+            {
+                _slots[pos] = _slots[next];
+                pos = next;
+            }
+        }
+        _slots[pos] = Slot();
+    }
+
+    void rebuild(dsize tableSize)
+    {
+        _slots.assign(tableSize, Slot());
+        _mask = dint(tableSize - 1);
+        for(dint i = 0; i < size(); ++i)
+        {
+            insertToSlots(_hashes[i], i);
+        }
+    }
+
+private:
+    Entries _entries;
+    std::vector<duint32> _hashes; ///< Hash of each entry.
+    std::vector<Slot> _slots;
+    dint _mask;
+};
+
+template <typename Key, typename Value>
+struct FlatMapKeyOf {
+    Key const &operator () (std::pair<Key, Value> const &entry) const { return entry.first; }
+};
+
+template <typename Key>
+struct FlatSetKeyOf {
+    Key const &operator () (Key const &entry) const { return entry; }
+};
+
+} // namespace internal
+
+/**
+ * Hash map with open addressing, for the cases where QHash is too slow.
+ *
+ * The entries are stored by value in a single contiguous array, so there are
+ * no per-entry allocations, no implicit sharing (and thus no reference
+ * counting), and iterating through the map is a linear walk over memory. The
+ * interface mirrors the parts of QHash that are commonly used, so switching
+ * between the two is straightforward.
+ *
+ * Inserting an entry may invalidate all iterators, pointers and references to
+ * the entries. Removing an entry moves the last entry to its place, so entries
+ * cannot be removed while iterating through the map. Iteration order is
+ * unspecified.
+ *
+ * @ingroup data
+ */
+template <typename Key, typename Value, typename Hash = FlatHash<Key> >
+class FlatHashMap
+{
+    typedef internal::FlatHashTable<Key, std::pair<Key, Value>,
+                                    internal::FlatMapKeyOf<Key, Value>, Hash> Table;
+    typedef typename Table::Entries Entries;
+
+public:
+    typedef std::pair<Key, Value> Entry;
+
+    class const_iterator;
+
+    class iterator
+    {
+    public:
+        iterator(typename Entries::iterator i = typename Entries::iterator()) : _i(i) {}
+        inline Key const &key() const { return _i->first; }
+        inline Value &value() const { return _i->second; }
+        inline Value &operator * () const { return _i->second; }
+        inline Value *operator -> () const { return &_i->second; }
+        inline iterator &operator ++ () { ++_i; return *this; }
+        inline iterator operator ++ (int) { iterator old = *this; ++_i; return old; }
+        inline bool operator == (iterator const &other) const { return _i == other._i; }
+        inline bool operator != (iterator const &other) const { return _i != other._i; }
+    private:
+        friend class const_iterator;
+        typename Entries::iterator _i;
+    };
+
+    class const_iterator
+    {
+    public:
+        const_iterator(typename Entries::const_iterator i = typename Entries::const_iterator()) : _i(i) {}
+        const_iterator(iterator const &other) : _i(other._i) {}
+        inline Key const &key() const { return _i->first; }
+        inline Value const &value() const { return _i->second; }
+        inline Value const &operator * () const { return _i->second; }
+        inline Value const *operator -> () const { return &_i->second; }
+        inline const_iterator &operator ++ () { ++_i; return *this; }
+        inline const_iterator operator ++ (int) { const_iterator old = *this; ++_i; return old; }
+        inline bool operator == (const_iterator const &other) const { return _i == other._i; }
+        inline bool operator != (const_iterator const &other) const { return _i != other._i; }
+    private:
+        typename Entries::const_iterator _i;
+    };
+
+public:
+    FlatHashMap() {}
+
+    inline dint size() const { return _table.size(); }
+    inline dint count() const { return _table.size(); }
+    inline bool isEmpty() const { return !_table.size(); }
+
+    /**
+     * Removes all entries. The allocated memory is retained for reuse.
+     */
+    inline void clear() { _table.clear(); }
+
+    /**
+     * Allocates memory for at least @a count entries.
+     */
+    inline void reserve(dint count) { _table.reserve(count); }
+
+    inline bool contains(Key const &key) const { return _table.find(key) >= 0; }
+
+    /**
+     * Returns the hash of a key as used by the map. Code that repeatedly looks
+     * up the same key can compute the hash once and pass it to constFind().
+     */
+    static inline duint32 hashOf(Key const &key) { return Table::hashOf(key); }
+
+    QList<Key> keys() const
+    {
+        QList<Key> list;
+        list.reserve(size());
+        for(Entry const &entry : _table.entries()) list.append(entry.first);
+        return list;
+    }
+
+    /**
+     * Inserts an entry, replacing the value of an existing entry with the
+     * same key.
+     *
+     * @return Iterator to the entry.
+     */
+    iterator insert(Key const &key, Value const &value)
+    {
+        dint pos = _table.find(key);
+        if(pos < 0)
+        {
+            pos = _table.insert(Entry(key, value));
+        }
+        else
+        {
+            _table.entries()[pos].second = value;
+        }
+        return iterator(_table.entries().begin() + pos);
+    }
+
+    /**
+     * Returns the value of an entry. A default-constructed value is inserted
+     * if the key is not in the map.
+     */
+    Value &operator [] (Key const &key)
+    {
+        dint pos = _table.find(key);
+        if(pos < 0)
+        {
+            pos = _table.insert(Entry(key, Value()));
+        }
+        return _table.entries()[pos].second;
+    }
+
+    Value value(Key const &key, Value const &defaultValue = Value()) const
+    {
+        dint const pos = _table.find(key);
+        return pos >= 0? _table.entries()[pos].second : defaultValue;
+    }
+
+    /**
+     * Removes the entry with a key.
+     *
+     * @return Number of removed entries (0 or 1).
+     */
+    inline dint remove(Key const &key) { return _table.remove(key)? 1 : 0; }
+
+    iterator find(Key const &key)
+    {
+        dint const pos = _table.find(key);
+        return pos >= 0? iterator(_table.entries().begin() + pos) : end();
+    }
+
+    const_iterator constFind(Key const &key) const
+    {
+        dint const pos = _table.find(key);
+        return pos >= 0? const_iterator(_table.entries().begin() + pos) : constEnd();
+    }
+
+    /**
+     * Finds an entry using a key hash computed in advance with hashOf().
+     */
+    const_iterator constFind(Key const &key, duint32 hash) const
+    {
+        dint const pos = _table.find(key, hash);
+        return pos >= 0? const_iterator(_table.entries().begin() + pos) : constEnd();
+    }
+
+    inline const_iterator find(Key const &key) const { return constFind(key); }
+
+    inline iterator begin() { return iterator(_table.entries().begin()); }
+    inline iterator end() { return iterator(_table.entries().end()); }
+    inline const_iterator begin() const { return constBegin(); }
+    inline const_iterator end() const { return constEnd(); }
+    inline const_iterator constBegin() const { return const_iterator(_table.entries().begin()); }
+    inline const_iterator constEnd() const { return const_iterator(_table.entries().end()); }
+
+private:
+    Table _table;
+};
+
+/**
+ * Hash set with open addressing, for the cases where QSet is too slow.
+ * The same notes apply as for FlatHashMap.
+ *
+ * @ingroup data
+ */
+template <typename Key, typename Hash = FlatHash<Key> >
+class FlatHashSet
+{
+    typedef internal::FlatHashTable<Key, Key, internal::FlatSetKeyOf<Key>, Hash> Table;
+
+public:
+    typedef typename Table::Entries::const_iterator const_iterator;
+    typedef const_iterator iterator;
+
+public:
+    FlatHashSet() {}
+
+    inline dint size() const { return _table.size(); }
+    inline dint count() const { return _table.size(); }
+    inline bool isEmpty() const { return !_table.size(); }
+
+    /**
+     * Removes all keys. The allocated memory is retained for reuse.
+     */
+    inline void clear() { _table.clear(); }
+
+    /**
+     * Allocates memory for at least @a count keys.
+     */
+    inline void reserve(dint count) { _table.reserve(count); }
+
+    inline bool contains(Key const &key) const { return _table.find(key) >= 0; }
+
+    void insert(Key const &key)
+    {
+        if(_table.find(key) < 0)
+        {
+            _table.insert(key);
+        }
+    }
+
+    /**
+     * Removes a key.
+     *
+     * @return @c true, if the key was in the set.
+     */
+    inline bool remove(Key const &key) { return _table.remove(key); }
+
+    inline const_iterator begin() const { return _table.entries().begin(); }
+    inline const_iterator end() const { return _table.entries().end(); }
+    inline const_iterator constBegin() const { return begin(); }
+    inline const_iterator constEnd() const { return end(); }
+
+private:
+    Table _table;
+};
+
+} // namespace de
+
+#endif // LIBDENG2_FLATHASHMAP_H
@@ -36,7 +36,7 @@ namespace codec {
  *
  * @return Encoded block of bits.
  */
-Block huffmanEncode(Block const &data);
+DENG2_PUBLIC Block huffmanEncode(Block const &data);
 
 /**
  * Decodes the coded message using the Huffman tree.
@@ -44,7 +44,43 @@ Block huffmanEncode(Block const &data);
  *
  * @return Decoded block of data.
  */
-Block huffmanDecode(Block const &codedData);
+DENG2_PUBLIC Block huffmanDecode(Block const &codedData);
+
+/**
+ * Determines the largest possible size of @a size bytes of data after it has
+ * been encoded with Huffman codes.
+ */
+DENG2_PUBLIC dsize huffmanMaxEncodedSize(dsize size);
+
+/**
+ * Encodes data using Huffman codes into a caller-provided buffer.
+ *
+ * @param data     Data to encode.
+ * @param size     Size of the data in bytes.
+ * @param encoded  Output buffer. Must have room for huffmanMaxEncodedSize()
+ *                 bytes.
+ *
+ * @return Size of the encoded data in bytes.
+ */
+DENG2_PUBLIC dsize huffmanEncode(dbyte const *data, dsize size, dbyte *encoded);
+
+/**
+ * Determines the largest possible size of @a codedSize bytes of Huffman-coded
+ * data after it has been decoded.
+ */
+DENG2_PUBLIC dsize huffmanMaxDecodedSize(dsize codedSize);
+
+/**
+ * Decodes Huffman-coded data into a caller-provided buffer.
+ *
+ * @param codedData  Huffman-coded data.
+ * @param size       Size of the coded data in bytes.
+ * @param decoded    Output buffer. Must have room for huffmanMaxDecodedSize()
+ *                   bytes.
+ *
+ * @return Size of the decoded data in bytes.
+ */
+DENG2_PUBLIC dsize huffmanDecode(dbyte const *codedData, dsize size, dbyte *decoded);
 
 } // namespace codec
 } // namespace de
@@ -28,8 +28,12 @@
 #include "../ISerializable"
 #include "../String"
 
+#include <QVarLengthArray>
+
 namespace de {
 
+class PathView;
+
 /**
  * A textual path composed of segments. @ingroup data
  *
@@ -134,6 +138,7 @@ public:
         bool operator < (Segment const &other) const;
 
         friend class Path;
+        friend class PathView;
         friend struct Path::Instance;
 
     private:
@@ -518,6 +523,79 @@ private:
     Rangei _range;
 };
 
+/**
+ * Lightweight view of a textual path, split into segments. @ingroup data
+ *
+ * PathView is meant for lookups where a Path would only be constructed
+ * temporarily: it shares the (implicitly shared) String it was given and
+ * keeps the segments of ordinary paths within itself, so making a view
+ * does not allocate any memory from the heap. Like with Path, segments are
+ * parsed only when first needed and the hash of each segment is computed
+ * only once.
+ *
+ * Because the view holds its own reference to the string, it may be made
+ * of a temporary String. Views cannot be copied, as the parsed segments
+ * refer to the string owned by the view.
+ */
+class DENG2_PUBLIC PathView
+{
+public:
+    /**
+     * Constructs a view of @a path.
+     *
+     * @param path  Path to be viewed. Shared, not copied.
+     * @param sep   Character used to separate path segments in @a path.
+     */
+    explicit PathView(String const &path, QChar sep = '/');
+
+    /// Returns the viewed path string.
+    String const &toStringRef() const { return _path; }
+
+    QChar separator() const { return _separator; }
+
+    bool isEmpty() const { return _path.isEmpty(); }
+
+    bool isAbsolute() const {
+        return !isEmpty() && !firstSegment().size();
+    }
+
+    /// @copydoc Path::segmentCount()
+    int segmentCount() const;
+
+    /// @copydoc Path::segment()
+    Path::Segment const &segment(int index) const {
+        return reverseSegment(segmentCount() - 1 - index);
+    }
+
+    /// @copydoc Path::reverseSegment()
+    Path::Segment const &reverseSegment(int reverseIndex) const;
+
+    inline Path::Segment const &firstSegment() const {
+        return segment(0);
+    }
+
+    inline Path::Segment const &lastSegment() const {
+        return reverseSegment(0);
+    }
+
+    /// Makes a Path (with its own copy of the string) out of the view.
+    Path toPath() const {
+        return Path(_path, _separator);
+    }
+
+private:
+    DENG2_NO_COPY  (PathView)
+    DENG2_NO_ASSIGN(PathView)
+
+    void parse() const;
+
+    String _path;
+    QChar _separator;
+
+    /// Segments in reverse order. Empty if not parsed yet.
+    mutable QVarLengthArray<Path::Segment, 16> _segments;
+};
+
 } // namespace de
 
 namespace std {
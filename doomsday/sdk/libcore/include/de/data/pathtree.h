@@ -222,6 +222,9 @@ public:
          */
         int comparePath(de::Path const &searchPattern, ComparisonFlags flags) const;
 
+        /// @copydoc comparePath()
+        int comparePath(PathView const &searchPattern, ComparisonFlags flags) const;
+
         /**
          * Composes the path for this node. The whole path is upwardly
          * reconstructed toward the root of the hierarchy -- you should
@@ -335,6 +338,22 @@ public:
 
     Node *tryFind(Path const &path, ComparisonFlags flags);
 
+    /**
+     * Determines if a path exists in the tree. Looking up a PathView does not
+     * allocate memory.
+     *
+     * @param path   Path to look for.
+     * @param flags  Search behavior.
+     */
+    bool has(PathView const &path, ComparisonFlags flags = 0) const;
+
+    /// @copydoc find()
+    Node const &find(PathView const &path, ComparisonFlags flags) const;
+    Node &find(PathView const &path, ComparisonFlags flags);
+
+    Node const *tryFind(PathView const &path, ComparisonFlags flags) const;
+    Node *tryFind(PathView const &path, ComparisonFlags flags);
+
     /**
      * Collate all referenced paths in the hierarchy into a list.
      *
@@ -367,6 +386,24 @@ public:
     int traverse(ComparisonFlags flags, Node const *parent, Path::hash_type hashKey,
                  int (*callback) (Node &node, void *parameters), void *parameters = 0) const;
 
+    /**
+     * Traverse the nodes whose path matches @a path, making a callback for
+     * each visited node. Only the nodes with the same hash as the last segment
+     * of the path are considered.
+     *
+     * @param flags       Path comparison flags.
+     * @param parent      Used in combination with ComparisonFlag::MatchParent
+     *                    to limit the traversal to only the child nodes of
+     *                    this node.
+     * @param path        Path to match.
+     * @param callback    Callback function ptr.
+     * @param parameters  Passed to the callback.
+     *
+     * @return  @c 0 iff iteration completed wholly.
+     */
+    int traverse(ComparisonFlags flags, Node const *parent, PathView const &path,
+                 int (*callback) (Node &node, void *parameters), void *parameters = 0) const;
+
     /**
      * Provides access to the nodes for efficent traversals.
      *
@@ -517,6 +554,22 @@ public:
         return static_cast<Type *>(PathTree::tryFind(path, flags));
     }
 
+    inline Type const &find(PathView const &path, ComparisonFlags flags) const {
+        return static_cast<Type const &>(PathTree::find(path, flags));
+    }
+
+    inline Type &find(PathView const &path, ComparisonFlags flags) {
+        return static_cast<Type &>(PathTree::find(path, flags));
+    }
+
+    inline Type const *tryFind(PathView const &path, ComparisonFlags flags) const {
+        return static_cast<Type const *>(PathTree::tryFind(path, flags));
+    }
+
+    inline Type *tryFind(PathView const &path, ComparisonFlags flags) {
+        return static_cast<Type *>(PathTree::tryFind(path, flags));
+    }
+
     inline int findAll(FoundNodes &found, bool (*predicate)(Type const &node, void *context),
                        void *context = 0) const {
         int numFoundSoFar = found.size();
@@ -539,6 +592,13 @@ public:
                                   context);
     }
 
+    inline int traverse(ComparisonFlags flags, Type const *parent, PathView const &path,
+                        int (*callback) (Type &node, void *context), void *context = 0) const {
+        return PathTree::traverse(flags, parent, path,
+                                  reinterpret_cast<int (*)(PathTree::Node &, void *)>(callback),
+                                  context);
+    }
+
 protected:
     PathTree::Node *newNode(NodeArgs const &args) {
         return new Type(args);
@@ -27,7 +27,10 @@
 #include "../Audience"
 #include "../Log"
 #include "../RecordAccessor"
+#include "../RecordKey"
+#include "../FlatHashMap"
 
+#include <QHash>
 #include <QMap>
 #include <QList>
 #include <QRegExp>
@@ -47,6 +50,11 @@ class NativeFunctionSpec;
  * main record. The ownership chain is as follows: Record -> Variable ->
  * RecordValue -> Record.
  *
+ * Members are kept in a FlatHashMap, so iterating members() proceeds in no
+ * particular order. Serialization writes the members in name order. Native
+ * code can use a RecordKey for frequently used names to avoid constructing
+ * and hashing a String for every lookup.
+ *
  * @see http://en.wikipedia.org/wiki/Record_(computer_science)
  *
  * @ingroup data
@@ -67,7 +75,7 @@ public:
     /// Name of the special variable that specifies super records.
     static String const SUPER_NAME;
 
-    typedef QMap<String, Variable *> Members;
+    typedef FlatHashMap<String, Variable *> Members;
     typedef QMap<String, Record *> Subrecords;
     typedef std::pair<String, String> KeyValue;
     typedef QList<KeyValue> List;
@@ -146,11 +154,18 @@ public:
      */
     bool has(String const &name) const;
 
+    bool has(RecordKey const &key) const;
+
     /**
      * Determines if the record contains a variable named @a variableName.
      */
     bool hasMember(String const &variableName) const;
 
+    /**
+     * Determines if the record contains a variable identified by @a key.
+     */
+    bool hasMember(RecordKey const &key) const;
+
     /**
      * Determines if the record contains a subrecord named @a subrecordName.
      */
@@ -361,6 +376,24 @@ public:
      */
     Variable const &operator [] (String const &name) const;
 
+    /**
+     * Looks up a variable in the record using a prepared key.
+     *
+     * @param key  Variable name or path.
+     *
+     * @return  Variable.
+     */
+    Variable &operator [] (RecordKey const &key);
+
+    /**
+     * Looks up a variable in the record using a prepared key.
+     *
+     * @param key  Variable name or path.
+     *
+     * @return  Variable (non-modifiable).
+     */
+    Variable const &operator [] (RecordKey const &key) const;
+
     /**
      * Looks up a subrecord in the record.
      *
@@ -20,6 +20,7 @@
 #define LIBDENG2_RECORDACCESSOR_H
 
 #include "../ArrayValue"
+#include "../RecordKey"
 
 namespace de {
 
@@ -65,6 +66,22 @@ public:
     String gets(String const &name, String const &defaultValue) const;
     ArrayValue const &geta(String const &name) const;
 
+    // Variants with a prepared key (see RecordKey).
+    bool has(RecordKey const &key) const;
+    Value const &get(RecordKey const &key) const;
+    dint geti(RecordKey const &key) const;
+    dint geti(RecordKey const &key, dint defaultValue) const;
+    bool getb(RecordKey const &key) const;
+    bool getb(RecordKey const &key, bool defaultValue) const;
+    duint getui(RecordKey const &key) const;
+    duint getui(RecordKey const &key, duint defaultValue) const;
+    dfloat getf(RecordKey const &key) const;
+    dfloat getf(RecordKey const &key, dfloat defaultValue) const;
+    ddouble getd(RecordKey const &key) const;
+    ddouble getd(RecordKey const &key, ddouble defaultValue) const;
+    String gets(RecordKey const &key) const;
+    String gets(RecordKey const &key, String const &defaultValue) const;
+
     Record const &subrecord(String const &name) const;
 
     template <typename ValueType>
@@ -0,0 +1,70 @@
+/** @file recordkey.h  Prepared name of a Record member.
+ *
+ * @authors Copyright (c) 2015 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * LGPL: http://www.gnu.org/licenses/lgpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details. You should have received a copy of
+ * the GNU Lesser General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#ifndef LIBDENG2_RECORDKEY_H
+#define LIBDENG2_RECORDKEY_H
+
+#include "../String"
+
+namespace de {
+
+/**
+ * Name of a Record member prepared for lookups. Native code that repeatedly
+ * looks up the same members (e.g., fields of definitions) can keep a RecordKey
+ * around, typically as a static constant. The key is split and hashed once
+ * when it is constructed, so a lookup neither constructs a String nor hashes
+ * the name again.
+ *
+ * The name may also be a path using the member notation
+ * (<code>subrecord-name.variable-name</code>). Only the final member name of
+ * a path is prehashed; the subrecords are looked up by name.
+ *
+ * @ingroup data
+ */
+class DENG2_PUBLIC RecordKey
+{
+public:
+    explicit RecordKey(String const &name);
+    explicit RecordKey(char const *nameUtf8);
+
+    inline String const &name() const { return _name; }
+
+    /// Determines whether the key uses the member notation.
+    inline bool isPath() const { return !_subrecordPath.isEmpty(); }
+
+    /// Path of the subrecord containing the member (empty if not a path).
+    inline String const &subrecordPath() const { return _subrecordPath; }
+
+    /// Name of the member without the subrecord path.
+    inline String const &memberName() const { return _memberName; }
+
+    /// Hash of memberName() as used by Record::Members.
+    inline duint32 hash() const { return _hash; }
+
+private:
+    void prepare();
+
+    String _name;
+    String _subrecordPath;
+    String _memberName;
+    duint32 _hash;
+};
+
+} // namespace de
+
+#endif // LIBDENG2_RECORDKEY_H
@@ -0,0 +1,128 @@
+/** @file resampler.h  Band-limited sample rate conversion.
+ *
+ * @authors Copyright © 2015 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * LGPL: http://www.gnu.org/licenses/lgpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details. You should have received a copy of
+ * the GNU Lesser General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#ifndef LIBDENG2_RESAMPLER_H
+#define LIBDENG2_RESAMPLER_H
+
+#include "../libcore.h"
+
+namespace de {
+
+/**
+ * Converts mono audio from one sample rate to another with a polyphase
+ * windowed-sinc filter.
+ *
+ * The ratio of the rates is reduced to L/M. The output is the input upsampled
+ * by L, low-pass filtered, and decimated by M; only the filter phase needed
+ * for each output sample is evaluated, so each output sample is the dot
+ * product of one of the L sets of coefficients with the nearby input samples.
+ * The filter cuts off below the Nyquist frequency of the lower of the two
+ * rates, so upsampling does not produce images and downsampling does not
+ * produce aliasing. If L would be larger than maxPhases(), the ratio is
+ * approximated with one that has fewer phases.
+ *
+ * The input can be given in pieces, which makes it possible to convert a
+ * stream: the resampler keeps the input samples that it still needs. A whole
+ * sound can be converted at once with convert().
+ *
+ * The dot products are computed with SSE2 or AVX2 instructions, when the CPU
+ * supports them.
+ *
+ * @ingroup data
+ */
+class DENG2_PUBLIC Resampler
+{
+public:
+    /**
+     * Sets up the resampler.
+     *
+     * @param inputRate   Sample rate of the input.
+     * @param outputRate  Sample rate of the output.
+     * @param halfLength  Length of one side of the filter, in samples of the
+     *                    lower rate. Longer filters have a sharper cutoff.
+     */
+    Resampler(int inputRate, int outputRate, int halfLength = 16);
+
+    int inputRate() const;
+    int outputRate() const;
+
+    /**
+     * Number of output samples corresponding to @a inputCount input samples.
+     */
+    dsize outputLength(dsize inputCount) const;
+
+    /**
+     * Converts a whole sound. The sound is assumed to be silent before and
+     * after the input. Any previously written input is discarded.
+     *
+     * @param input   Input samples.
+     * @param count   Number of input samples.
+     * @param output  Output samples. Must have room for outputLength(count)
+     *                samples.
+     *
+     * @return Number of output samples.
+     */
+    dsize convert(float const *input, dsize count, float *output);
+
+    /**
+     * Discards all input and begins a new stream.
+     */
+    void reset();
+
+    /**
+     * Adds input samples to the stream.
+     */
+    void write(float const *input, dsize count);
+
+    /**
+     * Ends the stream. The input is followed by silence, so the rest of the
+     * output becomes available.
+     */
+    void finish();
+
+    /**
+     * Number of output samples that can be read with the input written so far.
+     */
+    dsize available() const;
+
+    /**
+     * Reads output samples.
+     *
+     * @param output    Output samples.
+     * @param maxCount  Maximum number of samples to read.
+     *
+     * @return Number of samples read.
+     */
+    dsize read(float *output, dsize maxCount);
+
+    /// Largest number of filter phases.
+    static int maxPhases();
+
+    /**
+     * Name of the instruction set used for computing the filter (for
+     * diagnostics and benchmarks).
+     */
+    static char const *kernelName();
+
+private:
+    DENG2_PRIVATE(d)
+};
+
+} // namespace de
+
+#endif // LIBDENG2_RESAMPLER_H
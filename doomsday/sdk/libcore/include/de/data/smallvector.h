@@ -0,0 +1,233 @@
+/** @file smallvector.h  Array with inline capacity.
+ *
+ * @authors Copyright (c) 2015 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * LGPL: http://www.gnu.org/licenses/lgpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details. You should have received a copy of
+ * the GNU Lesser General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#ifndef LIBDENG2_SMALLVECTOR_H
+#define LIBDENG2_SMALLVECTOR_H
+
+#include "../libcore.h"
+
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace de {
+
+/**
+ * Dynamic array that stores up to @a InlineCapacity elements inside the object
+ * itself. Only when more elements are added is memory allocated from the heap.
+ * Suitable for short-lived, usually small arrays, for instance the temporary
+ * lists collected while processing a single map object during a tick.
+ *
+ * Unlike QVector, SmallVector is not implicitly shared: copying a SmallVector
+ * copies the elements. Adding elements may invalidate pointers and references
+ * to the existing elements.
+ *
+ * @ingroup data
+ */
+template <typename Type, dsize InlineCapacity = 16>
+class SmallVector
+{
+public:
+    typedef Type *iterator;
+    typedef Type const *const_iterator;
+
+public:
+    SmallVector() : _data(inlineData()), _size(0), _capacity(InlineCapacity) {}
+
+    SmallVector(SmallVector const &other)
+        : _data(inlineData()), _size(0), _capacity(InlineCapacity)
+    {
+        append(other.begin(), other.end());
+    }
+
+    SmallVector(SmallVector &&other)
+        : _data(inlineData()), _size(0), _capacity(InlineCapacity)
+    {
+        takeFrom(other);
+    }
+
+    ~SmallVector()
+    {
+        clear();
+        releaseHeap();
+    }
+
+    SmallVector &operator = (SmallVector const &other)
+    {
+        if(this != &other)
+        {
+            clear();
+            append(other.begin(), other.end());
+        }
+        return *this;
+    }
+
+    SmallVector &operator = (SmallVector &&other)
+    {
+        if(this != &other)
+        {
+            clear();
+            releaseHeap();
+            takeFrom(other);
+        }
+        return *this;
+    }
+
+    inline dsize size() const { return _size; }
+    inline dint count() const { return dint(_size); }
+    inline dsize capacity() const { return _capacity; }
+    inline bool isEmpty() const { return !_size; }
+
+    /// Determines whether the elements have been moved to the heap.
+    inline bool isOnHeap() const { return _data != inlineData(); }
+
+    inline Type *data() { return _data; }
+    inline Type const *data() const { return _data; }
+
+    inline Type &operator [] (dsize index) {
+        DENG2_ASSERT(index < _size);
+        return _data[index];
+    }
+    inline Type const &operator [] (dsize index) const {
+        DENG2_ASSERT(index < _size);
+        return _data[index];
+    }
+    inline Type const &at(dsize index) const { return (*this)[index]; }
+
+    inline Type &first() { return (*this)[0]; }
+    inline Type const &first() const { return (*this)[0]; }
+    inline Type &last() { return (*this)[_size - 1]; }
+    inline Type const &last() const { return (*this)[_size - 1]; }
+
+    inline iterator begin() { return _data; }
+    inline iterator end() { return _data + _size; }
+    inline const_iterator begin() const { return _data; }
+    inline const_iterator end() const { return _data + _size; }
+
+    /**
+     * Ensures there is room for at least @a count elements.
+     */
+    void reserve(dsize count)
+    {
+        if(count <= _capacity) return;
+
+        Type *data = static_cast<Type *>(std::malloc(count * sizeof(Type)));
+        if(!data) throw std::bad_alloc();
+        for(dsize i = 0; i < _size; ++i)
+        {
+            new (data + i) Type(std::move(_data[i]));
+            _data[i].~Type();
+        }
+        releaseHeap();
+        _data = data;
+        _capacity = count;
+    }
+
+    template <typename... Args>
+    Type &emplace_back(Args &&... args)
+    {
+        if(_size == _capacity)
+        {
+            // The arguments may refer to the current elements.
+            Type value(std::forward<Args>(args)...);
+            reserve(_capacity? _capacity * 2 : 4);
+            new (_data + _size) Type(std::move(value));
+        }
+        else
+        {
+            new (_data + _size) Type(std::forward<Args>(args)...);
+        }
+        return _data[_size++];
+    }
+
+    inline void append(Type const &value) { emplace_back(value); }
+    inline void append(Type &&value) { emplace_back(std::move(value)); }
+    inline void push_back(Type const &value) { emplace_back(value); }
+    inline void push_back(Type &&value) { emplace_back(std::move(value)); }
+
+    template <typename Iterator>
+    void append(Iterator first, Iterator last)
+    {
+        for(; first != last; ++first) emplace_back(*first);
+    }
+
+    inline SmallVector &operator << (Type const &value) {
+        emplace_back(value);
+        return *this;
+    }
+
+    void removeLast()
+    {
+        DENG2_ASSERT(_size > 0);
+        _data[--_size].~Type();
+    }
+
+    /**
+     * Destroys all elements. Heap memory, if any, is kept for reuse.
+     */
+    void clear()
+    {
+        while(_size) removeLast();
+    }
+
+private:
+    inline Type *inlineData() { return reinterpret_cast<Type *>(&_inline); }
+    inline Type const *inlineData() const { return reinterpret_cast<Type const *>(&_inline); }
+
+    void releaseHeap()
+    {
+        if(isOnHeap())
+        {
+            std::free(_data);
+            _data = inlineData();
+            _capacity = InlineCapacity;
+        }
+    }
+
+    /// Moves the elements of @a other into this empty vector.
+    void takeFrom(SmallVector &other)
+    {
+        if(other.isOnHeap())
+        {
+            // Take ownership of the heap memory.
+            _data = other._data;
+            _size = other._size;
+            _capacity = other._capacity;
+            other._data = other.inlineData();
+            other._size = 0;
+            other._capacity = InlineCapacity;
+        }
+        else
+        {
+            for(Type &value : other) emplace_back(std::move(value));
+            other.clear();
+        }
+    }
+
+private:
+    Type *_data;
+    dsize _size;
+    dsize _capacity;
+    typename std::aligned_storage<sizeof(Type) * InlineCapacity,
+                                  std::alignment_of<Type>::value>::type _inline;
+};
+
+} // namespace de
+
+#endif // LIBDENG2_SMALLVECTOR_H
@@ -47,8 +47,15 @@ namespace de {
  * Each string can also have an associated, custom user-defined uint32 value
  * and/or void *data pointer.
  *
- * The implementation has, at worst, O(log n) complexity for addition, removal,
- * string lookup, and user value/pointer set/get.
+ * The strings are indexed in a hash table using a case-folded hash, so addition,
+ * removal and lookup have O(1) average complexity. Getting a string or a user
+ * value/pointer by Id is a direct array access.
+ *
+ * The pool can be used from multiple threads. Modifying the pool and looking up
+ * strings by content is serialized with a mutex, but string(), stringRef(),
+ * userValue() and userPointer() do not lock: the stored strings are not moved
+ * in memory until the pool is cleared. (Reading a string while removing the
+ * same string in another thread is not allowed, though.)
  *
  * @todo Add case-sensitive mode.
  *
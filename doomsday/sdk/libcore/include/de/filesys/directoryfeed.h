@@ -118,7 +118,20 @@ public:
 
 protected:
     void populateSubFolder(Folder &folder, String const &entryName);
-    void populateFile(Folder &folder, String const &entryName);
+
+    /**
+     * Adds a file to the folder, unless it already has one with the same name.
+     *
+     * @param folder     Folder being populated.
+     * @param entryName  Name of the file in the native directory.
+     * @param status     Status of the native file.
+     * @param knownType  Type of the File previously interpreted from the same,
+     *                   unchanged native file. Empty if not known.
+     *
+     * @return Type of the File in the folder (see DENG2_TYPE_NAME).
+     */
+    String populateFile(Folder &folder, String const &entryName,
+                        File::Status const &status, String const &knownType);
 
 private:
     NativePath const _nativePath;
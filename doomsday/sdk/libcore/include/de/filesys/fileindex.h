@@ -21,9 +21,10 @@
 
 #include "../File"
 
-#include <map>
+#include <QList>
 #include <list>
 #include <utility>
+#include <vector>
 
 namespace de {
 
@@ -32,15 +33,20 @@ class File;
 /**
  * Indexes files for quick access.
  *
+ * Files are indexed by their name (case insensitively). The index is a flat
+ * array of entries with a separate open-addressing hash table, so adding,
+ * removing and looking up files are O(1) operations that do not allocate
+ * memory for each file. The order of iteration is unspecified.
+ *
  * @ingroup fs
  */
 class DENG2_PUBLIC FileIndex
 {
 public:
-    typedef std::multimap<String, File *> Index;
-    typedef std::pair<Index::iterator, Index::iterator> IndexRange;
-    typedef std::pair<Index::const_iterator, Index::const_iterator> ConstIndexRange;
+    typedef std::pair<String, File *> Entry; ///< Name of the file and the file.
+    typedef std::vector<Entry> Index;
     typedef std::list<File *> FoundFiles;
+    typedef QList<File *> Files;
 
     class DENG2_PUBLIC IPredicate
     {
@@ -80,6 +86,17 @@ public:
      */
     bool maybeAdd(File const &file);
 
+    /**
+     * Adds a set of files to the index, each one only if the predicate permits.
+     * This is faster than adding the files individually with maybeAdd() because
+     * the index only needs to be grown and locked once.
+     *
+     * @param files  Files to add.
+     *
+     * @return Number of files added to the index.
+     */
+    int maybeAddAll(Files const &files);
+
     /**
      * Removes a file from the index, if it has been indexed. If not, nothing is done.
      *
@@ -89,6 +106,14 @@ public:
 
     int size() const;
 
+    /**
+     * Calculates the hash of a file name as used in the index. The hash is
+     * case insensitive.
+     *
+     * @param name  File name.
+     */
+    static duint32 hashName(String const &name);
+
     enum Behavior { FindInEntireIndex, FindOnlyInLoadedPackages };
 
     void findPartialPath(String const &path, FoundFiles &found,
@@ -23,6 +23,7 @@
 #include "../libcore.h"
 #include "../Folder"
 #include "../FileIndex"
+#include "../NativeDirectoryIndex"
 #include "../System"
 
 #include <QFlags>
@@ -295,6 +296,15 @@ public:
      */
     void index(File &file);
 
+    /**
+     * Adds a set of files to the main index. This is equivalent to calling
+     * index() for each file, but faster when many files are added at once
+     * (e.g., when the contents of an archive are populated).
+     *
+     * @param files  Files to index.
+     */
+    void indexAll(FileIndex::Files const &files);
+
     /**
      * Removes a file from the main index.
      *
@@ -302,6 +312,13 @@ public:
      */
     void deindex(File &file);
 
+    /**
+     * Returns the index of native directory contents. DirectoryFeed uses it to
+     * avoid reinterpreting files that have not changed since the index was
+     * last saved.
+     */
+    NativeDirectoryIndex &nativeDirectoryIndex();
+
     enum CopyBehavior
     {
         PlainFileCopy          = 0,
@@ -0,0 +1,107 @@
+/** @file nativedirectoryindex.h  Persistent index of native directory contents.
+ *
+ * @authors Copyright (c) 2015 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * LGPL: http://www.gnu.org/licenses/lgpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details. You should have received a copy of
+ * the GNU Lesser General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#ifndef LIBDENG2_NATIVEDIRECTORYINDEX_H
+#define LIBDENG2_NATIVEDIRECTORYINDEX_H
+
+#include "../File"
+#include "../ISerializable"
+#include "../NativePath"
+
+#include <QHash>
+
+namespace de {
+
+/**
+ * Index of the files found in native directories, which can be saved and
+ * restored between sessions. For each file, the index records the status
+ * (size and time of last modification) and the type of the File that was
+ * interpreted from it.
+ *
+ * DirectoryFeed consults the index when populating a folder. If a file's
+ * status has not changed since it was indexed, the earlier interpretation
+ * result can be trusted: files that turned out to be plain native files (or
+ * failed to open as archives) do not need to be sniffed again.
+ *
+ * The file listing itself is never taken from the index, because modifying a
+ * file in place does not change the modification time of its directory.
+ *
+ * The index can be accessed from multiple threads.
+ *
+ * @ingroup fs
+ */
+class DENG2_PUBLIC NativeDirectoryIndex : public ISerializable
+{
+public:
+    struct Entry
+    {
+        File::Status status;
+        String type;    ///< Type of the interpreted File (see DENG2_TYPE_NAME).
+    };
+
+    /// Entries of a directory, keyed by file name.
+    typedef QHash<String, Entry> Entries;
+
+public:
+    NativeDirectoryIndex();
+
+    void clear();
+
+    /**
+     * Returns the indexed entries of a directory.
+     *
+     * @param directory  Native directory.
+     */
+    Entries entries(NativePath const &directory) const;
+
+    /**
+     * Replaces the indexed entries of a directory.
+     *
+     * @param directory  Native directory.
+     * @param entries    Files currently in the directory.
+     */
+    void setEntries(NativePath const &directory, Entries const &entries);
+
+    /**
+     * Reads the index from a native file. If the file does not exist or is in
+     * a different format revision, the index is left empty.
+     *
+     * @param nativePath  File to read.
+     *
+     * @return @c true, if the index was loaded.
+     */
+    bool load(NativePath const &nativePath);
+
+    /**
+     * Writes the index to a native file. Missing directories are created.
+     *
+     * @param nativePath  File to write.
+     */
+    void save(NativePath const &nativePath) const;
+
+    // Implements ISerializable.
+    void operator >> (Writer &to) const;
+    void operator << (Reader &from);
+
+private:
+    DENG2_PRIVATE(d)
+};
+
+} // namespace de
+
+#endif // LIBDENG2_NATIVEDIRECTORYINDEX_H
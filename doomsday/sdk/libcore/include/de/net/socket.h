@@ -23,6 +23,7 @@
 #include "../libcore.h"
 #include "../IByteArray"
 #include "../Address"
+#include "../Block"
 #include "../Transmitter"
 
 #include <QTcpSocket>
@@ -71,6 +72,89 @@ public:
     };
     Q_DECLARE_FLAGS(HeaderFlags, HeaderFlag)
 
+    /**
+     * Persistent zlib compression state of one connection. Consecutive
+     * messages are compressed as a single deflate stream, so later messages
+     * can refer back to the contents of earlier ones. The receiving socket
+     * keeps the matching decompression state.
+     */
+    class DENG2_PUBLIC DeflateStream
+    {
+    public:
+        DeflateStream();
+
+        /**
+         * Determines if a payload of @a size bytes is guaranteed to fit in a
+         * medium-sized message after being compressed with the stream.
+         */
+        bool accepts(dsize size) const;
+
+        /**
+         * Compresses @a payload as the next message of the stream.
+         */
+        Block deflate(IByteArray const &payload);
+
+    private:
+        DENG2_PRIVATE(d)
+    };
+
+    /**
+     * Message encoded in the wire format: the message header followed by the
+     * compressed payload. Encoding a message once and sending it to several
+     * sockets avoids compressing the same payload separately for each
+     * recipient.
+     */
+    class DENG2_PUBLIC EncodedMessage
+    {
+    public:
+        /**
+         * Encodes a message.
+         *
+         * @param packet  Payload of the message.
+         * @param stream  Compression stream of the connection the message is
+         *                sent over. If @c NULL, the message can be sent over
+         *                any socket.
+         */
+        EncodedMessage(IByteArray const &packet, DeflateStream *stream = 0);
+
+        /// Header and payload as they will be written to the socket.
+        Block const &bytes() const { return _bytes; }
+
+    private:
+        Block _bytes;
+    };
+
+    /**
+     * Receiving end of the wire format. The bytes received from a connection
+     * are given to the decoder as they arrive, in any size pieces, and the
+     * payloads of the complete messages are then decoded one at a time. The
+     * decoder keeps the decompression state of the connection's deflate
+     * stream, so all bytes of one connection must go to the same decoder.
+     */
+    class DENG2_PUBLIC MessageDecoder
+    {
+    public:
+        MessageDecoder();
+
+        /**
+         * Appends received bytes to the ones waiting to be decoded.
+         */
+        void receive(IByteArray const &bytes);
+
+        /**
+         * Decodes the next message, if all of it has been received.
+         *
+         * @param payload  The decompressed payload of the message is written here.
+         *
+         * @return @c true, if a message was decoded; @c false if more bytes
+         * need to be received first.
+         */
+        bool decode(Block &payload);
+
+    private:
+        DENG2_PRIVATE(d)
+    };
+
 public:
     Socket();
 
@@ -142,6 +226,29 @@ public:
      */
     Socket &operator << (IByteArray const &data);
 
+    /**
+     * Sends a previously encoded message over the socket. The same message
+     * can be sent over any number of sockets.
+     *
+     * @param message  Encoded message. Must not have been encoded using a
+     *                 compression stream.
+     */
+    void send(EncodedMessage const &message);
+
+    /**
+     * Enables or disables compressing the sent messages as one continuous
+     * deflate stream. This should only be enabled if the peer is known to
+     * support stream-compressed messages. Disabled by default.
+     *
+     * Broadcast messages sent with send(EncodedMessage const &) are not part
+     * of the stream.
+     *
+     * @param enabled  @c true to enable stream compression.
+     */
+    void setStreamCompression(bool enabled);
+
+    bool isStreamCompressionEnabled() const;
+
     /**
      * Returns the next received message. If nothing has been received,
      * returns @c NULL.
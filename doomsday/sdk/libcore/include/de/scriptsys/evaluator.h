@@ -25,6 +25,7 @@
 
 #include <vector>
 #include <list>
+#include <QList>
 
 namespace de {
 
@@ -45,7 +46,8 @@ public:
     /// Result is of wrong type. @ingroup errors
     DENG2_ERROR(ResultTypeError);
 
-    typedef std::list<Record *> Namespaces;
+    /// Namespaces for identifier lookup (implicitly shared; copying is cheap).
+    typedef QList<Record *> Namespaces;
 
 public:
     Evaluator(Context &owner);
@@ -28,6 +28,7 @@
 #include "../Variable"
 
 #include <list>
+#include <QList>
 
 namespace de {
 
@@ -63,7 +64,8 @@ public:
                      *   script or has been terminated. */
     };
 
-    typedef std::list<Record *> Namespaces;
+    /// Namespaces for identifier lookup (implicitly shared; copying is cheap).
+    typedef QList<Record *> Namespaces;
 
 public:
     /**
@@ -19,9 +19,9 @@
 #include "de/TaskPool"
 #include "de/Task"
 #include "de/Guard"
+#include "de/FlatHashSet"
 
 #include <QThreadPool>
-#include <QSet>
 #include <de/Lockable>
 #include <de/Waitable>
 
@@ -32,7 +32,7 @@ DENG2_PIMPL(TaskPool), public Lockable, public Waitable, public TaskPool::IPool
     bool deleteWhenDone { false }; ///< Private instance will be deleted when pool is empty.
 
     // Set of running tasks.
-    typedef QSet<Task *> Tasks;
+    typedef FlatHashSet<Task *> Tasks;
     Tasks tasks;
 
     Instance(Public *i) : Base(i)
@@ -238,8 +238,19 @@ DENG2_PIMPL(App)
 
         fs.makeFolder("/packs").attach(new PackageFeed(packageLoader));
 
-        // Populate the file system.
+        // Populate the file system. Files that were already interpreted during
+        // a previous run and have not changed since can be populated faster.
+        NativePath const dirIndexPath = self.nativeHomePath() / "cache" / "nativedirs.index";
+        fs.nativeDirectoryIndex().load(dirIndexPath);
         fs.refresh();
+        try
+        {
+            fs.nativeDirectoryIndex().save(dirIndexPath);
+        }
+        catch(Error const &er)
+        {
+            LOG_RES_WARNING("Failed to save the native directory index: %s") << er.asText();
+        }
 
         packageLoader.audienceForActivity() += this;
     }
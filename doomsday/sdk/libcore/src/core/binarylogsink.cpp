@@ -0,0 +1,185 @@
+/** @file binarylogsink.cpp  Log sink that writes entries in binary form.
+ *
+ * @authors Copyright © 2015 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * LGPL: http://www.gnu.org/licenses/lgpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details. You should have received a copy of
+ * the GNU Lesser General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#include "de/BinaryLogSink"
+#include "de/Block"
+#include "de/Reader"
+#include "de/Writer"
+
+namespace de {
+
+BinaryLogSink::Index::Index()
+    : previous(0)
+    , blockStart(0)
+    , entryCount(0)
+    , userContext(0)
+    , devContext(0)
+    , highestLevel(0)
+{}
+
+void BinaryLogSink::Index::add(LogEntry const &entry)
+{
+    duint32 const md = entry.metadata();
+    if(md & LogEntry::Dev)
+    {
+        devContext |= md & LogEntry::DomainMask;
+    }
+    else
+    {
+        userContext |= md & LogEntry::DomainMask;
+    }
+    highestLevel = de::max(highestLevel, dbyte(md & LogEntry::LevelMask));
+
+    if(!entryCount) first = entry.when();
+    last = entry.when();
+    entryCount++;
+}
+
+bool BinaryLogSink::Index::mayContain(LogEntry::Level minLevel, duint32 domains,
+                                      bool allowDev) const
+{
+    if(!entryCount || highestLevel < minLevel) return false;
+
+    duint32 const mask = (domains? domains : duint32(LogEntry::DomainMask));
+    return (userContext & mask) || (allowDev && (devContext & mask));
+}
+
+void BinaryLogSink::Index::operator >> (Writer &to) const
+{
+    to << previous
+       << blockStart
+       << entryCount
+       << userContext
+       << devContext
+       << highestLevel
+       << first
+       << last;
+}
+
+void BinaryLogSink::Index::operator << (Reader &from)
+{
+    from >> previous
+         >> blockStart
+         >> entryCount
+         >> userContext
+         >> devContext
+         >> highestLevel
+         >> first
+         >> last;
+}
+
+DENG2_PIMPL_NOREF(BinaryLogSink)
+{
+    File &file;
+    Block pending;          ///< Records not yet written to the file.
+    duint64 writtenSize;    ///< Amount of data written to the file so far.
+    duint64 lastIndexAt;    ///< Offset of the latest Index record.
+    Index block;            ///< Summary of the current block of entries.
+
+    Instance(File &outputFile)
+        : file(outputFile)
+        , writtenSize(outputFile.size())
+        , lastIndexAt(0)
+    {
+        if(!writtenSize)
+        {
+            Writer writer(pending);
+            writer << duint32(MAGIC) << duint16(FORMAT_VERSION);
+            writer.withHeader();
+        }
+        block.blockStart = offset();
+    }
+
+    /// Offset at which the next record will be located in the file.
+    duint64 offset() const
+    {
+        return writtenSize + pending.size();
+    }
+
+    void writeRecord(RecordType type, Block const &payload)
+    {
+        // The size of the payload is included.
+        Writer(pending, pending.size()) << dbyte(type) << payload;
+    }
+
+    void writeIndex()
+    {
+        duint64 const at = offset();
+
+        block.previous = lastIndexAt;
+        Block payload;
+        Writer(payload) << block;
+        writeRecord(IndexRecord, payload);
+
+        lastIndexAt = at;
+        block = Index();
+        block.blockStart = offset();
+    }
+
+    void writeToFile()
+    {
+        if(pending.isEmpty()) return;
+
+        file << pending;
+        writtenSize += pending.size();
+        pending.clear();
+    }
+};
+
+BinaryLogSink::BinaryLogSink(File &outputFile)
+    : d(new Instance(outputFile))
+{}
+
+BinaryLogSink::~BinaryLogSink()
+{
+    if(d->block.entryCount)
+    {
+        d->writeIndex();
+    }
+    flush();
+}
+
+LogSink &BinaryLogSink::operator << (LogEntry const &entry)
+{
+    Block payload;
+    Writer(payload) << entry;
+    d->writeRecord(EntryRecord, payload);
+
+    d->block.add(entry);
+    if(d->block.entryCount >= duint32(INDEX_INTERVAL))
+    {
+        d->writeIndex();
+    }
+    return *this;
+}
+
+LogSink &BinaryLogSink::operator << (String const &plainText)
+{
+    Block payload;
+    Writer(payload) << plainText;
+    d->writeRecord(PlainTextRecord, payload);
+    return *this;
+}
+
+void BinaryLogSink::flush()
+{
+    d->writeToFile();
+    d->file.flush();
+}
+
+} // namespace de
@@ -277,7 +277,7 @@ void LogEntry::Arg::returnToPool(Arg *arg)
     argPool.put(arg);
 }
 
-LogEntry::LogEntry() : _metadata(0), _sectionDepth(0), _disabled(true)
+LogEntry::LogEntry() : _metadata(0), _sectionDepth(0), _disabled(true), _nextPending(0)
 {}
 
 LogEntry::LogEntry(duint32 metadata, String const &section, int sectionDepth, String const &format, Args args)
@@ -287,6 +287,7 @@ LogEntry::LogEntry(duint32 metadata, String const &section, int sectionDepth, St
     , _format(format)
     , _disabled(false)
     , _args(args)
+    , _nextPending(0)
 {
     if(!LogBuffer::get().isEnabled(metadata))
     {
@@ -304,6 +305,7 @@ LogEntry::LogEntry(LogEntry const &other, Flags extraFlags)
     , _format(other._format)
     , _defaultFlags(other._defaultFlags | extraFlags)
     , _disabled(other._disabled)
+    , _nextPending(0)
 {
     DENG2_FOR_EACH_CONST(Args, i, other._args)
     {
@@ -728,8 +730,27 @@ void Log::disposeThreadLog()
 }
 
 LogEntryStager::LogEntryStager(duint32 metadata, String const &format)
-    : _metadata(metadata)
 {
+    begin(metadata);
+    if(!_disabled)
+    {
+        _format = format;
+    }
+}
+
+LogEntryStager::LogEntryStager(duint32 metadata, char const *format)
+{
+    begin(metadata);
+    if(!_disabled)
+    {
+        _format = format;
+    }
+}
+
+void LogEntryStager::begin(duint32 metadata)
+{
+    _metadata = metadata;
+
     // Automatically set the Generic domain.
     if(!(_metadata & LogEntry::DomainMask))
     {
@@ -741,8 +762,6 @@ LogEntryStager::LogEntryStager(duint32 metadata, String const &format)
 
     if(!_disabled)
     {
-        _format = format;
-
         LOG().setCurrentEntryMetadata(_metadata);
     }
 }
@@ -21,6 +21,7 @@
 #include "de/LogSink"
 #include "de/SimpleLogFilter"
 #include "de/FileLogSink"
+#include "de/BinaryLogSink"
 #include "de/DebugLogSink"
 #include "de/TextStreamLogSink"
 #include "de/Writer"
@@ -31,27 +32,114 @@
 #include <stdio.h>
 #include <QTextStream>
 #include <QCoreApplication>
+#include <QAtomicInt>
+#include <QAtomicPointer>
 #include <QList>
+#include <QMutex>
 #include <QSet>
+#include <QThread>
 #include <QTimer>
+#include <QWaitCondition>
 #include <QDebug>
+#include <atomic>
 
 namespace de {
 
 TimeDelta const FLUSH_INTERVAL = .2; // seconds
 
-DENG2_PIMPL_NOREF(LogBuffer)
+/// Number of queued entries that wakes up the flush thread ahead of time.
+static dint const FLUSH_THREAD_WAKE_COUNT = 256;
+
+DENG2_PIMPL(LogBuffer)
 {
     typedef QList<LogEntry *> EntryList;
     typedef QSet<LogSink *> Sinks;
 
+    /**
+     * Group of sinks that are flushed together, with the entries that have not
+     * yet been flushed to them. The lock serializes flushing of the group.
+     *
+     * When several locks are needed, they are taken in this order: addedOutputs,
+     * ownOutputs, the buffer itself.
+     */
+    struct Outputs : public Lockable
+    {
+        Sinks sinks;
+        EntryList toBeFlushed;
+    };
+
+    /**
+     * Flushes the buffer's own outputs (standard output/error and the log file)
+     * in the background, so that entry formatting and file I/O never stall the
+     * threads that are producing entries.
+     */
+    class FlushThread : public QThread
+    {
+    public:
+        FlushThread(Instance &inst)
+            : _inst(inst)
+            , _interval(FLUSH_INTERVAL)
+            , _stopping(false)
+        {}
+
+        void setInterval(TimeDelta const &interval)
+        {
+            QMutexLocker locker(&_mutex);
+            _interval = interval;
+        }
+
+        void wake()
+        {
+            _wakeUp.wakeOne();
+        }
+
+        void stop()
+        {
+            {
+                QMutexLocker locker(&_mutex);
+                _stopping = true;
+                _wakeUp.wakeOne();
+            }
+            wait();
+            _stopping = false;
+        }
+
+        void run()
+        {
+            QMutexLocker locker(&_mutex);
+            while(!_stopping)
+            {
+                _wakeUp.wait(&_mutex, (unsigned long) _interval.asMilliSeconds());
+                if(_stopping) break;
+
+                locker.unlock();
+                _inst.flushOwnOutputs();
+                locker.relock();
+            }
+            locker.unlock();
+
+            // Flush whatever remains before the thread ends.
+            _inst.flushOwnOutputs();
+
+            // Entries logged by the sinks were collected in this thread's log.
+            Log::disposeThreadLog();
+        }
+
+    private:
+        Instance &_inst;
+        QMutex _mutex;
+        QWaitCondition _wakeUp;
+        TimeDelta _interval;
+        bool _stopping;
+    };
+
     SimpleLogFilter defaultFilter;
     IFilter const *entryFilter;
     dint maxEntryCount;
     bool useStandardOutput;
-    bool flushingEnabled;
+    std::atomic<bool> flushingEnabled; ///< Read by the flush thread.
     File *outputFile;
-    FileLogSink *fileLogSink;
+    LogSink *fileLogSink;
 #ifndef WIN32
     TextStreamLogSink outSink;
     TextStreamLogSink errSink;
@@ -59,14 +147,20 @@ DENG2_PIMPL_NOREF(LogBuffer)
     DebugLogSink outSink;
     DebugLogSink errSink;
 #endif
+    QAtomicPointer<LogEntry> pending; ///< Most recently added first (linked via LogEntry).
+    QAtomicInt pendingCount;
     EntryList entries;
-    EntryList toBeFlushed;
+    Outputs ownOutputs;   ///< Standard output/error and the log file.
+    Outputs addedOutputs; ///< Sinks added with addSink().
     Time lastFlushedAt;
     QTimer *autoFlushTimer;
-    Sinks sinks;
+    FlushThread flushThread;
+    bool flushingOwnOutputs;   ///< Sinks are being written to (buffer locked when accessed).
+    bool flushingAddedOutputs;
 
-    Instance(duint maxEntryCount)
-        : entryFilter(&defaultFilter)
+    Instance(Public *i, duint maxEntryCount)
+        : Base(i)
+        , entryFilter(&defaultFilter)
         , maxEntryCount(maxEntryCount)
         , useStandardOutput(true)
         , flushingEnabled(true)
@@ -80,20 +174,25 @@ DENG2_PIMPL_NOREF(LogBuffer)
         , outSink(QtDebugMsg)
         , errSink(QtWarningMsg)
 #endif
+        , pending(0)
         , lastFlushedAt(Time::invalidTime())
         , autoFlushTimer(0)
+        , flushThread(*this)
+        , flushingOwnOutputs(false)
+        , flushingAddedOutputs(false)
     {
         // Standard output enabled by default.
         outSink.setMode(LogSink::OnlyNormalEntries);
         errSink.setMode(LogSink::OnlyWarningEntries);
 
-        sinks.insert(&outSink);
-        sinks.insert(&errSink);
+        ownOutputs.sinks.insert(&outSink);
+        ownOutputs.sinks.insert(&errSink);
     }
 
     ~Instance()
     {
         if(autoFlushTimer) autoFlushTimer->stop();
+        flushThread.stop();
         delete fileLogSink;
     }
 
@@ -107,10 +206,15 @@ DENG2_PIMPL_NOREF(LogBuffer)
                 // Every now and then the buffer will be flushed.
                 autoFlushTimer->start(int(FLUSH_INTERVAL.asMilliSeconds()));
             }
+            if(!flushThread.isRunning())
+            {
+                flushThread.start();
+            }
         }
         else
         {
             autoFlushTimer->stop();
+            flushThread.stop();
         }
     }
 
@@ -118,25 +222,200 @@ DENG2_PIMPL_NOREF(LogBuffer)
     {
         if(fileLogSink)
         {
-            sinks.remove(fileLogSink);
+            ownOutputs.sinks.remove(fileLogSink);
             delete fileLogSink;
             fileLogSink = 0;
         }
     }
+
+    inline LogEntry *pendingHead() const
+    {
+#ifdef DENG2_QT_5_0_OR_NEWER
+        return pending.loadAcquire();
+#else
+        return pending;
+#endif
+    }
+
+    /**
+     * Queues a new entry. This does not block, so entries can be added from any
+     * thread without waiting for an ongoing flush to finish.
+     *
+     * @return Number of entries that were already in the queue.
+     */
+    dint enqueue(LogEntry *entry)
+    {
+        // The entry itself is the queue node, so queuing allocates nothing.
+        do
+        {
+            entry->_nextPending = pendingHead();
+        }
+        while(!pending.testAndSetRelease(entry->_nextPending, entry));
+
+        return pendingCount.fetchAndAddRelaxed(1);
+    }
+
+    /**
+     * Moves the queued entries into the buffer, in the order they were added.
+     * The buffer must be locked.
+     */
+    void takePending()
+    {
+        LogEntry *entry = pending.fetchAndStoreAcquire(0);
+        if(!entry) return;
+
+        pendingCount.fetchAndStoreRelaxed(0);
+
+        // The queue is in reverse order.
+        EntryList added;
+        while(entry)
+        {
+            added.prepend(entry);
+            LogEntry *next = entry->_nextPending;
+            entry->_nextPending = 0;
+            entry = next;
+        }
+
+        entries                  += added;
+        ownOutputs.toBeFlushed   += added;
+        addedOutputs.toBeFlushed += added;
+    }
+
+    /**
+     * Deletes the oldest entries when there are too many of them. Entries still
+     * waiting to be flushed are kept. The buffer must be locked.
+     */
+    void prune()
+    {
+        dint const keep = de::max(maxEntryCount, de::max(ownOutputs.toBeFlushed.size(),
+                                                         addedOutputs.toBeFlushed.size()));
+        while(entries.size() > keep)
+        {
+            delete entries.takeFirst();
+        }
+    }
+
+    static void writeToSinks(EntryList const &list, Sinks const &sinks)
+    {
+        if(list.isEmpty()) return;
+
+        DENG2_FOR_EACH_CONST(EntryList, i, list)
+        {
+            DENG2_GUARD_FOR(**i, guardingCurrentLogEntry);
+            foreach(LogSink *sink, sinks)
+            {
+                // The entry is formatted only if the sink takes it.
+                if(sink->willAccept(**i))
+                {
+                    try
+                    {
+                        *sink << **i;
+                    }
+                    catch(Error const &error)
+                    {
+                        *sink << String("Exception during log flush:\n") +
+                                        error.what() + "\n(the entry format is: '" +
+                                        (*i)->format() + "')";
+                    }
+                }
+            }
+        }
+
+        // Make sure everything really gets written now.
+        foreach(LogSink *sink, sinks) sink->flush();
+    }
+
+    /**
+     * Flushes entries to standard output/error and the log file. The buffer is
+     * not kept locked while entries are being formatted and written.
+     */
+    void flushOwnOutputs()
+    {
+        if(!flushingEnabled) return;
+
+        DENG2_GUARD(ownOutputs);
+
+        EntryList list;
+        {
+            DENG2_GUARD_FOR(self, G);
+            takePending();
+            // The entries stay in toBeFlushed so they won't be pruned meanwhile.
+            list = ownOutputs.toBeFlushed;
+            flushingOwnOutputs = true;
+        }
+
+        writeToSinks(list, ownOutputs.sinks);
+
+        DENG2_GUARD_FOR(self, G);
+        ownOutputs.toBeFlushed.erase(ownOutputs.toBeFlushed.begin(),
+                                     ownOutputs.toBeFlushed.begin() + list.size());
+        lastFlushedAt = Time();
+        prune();
+        flushingOwnOutputs = false;
+    }
+
+    /**
+     * Determines whether entries added now should be left for a later flush
+     * because sinks are being written to. A sink that logs something must not
+     * cause a nested flush, as that would take the output locks out of order.
+     * The buffer must be locked.
+     */
+    bool isWritingToSinks() const
+    {
+        return flushingOwnOutputs || flushingAddedOutputs;
+    }
+
+    /**
+     * Flushes entries to the sinks added with addSink(). These may have thread
+     * affinity (GUI, network), so this is done in the thread calling LogBuffer::flush()
+     * or running the auto-flush timer. The outputs remain locked so that the sinks
+     * can't be removed during the flush, but the buffer is not.
+     */
+    void flushAddedOutputs()
+    {
+        if(!flushingEnabled) return;
+
+        DENG2_GUARD(addedOutputs);
+
+        EntryList list;
+        Sinks sinks;
+        {
+            DENG2_GUARD_FOR(self, G);
+            // A sink may flush the buffer while it is being flushed.
+            if(flushingAddedOutputs) return;
+
+            takePending();
+            // The entries stay in toBeFlushed so they won't be pruned meanwhile.
+            list  = addedOutputs.toBeFlushed;
+            sinks = addedOutputs.sinks;
+            flushingAddedOutputs = true;
+        }
+
+        writeToSinks(list, sinks);
+
+        DENG2_GUARD_FOR(self, G);
+        addedOutputs.toBeFlushed.erase(addedOutputs.toBeFlushed.begin(),
+                                       addedOutputs.toBeFlushed.begin() + list.size());
+        lastFlushedAt = Time();
+        prune();
+        flushingAddedOutputs = false;
+    }
 };
 
 LogBuffer *LogBuffer::_appBuffer = 0;
 
 LogBuffer::LogBuffer(duint maxEntryCount) 
-    : d(new Instance(maxEntryCount))
+    : d(new Instance(this, maxEntryCount))
 {
     d->autoFlushTimer = new QTimer(this);
-    connect(d->autoFlushTimer, SIGNAL(timeout()), this, SLOT(flush()));
+    connect(d->autoFlushTimer, SIGNAL(timeout()), this, SLOT(autoFlush()));
 }
 
 LogBuffer::~LogBuffer()
 {
-    DENG2_GUARD(this);
+    // The flush thread must be stopped before the outputs go away.
+    d->autoFlushTimer->stop();
+    d->flushThread.stop();
 
     setOutputFile("");
     clear();
@@ -146,11 +425,17 @@ LogBuffer::~LogBuffer()
 
 void LogBuffer::clear()
 {
-    DENG2_GUARD(this);
-
     // Flush first, we don't want to miss any messages.
     flush();
 
+    DENG2_GUARD_FOR(d->addedOutputs, guardingAddedOutputs);
+    DENG2_GUARD_FOR(d->ownOutputs, guardingOutputs);
+    DENG2_GUARD(this);
+
+    d->takePending();
+    d->ownOutputs.toBeFlushed.clear();
+    d->addedOutputs.toBeFlushed.clear();
+
     DENG2_FOR_EACH(Instance::EntryList, i, d->entries)
     {
         delete *i;
@@ -161,12 +446,14 @@ void LogBuffer::clear()
 dsize LogBuffer::size() const
 {
     DENG2_GUARD(this);
+    d->takePending();
     return d->entries.size();
 }
 
 void LogBuffer::latestEntries(Entries &entries, int count) const
 {
     DENG2_GUARD(this);
+    d->takePending();
     entries.clear();
     for(int i = d->entries.size() - 1; i >= 0; --i)
     {
@@ -203,22 +490,35 @@ void LogBuffer::setMaxEntryCount(duint maxEntryCount)
 }
 
 void LogBuffer::add(LogEntry *entry)
-{       
-    DENG2_GUARD(this);
+{
+    dint const queued = d->enqueue(entry);
 
-    // We will not flush the new entry as it likely has not yet been given
-    // all its arguments.
-    if(d->lastFlushedAt.isValid() && d->lastFlushedAt.since() > FLUSH_INTERVAL)
+    if(d->flushThread.isRunning())
     {
-        flush();
+        // Don't let the queue grow too long before the next flush.
+        if(queued + 1 == FLUSH_THREAD_WAKE_COUNT)
+        {
+            d->flushThread.wake();
+        }
+        return;
     }
 
-    d->entries.push_back(entry);
-    d->toBeFlushed.push_back(entry);
+    // Without automatic flushing, entries are flushed as they are being added.
+    bool flushNow;
+    {
+        DENG2_GUARD(this);
+        flushNow = (!d->isWritingToSinks() &&
+                    d->lastFlushedAt.isValid() && d->lastFlushedAt.since() > FLUSH_INTERVAL);
+    }
+    if(flushNow)
+    {
+        flush();
+    }
 }
 
 void LogBuffer::enableStandardOutput(bool yes)
 {
+    DENG2_GUARD_FOR(d->ownOutputs, guardingOutputs);
     DENG2_GUARD(this);
 
     d->useStandardOutput = yes;
@@ -238,10 +538,14 @@ void LogBuffer::setAutoFlushInterval(TimeDelta const &interval)
     enableFlushing();
 
     d->autoFlushTimer->setInterval(interval.asMilliSeconds());
+    d->flushThread.setInterval(interval);
 }
 
 void LogBuffer::setOutputFile(String const &path, OutputChangeBehavior behavior)
 {
+    // Lock the outputs first so that a flush won't be in progress.
+    DENG2_GUARD_FOR(d->addedOutputs, guardingAddedOutputs);
+    DENG2_GUARD_FOR(d->ownOutputs, guardingOutputs);
     DENG2_GUARD(this);
 
     if(behavior == FlushFirstToOldOutputs)
@@ -262,9 +566,16 @@ void LogBuffer::setOutputFile(String const &path, OutputChangeBehavior behavior)
         d->outputFile = &App::rootFolder().replaceFile(path);
         d->outputFile->audienceForDeletion() += this;
 
-        // Add a sink for the file.
-        d->fileLogSink = new FileLogSink(*d->outputFile);
-        d->sinks.insert(d->fileLogSink);
+        // Add a sink for the file. Binary logs are formatted offline.
+        if(!path.fileNameExtension().compareWithoutCase(".dlog"))
+        {
+            d->fileLogSink = new BinaryLogSink(*d->outputFile);
+        }
+        else
+        {
+            d->fileLogSink = new FileLogSink(*d->outputFile);
+        }
+        d->ownOutputs.sinks.insert(d->fileLogSink);
     }
 }
 
@@ -276,62 +587,31 @@ String LogBuffer::outputFile() const
 
 void LogBuffer::addSink(LogSink &sink)
 {
+    DENG2_GUARD_FOR(d->addedOutputs, guardingAddedOutputs);
     DENG2_GUARD(this);
 
-    d->sinks.insert(&sink);
+    d->addedOutputs.sinks.insert(&sink);
 }
 
 void LogBuffer::removeSink(LogSink &sink)
 {
+    // Waits until the sink is no longer being flushed.
+    DENG2_GUARD_FOR(d->addedOutputs, guardingAddedOutputs);
     DENG2_GUARD(this);
 
-    d->sinks.remove(&sink);
+    d->addedOutputs.sinks.remove(&sink);
 }
 
 void LogBuffer::flush()
 {
-    if(!d->flushingEnabled) return;
-
-    DENG2_GUARD(this);
-
-    if(!d->toBeFlushed.isEmpty())
-    {
-        DENG2_FOR_EACH(Instance::EntryList, i, d->toBeFlushed)
-        {
-            DENG2_GUARD_FOR(**i, guardingCurrentLogEntry);
-            foreach(LogSink *sink, d->sinks)
-            {
-                if(sink->willAccept(**i))
-                {
-                    try
-                    {
-                        *sink << **i;
-                    }
-                    catch(Error const &error)
-                    {
-                        *sink << String("Exception during log flush:\n") +
-                                        error.what() + "\n(the entry format is: '" +
-                                        (*i)->format() + "')";
-                    }
-                }
-            }
-        }
-
-        d->toBeFlushed.clear();
-
-        // Make sure everything really gets written now.
-        foreach(LogSink *sink, d->sinks) sink->flush();
-    }
-
-    d->lastFlushedAt = Time();
+    d->flushOwnOutputs();
+    d->flushAddedOutputs();
+}
 
-    // Too many entries? Now they can be destroyed since we have flushed everything.
-    while(d->entries.size() > d->maxEntryCount)
-    {
-        LogEntry *old = d->entries.front();
-        d->entries.pop_front();
-        delete old;
-    }
+void LogBuffer::autoFlush()
+{
+    // Standard output and the log file are flushed by the flush thread.
+    d->flushAddedOutputs();
 }
 
 void LogBuffer::fileBeingDeleted(File const &file)
@@ -339,6 +619,9 @@ void LogBuffer::fileBeingDeleted(File const &file)
     DENG2_ASSERT(d->outputFile == &file);
     DENG2_UNUSED(file);
 
+    DENG2_GUARD_FOR(d->addedOutputs, guardingAddedOutputs);
+    DENG2_GUARD_FOR(d->ownOutputs, guardingOutputs);
+
     flush();
     d->disposeFileLogSink();
     d->outputFile = 0;   
@@ -0,0 +1,782 @@
+/** @file audiomixer.cpp  Software mixer for sound effects.
+ *
+ * @authors Copyright © 2015 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * LGPL: http://www.gnu.org/licenses/lgpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details. You should have received a copy of
+ * the GNU Lesser General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#include "de/data/audiomixer.h"
+#include "de/Guard"
+#include "de/Lockable"
+#include "de/Waitable"
+#include "de/math.h"
+
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define DENG2_AUDIOMIXER_SSE2
+#  include <emmintrin.h>
+#endif
+
+namespace de {
+
+/// Changes in gain are spread over this many frames.
+static int const RAMP_FRAMES = 128;
+
+/// Voices are mixed this many frames at a time.
+static int const BLOCK_FRAMES = 512;
+
+static int const DEFAULT_VOICES_PER_THREAD = 64;
+
+namespace internal {
+
+/**
+ * Adds a mono signal to an interleaved stereo signal, with separate (linearly
+ * changing) gains for the left and right channels.
+ */
+typedef void (*MixFunc)(float *out, float const *mono, int count,
+                        float left, float right, float leftStep, float rightStep);
+
+static void mixScalar(float *out, float const *mono, int count,
+                      float left, float right, float leftStep, float rightStep)
+{
+    for(int i = 0; i < count; ++i)
+    {
+        out[2*i]     += mono[i] * (left  + leftStep  * i);
+        out[2*i + 1] += mono[i] * (right + rightStep * i);
+    }
+}
+
+static void addScalar(float *out, float const *in, int count)
+{
+    for(int i = 0; i < count; ++i)
+    {
+        out[i] += in[i];
+    }
+}
+
+#ifdef DENG2_AUDIOMIXER_SSE2
+static void mixSSE2(float *out, float const *mono, int count,
+                    float left, float right, float leftStep, float rightStep)
+{
+    __m128 const step = _mm_set_ps(3, 2, 1, 0);
+    __m128 gainL = _mm_add_ps(_mm_set1_ps(left),  _mm_mul_ps(step, _mm_set1_ps(leftStep)));
+    __m128 gainR = _mm_add_ps(_mm_set1_ps(right), _mm_mul_ps(step, _mm_set1_ps(rightStep)));
+    __m128 const advL = _mm_set1_ps(4 * leftStep);
+    __m128 const advR = _mm_set1_ps(4 * rightStep);
+
+    int i = 0;
+    for(; i + 4 <= count; i += 4)
+    {
+        __m128 const m = _mm_loadu_ps(mono + i);
+        __m128 const l = _mm_mul_ps(m, gainL);
+        __m128 const r = _mm_mul_ps(m, gainR);
+
+        // Interleave: l0 r0 l1 r1, l2 r2 l3 r3.
+        float *dest = out + 2*i;
+        _mm_storeu_ps(dest,     _mm_add_ps(_mm_loadu_ps(dest),     _mm_unpacklo_ps(l, r)));
+        _mm_storeu_ps(dest + 4, _mm_add_ps(_mm_loadu_ps(dest + 4), _mm_unpackhi_ps(l, r)));
+
+        gainL = _mm_add_ps(gainL, advL);
+        gainR = _mm_add_ps(gainR, advR);
+    }
+    mixScalar(out + 2*i, mono + i, count - i,
+              left + leftStep * i, right + rightStep * i, leftStep, rightStep);
+}
+
+static void addSSE2(float *out, float const *in, int count)
+{
+    int i = 0;
+    for(; i + 4 <= count; i += 4)
+    {
+        _mm_storeu_ps(out + i, _mm_add_ps(_mm_loadu_ps(out + i), _mm_loadu_ps(in + i)));
+    }
+    addScalar(out + i, in + i, count - i);
+}
+
+static MixFunc const mixKernel = mixSSE2;
+static void (*const addKernel)(float *, float const *, int) = addSSE2;
+static char const *const kernelIdentifier = "SSE2";
+#else
+static MixFunc const mixKernel = mixScalar;
+static void (*const addKernel)(float *, float const *, int) = addScalar;
+static char const *const kernelIdentifier = "scalar";
+#endif
+
+/**
+ * Distance attenuation: none closer than @a minDist, silence beyond
+ * @a maxDist. This is the same curve that is used for 2D sounds.
+ */
+static float attenuation(float dist, float minDist, float maxDist)
+{
+    if(dist <= minDist) return 1;
+    if(dist >= maxDist) return 0;
+
+    float const norm = (dist - minDist) / (maxDist - minDist);
+    return .125f / (.125f + norm) * (1 - norm);
+}
+
+/**
+ * Reverberator with parallel lowpass-feedback comb filters followed by
+ * allpass filters (Schroeder/Moorer). The delays differ slightly between the
+ * left and right outputs for a wider image.
+ */
+class Reverb
+{
+public:
+    Reverb(int sampleRate) : _volume(0), _space(-1), _feedback(0), _damping(0)
+    {
+        float const scale = sampleRate / 44100.f;
+        for(int side = 0; side < 2; ++side)
+        {
+            int const spread = side * STEREO_SPREAD;
+            for(int i = 0; i < NUM_COMBS; ++i)
+            {
+                _combs[side][i].init(int((COMB_TUNING[i] + spread) * scale));
+            }
+            for(int i = 0; i < NUM_ALLPASSES; ++i)
+            {
+                _allpasses[side][i].init(int((ALLPASS_TUNING[i] + spread) * scale));
+            }
+        }
+    }
+
+    void set(float volume, float space, float decay, float damping)
+    {
+        if(volume <= 0 && _volume > 0)
+        {
+            // The tail would resume if reverb was enabled again.
+            clear();
+        }
+
+        _volume   = de::clamp(0.f, volume, 1.f);
+        _feedback = .7f + .28f * de::clamp(0.f, decay, 1.f);
+        _damping  = .4f * de::clamp(0.f, damping, 1.f);
+
+        float const space01 = de::clamp(0.f, space, 1.f);
+        if(!de::fequal(space01, _space))
+        {
+            _space = space01;
+            // Smaller spaces have shorter delays.
+            float const size = .4f + .6f * _space;
+            for(int side = 0; side < 2; ++side)
+            {
+                for(int i = 0; i < NUM_COMBS; ++i) _combs[side][i].setSize(size);
+            }
+        }
+    }
+
+    bool isEnabled() const
+    {
+        return _volume > 0;
+    }
+
+    void process(float *frames, dsize count)
+    {
+        if(!isEnabled()) return;
+
+        float const wet = _volume * WET_SCALE;
+        for(dsize i = 0; i < count; ++i)
+        {
+            float *frame = frames + 2*i;
+            float const input = (frame[0] + frame[1]) * INPUT_GAIN;
+            for(int side = 0; side < 2; ++side)
+            {
+                float out = 0;
+                for(int c = 0; c < NUM_COMBS; ++c)
+                {
+                    out += _combs[side][c].process(input, _feedback, _damping);
+                }
+                for(int a = 0; a < NUM_ALLPASSES; ++a)
+                {
+                    out = _allpasses[side][a].process(out);
+                }
+                frame[side] += out * wet;
+            }
+        }
+    }
+
+    void clear()
+    {
+        for(int side = 0; side < 2; ++side)
+        {
+            for(int i = 0; i < NUM_COMBS; ++i)     _combs[side][i].clear();
+            for(int i = 0; i < NUM_ALLPASSES; ++i) _allpasses[side][i].clear();
+        }
+    }
+
+private:
+    enum { NUM_COMBS = 4, NUM_ALLPASSES = 2, STEREO_SPREAD = 23 };
+
+    /// Delays (in samples at 44100 Hz) of the largest space.
+    static int const COMB_TUNING[NUM_COMBS];
+    static int const ALLPASS_TUNING[NUM_ALLPASSES];
+    static float const INPUT_GAIN;
+    static float const WET_SCALE;
+
+    struct Comb
+    {
+        QVector<float> buffer;
+        int length;
+        int pos;
+        float filtered;
+
+        void init(int maxLength)
+        {
+            buffer.fill(0, de::max(1, maxLength));
+            length   = buffer.size();
+            pos      = 0;
+            filtered = 0;
+        }
+        void setSize(float size)
+        {
+            length = de::clamp(1, int(buffer.size() * size), buffer.size());
+            if(pos >= length) pos = 0;
+        }
+        void clear()
+        {
+            buffer.fill(0);
+            filtered = 0;
+        }
+        inline float process(float input, float feedback, float damping)
+        {
+            float const out = buffer[pos];
+            filtered = out * (1 - damping) + filtered * damping;
+            buffer[pos] = input + filtered * feedback;
+            if(++pos >= length) pos = 0;
+            return out;
+        }
+    };
+
+    struct Allpass
+    {
+        QVector<float> buffer;
+        int pos;
+
+        void init(int length)
+        {
+            buffer.fill(0, de::max(1, length));
+            pos = 0;
+        }
+        void clear()
+        {
+            buffer.fill(0);
+        }
+        inline float process(float input)
+        {
+            float const delayed = buffer[pos];
+            buffer[pos] = input + delayed * .5f;
+            if(++pos >= buffer.size()) pos = 0;
+            return delayed - input;
+        }
+    };
+
+    float _volume;
+    float _space;
+    float _feedback;
+    float _damping;
+    Comb _combs[2][NUM_COMBS];
+    Allpass _allpasses[2][NUM_ALLPASSES];
+};
+
+int const Reverb::COMB_TUNING[Reverb::NUM_COMBS]          = { 1116, 1277, 1422, 1557 };
+int const Reverb::ALLPASS_TUNING[Reverb::NUM_ALLPASSES]   = { 556, 441 };
+float const Reverb::INPUT_GAIN = .03f;
+float const Reverb::WET_SCALE  = 1.5f;
+
+} // namespace internal
+
+using namespace internal;
+
+DENG2_PIMPL_NOREF(AudioMixer), public Lockable
+{
+    struct Voice
+    {
+        bool used;
+        QVector<float> samples;
+        bool playing;
+        bool looping;
+        double pos;         ///< Position in the samples.
+        float volume;
+        float pitch;
+        float pan;
+        bool positional;
+        bool relative;
+        Vector3f origin;
+        float minDistance;
+        float maxDistance;
+
+        // Gains at the end of the previous render.
+        float left;
+        float right;
+        bool rampFromCurrent; ///< If false, the gains are not ramped.
+
+        Voice()
+            : used(false), playing(false), looping(false), pos(0)
+            , volume(1), pitch(1), pan(0)
+            , positional(false), relative(false)
+            , minDistance(0), maxDistance(1)
+            , left(0), right(0), rampFromCurrent(false)
+        {}
+    };
+
+    /// Mixes a group of voices in one of the mixer's threads.
+    class MixTask : public QRunnable
+    {
+    public:
+        MixTask(Instance *inst, int const *voices, int count, float *output, dsize frames)
+            : _inst(inst), _voices(voices), _count(count), _output(output), _frames(frames)
+        {}
+        void run()
+        {
+            std::memset(_output, 0, sizeof(float) * 2 * _frames);
+            _inst->mixVoices(_voices, _count, _output, _frames);
+            _inst->groupsDone.post();
+        }
+    private:
+        Instance *_inst;
+        int const *_voices;
+        int _count;
+        float *_output;
+        dsize _frames;
+    };
+
+    int sampleRate;
+    QVector<Voice> voices;
+    Vector3f listenerPos;
+    float listenerYaw;
+    int voicesPerThread;
+    Reverb reverb;
+
+    /**
+     * Threads used only for mixing. Output is often rendered in the audio
+     * device's callback, which must not wait for unrelated tasks in the
+     * shared thread pool.
+     */
+    QThreadPool threads;
+    Waitable groupsDone;                  ///< Posted when a group has been mixed.
+    QVector<int> active;                  ///< Voices being mixed.
+    QVector<QVector<float> > groupOutput; ///< Output of the mixing threads.
+    QVector<float> sinkBuffer;
+
+    Instance(int rate)
+        : sampleRate(de::max(1, rate))
+        , listenerYaw(0)
+        , voicesPerThread(DEFAULT_VOICES_PER_THREAD)
+        , reverb(sampleRate)
+    {
+        // The rendering thread mixes one group itself.
+        threads.setMaxThreadCount(de::max(1, QThread::idealThreadCount() - 1));
+
+        // Starting threads while rendering would be too slow.
+        threads.setExpiryTimeout(-1);
+    }
+
+    ~Instance()
+    {
+        threads.waitForDone();
+    }
+
+    Voice &voice(int id)
+    {
+        DENG2_ASSERT(id >= 0 && id < voices.size() && voices[id].used);
+        return voices[id];
+    }
+
+    Voice const &voice(int id) const
+    {
+        DENG2_ASSERT(id >= 0 && id < voices.size() && voices[id].used);
+        return voices[id];
+    }
+
+    void targetGains(Voice const &v, float &left, float &right) const
+    {
+        float gain = v.volume;
+        float pan  = v.pan;
+
+        if(v.positional)
+        {
+            // Direction of the voice in the listener's frame: +X is forward,
+            // +Y is to the left.
+            Vector3f delta = v.origin;
+            if(!v.relative)
+            {
+                delta -= listenerPos;
+                float const yaw = float(degreeToRadian(listenerYaw));
+                float const c = std::cos(yaw), s = std::sin(yaw);
+                delta = Vector3f(delta.x * c + delta.y * s, delta.y * c - delta.x * s, delta.z);
+            }
+
+            float const dist = float(delta.length());
+            gain *= attenuation(dist, v.minDistance, v.maxDistance);
+
+            pan = 0;
+            if(dist > .001f)
+            {
+                // Sounds above or below the listener are less to one side.
+                pan = -delta.y / dist;
+                if(delta.x < 0)
+                {
+                    // Dampen sounds coming from behind.
+                    gain *= (1 + de::abs(pan)) / 2;
+                }
+            }
+        }
+
+        // Constant power panning.
+        float const angle = float((de::clamp(-1.f, pan, 1.f) + 1) * PI / 4);
+        left  = gain * std::cos(angle);
+        right = gain * std::sin(angle);
+    }
+
+    /**
+     * Reads the next source samples of a voice, interpolating if the pitch
+     * is changed.
+     *
+     * @return Pointer to the samples: either the voice's own samples or
+     * @a scratch. Sets @a count to the number of samples available.
+     */
+    float const *readVoice(Voice &v, float *scratch, int &count)
+    {
+        int const size = v.samples.size();
+        float const *src = v.samples.constData();
+
+        if(de::fequal(v.pitch, 1.f) && v.pos == std::floor(v.pos))
+        {
+            // Samples can be used as is.
+            int const at = int(v.pos);
+            count = de::min(count, size - at);
+            v.pos += count;
+            return src + at;
+        }
+
+        int i = 0;
+        for(; i < count; ++i)
+        {
+            if(v.pos >= size)
+            {
+                if(!v.looping) break;
+                v.pos = std::fmod(v.pos, double(size));
+            }
+            int const at = int(v.pos);
+            float const frac = float(v.pos - at);
+            float const next = (at + 1 < size? src[at + 1] : v.looping? src[0] : 0);
+            scratch[i] = src[at] + (next - src[at]) * frac;
+            v.pos += v.pitch;
+        }
+        count = i;
+        return scratch;
+    }
+
+    void mixVoice(Voice &v, float *output, dsize frames)
+    {
+        float targetLeft, targetRight;
+        targetGains(v, targetLeft, targetRight);
+
+        int ramp = (v.rampFromCurrent? int(de::min(dsize(RAMP_FRAMES), frames)) : 0);
+        float const stepLeft  = (ramp? (targetLeft  - v.left)  / ramp : 0);
+        float const stepRight = (ramp? (targetRight - v.right) / ramp : 0);
+        if(!ramp)
+        {
+            v.left  = targetLeft;
+            v.right = targetRight;
+        }
+        v.rampFromCurrent = true;
+
+        float scratch[BLOCK_FRAMES];
+        dsize done = 0;
+        while(done < frames && v.playing)
+        {
+            int count = int(de::min(dsize(BLOCK_FRAMES), frames - done));
+            if(ramp) count = de::min(count, ramp);
+
+            float const *src = readVoice(v, scratch, count);
+            if(ramp)
+            {
+                mixKernel(output + 2*done, src, count, v.left, v.right, stepLeft, stepRight);
+                v.left  += stepLeft  * count;
+                v.right += stepRight * count;
+                ramp -= count;
+                if(!ramp)
+                {
+                    v.left  = targetLeft;
+                    v.right = targetRight;
+                }
+            }
+            else
+            {
+                mixKernel(output + 2*done, src, count, v.left, v.right, 0, 0);
+            }
+            done += count;
+
+            if(v.pos >= v.samples.size())
+            {
+                if(v.looping)
+                {
+                    v.pos = std::fmod(v.pos, double(v.samples.size()));
+                }
+                else
+                {
+                    v.playing = false;
+                }
+            }
+        }
+    }
+
+    void mixVoices(int const *ids, int count, float *output, dsize frames)
+    {
+        for(int i = 0; i < count; ++i)
+        {
+            mixVoice(voices[ids[i]], output, frames);
+        }
+    }
+
+    void render(float *output, dsize frames)
+    {
+        std::memset(output, 0, sizeof(float) * 2 * frames);
+
+        active.clear();
+        for(int i = 0; i < voices.size(); ++i)
+        {
+            Voice const &v = voices.at(i);
+            if(v.used && v.playing && !v.samples.isEmpty())
+            {
+                active.append(i);
+            }
+        }
+
+        int const perGroup = voicesPerThread;
+        int const groups = (active.size() + perGroup - 1) / perGroup;
+        if(groups > 1)
+        {
+            // The first group is mixed in this thread, others in the
+            // mixing threads.
+            if(groupOutput.size() < groups - 1) groupOutput.resize(groups - 1);
+            for(int g = 1; g < groups; ++g)
+            {
+                QVector<float> &buf = groupOutput[g - 1];
+                if(dsize(buf.size()) < 2 * frames) buf.resize(int(2 * frames));
+                threads.start(new MixTask(this, active.constData() + g * perGroup,
+                                          de::min(perGroup, active.size() - g * perGroup),
+                                          buf.data(), frames));
+            }
+            mixVoices(active.constData(), perGroup, output, frames);
+            for(int g = 1; g < groups; ++g)
+            {
+                groupsDone.wait();
+            }
+
+            for(int g = 1; g < groups; ++g)
+            {
+                addKernel(output, groupOutput.at(g - 1).constData(), int(2 * frames));
+            }
+        }
+        else
+        {
+            mixVoices(active.constData(), active.size(), output, frames);
+        }
+
+        reverb.process(output, frames);
+    }
+};
+
+void AudioMixer::MemorySink::consume(float const *frames, dsize count)
+{
+    int const oldSize = _samples.size();
+    _samples.resize(oldSize + int(2 * count));
+    std::memcpy(_samples.data() + oldSize, frames, sizeof(float) * 2 * count);
+}
+
+QVector<float> const &AudioMixer::MemorySink::samples() const
+{
+    return _samples;
+}
+
+dsize AudioMixer::MemorySink::frameCount() const
+{
+    return dsize(_samples.size() / 2);
+}
+
+void AudioMixer::MemorySink::clear()
+{
+    _samples.clear();
+}
+
+AudioMixer::AudioMixer(int sampleRate) : d(new Instance(sampleRate))
+{}
+
+int AudioMixer::sampleRate() const
+{
+    return d->sampleRate;
+}
+
+int AudioMixer::createVoice()
+{
+    DENG2_GUARD(d);
+
+    for(int i = 0; i < d->voices.size(); ++i)
+    {
+        if(!d->voices.at(i).used)
+        {
+            d->voices[i] = Instance::Voice();
+            d->voices[i].used = true;
+            return i;
+        }
+    }
+    d->voices.append(Instance::Voice());
+    d->voices.last().used = true;
+    return d->voices.size() - 1;
+}
+
+void AudioMixer::destroyVoice(int voice)
+{
+    DENG2_GUARD(d);
+    d->voice(voice) = Instance::Voice();
+}
+
+int AudioMixer::voiceCount() const
+{
+    DENG2_GUARD(d);
+
+    int count = 0;
+    foreach(Instance::Voice const &v, d->voices)
+    {
+        if(v.used) count++;
+    }
+    return count;
+}
+
+void AudioMixer::setSamples(int voice, QVector<float> const &samples)
+{
+    DENG2_GUARD(d);
+
+    Instance::Voice &v = d->voice(voice);
+    v.samples = samples;
+    v.playing = false;
+    v.pos = 0;
+}
+
+void AudioMixer::play(int voice, bool looping)
+{
+    DENG2_GUARD(d);
+
+    Instance::Voice &v = d->voice(voice);
+    v.playing = !v.samples.isEmpty();
+    v.looping = looping;
+    v.pos = 0;
+    v.rampFromCurrent = false;
+}
+
+void AudioMixer::stop(int voice)
+{
+    DENG2_GUARD(d);
+    d->voice(voice).playing = false;
+}
+
+bool AudioMixer::isPlaying(int voice) const
+{
+    DENG2_GUARD(d);
+    return d->voice(voice).playing;
+}
+
+void AudioMixer::setVolume(int voice, float volume)
+{
+    DENG2_GUARD(d);
+    d->voice(voice).volume = de::max(0.f, volume);
+}
+
+void AudioMixer::setPitch(int voice, float pitch)
+{
+    DENG2_GUARD(d);
+    d->voice(voice).pitch = de::max(.001f, pitch);
+}
+
+void AudioMixer::setPan(int voice, float pan)
+{
+    DENG2_GUARD(d);
+    d->voice(voice).pan = de::clamp(-1.f, pan, 1.f);
+}
+
+void AudioMixer::setPosition(int voice, Vector3f const &position, bool relative)
+{
+    DENG2_GUARD(d);
+
+    Instance::Voice &v = d->voice(voice);
+    v.positional = true;
+    v.origin     = position;
+    v.relative   = relative;
+}
+
+void AudioMixer::setDistanceRange(int voice, float minDistance, float maxDistance)
+{
+    DENG2_GUARD(d);
+
+    Instance::Voice &v = d->voice(voice);
+    v.minDistance = de::max(0.f, minDistance);
+    v.maxDistance = de::max(v.minDistance + .001f, maxDistance);
+}
+
+void AudioMixer::clearPosition(int voice)
+{
+    DENG2_GUARD(d);
+    d->voice(voice).positional = false;
+}
+
+void AudioMixer::setListener(Vector3f const &position, float yaw)
+{
+    DENG2_GUARD(d);
+    d->listenerPos = position;
+    d->listenerYaw = yaw;
+}
+
+void AudioMixer::setReverb(float volume, float space, float decay, float damping)
+{
+    DENG2_GUARD(d);
+    d->reverb.set(volume, space, decay, damping);
+}
+
+void AudioMixer::setVoicesPerThread(int count)
+{
+    DENG2_GUARD(d);
+    d->voicesPerThread = de::max(1, count);
+}
+
+void AudioMixer::render(float *frames, dsize count)
+{
+    DENG2_GUARD(d);
+    d->render(frames, count);
+}
+
+void AudioMixer::render(ISink &sink, dsize count)
+{
+    DENG2_GUARD(d);
+
+    if(dsize(d->sinkBuffer.size()) < 2 * count)
+    {
+        d->sinkBuffer.resize(int(2 * count));
+    }
+    d->render(d->sinkBuffer.data(), count);
+    sink.consume(d->sinkBuffer.constData(), count);
+}
+
+char const *AudioMixer::kernelName()
+{
+    return kernelIdentifier;
+}
+
+} // namespace de
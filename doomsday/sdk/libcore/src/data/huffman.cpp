@@ -26,6 +26,7 @@
 #include "de/App"
 #include "de/Log"
 #include "de/ByteRefArray"
+#include "de/math.h"
 
 // Heap relations.
 #define HEAP_PARENT(i)  (((i) + 1)/2 - 1)
@@ -123,25 +124,44 @@ struct HuffCode {
     duint length;
 };
 
-struct HuffBuffer {
-    dbyte *data;
-    dsize size;
+/// Number of bits decoded with one table lookup. Must be at least as long as
+/// the longest code (currently 10 bits).
+static int const LOOKUP_BITS = 12;
+
+struct HuffLookup {
+    dbyte value;
+    dbyte length;             // Number of bits in the code.
 };
 
+/**
+ * Huffman codec for network messages. The codes are derived from a tree built
+ * from a fixed table of byte frequencies, so both ends of the connection have
+ * identical codes. The bits of each code are stored starting from the least
+ * significant bit.
+ *
+ * Encoding collects the codes into a 64-bit accumulator that is written out a
+ * word at a time. Decoding uses a lookup table indexed by the next
+ * LOOKUP_BITS bits of input, which yields one value and its code length per
+ * step.
+ */
 struct Huffman
 {
-    // The root of the Huffman tree.
-    HuffNode *huffRoot;
-
     // The lookup table for encoding.
     HuffCode huffCodes[256];
 
+    // The lookup table for decoding.
+    HuffLookup huffLookup[1 << LOOKUP_BITS];
+
+    duint minLength;
+    duint maxLength;
+
     /**
-     * Builds the Huffman tree and initializes the code lookup.
+     * Builds the Huffman tree and initializes the code lookups.
      */
-    Huffman() : huffRoot(0)
+    Huffman() : minLength(32), maxLength(0)
     {
         zap(huffCodes);
+        zap(huffLookup);
 
         HuffQueue queue;
         HuffNode *node;
@@ -169,43 +189,27 @@ struct Huffman
         }
 
         // The root is the last node left in the queue.
-        huffRoot = Huff_QueueExtract(&queue);
+        HuffNode *root = Huff_QueueExtract(&queue);
 
-        // Fill in the code lookup table.
-        Huff_BuildLookup(huffRoot, 0, 0);
+        // Fill in the code lookup table. After this the tree is not needed.
+        Huff_BuildLookup(root, 0, 0);
+        Huff_DestroyNode(root);
 
-#if 0
-        if(qApp->arguments().contains("-huffcodes"))
+        // Every possible sequence of LOOKUP_BITS bits begins with exactly one
+        // code: fill in all the table entries whose low bits match the code.
+        for(i = 0; i < 256; ++i)
         {
-            double realBits = 0;
-            double huffBits = 0;
-
-            LOG_MSG("Huffman codes:");
-            for(i = 0; i < 256; ++i)
+            HuffCode const &hc = huffCodes[i];
+            DENG2_ASSERT(hc.length <= duint(LOOKUP_BITS));
+            for(duint high = 0; high < (1u << (LOOKUP_BITS - hc.length)); ++high)
             {
-                uint k;
-                realBits += freqs[i] * 8;
-                huffBits += freqs[i] * huffCodes[i].length;
-                LOG_MSG("%03i: (%07i) ", i, (int) (6e6 * freqs[i]));
-                for(k = 0; k < huffCodes[i].length; ++k)
-                {
-                    LogBuffer_Printf(0, "%c", huffCodes[i].code & (1 << k) ? '1' : '0');
-                }
-                LogBuffer_Printf(0, "\n");
+                HuffLookup &entry = huffLookup[hc.code | (high << hc.length)];
+                entry.value  = dbyte(i);
+                entry.length = dbyte(hc.length);
             }
-            LOG_MSG("realbits=%f, huffbits=%f (%f%%)")
-                    << realBits <<huffBits << huffBits / realBits * 100;
+            minLength = de::min(minLength, hc.length);
+            maxLength = de::max(maxLength, hc.length);
         }
-#endif
-    }
-
-    /**
-     * Free all resources allocated for Huffman codes.
-     */
-    ~Huffman()
-    {
-        Huff_DestroyNode(huffRoot);
-        huffRoot = NULL;
     }
 
     /**
@@ -326,22 +330,6 @@ struct Huffman
         }
     }
 
-    /**
-     * Checks if the encoding/decoding buffer can hold the given number of
-     * bytes. If not, reallocates the buffer.
-     */
-    void Huff_ResizeBuffer(HuffBuffer *buffer, dsize neededSize)
-    {
-        while(neededSize > buffer->size)
-        {
-            if(!buffer->size)
-                buffer->size = qMax(dsize(1024), neededSize);
-            else
-                buffer->size *= 2;
-        }
-        buffer->data = (dbyte *) realloc(buffer->data, buffer->size);
-    }
-
     /**
      * Recursively frees the node and its subtree.
      */
@@ -355,143 +343,100 @@ struct Huffman
         }
     }
 
-    /**
-     * Free the buffer.
-     */
-    void Huff_DestroyBuffer(HuffBuffer *buffer)
+    dsize maxEncodedSize(dsize size) const
     {
-        free(buffer->data);
-        zapPtr(buffer);
+        // Three bits are needed for the header.
+        return (3 + size * maxLength + 7) / 8;
     }
 
-    dbyte *encode(dbyte const *data, dsize size, dsize *encodedSize)
+    dsize maxDecodedSize(dsize size) const
     {
-        HuffBuffer huffEnc;
-        dsize i;
-        duint code;
-        int remaining, fits;
-        dbyte *out, bit;
-
-        zap(huffEnc);
-
-        // The encoded message is never twice the original size
-        // (longest codes are currently 11 bits).
-        Huff_ResizeBuffer(&huffEnc, 2 * size);
+        return size * 8 / minLength;
+    }
 
-        // First three bits of the encoded data contain the number of bits (-1)
-        // in the last dbyte of the encoded data. It's written when we have
-        // finished the encoding.
-        bit = 3;
+    dsize encode(dbyte const *data, dsize size, dbyte *encoded) const
+    {
+        dbyte *out = encoded;
 
-        // Clear the first dbyte of the result.
-        out = huffEnc.data;
-        *out = 0;
+        // The first three bits of the encoded data contain the number of bits
+        // (-1) in the last byte of the encoded data. They are filled in when
+        // the encoding is finished.
+        duint64 bits = 0;
+        int count = 3;
 
-        for(i = 0; i < size; ++i)
+        for(dbyte const *in = data, *end = data + size; in != end; ++in)
         {
-            remaining = huffCodes[data[i]].length;
-            code = huffCodes[data[i]].code;
+            HuffCode const &hc = huffCodes[*in];
+            bits |= duint64(hc.code) << count;
+            count += hc.length;
 
-            while(remaining > 0)
+            if(count >= 32)
             {
-                fits = 8 - bit;
-                if(fits > remaining)
-                    fits = remaining;
-
-                // Write the bits that fit the current dbyte.
-                *out |= code << bit;
-                code >>= fits;
-                remaining -= fits;
-
-                // Advance the bit position.
-                bit += fits;
-                if(bit == 8)
-                {
-                    bit = 0;
-                    *++out = 0;
-                }
+                // Write a full word.
+                out[0] = dbyte(bits);
+                out[1] = dbyte(bits >> 8);
+                out[2] = dbyte(bits >> 16);
+                out[3] = dbyte(bits >> 24);
+                out += 4;
+                bits >>= 32;
+                count -= 32;
             }
         }
 
-        // If the last dbyte is empty, back up.
-        if(bit == 0)
+        // Write the remaining bits.
+        while(count > 0)
         {
-            out--;
-            bit = 8;
+            *out++ = dbyte(bits);
+            bits >>= 8;
+            count -= 8;
         }
 
-        if(encodedSize)
-            *encodedSize = out - huffEnc.data + 1;
-
-        // The number of valid bits - 1 in the last dbyte.
-        huffEnc.data[0] |= bit - 1;
+        // The number of valid bits - 1 in the last byte.
+        encoded[0] |= dbyte(8 + count - 1);
 
-        return huffEnc.data;
+        return out - encoded;
     }
 
-    dbyte *decode(dbyte const *data, dsize size, dsize *decodedSize)
+    dsize decode(dbyte const *data, dsize size, dbyte *decoded) const
     {
-        HuffBuffer huffDec;
-        HuffNode *node;
-        dsize outBytes = 0;
-        dbyte const *in = data;
-        dbyte const *lastIn = in + size - 1;
-        dbyte bit = 3, lastByteBits;
+        if(!size) return 0;
 
-        zap(huffDec);
-        Huff_ResizeBuffer(&huffDec, 256);
+        duint64 const mask = (1 << LOOKUP_BITS) - 1;
 
-        // The first three bits contain the number of valid bits in
-        // the last dbyte.
-        lastByteBits = (*in & 7) + 1;
+        // The first three bits contain the number of valid bits in the last
+        // byte.
+        dsize const totalBits = (size - 1) * 8 + (data[0] & 7) + 1;
+        dsize usedBits = 3;
 
-        // Start from the root node.
-        node = huffRoot;
+        dbyte const *in = data + 1;
+        dbyte const *end = data + size;
+        dbyte *out = decoded;
 
-        while(in < lastIn || bit < lastByteBits)
-        {
-            // Go left or right?
-            if(*in & (1 << bit))
-            {
-                node = node->right;
-            }
-            else
-            {
-                node = node->left;
-            }
+        // Bits of the first byte that follow the header.
+        duint64 bits = data[0] >> 3;
+        int count = 5;
 
-            // Did we arrive at a leaf?
-            if(!node->left && !node->right)
+        while(usedBits < totalBits)
+        {
+            // Fill up the accumulator.
+            while(count <= 56 && in != end)
             {
-                // This node represents a value.
-                huffDec.data[outBytes++] = node->value;
-
-                // Should we allocate more memory?
-                if(outBytes == huffDec.size)
-                {
-                    Huff_ResizeBuffer(&huffDec, 2 * huffDec.size);
-                }
-
-                // Back to the root.
-                node = huffRoot;
+                bits |= duint64(*in++) << count;
+                count += 8;
             }
 
-            // Advance bit position.
-            if(++bit == 8)
+            HuffLookup const &entry = huffLookup[bits & mask];
+            if(usedBits + entry.length > totalBits)
             {
-                bit = 0;
-                ++in;
-
-                // Out of buffer?
-                if(in > lastIn)
-                    break;
+                // An incomplete code at the end is ignored.
+                break;
             }
+            *out++ = entry.value;
+            bits >>= entry.length;
+            count -= entry.length;
+            usedBits += entry.length;
         }
-        if(decodedSize)
-        {
-            *decodedSize = outBytes;
-        }
-        return huffDec.data;
+        return out - decoded;
     }
 };
 
@@ -499,29 +444,37 @@ struct Huffman
 
 static internal::Huffman huff;
 
+dsize codec::huffmanMaxEncodedSize(dsize size)
+{
+    return huff.maxEncodedSize(size);
+}
+
+dsize codec::huffmanEncode(dbyte const *data, dsize size, dbyte *encoded)
+{
+    return huff.encode(data, size, encoded);
+}
+
+dsize codec::huffmanMaxDecodedSize(dsize codedSize)
+{
+    return huff.maxDecodedSize(codedSize);
+}
+
+dsize codec::huffmanDecode(dbyte const *codedData, dsize size, dbyte *decoded)
+{
+    return huff.decode(codedData, size, decoded);
+}
+
 Block codec::huffmanEncode(Block const &data)
 {
-    Block result;
-    dsize size = 0;
-    dbyte *coded = huff.encode(data.data(), data.size(), &size);
-    if(coded)
-    {
-        result.copyFrom(ByteRefArray(coded, size), 0, size);
-        free(coded);
-    }
+    Block result(huff.maxEncodedSize(data.size()));
+    result.resize(huff.encode(data.data(), data.size(), result.data()));
     return result;
 }
 
 Block codec::huffmanDecode(Block const &codedData)
 {
-    Block result;
-    dsize size = 0;
-    dbyte *decoded = huff.decode(codedData.data(), codedData.size(), &size);
-    if(decoded)
-    {
-        result.copyFrom(ByteRefArray(decoded, size), 0, size);
-        free(decoded);
-    }
+    Block result(huff.maxDecodedSize(codedData.size()));
+    result.resize(huff.decode(codedData.data(), codedData.size(), result.data()));
     return result;
 }
 
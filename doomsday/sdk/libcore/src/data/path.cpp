@@ -86,6 +86,62 @@ String Path::Segment::toString() const
     return range.string()->mid(range.position(), range.size());
 }
 
+/**
+ * Splits a path into segments, in reverse order. Trailing separators are
+ * ignored, and a leading separator yields an empty root segment. There is
+ * always at least one segment.
+ *
+ * @param path         Path to parse.
+ * @param separator    Segment separator.
+ * @param addSegment   Called for each segment (QStringRef const &).
+ */
+template <typename AddFunc>
+static void parseSegments(String const &path, QChar separator, AddFunc addSegment)
+{
+    if(path.isEmpty())
+    {
+        // There always has to be at least one segment.
+        addSegment(QStringRef(&emptyPath));
+        return;
+    }
+
+    QChar const *segBegin = path.constData();
+    QChar const *segEnd   = path.constData() + path.length() - 1;
+
+    // Skip over any trailing delimiters.
+    for(int i = path.length();
+        segEnd->unicode() && *segEnd == separator && i-- > 0;
+        --segEnd) {}
+
+    // Scan the path for segments, in reverse order.
+    QChar const *from;
+    forever
+    {
+        if(segEnd < segBegin) break; // E.g., path is "/"
+
+        // Find the start of the next segment.
+        for(from = segEnd; from > segBegin && !(*from == separator); from--)
+        {}
+
+        int startIndex = (*from == separator? from + 1 : from) - path.constData();
+        int length = (segEnd - path.constData()) - startIndex + 1;
+        addSegment(QStringRef(&path, startIndex, length));
+
+        // Are there no more parent directories?
+        if(from == segBegin) break;
+
+        // So far so good. Move one directory level upwards.
+        // The next name ends here.
+        segEnd = from - 1;
+    }
+
+    // Unix style zero-length root name?
+    if(*segBegin == separator)
+    {
+        addSegment(QStringRef(&emptyPath));
+    }
+}
+
 struct Path::Instance
 {
     String path;
@@ -189,50 +245,9 @@ struct Path::Instance
         segmentCount = 0;
         extraSegments.clear();
 
-        if(path.isEmpty())
-        {
-            // There always has to be at least one segment.
-            allocSegment(&emptyPath);
-
-            DENG2_ASSERT(segmentCount > 0);
-            return;
-        }
-
-        QChar const *segBegin = path.constData();
-        QChar const *segEnd   = path.constData() + path.length() - 1;
-
-        // Skip over any trailing delimiters.
-        for(int i = path.length();
-            segEnd->unicode() && *segEnd == separator && i-- > 0;
-            --segEnd) {}
-
-        // Scan the path for segments, in reverse order.
-        QChar const *from;
-        forever
-        {
-            if(segEnd < segBegin) break; // E.g., path is "/"
-
-            // Find the start of the next segment.
-            for(from = segEnd; from > segBegin && !(*from == separator); from--)
-            {}
-
-            int startIndex = (*from == separator? from + 1 : from) - path.constData();
-            int length = (segEnd - path.constData()) - startIndex + 1;
-            allocSegment(QStringRef(&path, startIndex, length));
-
-            // Are there no more parent directories?
-            if(from == segBegin) break;
-
-            // So far so good. Move one directory level upwards.
-            // The next name ends here.
-            segEnd = from - 1;
-        }
-
-        // Unix style zero-length root name?
-        if(*segBegin == separator)
-        {
-            allocSegment(&emptyPath);
-        }
+        parseSegments(path, separator, [this] (QStringRef const &range) {
+            allocSegment(range);
+        });
 
         DENG2_ASSERT(segmentCount > 0);
     }
@@ -517,6 +532,45 @@ Path PathRef::toPath() const
     return Path(composed, path().separator());
 }
 
+PathView::PathView(String const &path, QChar sep)
+    : _path(path)
+    , _separator(sep)
+{}
+
+void PathView::parse() const
+{
+    if(!_segments.isEmpty()) return;
+
+    parseSegments(_path, _separator, [this] (QStringRef const &range) {
+        Path::Segment seg;
+        seg.gotHashKey = false;
+        seg.hashKey    = 0;
+        seg.range      = range;
+        _segments.append(seg);
+    });
+
+    DENG2_ASSERT(!_segments.isEmpty());
+}
+
+int PathView::segmentCount() const
+{
+    parse();
+    return _segments.size();
+}
+
+Path::Segment const &PathView::reverseSegment(int reverseIndex) const
+{
+    parse();
+
+    if(reverseIndex < 0 || reverseIndex >= _segments.size())
+    {
+        /// @throw Path::OutOfBoundsError  Attempt to reference a nonexistent segment.
+        throw Path::OutOfBoundsError("PathView::reverseSegment",
+                                     String("Reverse index %1 is out of bounds").arg(reverseIndex));
+    }
+    return _segments[reverseIndex];
+}
+
 } // namespace de
 
 #ifdef _DEBUG
@@ -156,8 +156,9 @@ struct PathTree::Instance
         return node;
     }
 
+    template <typename PathType>
     PathTree::Node *findInHash(PathTree::Nodes &hash, Path::hash_type hashKey,
-                               Path const &searchPath,
+                               PathType const &searchPath,
                                PathTree::ComparisonFlags compFlags)
     {
         for(Nodes::iterator i = hash.find(hashKey);
@@ -181,7 +182,8 @@ struct PathTree::Instance
         return 0;
     }
 
-    PathTree::Node *find(Path const &searchPath, PathTree::ComparisonFlags compFlags)
+    template <typename PathType>
+    PathTree::Node *find(PathType const &searchPath, PathTree::ComparisonFlags compFlags)
     {
         if(searchPath.isEmpty() && !compFlags.testFlag(NoBranch))
         {
@@ -341,6 +343,46 @@ PathTree::Node *PathTree::tryFind(Path const &path, ComparisonFlags flags)
     return d->find(path, flags);
 }
 
+bool PathTree::has(PathView const &path, ComparisonFlags flags) const
+{
+    DENG2_GUARD(this);
+
+    flags &= ~RelinquishMatching; // never relinquish
+    return d->find(path, flags) != 0;
+}
+
+PathTree::Node const &PathTree::find(PathView const &searchPath, ComparisonFlags flags) const
+{
+    DENG2_GUARD(this);
+
+    Node const *found = d->find(searchPath, flags);
+    if(!found)
+    {
+        /// @throw NotFoundError  The referenced node could not be found.
+        throw NotFoundError("PathTree::find", "No paths found matching \"" +
+                            searchPath.toStringRef() + "\"");
+    }
+    return *found;
+}
+
+PathTree::Node &PathTree::find(PathView const &path, ComparisonFlags flags)
+{
+    Node const &node = const_cast<PathTree const *>(this)->find(path, flags);
+    return const_cast<Node &>(node);
+}
+
+PathTree::Node const *PathTree::tryFind(PathView const &path, ComparisonFlags flags) const
+{
+    DENG2_GUARD(this);
+    return d->find(path, flags);
+}
+
+PathTree::Node *PathTree::tryFind(PathView const &path, ComparisonFlags flags)
+{
+    DENG2_GUARD(this);
+    return d->find(path, flags);
+}
+
 String const &PathTree::segmentName(SegmentId segmentId) const
 {
     DENG2_GUARD(this);
@@ -466,6 +508,33 @@ int PathTree::traverse(ComparisonFlags flags, PathTree::Node const *parent, Path
     return result;
 }
 
+namespace internal {
+    struct MatchingPathTraversal
+    {
+        PathView const &path;
+        PathTree::ComparisonFlags flags;
+        int (*callback) (PathTree::Node &, void *);
+        void *parameters;
+
+        static int visit(PathTree::Node &node, void *context)
+        {
+            MatchingPathTraversal const &trav = *static_cast<MatchingPathTraversal *>(context);
+            if(node.comparePath(trav.path, trav.flags)) return 0; // Not a match.
+            return trav.callback(node, trav.parameters);
+        }
+    };
+}
+
+int PathTree::traverse(ComparisonFlags flags, PathTree::Node const *parent, PathView const &path,
+                       int (*callback) (PathTree::Node &, void *), void *parameters) const
+{
+    if(!callback) return 0;
+
+    internal::MatchingPathTraversal trav = { path, flags & ~RelinquishMatching, callback, parameters };
+    return traverse(flags, parent, path.lastSegment().hash(),
+                    internal::MatchingPathTraversal::visit, &trav);
+}
+
 #ifdef DENG2_DEBUG
 void PathTree::debugPrint(QChar separator) const
 {
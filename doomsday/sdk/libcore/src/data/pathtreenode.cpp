@@ -167,10 +167,21 @@ static int matchName(QChar const *string,  dsize stringSize,
     return st == (pattern + patternSize);
 }
 
-int PathTree::Node::comparePath(de::Path const &searchPattern, ComparisonFlags flags) const
+/**
+ * Compares the path of @a node against a search pattern.
+ *
+ * @param node           Tree node.
+ * @param searchPattern  Path or PathView to compare with.
+ * @param flags          Path comparison flags.
+ *
+ * @return Zero iff the pattern matched.
+ */
+template <typename PathType>
+static int comparePathOfNode(PathTree::Node const &node, PathType const &searchPattern,
+                             PathTree::ComparisonFlags flags)
 {
-    if(((flags & PathTree::NoLeaf)   && isLeaf()) ||
-       ((flags & PathTree::NoBranch) && isBranch()))
+    if(((flags & PathTree::NoLeaf)   && node.isLeaf()) ||
+       ((flags & PathTree::NoBranch) && node.isBranch()))
         return 1;
 
     try
@@ -180,20 +191,20 @@ int PathTree::Node::comparePath(de::Path const &searchPattern, ComparisonFlags f
         // In reverse order, compare each path node in the search term.
         int pathNodeCount = searchPattern.segmentCount();
 
-        PathTree::Node const *node = this;
+        PathTree::Node const *trav = &node;
         for(int i = 0; i < pathNodeCount; ++i)
         {
             bool const snameIsWild = !snode->toStringRef().compare("*");
             if(!snameIsWild)
             {
                 // If the hashes don't match it can't possibly be this.
-                if(snode->hash() != node->hash())
+                if(snode->hash() != trav->hash())
                 {
                     return 1;
                 }
 
                 // Compare the names.
-                if(!matchName(node->name().constData(), node->name().size(),
+                if(!matchName(trav->name().constData(), trav->name().size(),
                               snode->toStringRef().constData(), snode->toStringRef().size()))
                 {
                     return 1;
@@ -203,17 +214,17 @@ int PathTree::Node::comparePath(de::Path const &searchPattern, ComparisonFlags f
             // Have we arrived at the search target?
             if(i == pathNodeCount - 1)
             {
-                return !(!(flags & MatchFull) || node->isAtRootLevel());
+                return !(!(flags & PathTree::MatchFull) || trav->isAtRootLevel());
             }
 
             // Is the hierarchy too shallow?
-            if(node->isAtRootLevel())
+            if(trav->isAtRootLevel())
             {
                 return 1;
             }
 
             // So far so good. Move one level up the hierarchy.
-            node  = &node->parent();
+            trav  = &trav->parent();
             snode = &searchPattern.reverseSegment(i + 1);
         }
     }
@@ -223,6 +234,16 @@ int PathTree::Node::comparePath(de::Path const &searchPattern, ComparisonFlags f
     return 1;
 }
 
+int PathTree::Node::comparePath(de::Path const &searchPattern, ComparisonFlags flags) const
+{
+    return comparePathOfNode(*this, searchPattern, flags);
+}
+
+int PathTree::Node::comparePath(PathView const &searchPattern, ComparisonFlags flags) const
+{
+    return comparePathOfNode(*this, searchPattern, flags);
+}
+
 #ifdef LIBDENG_STACK_MONITOR
 static void *stackStart;
 static size_t maxStackDepth;
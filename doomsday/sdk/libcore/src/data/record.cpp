@@ -32,6 +32,7 @@
 #include "de/Vector"
 #include "de/String"
 
+#include <QAtomicInt>
 #include <QTextStream>
 #include <functional>
 
@@ -43,7 +44,7 @@ String const Record::SUPER_NAME = "__super__";
  * Each record is given a unique identifier, so that serialized record
  * references can be tracked to their original target.
  */
-static duint32 recordIdCounter = 0;
+static QAtomicInt recordIdCounter;
 
 DENG2_PIMPL(Record)
 {
@@ -55,10 +56,22 @@ DENG2_PIMPL(Record)
 
     Instance(Public &r)
         : Base(r)
-        , uniqueId(++recordIdCounter)
+        , uniqueId(duint32(recordIdCounter.fetchAndAddOrdered(1) + 1))
         , oldUniqueId(0)
     {}
 
+    Variable *findMember(String const &name) const
+    {
+        Members::const_iterator found = members.constFind(name);
+        return (found != members.constEnd()? found.value() : 0);
+    }
+
+    Variable *findMember(String const &name, duint32 hash) const
+    {
+        Members::const_iterator found = members.constFind(name, hash);
+        return (found != members.constEnd()? found.value() : 0);
+    }
+
     struct ExcludeByBehavior {
         Behavior behavior;
         ExcludeByBehavior(Behavior b) : behavior(b) {}
@@ -79,7 +92,7 @@ DENG2_PIMPL(Record)
     template <typename Predicate>
     void clear(Predicate excluded)
     {
-        if(!members.empty())
+        if(!members.isEmpty())
         {
             Record::Members remaining; // Contains all members that are not removed.
 
@@ -162,14 +175,18 @@ DENG2_PIMPL(Record)
             if(!self.hasSubrecord(subName)) return 0;
             return self[subName].value<RecordValue>().dereference().d->findMemberByPath(remaining);
         }
+        return findMember(name);
+    }
 
-        Members::const_iterator found = members.constFind(name);
-        if(found != members.constEnd())
+    Variable const *findMemberByKey(RecordKey const &key) const
+    {
+        if(key.isPath())
         {
-            return found.value();
+            Variable const *sub = findMemberByPath(key.subrecordPath());
+            if(!sub || !isSubrecord(*sub)) return 0;
+            return sub->value<RecordValue>().dereference().d->findMember(key.memberName(), key.hash());
         }
-
-        return 0;
+        return findMember(key.memberName(), key.hash());
     }
 
     /**
@@ -311,11 +328,21 @@ bool Record::has(String const &name) const
     return hasMember(name);
 }
 
+bool Record::has(RecordKey const &key) const
+{
+    return hasMember(key);
+}
+
 bool Record::hasMember(String const &variableName) const
 {
     return d->findMemberByPath(variableName) != 0;
 }
 
+bool Record::hasMember(RecordKey const &key) const
+{
+    return d->findMemberByKey(key) != 0;
+}
+
 bool Record::hasSubrecord(String const &subrecordName) const
 {
     Variable const *found = d->findMemberByPath(subrecordName);
@@ -443,11 +470,11 @@ Record &Record::addRecord(String const &name)
 
 Record *Record::removeSubrecord(String const &name)
 {
-    Members::const_iterator found = d->members.find(name);
-    if(found != d->members.end() && d->isSubrecord(*found.value()))
+    Variable *found = d->findMember(name);
+    if(found && d->isSubrecord(*found))
     {
-        Record *returnedToCaller = found.value()->value().as<RecordValue>().takeRecord();
-        remove(*found.value());
+        Record *returnedToCaller = found->value().as<RecordValue>().takeRecord();
+        remove(*found);
         return returnedToCaller;
     }
     throw NotFoundError("Record::remove", "Subrecord '" + name + "' not found");
@@ -524,6 +551,21 @@ Variable const &Record::operator [] (String const &name) const
     throw NotFoundError("Record::operator []", "Variable '" + name + "' not found");
 }
 
+Variable &Record::operator [] (RecordKey const &key)
+{
+    return const_cast<Variable &>((*const_cast<Record const *>(this))[key]);
+}
+
+Variable const &Record::operator [] (RecordKey const &key) const
+{
+    Variable const *found = d->findMemberByKey(key);
+    if(found)
+    {
+        return *found;
+    }
+    throw NotFoundError("Record::operator []", "Variable '" + key.name() + "' not found");
+}
+
 Record &Record::subrecord(String const &name)
 {
     return const_cast<Record &>((const_cast<Record const *>(this))->subrecord(name));
@@ -538,10 +580,10 @@ Record const &Record::subrecord(String const &name) const
         return subrecord(name.substr(0, pos)).subrecord(name.substr(pos + 1));
     }
 
-    Members::const_iterator found = d->members.find(name);
-    if(found != d->members.end() && d->isSubrecord(*found.value()))
+    Variable const *found = d->findMember(name);
+    if(found && d->isSubrecord(*found))
     {
-        return *found.value()->value().as<RecordValue>().record();
+        return *found->value().as<RecordValue>().record();
     }
     throw NotFoundError("Record::subrecord", "Subrecord '" + name + "' not found");
 }
@@ -636,9 +678,14 @@ void Record::addSuperRecord(Value *superValue)
 void Record::operator >> (Writer &to) const
 {
     to << d->uniqueId << duint32(d->members.size());
-    DENG2_FOR_EACH_CONST(Members, i, d->members)
+
+    // Members are written in name order so that the serialization is the same
+    // regardless of the order of the hash.
+    QList<String> names = d->members.keys();
+    qSort(names);
+    foreach(String const &name, names)
     {
-        to << *i.value();
+        to << *d->members.value(name);
     }
 }
     
@@ -119,6 +119,82 @@ ArrayValue const &RecordAccessor::geta(String const &name) const
     return getAs<ArrayValue>(name);
 }
 
+bool RecordAccessor::has(RecordKey const &key) const
+{
+    return accessedRecord().hasMember(key);
+}
+
+Value const &RecordAccessor::get(RecordKey const &key) const
+{
+    return accessedRecord()[key].value();
+}
+
+dint RecordAccessor::geti(RecordKey const &key) const
+{
+    return get(key).asInt();
+}
+
+dint RecordAccessor::geti(RecordKey const &key, dint defaultValue) const
+{
+    if(!accessedRecord().hasMember(key)) return defaultValue;
+    return geti(key);
+}
+
+bool RecordAccessor::getb(RecordKey const &key) const
+{
+    return get(key).isTrue();
+}
+
+bool RecordAccessor::getb(RecordKey const &key, bool defaultValue) const
+{
+    if(!accessedRecord().hasMember(key)) return defaultValue;
+    return getb(key);
+}
+
+duint RecordAccessor::getui(RecordKey const &key) const
+{
+    return duint(get(key).asNumber());
+}
+
+duint RecordAccessor::getui(RecordKey const &key, duint defaultValue) const
+{
+    if(!accessedRecord().hasMember(key)) return defaultValue;
+    return getui(key);
+}
+
+dfloat RecordAccessor::getf(RecordKey const &key) const
+{
+    return dfloat(getd(key));
+}
+
+dfloat RecordAccessor::getf(RecordKey const &key, dfloat defaultValue) const
+{
+    if(!accessedRecord().hasMember(key)) return defaultValue;
+    return getf(key);
+}
+
+ddouble RecordAccessor::getd(RecordKey const &key) const
+{
+    return get(key).asNumber();
+}
+
+ddouble RecordAccessor::getd(RecordKey const &key, ddouble defaultValue) const
+{
+    if(!accessedRecord().hasMember(key)) return defaultValue;
+    return getd(key);
+}
+
+String RecordAccessor::gets(RecordKey const &key) const
+{
+    return get(key).asText();
+}
+
+String RecordAccessor::gets(RecordKey const &key, String const &defaultValue) const
+{
+    if(!accessedRecord().hasMember(key)) return defaultValue;
+    return gets(key);
+}
+
 Record const &RecordAccessor::subrecord(String const &name) const
 {
     return accessedRecord().subrecord(name);
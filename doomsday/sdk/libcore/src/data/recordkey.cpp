@@ -0,0 +1,49 @@
+/** @file recordkey.cpp  Prepared name of a Record member.
+ *
+ * @authors Copyright (c) 2015 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * LGPL: http://www.gnu.org/licenses/lgpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details. You should have received a copy of
+ * the GNU Lesser General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#include "de/RecordKey"
+#include "de/Record"
+
+namespace de {
+
+RecordKey::RecordKey(String const &name) : _name(name)
+{
+    prepare();
+}
+
+RecordKey::RecordKey(char const *nameUtf8) : _name(nameUtf8)
+{
+    prepare();
+}
+
+void RecordKey::prepare()
+{
+    int const pos = _name.lastIndexOf('.');
+    if(pos >= 0)
+    {
+        _subrecordPath = _name.left(pos);
+        _memberName    = _name.mid(pos + 1);
+    }
+    else
+    {
+        _memberName = _name;
+    }
+    _hash = Record::Members::hashOf(_memberName);
+}
+
+} // namespace de
@@ -0,0 +1,383 @@
+/** @file resampler.cpp  Band-limited sample rate conversion.
+ *
+ * @authors Copyright © 2015 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * LGPL: http://www.gnu.org/licenses/lgpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details. You should have received a copy of
+ * the GNU Lesser General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#include "de/data/resampler.h"
+#include "de/math.h"
+
+#include <QVector>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define DENG2_RESAMPLER_SSE2
+#  include <emmintrin.h>
+#endif
+
+#if defined(DENG2_RESAMPLER_SSE2) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#  define DENG2_RESAMPLER_AVX2
+#  include <immintrin.h>
+#endif
+
+namespace de {
+
+/// Larger reduced ratios are approximated.
+static int const MAX_PHASES = 1024;
+
+/// Coefficients of each phase are padded to a multiple of this (for SIMD).
+static int const TAP_ALIGN = 8;
+
+/// Kaiser window shape: about 85 dB stopband attenuation.
+static double const KAISER_BETA = 8.0;
+
+/// Cutoff frequency relative to the Nyquist frequency of the lower rate.
+static double const CUTOFF = .94;
+
+/// Consumed input is discarded from the buffer once there is this much of it.
+static dsize const COMPACT_THRESHOLD = 8192;
+
+namespace internal {
+
+typedef float (*DotProductFunc)(float const *a, float const *b, int count);
+
+/// @param count  Multiple of TAP_ALIGN.
+static float dotProductScalar(float const *a, float const *b, int count)
+{
+    float sum = 0;
+    for(int i = 0; i < count; ++i)
+    {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+#ifdef DENG2_RESAMPLER_SSE2
+static float dotProductSSE2(float const *a, float const *b, int count)
+{
+    __m128 sum1 = _mm_setzero_ps();
+    __m128 sum2 = _mm_setzero_ps();
+    for(int i = 0; i < count; i += 8)
+    {
+        sum1 = _mm_add_ps(sum1, _mm_mul_ps(_mm_loadu_ps(a + i),     _mm_loadu_ps(b + i)));
+        sum2 = _mm_add_ps(sum2, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+    __m128 sum = _mm_add_ps(sum1, sum2);
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+    return _mm_cvtss_f32(sum);
+}
+#endif
+
+#ifdef DENG2_RESAMPLER_AVX2
+__attribute__((target("avx2,fma")))
+static float dotProductAVX2(float const *a, float const *b, int count)
+{
+    __m256 sum = _mm256_setzero_ps();
+    for(int i = 0; i < count; i += 8)
+    {
+        sum = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), sum);
+    }
+    __m128 half = _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+    half = _mm_add_ps(half, _mm_movehl_ps(half, half));
+    half = _mm_add_ss(half, _mm_shuffle_ps(half, half, 1));
+    return _mm_cvtss_f32(half);
+}
+#endif
+
+struct Kernel
+{
+    DotProductFunc func;
+    char const *name;
+
+    Kernel()
+    {
+#if defined(DENG2_RESAMPLER_AVX2)
+        __builtin_cpu_init();
+        if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        {
+            func = dotProductAVX2;
+            name = "AVX2";
+            return;
+        }
+#endif
+#if defined(DENG2_RESAMPLER_SSE2)
+        func = dotProductSSE2;
+        name = "SSE2";
+#else
+        func = dotProductScalar;
+        name = "scalar";
+#endif
+    }
+};
+
+static Kernel const &kernel()
+{
+    static Kernel k;
+    return k;
+}
+
+static int greatestCommonDivisor(int a, int b)
+{
+    while(b)
+    {
+        int const t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+/// Zeroth-order modified Bessel function of the first kind.
+static double besselI0(double x)
+{
+    double sum = 1, term = 1;
+    double const q = x * x / 4;
+    for(int k = 1; k < 50; ++k)
+    {
+        term *= q / (double(k) * k);
+        sum += term;
+        if(term < sum * 1e-12) break;
+    }
+    return sum;
+}
+
+} // namespace internal
+
+using namespace internal;
+
+DENG2_PIMPL_NOREF(Resampler)
+{
+    int inRate;
+    int outRate;
+    int upFactor;           ///< L: number of phases.
+    int downFactor;         ///< M: input advance per output, in phases.
+    int half;               ///< Half of the filter length, in input samples.
+    int taps;               ///< Coefficients per phase (padded).
+    QVector<float> coefs;   ///< Phase-major.
+
+    QVector<float> buffer;  ///< Input, preceded by the history.
+    dsize base;             ///< Buffer index of the next filter window.
+    int phase;              ///< Phase of the next output sample.
+    dsize totalIn;
+    dsize totalOut;
+    bool finished;
+
+    Instance(int inputRate, int outputRate, int halfLength)
+        : inRate(de::max(1, inputRate))
+        , outRate(de::max(1, outputRate))
+    {
+        int const gcd = greatestCommonDivisor(inRate, outRate);
+        upFactor   = outRate / gcd;
+        downFactor = inRate / gcd;
+
+        if(upFactor > MAX_PHASES)
+        {
+            // Approximate the ratio.
+            downFactor = de::max(1, int(std::floor(double(downFactor) * MAX_PHASES / upFactor + .5)));
+            upFactor   = MAX_PHASES;
+            int const g = greatestCommonDivisor(upFactor, downFactor);
+            upFactor   /= g;
+            downFactor /= g;
+        }
+
+        makeFilter(de::max(1, halfLength));
+        reset();
+    }
+
+    void makeFilter(int halfLength)
+    {
+        // When downsampling, the cutoff is lowered and the filter is made
+        // longer in terms of input samples.
+        double const scale  = de::min(1.0, double(upFactor) / downFactor);
+        double const cutoff = CUTOFF * scale / 2; // Cycles per input sample.
+
+        half = int(std::ceil(halfLength / scale));
+        taps = (2 * half + TAP_ALIGN - 1) / TAP_ALIGN * TAP_ALIGN;
+
+        coefs.fill(0, upFactor * taps);
+
+        double const windowNorm = besselI0(KAISER_BETA);
+        for(int p = 0; p < upFactor; ++p)
+        {
+            float *phaseCoefs = coefs.data() + p * taps;
+            double sum = 0;
+            for(int k = 0; k < 2 * half; ++k)
+            {
+                // Distance from the output position to the input sample.
+                double const t = half - 1 - k + double(p) / upFactor;
+                double const x = t / half;
+                if(x <= -1 || x >= 1) continue;
+
+                double const arg = 2 * PI * cutoff * t;
+                double const sinc = (std::fabs(t) < 1e-9? 1 : std::sin(arg) / arg);
+                double const window = besselI0(KAISER_BETA * std::sqrt(1 - x * x)) / windowNorm;
+
+                double const h = 2 * cutoff * sinc * window;
+                phaseCoefs[k] = float(h);
+                sum += h;
+            }
+            // Each phase passes a constant signal unchanged.
+            if(sum > 0)
+            {
+                for(int k = 0; k < 2 * half; ++k)
+                {
+                    phaseCoefs[k] = float(phaseCoefs[k] / sum);
+                }
+            }
+        }
+    }
+
+    void reset()
+    {
+        // The window of the first output sample extends before the input.
+        buffer.fill(0, half - 1);
+        base     = 0;
+        phase    = 0;
+        totalIn  = 0;
+        totalOut = 0;
+        finished = false;
+    }
+
+    dsize outputLength(dsize inputCount) const
+    {
+        return dsize((duint64(inputCount) * upFactor + downFactor - 1) / downFactor);
+    }
+
+    void append(float const *input, dsize count)
+    {
+        dsize const oldSize = dsize(buffer.size());
+        buffer.resize(int(oldSize + count));
+        if(input)
+        {
+            std::memcpy(buffer.data() + oldSize, input, sizeof(float) * count);
+        }
+        else
+        {
+            std::memset(buffer.data() + oldSize, 0, sizeof(float) * count);
+        }
+    }
+
+    dsize available() const
+    {
+        dsize count = 0;
+        if(base + taps <= dsize(buffer.size()))
+        {
+            // Each output advances the window by (phase + M) / L samples.
+            duint64 const room = duint64(buffer.size() - taps - base + 1) * upFactor - phase;
+            count = dsize((room + downFactor - 1) / downFactor);
+        }
+        if(finished)
+        {
+            count = de::min(count, outputLength(totalIn) - totalOut);
+        }
+        return count;
+    }
+
+    dsize read(float *output, dsize maxCount)
+    {
+        DotProductFunc const dot = kernel().func;
+        float const *in = buffer.constData();
+
+        dsize const count = de::min(maxCount, available());
+        for(dsize i = 0; i < count; ++i)
+        {
+            output[i] = dot(in + base, coefs.constData() + phase * taps, taps);
+
+            phase += downFactor;
+            base  += phase / upFactor;
+            phase %= upFactor;
+        }
+        totalOut += count;
+
+        if(base >= COMPACT_THRESHOLD)
+        {
+            buffer.remove(0, int(base));
+            base = 0;
+        }
+        return count;
+    }
+};
+
+Resampler::Resampler(int inputRate, int outputRate, int halfLength)
+    : d(new Instance(inputRate, outputRate, halfLength))
+{}
+
+int Resampler::inputRate() const
+{
+    return d->inRate;
+}
+
+int Resampler::outputRate() const
+{
+    return d->outRate;
+}
+
+dsize Resampler::outputLength(dsize inputCount) const
+{
+    return d->outputLength(inputCount);
+}
+
+dsize Resampler::convert(float const *input, dsize count, float *output)
+{
+    reset();
+    write(input, count);
+    finish();
+    return read(output, outputLength(count));
+}
+
+void Resampler::reset()
+{
+    d->reset();
+}
+
+void Resampler::write(float const *input, dsize count)
+{
+    DENG2_ASSERT(!d->finished);
+    d->append(input, count);
+    d->totalIn += count;
+}
+
+void Resampler::finish()
+{
+    if(d->finished) return;
+
+    // The last windows extend past the input.
+    d->append(0, d->taps);
+    d->finished = true;
+}
+
+dsize Resampler::available() const
+{
+    return d->available();
+}
+
+dsize Resampler::read(float *output, dsize maxCount)
+{
+    return d->read(output, maxCount);
+}
+
+int Resampler::maxPhases()
+{
+    return MAX_PHASES;
+}
+
+char const *Resampler::kernelName()
+{
+    return kernel().name;
+}
+
+} // namespace de
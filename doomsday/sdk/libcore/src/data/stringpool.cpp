@@ -20,12 +20,14 @@
  */
 
 #include "de/StringPool"
+#include "de/Guard"
 #include "de/Reader"
 #include "de/Writer"
 
+#include <QAtomicPointer>
+#include <QVector>
 #include <vector>
-#include <list>
-#include <set>
+#include <deque>
 #include <algorithm>
 #ifdef _DEBUG
 #  include <stdio.h> /// @todo should use C++
@@ -39,130 +41,113 @@
 
 namespace de {
 
-static String const nullString = "(nullptr)";
-
 typedef uint InternalId;
 
+namespace internal {
+
+/// Number of entries in a page (2^PAGE_BITS).
+static InternalId const PAGE_BITS = 8;
+static InternalId const PAGE_SIZE = 1 << PAGE_BITS;
+static InternalId const PAGE_MASK = PAGE_SIZE - 1;
+
+/// Minimum size of the hash table.
+static dint const MIN_HASH_SIZE = 64;
+
 /**
- * Case-insensitive text string (String).
+ * Computes a hash of the case-folded characters of @a text. Strings that are
+ * equal when compared case insensitively have the same hash.
  */
-class CaselessString : public ISerializable
+static duint32 caselessHash(String const &text)
 {
-public:
-    CaselessString()
-        : _str(), _id(0), _userValue(0), _userPointer(0)
-    {}
+    duint32 hash = 2166136261u; // FNV-1a
+    QChar const *ch  = text.constData();
+    QChar const *end = ch + text.size();
+    for(; ch != end; ++ch)
+    {
+        uint code = ch->unicode();
+        if(ch->isHighSurrogate() && ch + 1 != end && ch[1].isLowSurrogate())
+        {
+            code = QChar::surrogateToUcs4(ch[0], ch[1]);
+            ++ch;
+        }
+        hash = (hash ^ QChar::toCaseFolded(code)) * 16777619u;
+    }
+    return hash;
+}
 
-    CaselessString(QString text)
-        : _str(text), _id(0), _userValue(0), _userPointer(0)
-    {}
+/**
+ * Interned string and its associated values.
+ */
+struct Entry
+{
+    String str;
+    duint32 hash;
+    uint userValue;
+    void *userPointer;
+    bool inUse;
 
-    CaselessString(CaselessString const &other)
-        : ISerializable(), _str(other._str), _id(other._id), _userValue(other._userValue), _userPointer(0)
-    {}
+    Entry() : hash(0), userValue(0), userPointer(0), inUse(false) {}
 
-    void setText(String &text)
+    void release()
     {
-        _str = text;
-    }
-    operator String const *() const {
-        return &_str;
+        str.clear();
+        hash        = 0;
+        userValue   = 0;
+        userPointer = 0;
+        inUse       = false;
     }
-    operator String const &() const {
-        return _str;
-    }
-    bool operator < (CaselessString const &other) const {
-        return _str.compare(other, Qt::CaseInsensitive) < 0;
-    }
-    bool operator == (CaselessString const &other) const {
-        return !_str.compare(other, Qt::CaseInsensitive);
-    }
-    InternalId id() const {
-        return _id;
-    }
-    void setId(InternalId i) {
-        _id = i;
-    }
-    uint userValue() const {
-        return _userValue;
-    }
-    void setUserValue(uint value) {
-        _userValue = value;
-    }
-    void *userPointer() const {
-        return _userPointer;
-    }
-    void setUserPointer(void *ptr) {
-        _userPointer = ptr;
-    }
-    // Implements ISerializable.
-    void operator >> (Writer &to) const {
-        to << _str << duint32(_id) << duint32(_userValue);
-    }
-    void operator << (Reader &from) {
-        from >> _str >> _id >> _userValue;
-    }
-
-private:
-    String _str;
-    InternalId _id; ///< The id that refers to this string.
-    uint _userValue;
-    void *_userPointer;
 };
 
 /**
- * Utility class that acts as the value type for the std::set of interned
- * strings. Only points to CaselessString instances. The less-than operator
- * is needed by std::set to keep the strings ordered.
+ * Table of entry pages, indexed with (InternalId >> PAGE_BITS). Pages are never
+ * moved once allocated, and a directory that gets outgrown is retired instead of
+ * being deleted, so readers never see memory being freed under them.
  */
-class CaselessStringRef {
-public:
-    CaselessStringRef(CaselessString const *s = 0) {
-        _str = s;
-    }
-    CaselessStringRef(CaselessStringRef const &other) {
-        _str = other._str;
-    }
-    CaselessString *toStr() const {
-        return const_cast<CaselessString *>(_str);
-    }
-    InternalId id() const {
-        DENG2_ASSERT(_str);
-        return _str->id();
-    }
-    bool operator < (CaselessStringRef const &other) const {
-        DENG2_ASSERT(_str);
-        DENG2_ASSERT(other._str);
-        return *_str < *other._str;
+struct Directory
+{
+    dsize capacity;
+    Entry **pages;
+
+    Directory(dsize cap, Directory const *old = 0) : capacity(cap), pages(new Entry *[cap])
+    {
+        std::fill(pages, pages + cap, (Entry *) 0);
+        if(old) std::copy(old->pages, old->pages + old->capacity, pages);
     }
-    bool operator == (CaselessStringRef const &other) const {
-        DENG2_ASSERT(_str);
-        DENG2_ASSERT(other._str);
-        return *_str == *other._str;
+
+    ~Directory()
+    {
+        delete [] pages;
     }
-private:
-    CaselessString const *_str;
 };
 
-typedef std::set<CaselessStringRef> Interns;
-typedef std::vector<CaselessString *> IdMap;
-typedef std::list<InternalId> AvailableIds;
-
-DENG2_PIMPL_NOREF(StringPool)
-{
-    /// Interned strings (owns the CaselessString instances).
-    Interns interns;
+} // namespace internal
 
-    /// InternId => CaselessString*. Only one id can refer to the each CaselessString*.
-    IdMap idMap;
+using namespace internal;
 
-    /// Number of strings in the pool (must always be idMap.size() - available.size()).
+DENG2_PIMPL_NOREF(StringPool), public Lockable
+{
+    /**
+     * Open-addressing hash table (linear probing) of the interned strings.
+     * Removal shifts the following entries back, so no tombstones are needed.
+     */
+    struct Slot {
+        duint32 hash;
+        InternalId id; ///< EXPORT_ID of the string; zero for a free slot.
+        Slot() : hash(0), id(0) {}
+    };
+    QVector<Slot> table;
+
+    QAtomicPointer<Directory> directory; ///< Current directory (read without locking).
+    std::vector<Directory *> retired;    ///< Outgrown directories.
+    InternalId idCount;                  ///< Number of ids in use or available.
+
+    /// Number of strings in the pool (must always be idCount - available.size()).
     dsize count;
 
-    /// List of currently unused ids in idMap.
-    AvailableIds available;
+    /// Queue of currently unused ids.
+    std::deque<InternalId> available;
 
-    Instance() : count(0)
+    Instance() : directory(0), idCount(0), count(0)
     {}
 
     ~Instance()
@@ -171,16 +156,35 @@ DENG2_PIMPL_NOREF(StringPool)
         clear();
     }
 
+    Directory *dir() const
+    {
+#ifdef DENG2_QT_5_0_OR_NEWER
+        return directory.loadAcquire();
+#else
+        return directory;
+#endif
+    }
+
     void clear()
     {
-        for(dsize i = 0; i < idMap.size(); ++i)
+        if(Directory *current = dir())
         {
-            if(!idMap[i]) continue; // Unused slot.
-            delete idMap[i];
+            for(dsize i = 0; i < current->capacity; ++i)
+            {
+                delete [] current->pages[i];
+            }
+            delete current;
         }
+        for(Directory *old : retired) delete old;
+        retired.clear();
+#ifdef DENG2_QT_5_0_OR_NEWER
+        directory.storeRelease(0);
+#else
+        directory = 0;
+#endif
+        table.clear();
+        idCount = 0;
         count = 0;
-        interns.clear();
-        idMap.clear();
         available.clear();
 
         assertCount();
@@ -188,63 +192,171 @@ DENG2_PIMPL_NOREF(StringPool)
 
     void inline assertCount() const
     {
-        DENG2_ASSERT(count == interns.size());
-        DENG2_ASSERT(count == idMap.size() - available.size());
+        DENG2_ASSERT(count == idCount - available.size());
     }
 
-    Interns::iterator findIntern(String text)
+    inline Entry &entry(InternalId id) const
     {
-        CaselessString const key(text);
-        return interns.find(CaselessStringRef(&key)); // O(log n)
+        Directory const *current = dir();
+        DENG2_ASSERT(current != 0);
+        DENG2_ASSERT((id >> PAGE_BITS) < current->capacity);
+        DENG2_ASSERT(current->pages[id >> PAGE_BITS] != 0);
+        return current->pages[id >> PAGE_BITS][id & PAGE_MASK];
     }
 
-    Interns::const_iterator findIntern(String text) const
+    /// Returns the entry of an externally visible @a id, or @c NULL if not in use.
+    Entry *usedEntry(Id id) const
     {
-        CaselessString const key(text);
-        return interns.find(CaselessStringRef(&key)); // O(log n)
+        if(id == 0 || IMPORT_ID(id) >= idCount) return 0;
+        Entry &ent = entry(IMPORT_ID(id));
+        return ent.inUse? &ent : 0;
+    }
+
+    /// Makes sure there is an entry for @a id.
+    void reserveEntry(InternalId id)
+    {
+        dsize const pageIndex = id >> PAGE_BITS;
+        Directory *current = dir();
+        if(!current || pageIndex >= current->capacity)
+        {
+            dsize cap = (current? current->capacity : 8);
+            while(cap <= pageIndex) cap *= 2;
+
+            // Readers may still be using the old directory.
+            Directory *grown = new Directory(cap, current);
+            if(current) retired.push_back(current);
+#ifdef DENG2_QT_5_0_OR_NEWER
+            directory.storeRelease(grown);
+#else
+            directory = grown;
+#endif
+            current = grown;
+        }
+        if(!current->pages[pageIndex])
+        {
+            current->pages[pageIndex] = new Entry[PAGE_SIZE];
+        }
     }
 
     /**
-     * Before this is called make sure there is no duplicate of @a text in
-     * the interns set.
+     * Finds the table slot of a string.
      *
-     * @param text  Text string to add to the interned strings. A copy is
-     *              made of this.
+     * @return Slot index, or -1 if the string is not in the pool.
      */
-    InternalId copyAndAssignUniqueId(String const &text)
+    dint findSlot(String const &text, duint32 hash) const
     {
-        CaselessString *str = new CaselessString(text);
+        if(table.isEmpty()) return -1;
 
-        // This is a new string that is added to the pool.
-        interns.insert(str); // O(log n)
+        dint const mask = table.size() - 1;
+        Slot const *slots = table.constData();
+        for(dint i = hash & mask; slots[i].id; i = (i + 1) & mask)
+        {
+            // The strings are only compared if the hashes match.
+            if(slots[i].hash == hash &&
+               !entry(IMPORT_ID(slots[i].id)).str.compare(text, Qt::CaseInsensitive))
+            {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    Id find(String const &text) const
+    {
+        dint const pos = findSlot(text, caselessHash(text));
+        return (pos >= 0? table.at(pos).id : 0);
+    }
+
+    /// Makes sure the table has room for one more string.
+    void reserveTable()
+    {
+        // Keep the load factor at or below 1/2.
+        if(2 * (count + 1) > dsize(table.size()))
+        {
+            rebuildTable(de::max(MIN_HASH_SIZE, 2 * table.size()));
+        }
+    }
+
+    void insertToTable(Id id, duint32 hash)
+    {
+        dint const mask = table.size() - 1;
+        dint i = hash & mask;
+        while(table.at(i).id) i = (i + 1) & mask;
+        table[i].hash = hash;
+        table[i].id   = id;
+    }
 
-        return assignUniqueId(str);
+    void removeFromTable(dint pos)
+    {
+        dint const mask = table.size() - 1;
+        for(dint next = (pos + 1) & mask; table.at(next).id; next = (next + 1) & mask)
+        {
+            dint const home = table.at(next).hash & mask;
+            bool const reachable = (pos <= next? (pos < home && home <= next)
+                                               : (pos < home || home <= next));
+            if(!reachable)
+            {
+                table[pos] = table.at(next);
+                pos = next;
+            }
+        }
+        table[pos] = Slot();
     }
 
-    InternalId assignUniqueId(CaselessString *str) // O(1)
+    void rebuildTable(dint size)
+    {
+        table = QVector<Slot>(size);
+        dint const mask = size - 1;
+        for(InternalId id = 0; id < idCount; ++id)
+        {
+            Entry const &ent = entry(id);
+            if(!ent.inUse) continue;
+
+            dint i = ent.hash & mask;
+            while(table.at(i).id) i = (i + 1) & mask;
+            table[i].hash = ent.hash;
+            table[i].id   = EXPORT_ID(id);
+        }
+    }
+
+    /**
+     * Before this is called make sure there is no duplicate of @a text in
+     * the pool.
+     *
+     * @param text  Text string to add to the interned strings. A copy is
+     *              made of this.
+     * @param hash  Case-folded hash of @a text.
+     */
+    InternalId copyAndAssignUniqueId(String const &text, duint32 hash)
     {
         InternalId idx;
 
+        reserveTable();
+
         // Any available ids in the shortlist?
         if(!available.empty()) // O(1)
         {
             idx = available.front();
             available.pop_front();
-            idMap[idx] = str;
         }
         else
         {
-            if(idMap.size() >= MAXIMUM_VALID_ID)
+            if(idCount >= MAXIMUM_VALID_ID)
             {
                 throw StringPool::FullError("StringPool::assignUniqueId",
                                             "Out of valid 32-bit identifiers");
             }
-
-            // Expand the idMap.
-            idx = InternalId(idMap.size());
-            idMap.push_back(str); // O(1) (amortized)
+            idx = idCount;
+            reserveEntry(idx);
+            idCount++;
         }
-        str->setId(idx);
+
+        Entry &ent = entry(idx);
+        ent.str   = text;
+        ent.hash  = hash;
+        ent.inUse = true;
+
+        insertToTable(EXPORT_ID(idx), hash);
 
         // We have one more logical string in the pool.
         count++;
@@ -253,24 +365,14 @@ DENG2_PIMPL_NOREF(StringPool)
         return idx;
     }
 
-    void releaseAndDestroy(InternalId id, Interns::iterator *iterToErase = 0)
+    void releaseAndDestroy(dint slot)
     {
-        DENG2_ASSERT(id < idMap.size());
+        InternalId const id = IMPORT_ID(table.at(slot).id);
 
-        CaselessString *interned = idMap[id];
-        DENG2_ASSERT(interned != 0);
-
-        idMap[id] = 0;
+        removeFromTable(slot);
+        entry(id).release();
         available.push_back(id);
 
-        // Delete the string itself, no one refers to it any more.
-        delete interned;
-
-        // If the caller already located the interned string, let's use it
-        // to erase the string in O(1) time. Otherwise it's up to the
-        // caller to make sure it gets removed from the interns.
-        if(iterToErase) interns.erase(*iterToErase); // O(1) (amortized)
-
         // One less string.
         count--;
         assertCount();
@@ -291,95 +393,94 @@ StringPool::StringPool(String const *strings, uint count) : d(new Instance)
 
 void StringPool::clear()
 {
+    DENG2_GUARD(d);
     d->clear();
 }
 
 bool StringPool::empty() const
 {
+    DENG2_GUARD(d);
     d->assertCount();
     return !d->count;
 }
 
 dsize StringPool::size() const
 {
+    DENG2_GUARD(d);
     d->assertCount();
     return d->count;
 }
 
 StringPool::Id StringPool::intern(String str)
 {
-    Interns::iterator found = d->findIntern(str); // O(log n)
-    if(found != d->interns.end())
+    DENG2_GUARD(d);
+
+    duint32 const hash = caselessHash(str);
+    dint const found = d->findSlot(str, hash); // O(1)
+    if(found >= 0)
     {
         // Already got this one.
-        return EXPORT_ID(found->id());
+        return d->table.at(found).id;
     }
-    return EXPORT_ID(d->copyAndAssignUniqueId(str)); // O(log n)
+    return EXPORT_ID(d->copyAndAssignUniqueId(str, hash)); // O(1) (amortized)
 }
 
 String StringPool::internAndRetrieve(String str)
 {
+    DENG2_GUARD(d);
+
     InternalId id = IMPORT_ID(intern(str));
-    return *d->idMap[id];
+    return d->entry(id).str;
 }
 
 void StringPool::setUserValue(Id id, uint value)
 {
     if(id == 0) return;
 
-    InternalId const internalId = IMPORT_ID(id);
+    DENG2_GUARD(d);
 
-    DENG2_ASSERT(internalId < d->idMap.size());
-    DENG2_ASSERT(d->idMap[internalId] != 0);
+    Entry *ent = d->usedEntry(id);
+    DENG2_ASSERT(ent != 0);
 
-    d->idMap[internalId]->setUserValue(value); // O(1)
+    ent->userValue = value; // O(1)
 }
 
 uint StringPool::userValue(Id id) const
 {
     if(id == 0) return 0;
 
-    InternalId const internalId = IMPORT_ID(id);
-
-    DENG2_ASSERT(internalId < d->idMap.size());
-    DENG2_ASSERT(d->idMap[internalId] != 0);
+    Entry const &ent = d->entry(IMPORT_ID(id));
+    DENG2_ASSERT(ent.inUse);
 
-    return d->idMap[internalId]->userValue(); // O(1)
+    return ent.userValue; // O(1)
 }
 
 void StringPool::setUserPointer(Id id, void *ptr)
 {
     if(id == 0) return;
 
-    InternalId const internalId = IMPORT_ID(id);
+    DENG2_GUARD(d);
 
-    DENG2_ASSERT(internalId < d->idMap.size());
-    DENG2_ASSERT(d->idMap[internalId] != 0);
+    Entry *ent = d->usedEntry(id);
+    DENG2_ASSERT(ent != 0);
 
-    d->idMap[internalId]->setUserPointer(ptr); // O(1)
+    ent->userPointer = ptr; // O(1)
 }
 
 void *StringPool::userPointer(Id id) const
 {
     if(id == 0) return NULL;
 
-    InternalId const internalId = IMPORT_ID(id);
+    Entry const &ent = d->entry(IMPORT_ID(id));
+    DENG2_ASSERT(ent.inUse);
 
-    DENG2_ASSERT(internalId < d->idMap.size());
-    DENG2_ASSERT(d->idMap[internalId] != 0);
-
-    return d->idMap[internalId]->userPointer(); // O(1)
+    return ent.userPointer; // O(1)
 }
 
 StringPool::Id StringPool::isInterned(String str) const
 {
-    Interns::const_iterator found = d->findIntern(str); // O(log n)
-    if(found != d->interns.end())
-    {
-        return EXPORT_ID(found->id());
-    }
-    // Not found.
-    return 0;
+    DENG2_GUARD(d);
+    return d->find(str); // O(1)
 }
 
 String StringPool::string(Id id) const
@@ -398,17 +499,18 @@ String const &StringPool::stringRef(StringPool::Id id) const
         return emptyString;
     }
 
-    InternalId const internalId = IMPORT_ID(id);
-    DENG2_ASSERT(internalId < d->idMap.size());
-    return *d->idMap[internalId];
+    // No locking: entries are never moved while the pool exists.
+    return d->entry(IMPORT_ID(id)).str;
 }
 
 bool StringPool::remove(String str)
 {
-    Interns::iterator found = d->findIntern(str); // O(log n)
-    if(found != d->interns.end())
+    DENG2_GUARD(d);
+
+    dint const found = d->findSlot(str, caselessHash(str)); // O(1)
+    if(found >= 0)
     {
-        d->releaseAndDestroy(found->id(), &found); // O(1) (amortized)
+        d->releaseAndDestroy(found); // O(1)
         return true;
     }
     return false;
@@ -416,25 +518,25 @@ bool StringPool::remove(String str)
 
 bool StringPool::removeById(Id id)
 {
-    if(id == 0) return false;
+    DENG2_GUARD(d);
 
-    InternalId const internalId = IMPORT_ID(id);
-    if(id >= d->idMap.size()) return false;
+    Entry const *ent = d->usedEntry(id);
+    if(!ent) return false;
 
-    CaselessString *str = d->idMap[internalId];
-    if(!str) return false;
-
-    d->interns.erase(str); // O(log n)
-    d->releaseAndDestroy(str->id());
+    dint const found = d->findSlot(ent->str, ent->hash); // O(1)
+    DENG2_ASSERT(found >= 0);
+    d->releaseAndDestroy(found);
     return true;
 }
 
 int StringPool::iterate(int (*callback)(Id, void *), void *data) const
 {
     if(!callback) return 0;
-    for(uint i = 0; i < d->idMap.size(); ++i)
+
+    DENG2_GUARD(d);
+    for(uint i = 0; i < d->idCount; ++i)
     {
-        if(!d->idMap[i]) continue;
+        if(!d->entry(i).inUse) continue;
         int result = callback(EXPORT_ID(i), data);
         if(result) return result;
     }
@@ -444,47 +546,81 @@ int StringPool::iterate(int (*callback)(Id, void *), void *data) const
 // Implements ISerializable.
 void StringPool::operator >> (Writer &to) const
 {
+    DENG2_GUARD(d);
+
     // Number of strings altogether (includes unused ids).
-    to << duint32(d->idMap.size());
+    to << duint32(d->idCount);
+
+    // The interns are written in case-insensitive alphabetical order.
+    std::vector<InternalId> sorted;
+    sorted.reserve(d->count);
+    for(InternalId i = 0; i < d->idCount; ++i)
+    {
+        if(d->entry(i).inUse) sorted.push_back(i);
+    }
+    std::sort(sorted.begin(), sorted.end(), [this] (InternalId a, InternalId b) {
+        return d->entry(a).str.compare(d->entry(b).str, Qt::CaseInsensitive) < 0;
+    });
 
     // Write the interns.
-    to << duint32(d->interns.size());
-    for(Interns::const_iterator i = d->interns.begin(); i != d->interns.end(); ++i)
+    to << duint32(sorted.size());
+    for(InternalId id : sorted)
     {
-        to << *i->toStr();
+        Entry const &ent = d->entry(id);
+        to << ent.str << duint32(id) << duint32(ent.userValue);
     }
 }
 
 void StringPool::operator << (Reader &from)
 {
-    clear();
+    DENG2_GUARD(d);
+
+    d->clear();
 
     // Read the number of total number of strings.
     uint numStrings;
     from >> numStrings;
-    d->idMap.resize(numStrings, 0);
+    for(InternalId i = 0; i < numStrings; i += PAGE_SIZE)
+    {
+        d->reserveEntry(i);
+    }
+    d->idCount = numStrings;
 
     // Read the interns.
     uint numInterns;
     from >> numInterns;
     while(numInterns--)
     {
-        CaselessString *str = new CaselessString;
-        from >> *str;
-        d->interns.insert(str);
+        String text;
+        duint32 id, userValue;
+        from >> text >> id >> userValue;
+        if(id >= numStrings)
+        {
+            /// @throws InvalidIdError Serialized identifier is out of range.
+            throw InvalidIdError("StringPool::operator <<",
+                                 "Serialized string has an invalid identifier");
+        }
 
-        // Update the id map.
-        d->idMap[str->id()] = str;
+        Entry &ent = d->entry(id);
+        ent.str       = text;
+        ent.hash      = caselessHash(text);
+        ent.userValue = userValue;
+        ent.inUse     = true;
 
         d->count++;
     }
 
     // Update the available ids.
-    for(uint i = 0; i < d->idMap.size(); ++i)
+    for(InternalId i = 0; i < d->idCount; ++i)
     {
-        if(!d->idMap[i]) d->available.push_back(i);
+        if(!d->entry(i).inUse) d->available.push_back(i);
     }
 
+    // Index the strings.
+    dint size = MIN_HASH_SIZE;
+    while(dsize(size) < 2 * d->count) size *= 2;
+    d->rebuildTable(size);
+
     d->assertCount();
 }
 
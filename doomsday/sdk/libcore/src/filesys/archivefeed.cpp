@@ -158,6 +158,7 @@ DENG2_PIMPL(ArchiveFeed)
         Archive::Names names;
         archive().listFiles(names, basePath);
 
+        FileIndex::Files added;
         DENG2_FOR_EACH(Archive::Names, i, names)
         {
             if(folder.has(*i))
@@ -183,10 +184,12 @@ DENG2_PIMPL(ArchiveFeed)
             // We will decide on pruning this.
             f->setOriginFeed(&self);
 
-            // Include the file in the main index.
-            folder.fileSystem().index(*f);
+            added << f;
         }
 
+        // Include the files in the main index.
+        folder.fileSystem().indexAll(added);
+
         // Also populate subfolders.
         archive().listFolders(names, basePath);
 
@@ -20,6 +20,7 @@
 #include "de/DirectoryFeed"
 #include "de/Folder"
 #include "de/NativeFile"
+#include "de/NativeDirectoryIndex"
 #include "de/FS"
 #include "de/Date"
 #include "de/App"
@@ -63,6 +64,11 @@ void DirectoryFeed::populate(Folder &folder)
         /// @throw NotFoundError The native directory was not accessible.
         throw NotFoundError("DirectoryFeed::populate", "Path '" + _nativePath + "' inaccessible");
     }
+    // Earlier interpretation results are valid for files that haven't changed.
+    NativeDirectoryIndex &dirIndex = folder.fileSystem().nativeDirectoryIndex();
+    NativeDirectoryIndex::Entries const known = dirIndex.entries(_nativePath);
+    NativeDirectoryIndex::Entries current;
+
     QStringList nameFilters;
     nameFilters << "*";
     foreach(QFileInfo entry,
@@ -74,9 +80,23 @@ void DirectoryFeed::populate(Folder &folder)
         }
         else
         {
-            populateFile(folder, entry.fileName());
+            // The listing already provides the status of the file.
+            NativeDirectoryIndex::Entry indexed;
+            indexed.status = File::Status(entry.size(), entry.lastModified());
+
+            String knownType;
+            NativeDirectoryIndex::Entries::const_iterator found = known.constFind(entry.fileName());
+            if(found != known.constEnd() && found.value().status == indexed.status)
+            {
+                knownType = found.value().type;
+            }
+
+            indexed.type = populateFile(folder, entry.fileName(), indexed.status, knownType);
+            current.insert(entry.fileName(), indexed);
         }
     }
+
+    dirIndex.setEntries(_nativePath, current);
 }
 
 void DirectoryFeed::populateSubFolder(Folder &folder, String const &entryName)
@@ -99,25 +119,35 @@ void DirectoryFeed::populateSubFolder(Folder &folder, String const &entryName)
     }
 }
 
-void DirectoryFeed::populateFile(Folder &folder, String const &entryName)
+String DirectoryFeed::populateFile(Folder &folder, String const &entryName,
+                                   File::Status const &status, String const &knownType)
 {
-    if(folder.has(entryName))
+    if(File *existing = folder.tryLocateFile(entryName))
     {
         // Already has an entry for this, skip it (wasn't pruned so it's OK).
-        return;
+        return DENG2_TYPE_NAME(*existing);
     }
 
     NativePath entryPath = _nativePath / entryName;
 
     // Open the native file.
     std::auto_ptr<NativeFile> nativeFile(new NativeFile(entryName, entryPath));
-    nativeFile->setStatus(fileStatus(entryPath));
+    nativeFile->setStatus(status);
     if(_mode & AllowWrite)
     {
         nativeFile->setMode(File::Write);
     }
 
-    File *file = folder.fileSystem().interpret(nativeFile.release());
+    File *file = 0;
+    if(knownType == DENG2_TYPE_NAME(NativeFile))
+    {
+        // Unchanged since it was last found not to be interpretable.
+        file = nativeFile.release();
+    }
+    else
+    {
+        file = folder.fileSystem().interpret(nativeFile.release());
+    }
     folder.add(file);
 
     // We will decide on pruning this.
@@ -125,6 +155,8 @@ void DirectoryFeed::populateFile(Folder &folder, String const &entryName)
 
     // Include files in the main index.
     folder.fileSystem().index(*file);
+
+    return DENG2_TYPE_NAME(*file);
 }
 
 bool DirectoryFeed::prune(File &file) const
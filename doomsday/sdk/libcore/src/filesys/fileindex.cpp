@@ -23,55 +23,161 @@
 
 namespace de {
 
+/// Minimum size of the hash table.
+static dint const MIN_TABLE_SIZE = 16;
+
 DENG2_PIMPL(FileIndex), public ReadWriteLockable
 {
     IPredicate const *predicate;
     Index index;
 
+    /// Hash of each entry in @a index.
+    std::vector<duint32> hashes;
+
+    /**
+     * Slot of the hash table, which refers to an entry of @a index. Linear
+     * probing is used; files with the same name occupy slots in the order
+     * they were added.
+     */
+    struct Slot {
+        duint32 hash;
+        dint pos; ///< Position in @a index, or -1 if the slot is free.
+        Slot() : hash(0), pos(-1) {}
+    };
+    std::vector<Slot> table; ///< Size is a power of two (or zero).
+
     Instance(Public *i)
         : Base(i)
         , predicate(0)
     {}
 
-    static String indexedName(File const &file)
+    dint mask() const
     {
-        return file.name().lower();
+        return dint(table.size()) - 1;
     }
 
-    void add(File const &file)
+    /**
+     * Resizes the hash table. The old table is walked in probe order starting
+     * from a free slot, so files with the same name remain in the same order.
+     */
+    void resizeTable(dint size)
     {
-        DENG2_GUARD_WRITE(this);
+        std::vector<Slot> old(size);
+        old.swap(table);
+
+        dint const oldCount = dint(old.size());
+        dint start = 0;
+        while(start < oldCount && old[start].pos >= 0) ++start;
 
-        index.insert(std::pair<String, File *>(indexedName(file), const_cast<File *>(&file)));
+        for(dint k = 0; k < oldCount; ++k)
+        {
+            Slot const &slot = old[(start + k) % oldCount];
+            if(slot.pos >= 0) insertToTable(slot.hash, slot.pos);
+        }
     }
 
-    void remove(File const &file)
+    void reserve(dint count)
     {
-        DENG2_GUARD_WRITE(this);
+        // Keep the load factor at or below 1/2.
+        dint size = de::max(MIN_TABLE_SIZE, dint(table.size()));
+        while(2 * count > size) size *= 2;
+        if(size != dint(table.size()))
+        {
+            resizeTable(size);
+        }
+        index.reserve(count);
+        hashes.reserve(count);
+    }
+
+    void insertToTable(duint32 hash, dint pos)
+    {
+        dint i = hash & mask();
+        while(table[i].pos >= 0) i = (i + 1) & mask();
+        table[i].hash = hash;
+        table[i].pos  = pos;
+    }
 
-        if(index.empty())
+    /// Finds the table slot that refers to the entry at @a pos.
+    dint findSlotOfEntry(dint pos) const
+    {
+        for(dint i = hashes[pos] & mask(); table[i].pos >= 0; i = (i + 1) & mask())
         {
-            return;
+            if(table[i].pos == pos) return i;
         }
+        return -1;
+    }
 
-        // Look up the ones that might be this file.
-        IndexRange range = index.equal_range(indexedName(file));
+    /// Finds the table slot that refers to @a file.
+    dint findSlotOfFile(File const &file, duint32 hash) const
+    {
+        if(table.empty()) return -1;
+        for(dint i = hash & mask(); table[i].pos >= 0; i = (i + 1) & mask())
+        {
+            if(table[i].hash == hash && index[table[i].pos].second == &file) return i;
+        }
+        return -1;
+    }
 
-        for(Index::iterator i = range.first; i != range.second; ++i)
+    void removeSlot(dint pos)
+    {
+        // Shift the following slots of the probe sequence backwards so that
+        // no tombstones are needed.
+        dint const m = mask();
+        for(dint next = (pos + 1) & m; table[next].pos >= 0; next = (next + 1) & m)
         {
-            if(i->second == &file)
+            dint const home = table[next].hash & m;
+            bool const reachable = (pos <= next? (pos < home && home <= next)
+                                               : (pos < home || home <= next));
+            if(!reachable)
             {
-                // This is the one to deindex.
-                index.erase(i);
-                break;
+                table[pos] = table[next];
+                pos = next;
             }
         }
+        table[pos] = Slot();
+    }
+
+    void add(File const &file)
+    {
+        String const name = file.name();
+        duint32 const hash = hashName(name);
+        dint const pos = dint(index.size());
+
+        if(2 * (pos + 1) > dint(table.size()))
+        {
+            reserve(de::max(pos + 1, 2 * pos));
+        }
+        index.push_back(Entry(name, const_cast<File *>(&file)));
+        hashes.push_back(hash);
+        insertToTable(hash, pos);
+    }
+
+    void remove(File const &file)
+    {
+        DENG2_GUARD_WRITE(this);
+
+        dint const slot = findSlotOfFile(file, hashName(file.name()));
+        if(slot < 0) return;
+
+        dint const pos = table[slot].pos;
+        removeSlot(slot);
+
+        // Fill the gap with the last entry.
+        dint const last = dint(index.size()) - 1;
+        if(pos != last)
+        {
+            table[findSlotOfEntry(last)].pos = pos;
+            index[pos]  = index[last];
+            hashes[pos] = hashes[last];
+        }
+        index.pop_back();
+        hashes.pop_back();
     }
 
     void findPartialPath(String const &path, FoundFiles &found) const
     {
-        String baseName = path.fileName().lower();
-        String dir      = path.fileNamePath().lower();
+        String const baseName = path.fileName();
+        String dir = path.fileNamePath();
 
         if(!dir.empty() && !dir.beginsWith("/"))
         {
@@ -79,15 +185,21 @@ DENG2_PIMPL(FileIndex), public ReadWriteLockable
             dir = "/" + dir;
         }
 
+        duint32 const hash = hashName(baseName);
+
         DENG2_GUARD_READ(this);
 
-        ConstIndexRange range = index.equal_range(baseName);
-        for(Index::const_iterator i = range.first; i != range.second; ++i)
+        if(table.empty()) return;
+
+        for(dint i = hash & mask(); table[i].pos >= 0; i = (i + 1) & mask())
         {
-            File *file = i->second;
-            if(file->path().fileNamePath().endsWith(dir, Qt::CaseInsensitive))
+            if(table[i].hash != hash) continue;
+
+            Entry const &entry = index[table[i].pos];
+            if(!entry.first.compareWithoutCase(baseName) &&
+               entry.second->path().fileNamePath().endsWith(dir, Qt::CaseInsensitive))
             {
-                found.push_back(file);
+                found.push_back(entry.second);
             }
         }
     }
@@ -114,7 +226,10 @@ bool FileIndex::maybeAdd(File const &file)
         return false;
     }
 
-    d->add(file);
+    {
+        DENG2_GUARD_WRITE(d);
+        d->add(file);
+    }
 
     // Notify audience.
     DENG2_FOR_AUDIENCE2(Addition, i)
@@ -125,6 +240,39 @@ bool FileIndex::maybeAdd(File const &file)
     return true;
 }
 
+int FileIndex::maybeAddAll(Files const &files)
+{
+    Files included;
+    foreach(File *file, files)
+    {
+        if(!d->predicate || d->predicate->shouldIncludeInIndex(*file))
+        {
+            included << file;
+        }
+    }
+    if(included.isEmpty()) return 0;
+
+    {
+        DENG2_GUARD_WRITE(d);
+        d->reserve(dint(d->index.size()) + included.size());
+        foreach(File *file, included)
+        {
+            d->add(*file);
+        }
+    }
+
+    // Notify audience.
+    foreach(File *file, included)
+    {
+        DENG2_FOR_AUDIENCE2(Addition, i)
+        {
+            i->fileAdded(*file, *this);
+        }
+    }
+
+    return included.size();
+}
+
 void FileIndex::remove(File const &file)
 {
     d->remove(file);
@@ -141,6 +289,18 @@ int FileIndex::size() const
     return int(d->index.size());
 }
 
+duint32 FileIndex::hashName(String const &name)
+{
+    // FNV-1a of the case-folded UTF-16 code units.
+    duint32 hash = 2166136261u;
+    for(int i = 0; i < name.size(); ++i)
+    {
+        hash ^= name.at(i).toCaseFolded().unicode();
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
 static bool fileNotInAnyLoadedPackage(File *file)
 {
     String const identifier = Package::identifierForContainerOfFile(*file);
@@ -33,7 +33,7 @@ namespace de {
 
 static FileIndex const emptyIndex; // never contains any files
 
-DENG2_PIMPL_NOREF(FileSystem)
+DENG2_PIMPL_NOREF(FileSystem), public Lockable
 {
     /// The main index to all files in the file system.
     FileIndex index;
@@ -45,6 +45,9 @@ DENG2_PIMPL_NOREF(FileSystem)
 
     QSet<FileIndex *> userIndices; // not owned
 
+    /// Contents of native directories, saved between sessions.
+    NativeDirectoryIndex nativeDirs;
+
     /// The root folder of the entire file system.
     Folder root;
 
@@ -265,6 +268,9 @@ File &FileSystem::find(String const &path) const
 
 void FileSystem::index(File &file)
 {
+    // Folders may be populated concurrently.
+    DENG2_GUARD(d);
+
     d->index.maybeAdd(file);
 
     // Also make an entry in the type index.
@@ -282,8 +288,41 @@ void FileSystem::index(File &file)
     }
 }
 
+void FileSystem::indexAll(FileIndex::Files const &files)
+{
+    if(files.isEmpty()) return;
+
+    DENG2_GUARD(d);
+
+    d->index.maybeAddAll(files);
+
+    // Group the files by type for the type indices.
+    typedef QHash<String, FileIndex::Files> FilesByType;
+    FilesByType byType;
+    foreach(File *file, files)
+    {
+        byType[DENG2_TYPE_NAME(*file)] << file;
+    }
+    DENG2_FOR_EACH_CONST(FilesByType, i, byType)
+    {
+        if(!d->typeIndex.contains(i.key()))
+        {
+            d->typeIndex.insert(i.key(), new FileIndex);
+        }
+        d->typeIndex[i.key()]->maybeAddAll(i.value());
+    }
+
+    // Also offer to custom indices.
+    foreach(FileIndex *user, d->userIndices)
+    {
+        user->maybeAddAll(files);
+    }
+}
+
 void FileSystem::deindex(File &file)
 {
+    DENG2_GUARD(d);
+
     d->index.remove(file);
 
     String const typeName = DENG2_TYPE_NAME(file);
@@ -299,6 +338,11 @@ void FileSystem::deindex(File &file)
     }
 }
 
+NativeDirectoryIndex &FileSystem::nativeDirectoryIndex()
+{
+    return d->nativeDirs;
+}
+
 File &FileSystem::copySerialized(String const &sourcePath, String const &destinationPath,
                                  CopyBehaviors behavior)
 {
@@ -330,6 +374,8 @@ void FileSystem::timeChanged(Clock const &)
 
 FileIndex const &FileSystem::indexFor(String const &typeName) const
 {
+    DENG2_GUARD(d);
+
     Instance::TypeIndex::const_iterator found = d->typeIndex.constFind(typeName);
     if(found != d->typeIndex.constEnd())
     {
@@ -340,11 +386,13 @@ FileIndex const &FileSystem::indexFor(String const &typeName) const
 
 void FileSystem::addUserIndex(FileIndex &userIndex)
 {
+    DENG2_GUARD(d);
     d->userIndices.insert(&userIndex);
 }
 
 void FileSystem::removeUserIndex(FileIndex &userIndex)
 {
+    DENG2_GUARD(d);
     d->userIndices.remove(&userIndex);
 }
 
@@ -18,14 +18,74 @@
  */
 
 #include "de/Folder"
+#include "de/DirectoryFeed"
 #include "de/Feed"
 #include "de/FS"
 #include "de/NumberValue"
 #include "de/Log"
 #include "de/Guard"
+#include "de/Task"
+#include "de/TaskPool"
+
+#include <QList>
+#include <exception>
+#include <typeinfo>
 
 namespace de {
 
+namespace internal {
+
+/**
+ * Collects the exception thrown by the first failed population task, so that
+ * it can be rethrown in the thread that started the population.
+ */
+struct PopulationErrors : public Lockable
+{
+    std::exception_ptr first;
+
+    void catchCurrent()
+    {
+        DENG2_GUARD(this);
+        if(!first) first = std::current_exception();
+    }
+
+    void rethrow()
+    {
+        if(first) std::rethrow_exception(first);
+    }
+};
+
+/**
+ * Populates a single folder (without descending into subfolders) in a
+ * background thread.
+ */
+class PopulateFolderTask : public Task
+{
+public:
+    PopulateFolderTask(Folder &folder, PopulationErrors &errors)
+        : _folder(folder), _errors(errors) {}
+
+    void runTask()
+    {
+        try
+        {
+            _folder.populate(Folder::PopulateOnlyThisFolder);
+        }
+        catch(...)
+        {
+            _errors.catchCurrent();
+        }
+    }
+
+private:
+    Folder &_folder;
+    PopulationErrors &_errors;
+};
+
+} // namespace internal
+
+using namespace internal;
+
 DENG2_PIMPL_NOREF(Folder)
 {
     /// A map of file names to file instances.
@@ -33,6 +93,84 @@ DENG2_PIMPL_NOREF(Folder)
 
     /// Feeds provide content for the folder.
     Feeds feeds;
+
+    static QList<Folder *> subfoldersOf(Folder const &folder)
+    {
+        DENG2_GUARD(folder);
+
+        QList<Folder *> subs;
+        for(Contents::const_iterator i = folder.d->contents.begin(); i != folder.d->contents.end(); ++i)
+        {
+            if(Folder *sub = i->second->maybeAs<Folder>())
+            {
+                subs << sub;
+            }
+        }
+        return subs;
+    }
+
+    /**
+     * Empty plain folders whose contents come only from native directories do
+     * not depend on anything outside their own subtree, so they can be
+     * populated concurrently with each other. Other kinds of folders (e.g.,
+     * archives) may notify observers during population, and pruning existing
+     * files may do the same, so those are populated in the calling thread.
+     */
+    static bool canPopulateConcurrently(Folder const &folder)
+    {
+        if(typeid(folder) != typeid(Folder)) return false;
+
+        DENG2_GUARD(folder);
+        if(folder.d->feeds.empty() || !folder.d->contents.empty()) return false;
+        DENG2_FOR_EACH_CONST(Feeds, i, folder.d->feeds)
+        {
+            if(!(*i)->maybeAs<DirectoryFeed>()) return false;
+        }
+        return true;
+    }
+
+    /**
+     * Populates all the subfolders of @a folder, one level of the tree at a
+     * time. The folders of each level are independent of each other, so they
+     * are distributed to the background task pool. Each folder is only locked
+     * while it is itself being populated.
+     */
+    static void populateSubtrees(Folder const &folder)
+    {
+        QList<Folder *> level = subfoldersOf(folder);
+        while(!level.isEmpty())
+        {
+            PopulationErrors errors;
+            {
+                TaskPool tasks;
+                foreach(Folder *sub, level)
+                {
+                    if(level.size() > 1 && canPopulateConcurrently(*sub))
+                    {
+                        tasks.start(new PopulateFolderTask(*sub, errors));
+                        continue;
+                    }
+                    try
+                    {
+                        sub->populate(PopulateOnlyThisFolder);
+                    }
+                    catch(...)
+                    {
+                        errors.catchCurrent();
+                    }
+                }
+                tasks.waitForDone();
+            }
+            errors.rethrow();
+
+            QList<Folder *> next;
+            foreach(Folder *sub, level)
+            {
+                next << subfoldersOf(*sub);
+            }
+            level = next;
+        }
+    }
 };
 
 Folder::Folder(String const &name) : File(name), d(new Instance)
@@ -138,71 +276,68 @@ void Folder::clear()
 
 void Folder::populate(PopulationBehavior behavior)
 {
-    DENG2_GUARD(this);
-
     LOG_AS("Folder");
-    
-    // Prune the existing files first.
-    for(Contents::iterator i = d->contents.begin(); i != d->contents.end(); )
+
     {
-        // By default we will NOT prune if there are no feeds attached to the folder.
-        // In this case the files were probably created manually, so we shouldn't
-        // touch them.
-        bool mustPrune = false;
-
-        File *file = i->second;
-        
-        // If the file has a designated feed, ask it about pruning.
-        if(file->originFeed() && file->originFeed()->prune(*file))
-        {
-            LOG_RES_XVERBOSE("Pruning \"%s\" due to origin feed %s") << file->path() << file->originFeed()->description();
-            mustPrune = true;
-        }
-        else if(!file->originFeed())
+        DENG2_GUARD(this);
+
+        // Prune the existing files first.
+        for(Contents::iterator i = d->contents.begin(); i != d->contents.end(); )
         {
-            // There is no designated feed, ask all feeds of this folder.
-            // If even one of the feeds thinks that the file is out of date,
-            // it will be pruned.
-            for(Feeds::iterator f = d->feeds.begin(); f != d->feeds.end(); ++f)
+            // By default we will NOT prune if there are no feeds attached to the folder.
+            // In this case the files were probably created manually, so we shouldn't
+            // touch them.
+            bool mustPrune = false;
+
+            File *file = i->second;
+
+            // If the file has a designated feed, ask it about pruning.
+            if(file->originFeed() && file->originFeed()->prune(*file))
+            {
+                LOG_RES_XVERBOSE("Pruning \"%s\" due to origin feed %s") << file->path() << file->originFeed()->description();
+                mustPrune = true;
+            }
+            else if(!file->originFeed())
             {
-                if((*f)->prune(*file))
+                // There is no designated feed, ask all feeds of this folder.
+                // If even one of the feeds thinks that the file is out of date,
+                // it will be pruned.
+                for(Feeds::iterator f = d->feeds.begin(); f != d->feeds.end(); ++f)
                 {
-                    LOG_RES_XVERBOSE("Pruning %s due to non-origin feed %s")
-                            << file->path() << (*f)->description();
-                    mustPrune = true;
-                    break;
+                    if((*f)->prune(*file))
+                    {
+                        LOG_RES_XVERBOSE("Pruning %s due to non-origin feed %s")
+                                << file->path() << (*f)->description();
+                        mustPrune = true;
+                        break;
+                    }
                 }
             }
-        }
 
-        if(mustPrune)
-        {
-            // It needs to go.
-            d->contents.erase(i++);
-            delete file;
+            if(mustPrune)
+            {
+                // It needs to go.
+                d->contents.erase(i++);
+                delete file;
+            }
+            else
+            {
+                ++i;
+            }
         }
-        else
+
+        // Populate with new/updated ones.
+        for(Feeds::reverse_iterator i = d->feeds.rbegin(); i != d->feeds.rend(); ++i)
         {
-            ++i;
+            (*i)->populate(*this);
         }
     }
-    
-    // Populate with new/updated ones.
-    for(Feeds::reverse_iterator i = d->feeds.rbegin(); i != d->feeds.rend(); ++i)
-    {
-        (*i)->populate(*this);
-    }
-    
+
     if(behavior == PopulateFullTree)
     {
-        // Call populate on subfolders.
-        for(Contents::iterator i = d->contents.begin(); i != d->contents.end(); ++i)
-        {
-            if(Folder *folder = i->second->maybeAs<Folder>())
-            {
-                folder->populate();
-            }
-        }
+        // The lock on this folder is not held while the subfolders are being
+        // populated in other threads.
+        Instance::populateSubtrees(*this);
     }
 }
 
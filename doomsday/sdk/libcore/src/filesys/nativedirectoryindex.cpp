@@ -0,0 +1,169 @@
+/** @file nativedirectoryindex.cpp  Persistent index of native directory contents.
+ *
+ * @authors Copyright (c) 2015 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * LGPL: http://www.gnu.org/licenses/lgpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details. You should have received a copy of
+ * the GNU Lesser General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#include "de/NativeDirectoryIndex"
+#include "de/DirectoryFeed"
+#include "de/Reader"
+#include "de/Writer"
+#include "de/Log"
+
+#include <QFile>
+
+namespace de {
+
+static duint32 const FORMAT_MAGIC = 0x4e444958; // "NDIX"
+
+/**
+ * Revision of the index format. Increase this also when the interpretation of
+ * native files changes (e.g., a new type of archive is recognized), because the
+ * recorded interpretation results are then no longer valid.
+ */
+static duint16 const FORMAT_VERSION = 2;
+
+DENG2_PIMPL_NOREF(NativeDirectoryIndex), public Lockable
+{
+    typedef QHash<String, Entries> Directories;
+    Directories dirs;
+};
+
+NativeDirectoryIndex::NativeDirectoryIndex() : d(new Instance)
+{}
+
+void NativeDirectoryIndex::clear()
+{
+    DENG2_GUARD(d);
+    d->dirs.clear();
+}
+
+NativeDirectoryIndex::Entries NativeDirectoryIndex::entries(NativePath const &directory) const
+{
+    DENG2_GUARD(d);
+    return d->dirs.value(directory);
+}
+
+void NativeDirectoryIndex::setEntries(NativePath const &directory, Entries const &entries)
+{
+    DENG2_GUARD(d);
+    d->dirs.insert(directory, entries);
+}
+
+bool NativeDirectoryIndex::load(NativePath const &nativePath)
+{
+    LOG_AS("NativeDirectoryIndex");
+
+    clear();
+
+    QFile file(nativePath);
+    if(!file.open(QFile::ReadOnly)) return false;
+    Block const data = file.readAll();
+    file.close();
+
+    try
+    {
+        Reader(data) >> *this;
+        return true;
+    }
+    catch(Error const &er)
+    {
+        LOG_RES_VERBOSE("Ignoring %s: %s") << nativePath.pretty() << er.asText();
+        clear();
+    }
+    return false;
+}
+
+void NativeDirectoryIndex::save(NativePath const &nativePath) const
+{
+    LOG_AS("NativeDirectoryIndex");
+
+    Block data;
+    Writer(data) << *this;
+
+    NativePath const dir = nativePath.fileNamePath();
+    if(!dir.isEmpty() && !DirectoryFeed::exists(dir))
+    {
+        DirectoryFeed::createDir(dir);
+    }
+
+    QFile file(nativePath);
+    if(!file.open(QFile::WriteOnly | QFile::Truncate))
+    {
+        LOG_RES_WARNING("Failed to write %s") << nativePath.pretty();
+        return;
+    }
+    file.write(data);
+}
+
+void NativeDirectoryIndex::operator >> (Writer &to) const
+{
+    DENG2_GUARD(d);
+
+    to << FORMAT_MAGIC << FORMAT_VERSION;
+    to.withHeader();
+    to << duint32(d->dirs.size());
+
+    DENG2_FOR_EACH_CONST(Instance::Directories, dir, d->dirs)
+    {
+        to << dir.key() << duint32(dir.value().size());
+        DENG2_FOR_EACH_CONST(Entries, i, dir.value())
+        {
+            to << i.key()
+               << duint64(i.value().status.size)
+               << i.value().status.modifiedAt
+               << i.value().type;
+        }
+    }
+}
+
+void NativeDirectoryIndex::operator << (Reader &from)
+{
+    DENG2_GUARD(d);
+
+    d->dirs.clear();
+
+    duint32 magic;
+    duint16 version;
+    from >> magic >> version;
+    if(magic != FORMAT_MAGIC || version != FORMAT_VERSION)
+    {
+        /// @throw Error  The data is not in a supported format.
+        throw Error("NativeDirectoryIndex::operator <<", "Unsupported format");
+    }
+    from.withHeader();
+
+    duint32 dirCount;
+    from >> dirCount;
+    while(dirCount--)
+    {
+        String dirPath;
+        duint32 count;
+        from >> dirPath >> count;
+
+        Entries &entries = d->dirs[dirPath];
+        while(count--)
+        {
+            String name;
+            duint64 size;
+            Entry entry;
+            from >> name >> size >> entry.status.modifiedAt >> entry.type;
+            entry.status.size = dsize(size);
+            entries.insert(name, entry);
+        }
+    }
+}
+
+} // namespace de
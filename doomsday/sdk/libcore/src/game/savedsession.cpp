@@ -231,15 +231,17 @@ String SavedSession::Metadata::asTextWithInfoSyntax() const
         os << "\n" << BLOCK_GROUP << " ruleset {";
 
         Record const &rules = subrecord("gameRules");
-        DENG2_FOR_EACH_CONST(Record::Members, i, rules.members())
+        QList<String> names = rules.members().keys();
+        qSort(names);
+        foreach(String const &name, names)
         {
-            Value const &value = i.value()->value();
+            Value const &value = rules[name].value();
             String valueAsText = value.asText();
             if(value.is<Value::Text>())
             {
                 valueAsText = "\"" + valueAsText.replace("\"", "''") + "\"";
             }
-            os << "\n    " << BLOCK_GAMERULE << " \"" << i.key() << "\""
+            os << "\n    " << BLOCK_GAMERULE << " \"" << name << "\""
                << " { value= " << valueAsText << " }";
         }
 
@@ -51,6 +51,13 @@
  * - 1 byte: (payload size >> 7) | (0x40 for deflated, otherwise Huffman)
  * - @em n bytes: payload contents (as produced by ZipFile::compressAtLevel()).
  *
+ * If stream compression has been enabled for the connection, medium-sized
+ * messages may instead be deflated as part of a single zlib stream that
+ * continues from one message to the next (see Socket::DeflateStream). Each
+ * such message is flushed with Z_SYNC_FLUSH and the trailing empty stored
+ * block (00 00 FF FF) is omitted. These messages have both 0x40 and 0x20 set
+ * in the second header byte. The receiver must process them in order.
+ *
  * @par >= 4096 bytes (up to 4MB)
  * Large messages are compressed using the best zlib deflate level.
  * Message structure:
@@ -72,6 +79,10 @@
 #include "de/Reader"
 #include "de/data/huffman.h"
 
+#include <cstring>
+#include <memory>
+#include <zlib.h>
+
 namespace de {
 
 /// Maximum number of channels.
@@ -90,8 +101,9 @@ static int const MAX_SIZE_LARGE  = DENG2_SOCKET_MAX_PAYLOAD_SIZE;
 
 #define TRMF_CONTINUE           0x80
 #define TRMF_DEFLATED           0x40
+#define TRMF_STREAM             0x20
 #define TRMF_SIZE_MASK          0x7f
-#define TRMF_SIZE_MASK_MEDIUM   0x3f
+#define TRMF_SIZE_MASK_MEDIUM   0x1f
 #define TRMF_SIZE_SHIFT         7
 
 namespace internal {
@@ -104,9 +116,10 @@ struct MessageHeader : public ISerializable
     int size;
     bool isHuffmanCoded;
     bool isDeflated;
+    bool isStreamed; ///< Part of the connection's deflate stream.
     duint channel; /// @todo include in the written header
 
-    MessageHeader() : size(0), isHuffmanCoded(false), isDeflated(false), channel(0)
+    MessageHeader() : size(0), isHuffmanCoded(false), isDeflated(false), isStreamed(false), channel(0)
     {}
 
     void operator >> (Writer &writer) const
@@ -118,7 +131,8 @@ struct MessageHeader : public ISerializable
         else if(size <= MAX_SIZE_MEDIUM)
         {
             writer << dbyte(TRMF_CONTINUE | (size & TRMF_SIZE_MASK));
-            writer << dbyte((isDeflated? TRMF_DEFLATED : 0) | (size >> TRMF_SIZE_SHIFT));
+            writer << dbyte((isDeflated? TRMF_DEFLATED : 0) |
+                            (isStreamed? TRMF_STREAM   : 0) | (size >> TRMF_SIZE_SHIFT));
         }
         else if(size <= MAX_SIZE_LARGE)
         {
@@ -147,6 +161,7 @@ struct MessageHeader : public ISerializable
         size = b & TRMF_SIZE_MASK;
 
         isDeflated = false;
+        isStreamed = false;
         isHuffmanCoded = true;
 
         if(b & TRMF_CONTINUE) // More follows...
@@ -170,6 +185,7 @@ struct MessageHeader : public ISerializable
                 if(b & TRMF_DEFLATED)
                 {
                     isDeflated = true;
+                    isStreamed = (b & TRMF_STREAM) != 0;
                     isHuffmanCoded = false;
                 }
                 size |= ((b & TRMF_SIZE_MASK_MEDIUM) << TRMF_SIZE_SHIFT);
@@ -178,15 +194,212 @@ struct MessageHeader : public ISerializable
     }
 };
 
+/// Deflated stream messages end in an empty stored block, which is not sent.
+static char const SYNC_FLUSH_TAIL[] = { 0, 0, char(0xff), char(0xff) };
+static dsize const SYNC_FLUSH_TAIL_SIZE = 4;
+
+/// Bytes that Z_SYNC_FLUSH may add on top of deflateBound().
+static dsize const SYNC_FLUSH_MARGIN = 16;
+
+/**
+ * Receiving end of a connection's deflate stream.
+ */
+struct InflateStream
+{
+    z_stream stream;
+
+    InflateStream()
+    {
+        zap(stream);
+        if(inflateInit2(&stream, -MAX_WBITS) != Z_OK)
+        {
+            throw Socket::ProtocolError("InflateStream", "Failed to initialize zlib");
+        }
+    }
+
+    ~InflateStream()
+    {
+        inflateEnd(&stream);
+    }
+
+    Block inflate(Block const &deflated)
+    {
+        Block input = deflated;
+        input += Block(SYNC_FLUSH_TAIL, SYNC_FLUSH_TAIL_SIZE);
+
+        stream.next_in  = reinterpret_cast<Bytef *>(input.data());
+        stream.avail_in = uInt(input.size());
+
+        Block output;
+        forever
+        {
+            dsize const pos = output.size();
+            output.resize(de::max(dsize(2 * MAX_SIZE_MEDIUM), 2 * pos));
+
+            stream.next_out  = reinterpret_cast<Bytef *>(output.data()) + pos;
+            stream.avail_out = uInt(output.size() - pos);
+
+            int const result = ::inflate(&stream, Z_SYNC_FLUSH);
+            output.resize(output.size() - stream.avail_out);
+
+            if(result != Z_OK && result != Z_BUF_ERROR)
+            {
+                throw Socket::ProtocolError("InflateStream::inflate", "Inflate failed");
+            }
+            if(!stream.avail_in && stream.avail_out)
+            {
+                // All of the message has been decompressed.
+                break;
+            }
+            if(output.size() > MAX_SIZE_LARGE)
+            {
+                throw Socket::ProtocolError("InflateStream::inflate", "Inflated payload is too large");
+            }
+        }
+        return output;
+    }
+};
+
+/**
+ * Encodes a message payload into the wire format (header and payload).
+ *
+ * @param packet  Payload.
+ * @param stream  Compression stream of the connection, or @c NULL.
+ */
+static Block encodeMessage(IByteArray const &packet, Socket::DeflateStream *stream)
+{
+    Block payload(packet);
+    Block huffData;
+    MessageHeader header;
+
+    // Let's find the appropriate compression method of the payload. First see
+    // if the encoded contents are under 128 bytes as Huffman codes.
+    if(payload.size() <= MAX_HUFFMAN_INPUT_SIZE) // Potentially short enough.
+    {
+        huffData = codec::huffmanEncode(payload);
+        if(int(huffData.size()) <= MAX_SIZE_SMALL)
+        {
+            // We'll use this.
+            header.isHuffmanCoded = true;
+            header.size = huffData.size();
+            payload = huffData;
+        }
+        // Even if that didn't seem suitable, we'll keep it to compare against
+        // the deflated payload.
+    }
+
+    if(!header.size && stream && stream->accepts(payload.size()))
+    {
+        // Continue the connection's deflate stream. The receiver's stream
+        // state must follow along, so this is now the payload regardless of
+        // how well the Huffman codes would have done.
+        payload = stream->deflate(payload);
+        header.isDeflated = true;
+        header.isStreamed = true;
+        header.size = payload.size();
+    }
+
+    if(!header.size) // Try deflate.
+    {
+        int const level = (payload.size() < 2*MAX_SIZE_MEDIUM? 6 /*default*/ : 9 /*best*/);
+        QByteArray deflated = qCompress(payload, level);
+
+        if(!deflated.size())
+        {
+            throw Socket::ProtocolError("Socket::send:", "Failed to deflate message payload");
+        }
+        if(deflated.size() > MAX_SIZE_LARGE)
+        {
+            throw Socket::ProtocolError("Socket::send",
+                                        QString("Compressed payload is too large (%1 bytes)").arg(deflated.size()));
+        }
+
+        // Choose the smallest compression.
+        if(huffData.size() && int(huffData.size()) <= deflated.size() && int(huffData.size()) <= MAX_SIZE_MEDIUM)
+        {
+            // Huffman yielded smaller payload.
+            header.isHuffmanCoded = true;
+            header.size = huffData.size();
+            payload = huffData;
+        }
+        else
+        {
+            // Use the deflated payload.
+            header.isDeflated = true;
+            header.size = deflated.size();
+            payload = deflated;
+        }
+    }
+
+    // Header followed by the payload.
+    Block encoded;
+    Writer(encoded) << header;
+    encoded += payload;
+    return encoded;
+}
+
 } // namespace internal
 
 using namespace internal;
 
-DENG2_PIMPL_NOREF(Socket)
+DENG2_PIMPL_NOREF(Socket::DeflateStream)
 {
-    Address target;
-    bool quiet;
+    z_stream stream;
+
+    Instance()
+    {
+        zap(stream);
+        if(deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8,
+                        Z_DEFAULT_STRATEGY) != Z_OK)
+        {
+            throw ProtocolError("Socket::DeflateStream", "Failed to initialize zlib");
+        }
+    }
+
+    ~Instance()
+    {
+        deflateEnd(&stream);
+    }
+};
+
+Socket::DeflateStream::DeflateStream() : d(new Instance)
+{}
+
+bool Socket::DeflateStream::accepts(dsize size) const
+{
+    return deflateBound(&d->stream, uLong(size)) + SYNC_FLUSH_MARGIN <= dsize(MAX_SIZE_MEDIUM);
+}
+
+Block Socket::DeflateStream::deflate(IByteArray const &payload)
+{
+    Block const input(payload);
+    Block output(deflateBound(&d->stream, uLong(input.size())) + SYNC_FLUSH_MARGIN);
+
+    d->stream.next_in   = const_cast<Bytef *>(reinterpret_cast<Bytef const *>(input.data()));
+    d->stream.avail_in  = uInt(input.size());
+    d->stream.next_out  = reinterpret_cast<Bytef *>(output.data());
+    d->stream.avail_out = uInt(output.size());
+
+    if(::deflate(&d->stream, Z_SYNC_FLUSH) != Z_OK || d->stream.avail_in || !d->stream.avail_out)
+    {
+        throw ProtocolError("Socket::DeflateStream::deflate", "Failed to deflate message payload");
+    }
+    output.resize(output.size() - d->stream.avail_out);
+
+    // The receiver appends the flush marker back.
+    DENG2_ASSERT(output.size() >= SYNC_FLUSH_TAIL_SIZE);
+    DENG2_ASSERT(!memcmp(output.data() + output.size() - SYNC_FLUSH_TAIL_SIZE, SYNC_FLUSH_TAIL,
+                         SYNC_FLUSH_TAIL_SIZE));
+    output.resize(output.size() - SYNC_FLUSH_TAIL_SIZE);
+    return output;
+}
 
+Socket::EncodedMessage::EncodedMessage(IByteArray const &packet, DeflateStream *stream)
+    : _bytes(encodeMessage(packet, stream))
+{}
+
+DENG2_PIMPL_NOREF(Socket::MessageDecoder)
+{
     enum ReceptionState {
         ReceivingHeader,
         ReceivingPayload
@@ -195,6 +408,94 @@ DENG2_PIMPL_NOREF(Socket)
     Block receivedBytes;
     MessageHeader incomingHeader;
 
+    /// Decompression state of the incoming stream (created when needed).
+    std::unique_ptr<InflateStream> inflater;
+
+    Instance() : receptionState(ReceivingHeader) {}
+};
+
+Socket::MessageDecoder::MessageDecoder() : d(new Instance)
+{}
+
+void Socket::MessageDecoder::receive(IByteArray const &bytes)
+{
+    d->receivedBytes += Block(bytes);
+}
+
+bool Socket::MessageDecoder::decode(Block &payload)
+{
+    if(d->receptionState == Instance::ReceivingHeader)
+    {
+        if(d->receivedBytes.size() < 2)
+        {
+            // A message must be at least two bytes long (header + payload).
+            return false;
+        }
+
+        try
+        {
+            Reader reader(d->receivedBytes);
+            reader >> d->incomingHeader;
+            d->receptionState = Instance::ReceivingPayload;
+
+            // Remove the read bytes from the buffer.
+            d->receivedBytes.remove(0, reader.offset());
+        }
+        catch(de::Error const &)
+        {
+            // It seems we don't have a full header yet.
+            return false;
+        }
+    }
+
+    if(int(d->receivedBytes.size()) < d->incomingHeader.size)
+    {
+        // Let's wait until more is available.
+        return false;
+    }
+
+    // Extract the payload from the incoming buffer.
+    payload = d->receivedBytes.left(d->incomingHeader.size);
+    d->receivedBytes.remove(0, d->incomingHeader.size);
+
+    // We have the full payload, but it still may need to uncompressed.
+    if(d->incomingHeader.isHuffmanCoded)
+    {
+        payload = codec::huffmanDecode(payload);
+        if(!payload.size())
+        {
+            throw ProtocolError("Socket::MessageDecoder::decode", "Huffman decoding failed");
+        }
+    }
+    else if(d->incomingHeader.isStreamed)
+    {
+        if(!d->inflater) d->inflater.reset(new InflateStream);
+        payload = d->inflater->inflate(payload);
+    }
+    else if(d->incomingHeader.isDeflated)
+    {
+        payload = qUncompress(payload);
+        if(!payload.size())
+        {
+            throw ProtocolError("Socket::MessageDecoder::decode", "Deflate failed");
+        }
+    }
+
+    // We can proceed to the next message.
+    d->receptionState = Instance::ReceivingHeader;
+    d->incomingHeader = MessageHeader();
+    return true;
+}
+
+
+DENG2_PIMPL_NOREF(Socket)
+{
+    Address target;
+    bool quiet;
+
+    /// Forms messages out of the received bytes.
+    MessageDecoder decoder;
+
     /// Number of the active channel.
     /// @todo Channel is not used at the moment.
     duint activeChannel;
@@ -211,9 +512,11 @@ DENG2_PIMPL_NOREF(Socket)
     /// Number of bytes written to the socket so far.
     dint64 totalBytesWritten;
 
+    /// Compression state of the outgoing stream (if enabled).
+    std::unique_ptr<DeflateStream> deflater;
+
     Instance() :
         quiet(false),
-        receptionState(ReceivingHeader),
         activeChannel(0),
         socket(0),
         bytesToBeWritten(0),
@@ -225,75 +528,13 @@ DENG2_PIMPL_NOREF(Socket)
         foreach(Message *msg, receivedMessages) delete msg;
     }
 
-    void serializeAndSendMessage(IByteArray const &packet)
+    void sendBytes(Block const &bytes)
     {
-        Block payload(packet);
-        Block huffData;
-        MessageHeader header;
-
-        // Let's find the appropriate compression method of the payload. First see
-        // if the encoded contents are under 128 bytes as Huffman codes.
-        if(payload.size() <= MAX_HUFFMAN_INPUT_SIZE) // Potentially short enough.
-        {
-            huffData = codec::huffmanEncode(payload);
-            if(int(huffData.size()) <= MAX_SIZE_SMALL)
-            {
-                // We'll use this.
-                header.isHuffmanCoded = true;
-                header.size = huffData.size();
-                payload = huffData;
-            }
-            // Even if that didn't seem suitable, we'll keep it to compare against
-            // the deflated payload.
-        }
-
-        /// @todo Messages broadcasted to multiple recipients are separately
-        /// compressed for each TCP send -- should do only one compression per
-        /// message.
-
-        if(!header.size) // Try deflate.
-        {
-            int const level = (payload.size() < 2*MAX_SIZE_MEDIUM? 6 /*default*/ : 9 /*best*/);
-            QByteArray deflated = qCompress(payload, level);
-
-            if(!deflated.size())
-            {
-                throw ProtocolError("Socket::send:", "Failed to deflate message payload");
-            }
-            if(deflated.size() > MAX_SIZE_LARGE)
-            {
-                throw ProtocolError("Socket::send",
-                                    QString("Compressed payload is too large (%1 bytes)").arg(deflated.size()));
-            }
-
-            // Choose the smallest compression.
-            if(huffData.size() && int(huffData.size()) <= deflated.size() && int(huffData.size()) <= MAX_SIZE_MEDIUM)
-            {
-                // Huffman yielded smaller payload.
-                header.isHuffmanCoded = true;
-                header.size = huffData.size();
-                payload = huffData;
-            }
-            else
-            {
-                // Use the deflated payload.
-                header.isDeflated = true;
-                header.size = deflated.size();
-                payload = deflated;
-            }
-        }
-
-        // Write the message header.
-        Block dest;
-        Writer(dest) << header;
-        socket->write(dest);
-
         // Update totals (for statistics).
-        dsize total = dest.size() + payload.size();
-        bytesToBeWritten += total;
-        totalBytesWritten += total;
+        bytesToBeWritten  += bytes.size();
+        totalBytesWritten += bytes.size();
 
-        socket->write(payload);
+        socket->write(bytes);
     }
 
     /**
@@ -301,71 +542,12 @@ DENG2_PIMPL_NOREF(Socket)
      */
     void deserializeMessages()
     {
-        forever
+        Block payload;
+        while(decoder.decode(payload))
         {
-            if(receptionState == ReceivingHeader)
-            {
-                if(receivedBytes.size() < 2)
-                {
-                    // A message must be at least two bytes long (header + payload).
-                    return;
-                }
-
-                try
-                {
-                    Reader reader(receivedBytes);
-                    reader >> incomingHeader;
-                    receptionState = ReceivingPayload;
-
-                    // Remove the read bytes from the buffer.
-                    receivedBytes.remove(0, reader.offset());
-                }
-                catch(de::Error const &)
-                {
-                    // It seems we don't have a full header yet.
-                    return;
-                }
-            }
-
-            if(receptionState == ReceivingPayload)
-            {
-                if(int(receivedBytes.size()) >= incomingHeader.size)
-                {
-                    // Extract the payload from the incoming buffer.
-                    Block payload = receivedBytes.left(incomingHeader.size);
-                    receivedBytes.remove(0, incomingHeader.size);
-
-                    // We have the full payload, but it still may need to uncompressed.
-                    if(incomingHeader.isHuffmanCoded)
-                    {
-                        payload = codec::huffmanDecode(payload);
-                        if(!payload.size())
-                        {
-                            throw ProtocolError("Socket::Instance::deserializeMessages", "Huffman decoding failed");
-                        }
-                    }
-                    else if(incomingHeader.isDeflated)
-                    {
-                        payload = qUncompress(payload);
-                        if(!payload.size())
-                        {
-                            throw ProtocolError("Socket::Instance::deserializeMessages", "Deflate failed");
-                        }
-                    }
-
-                    receivedMessages << new Message(Address(socket->peerAddress(), socket->peerPort()),
-                                                    incomingHeader.channel, payload);
-
-                    // We can proceed to the next message.
-                    receptionState = ReceivingHeader;
-                    incomingHeader = MessageHeader();
-                }
-                else
-                {
-                    // Let's wait until more is available.
-                    return;
-                }
-            }
+            /// @todo The channel is not included in the header.
+            receivedMessages << new Message(Address(socket->peerAddress(), socket->peerPort()),
+                                            0 /*channel*/, payload);
         }
     }
 };
@@ -548,7 +730,35 @@ void Socket::send(IByteArray const &packet, duint /*channel*/)
         throw DisconnectedError("Socket::send", "Socket is unavailable");
     }
 
-    d->serializeAndSendMessage(packet);
+    d->sendBytes(encodeMessage(packet, d->deflater.get()));
+}
+
+void Socket::send(EncodedMessage const &message)
+{
+    if(!d->socket)
+    {
+        /// @throw DisconnectedError Sending is not possible because the socket has been closed.
+        throw DisconnectedError("Socket::send", "Socket is unavailable");
+    }
+
+    d->sendBytes(message.bytes());
+}
+
+void Socket::setStreamCompression(bool enabled)
+{
+    if(enabled && !d->deflater)
+    {
+        d->deflater.reset(new DeflateStream);
+    }
+    else if(!enabled)
+    {
+        d->deflater.reset();
+    }
+}
+
+bool Socket::isStreamCompressionEnabled() const
+{
+    return d->deflater.get() != 0;
 }
 
 void Socket::readIncomingBytes()
@@ -558,7 +768,7 @@ void Socket::readIncomingBytes()
     int available = d->socket->bytesAvailable();
     if(available > 0)
     {
-        d->receivedBytes += d->socket->read(d->socket->bytesAvailable());
+        d->decoder.receive(Block(d->socket->read(d->socket->bytesAvailable())));
     }
 
     d->deserializeMessages();
@@ -110,10 +110,14 @@ Value *BuiltInExpression::evaluate(Evaluator &evaluator) const
             ns = &args.at(1).as<RecordValue>().dereference();
         }
 
+        // The names are listed in alphabetical order.
+        QList<String> names = ns->members().keys();
+        qSort(names);
+
         ArrayValue *keys = new ArrayValue;
-        DENG2_FOR_EACH_CONST(Record::Members, i, ns->members())
+        foreach(String const &name, names)
         {
-            *keys << new TextValue(i.key());
+            *keys << new TextValue(name);
         }
         return keys;
     }
@@ -23,7 +23,7 @@
 #include "de/Context"
 #include "de/Process"
 
-#include <QList>
+#include <QVector>
 
 namespace de {
 
@@ -46,11 +46,13 @@ DENG2_PIMPL(Evaluator)
         Value *result;
         Value *scope; // owned
 
-        ScopedResult(Value *v, Value *s = 0) : result(v), scope(s) {}
+        ScopedResult(Value *v = 0, Value *s = 0) : result(v), scope(s) {}
     };
 
-    typedef QList<ScopedExpression> Expressions;
-    typedef QList<ScopedResult> Results;
+    // Vectors keep their allocated capacity, so pushing and popping does not
+    // allocate memory once the stacks have grown large enough.
+    typedef QVector<ScopedExpression> Expressions;
+    typedef QVector<ScopedResult> Results;
 
     /// The expression that is currently being evaluated.
     Expression const *current;
@@ -58,6 +60,9 @@ DENG2_PIMPL(Evaluator)
     /// Namespace for the current expression.
     Record *names;
 
+    /// Shared list containing only @a names (see Evaluator::namespaces()).
+    Namespaces namesOnly;
+
     Expressions stack;
     Results results;
 
@@ -69,7 +74,10 @@ DENG2_PIMPL(Evaluator)
         , context(owner)
         , current(0)
         , names(0)
-    {}
+    {
+        stack.reserve(16);
+        results.reserve(16);
+    }
 
     ~Instance()
     {
@@ -92,14 +100,15 @@ DENG2_PIMPL(Evaluator)
             delete i.result;
             delete i.scope;
         }
-        results.clear();
+        results.erase(results.begin(), results.end()); // keeps capacity
     }
 
     void clearStack()
     {
         while(!stack.empty())
         {
-            ScopedExpression top = stack.takeLast();
+            ScopedExpression top = stack.back();
+            stack.pop_back();
             clearNames();
             names = top.names();
             delete top.scope;
@@ -144,7 +153,8 @@ DENG2_PIMPL(Evaluator)
         while(!stack.empty())
         {
             // Continue by processing the next step in the evaluation.
-            ScopedExpression top = stack.takeLast();
+            ScopedExpression top = stack.back();
+            stack.pop_back();
             clearNames();
             names = top.names();
             /*qDebug() << "Evaluator: Evaluating latest scoped expression" << top.expression
@@ -206,8 +216,12 @@ void Evaluator::namespaces(Namespaces &spaces) const
     if(d->names)
     {
         // A specific namespace has been defined.
-        spaces.clear();
-        spaces.push_back(d->names);
+        if(d->namesOnly.size() != 1 || d->namesOnly.first() != d->names)
+        {
+            d->namesOnly.clear();
+            d->namesOnly.append(d->names);
+        }
+        spaces = d->namesOnly;
     }
     else
     {
@@ -221,8 +235,8 @@ Record *Evaluator::localNamespace() const
     Namespaces spaces;
     namespaces(spaces);
     DENG2_ASSERT(!spaces.empty());
-    DENG2_ASSERT(spaces.front() != 0);
-    return spaces.front();
+    DENG2_ASSERT(spaces.at(0) != 0);
+    return spaces.at(0);
 }
 
 bool Evaluator::hasResult() const
@@ -249,7 +263,8 @@ Value *Evaluator::popResult(Value **evaluationScope)
 {
     DENG2_ASSERT(d->results.size() > 0);
 
-    Instance::ScopedResult result = d->results.takeLast();
+    Instance::ScopedResult result = d->results.back();
+    d->results.pop_back();
     /*qDebug() << "Evaluator: Popping result" << result.result->asText()
              << "in scope" << (result.scope? result.scope->asText() : "null");*/
 
@@ -190,7 +190,7 @@ Value *NameExpression::evaluate(Evaluator &evaluator) const
        (flags().testFlag(NewSubrecordIfNotInScope) && !variable))
     {
         // Replaces existing member with this identifier.
-        Record &record = spaces.front()->addRecord(d->identifier);
+        Record &record = spaces.at(0)->addRecord(d->identifier);
         return new RecordValue(record);
     }
 
@@ -201,14 +201,13 @@ Value *NameExpression::evaluate(Evaluator &evaluator) const
         variable = new Variable(d->identifier);
 
         // Add it to the local namespace.
-        spaces.front()->add(variable);
+        spaces.at(0)->add(variable);
 
         // Take note of the namespaces.
-        foundInNamespace = spaces.front();
+        foundInNamespace = spaces.at(0);
         if(!higherNamespace && spaces.size() > 1)
         {
-            Evaluator::Namespaces::iterator i = spaces.begin();
-            higherNamespace = *(++i);
+            higherNamespace = spaces.at(1);
         }
     }
 
@@ -241,7 +240,7 @@ Value *NameExpression::evaluate(Evaluator &evaluator) const
             evaluator.process().globals()["__file__"].value().asText());
 
         // Overwrite any existing member with this identifier.
-        spaces.front()->add(variable = new Variable(d->identifier));
+        spaces.at(0)->add(variable = new Variable(d->identifier));
 
         if(flags().testFlag(ByValue))
         {
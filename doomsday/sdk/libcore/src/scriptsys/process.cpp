@@ -40,6 +40,11 @@ DENG2_PIMPL(Process)
     typedef std::vector<Context *> ContextStack;
     ContextStack stack;
 
+    /// Namespaces visible in the current context (see Process::namespaces()).
+    /// Rebuilt only when the context stack changes.
+    Namespaces namespaces;
+    bool namespacesValid;
+
     /// This is the current working folder of the process. Relative paths
     /// given to workingFile() are located in relation to this
     /// folder. Initial value is the root folder.
@@ -51,6 +56,7 @@ DENG2_PIMPL(Process)
     Instance(Public *i)
         : Base(i)
         , state(Stopped)
+        , namespacesValid(false)
         , workingPath("/")
     {}
 
@@ -90,6 +96,33 @@ DENG2_PIMPL(Process)
             delete stack.back();
             stack.pop_back();
         }
+        namespacesValid = false;
+    }
+
+    void updateNamespaces()
+    {
+        namespaces.clear();
+
+        bool gotFunction = false;
+
+        DENG2_FOR_EACH_CONST_REVERSE(ContextStack, i, stack)
+        {
+            Context &context = **i;
+            if(context.type() == Context::FunctionCall)
+            {
+                // Only the topmost function call namespace is available: one cannot
+                // access the local variables of the callers.
+                if(gotFunction) continue;
+                gotFunction = true;
+            }
+            namespaces.append(&context.names());
+            if(context.type() == Context::GlobalNamespace)
+            {
+                // This shadows everything below.
+                break;
+            }
+        }
+        namespacesValid = true;
     }
 
     void run(Statement const *firstStatement)
@@ -226,6 +259,7 @@ void Process::stop()
 
     // Erase all but the first context.
     d->stack.erase(d->stack.begin() + 1, d->stack.end());
+    d->namespacesValid = false;
     
     // This will reset any half-done evaluations, but it won't clear the namespace.
     context().reset();
@@ -302,12 +336,14 @@ Context &Process::context(duint downDepth)
 void Process::pushContext(Context *context)
 {
     d->stack.push_back(context);
+    d->namespacesValid = false;
 }
 
 Context *Process::popContext()
 {
     Context *topmost = d->stack.back();
     d->stack.pop_back();
+    d->namespacesValid = false;
 
     // Pop a global namespace as well, if present.
     if(context().type() == Context::GlobalNamespace)
@@ -422,27 +458,11 @@ void Process::call(Function const &function, ArrayValue const &arguments, Value
 
 void Process::namespaces(Namespaces &spaces) const
 {
-    spaces.clear();
-
-    bool gotFunction = false;
-    
-    DENG2_FOR_EACH_CONST_REVERSE(Instance::ContextStack, i, d->stack)
+    if(!d->namespacesValid)
     {
-        Context &context = **i;
-        if(context.type() == Context::FunctionCall)
-        {
-            // Only the topmost function call namespace is available: one cannot
-            // access the local variables of the callers.
-            if(gotFunction) continue;
-            gotFunction = true;
-        }
-        spaces.push_back(&context.names());
-        if(context.type() == Context::GlobalNamespace)
-        {
-            // This shadows everything below.
-            break;
-        }
+        d->updateNamespaces();
     }
+    spaces = d->namespaces;
 }
 
 Record &Process::globals()
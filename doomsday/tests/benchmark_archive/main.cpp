@@ -0,0 +1,93 @@
+/*
+ * The Doomsday Engine Project
+ *
+ * Copyright (c) 2015 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * Mounts a large synthetic archive (similar to a PK3 with thousands of
+ * entries) and looks up all of its files via the file system index.
+ */
+
+#include <de/TextApp>
+#include <de/ZipArchive>
+#include <de/Block>
+#include <de/Writer>
+#include <de/FS>
+#include <de/Time>
+
+#include <QDebug>
+
+using namespace de;
+
+int main(int argc, char **argv)
+{
+    try
+    {
+        TextApp app(argc, argv);
+        app.initSubsystems(App::DisablePlugins);
+
+        int const folderCount    = 200;
+        int const filesPerFolder = 100;
+        int const total          = folderCount * filesPerFolder;
+
+        ZipArchive arch;
+        Block const content("benchmark");
+        for(int f = 0; f < folderCount; ++f)
+        {
+            for(int i = 0; i < filesPerFolder; ++i)
+            {
+                arch.add(Path(String("folder%1/file%2.lmp").arg(f).arg(i)), content);
+            }
+        }
+        File &pk3 = App::homeFolder().replaceFile("benchmark.pk3");
+        pk3.setMode(File::Write | File::Truncate);
+        Writer(pk3) << arch;
+
+        Time startedAt;
+        Folder &mounted = pk3.reinterpret()->as<Folder>();
+        mounted.populate();
+        TimeDelta const mountTime = startedAt.since();
+
+        startedAt = Time();
+        int found = 0;
+        for(int f = 0; f < folderCount; ++f)
+        {
+            for(int i = 0; i < filesPerFolder; ++i)
+            {
+                FS::FoundFiles files;
+                App::fileSystem().findAll(String("folder%1/file%2.lmp").arg(f).arg(i), files);
+                found += int(files.size());
+            }
+        }
+        TimeDelta const lookupTime = startedAt.since();
+
+        DENG2_ASSERT(found == total);
+
+        qDebug() << "Mounted" << total << "archive entries in" << ddouble(mountTime) << "s,"
+                 << "looked them up in" << ddouble(lookupTime) << "s";
+
+        // Don't leave the generated archive behind.
+        App::homeFolder().removeFile("benchmark.pk3");
+    }
+    catch(Error const &err)
+    {
+        qWarning() << err.asText();
+    }
+
+    qDebug() << "Exiting main()...";
+    return 0;
+}
@@ -0,0 +1,89 @@
+/**
+ * @file main.cpp
+ *
+ * StringPool benchmark. @ingroup tests
+ *
+ * Measures the throughput of interning, looking up and retrieving a large
+ * number of path segment-like strings.
+ *
+ * @authors Copyright (c) 2015 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#include <de/StringPool>
+#include <de/Time>
+#include <QDebug>
+#include <QStringList>
+#include <QVector>
+
+using namespace de;
+
+int main(int, char **)
+{
+    try
+    {
+        int const count = 200000;
+
+        QStringList texts;
+        for(int i = 0; i < count; ++i)
+        {
+            texts << String("Segment%1_%2").arg(i % 997).arg(i);
+        }
+
+        StringPool pool;
+        QVector<StringPool::Id> ids(count);
+
+        Time startedAt;
+        for(int i = 0; i < count; ++i)
+        {
+            ids[i] = pool.intern(texts.at(i));
+        }
+        TimeDelta const internTime = startedAt.since();
+
+        // Lookups using a different case.
+        startedAt = Time();
+        int found = 0;
+        for(int i = 0; i < count; ++i)
+        {
+            if(pool.isInterned(texts.at(i).toUpper())) found++;
+        }
+        TimeDelta const lookupTime = startedAt.since();
+
+        startedAt = Time();
+        dsize totalLength = 0;
+        for(int i = 0; i < count; ++i)
+        {
+            totalLength += pool.stringRef(ids.at(i)).size();
+        }
+        TimeDelta const retrieveTime = startedAt.since();
+
+        DENG2_ASSERT(pool.size() == dsize(count));
+        DENG2_ASSERT(found == count);
+
+        qDebug() << "Interned" << count << "strings in" << ddouble(internTime) << "s,"
+                 << int(count / de::max(ddouble(internTime), 1e-6)) << "per second";
+        qDebug() << "Looked up" << found << "strings in" << ddouble(lookupTime) << "s,"
+                 << int(count / de::max(ddouble(lookupTime), 1e-6)) << "per second";
+        qDebug() << "Retrieved" << totalLength << "characters in" << ddouble(retrieveTime) << "s";
+    }
+    catch(Error const &err)
+    {
+        qWarning() << err.asText() << "\n";
+    }
+
+    qDebug() << "Exiting main()...\n";
+    return 0;
+}
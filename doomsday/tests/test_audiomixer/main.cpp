@@ -0,0 +1,284 @@
+/**
+ * @file main.cpp
+ *
+ * Tests and benchmarks for the software audio mixer. @ingroup tests
+ *
+ * @authors Copyright (c) 2015 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#include <de/AudioMixer>
+#include <de/Error>
+#include <de/Time>
+#include <de/math.h>
+#include <QDebug>
+#include <QVector>
+#include <cmath>
+
+using namespace de;
+
+static int const RATE = 44100;
+
+static QVector<float> sine(double freq, int count)
+{
+    QVector<float> samples(count);
+    for(int i = 0; i < count; ++i)
+    {
+        samples[i] = float(.5 * std::sin(2 * PI * freq * i / RATE));
+    }
+    return samples;
+}
+
+/// Energy of one channel of interleaved stereo frames.
+static double energy(QVector<float> const &frames, int channel, int from = 0, int to = -1)
+{
+    if(to < 0) to = frames.size() / 2;
+    double sum = 0;
+    for(int i = from; i < to; ++i)
+    {
+        double const s = frames[2*i + channel];
+        sum += s * s;
+    }
+    return sum;
+}
+
+static void testPanning()
+{
+    QVector<float> const src = sine(440, RATE);
+
+    AudioMixer mixer(RATE);
+    int const voice = mixer.createVoice();
+    mixer.setSamples(voice, src);
+    mixer.play(voice);
+
+    // Center: constant power.
+    AudioMixer::MemorySink sink;
+    mixer.render(sink, 1000);
+    for(int i = 0; i < 1000; ++i)
+    {
+        DENG2_ASSERT(std::fabs(sink.samples()[2*i]     - src[i] * std::sqrt(.5f)) < 1e-5f);
+        DENG2_ASSERT(std::fabs(sink.samples()[2*i + 1] - src[i] * std::sqrt(.5f)) < 1e-5f);
+    }
+
+    // Hard left. The change is ramped, so look at the end.
+    mixer.setPan(voice, -1);
+    sink.clear();
+    mixer.render(sink, 1000);
+    double const left  = energy(sink.samples(), 0, 500);
+    double const right = energy(sink.samples(), 1, 500);
+    qDebug() << "Hard left pan: left" << left << "right" << right;
+    DENG2_ASSERT(left > 50);
+    DENG2_ASSERT(right < 1e-6);
+    DENG2_UNUSED2(left, right);
+}
+
+static void testEndOfSound()
+{
+    AudioMixer mixer(RATE);
+    int const voice = mixer.createVoice();
+    mixer.setSamples(voice, sine(1000, 1000));
+
+    AudioMixer::MemorySink sink;
+    mixer.play(voice);
+    mixer.render(sink, 4096);
+    DENG2_ASSERT(!mixer.isPlaying(voice));
+    DENG2_ASSERT(energy(sink.samples(), 0, 0, 1000) > 1);
+    DENG2_ASSERT(energy(sink.samples(), 0, 1000) == 0);
+
+    // Looping continues indefinitely.
+    sink.clear();
+    mixer.play(voice, true);
+    mixer.render(sink, 4096);
+    DENG2_ASSERT(mixer.isPlaying(voice));
+    DENG2_ASSERT(energy(sink.samples(), 0, 3000) > 1);
+
+    // Changed pitch: twice as fast, half as long.
+    sink.clear();
+    mixer.setPitch(voice, 2);
+    mixer.play(voice);
+    mixer.render(sink, 4096);
+    DENG2_ASSERT(!mixer.isPlaying(voice));
+    DENG2_ASSERT(energy(sink.samples(), 0, 0, 500) > 1);
+    DENG2_ASSERT(energy(sink.samples(), 0, 501) == 0);
+}
+
+static void testPositional()
+{
+    struct {
+        Vector3f position;
+        float yaw;
+        int louder;     // 0: left, 1: right, -1: silent
+    } const cases[] = {
+        { Vector3f(0,  100, 0),  0, 0 },
+        { Vector3f(0, -100, 0),  0, 1 },
+        { Vector3f(100,  0, 0), 90, 1 },    // Facing +Y, the sound is on the right.
+        { Vector3f(5000, 0, 0),  0, -1 }    // Too far away.
+    };
+    for(auto const &c : cases)
+    {
+        AudioMixer mixer(RATE);
+        int const voice = mixer.createVoice();
+        mixer.setSamples(voice, sine(440, RATE));
+        mixer.setPosition(voice, c.position);
+        mixer.setDistanceRange(voice, 256, 2025);
+        mixer.setListener(Vector3f(), c.yaw);
+        mixer.play(voice);
+
+        AudioMixer::MemorySink sink;
+        mixer.render(sink, 2000);
+        double const left  = energy(sink.samples(), 0);
+        double const right = energy(sink.samples(), 1);
+        if(c.louder < 0)
+        {
+            DENG2_ASSERT(left == 0 && right == 0);
+        }
+        else
+        {
+            DENG2_ASSERT(c.louder == 0? left > 10 * right : right > 10 * left);
+        }
+        DENG2_UNUSED2(left, right);
+    }
+
+    // Attenuation increases with distance.
+    double previous = 1e9;
+    for(float dist = 300; dist < 2000; dist += 300)
+    {
+        AudioMixer mixer(RATE);
+        int const voice = mixer.createVoice();
+        mixer.setSamples(voice, sine(440, RATE));
+        mixer.setPosition(voice, Vector3f(dist, 0, 0));
+        mixer.setDistanceRange(voice, 256, 2025);
+        mixer.play(voice);
+
+        AudioMixer::MemorySink sink;
+        mixer.render(sink, 2000);
+        double const level = energy(sink.samples(), 0);
+        DENG2_ASSERT(level < previous);
+        previous = level;
+    }
+}
+
+static void testReverb()
+{
+    QVector<float> burst = sine(500, 2000);
+
+    for(int enabled = 0; enabled < 2; ++enabled)
+    {
+        AudioMixer mixer(RATE);
+        int const voice = mixer.createVoice();
+        mixer.setSamples(voice, burst);
+        mixer.setReverb(enabled? 1 : 0, .8f, .6f, .3f);
+        mixer.play(voice);
+
+        AudioMixer::MemorySink sink;
+        mixer.render(sink, RATE / 2);
+
+        double const tail = energy(sink.samples(), 0, 2000) + energy(sink.samples(), 1, 2000);
+        double const dry  = energy(sink.samples(), 0, 0, 2000) + energy(sink.samples(), 1, 0, 2000);
+        qDebug() << "Reverb" << (enabled? "on:" : "off:") << "tail/dry energy" << tail / dry;
+        DENG2_ASSERT(enabled? tail > dry * .01 : tail == 0);
+        DENG2_UNUSED2(tail, dry);
+    }
+}
+
+static void setupManyVoices(AudioMixer &mixer, int count)
+{
+    duint32 seed = 1;
+    for(int i = 0; i < count; ++i)
+    {
+        seed = seed * 1103515245 + 12345;
+        int const voice = mixer.createVoice();
+        mixer.setSamples(voice, sine(100 + (seed >> 16) % 2000, RATE / 4));
+        mixer.setVolume(voice, .1f);
+        mixer.setPitch(voice, i % 3? 1.f : .8f + (seed >> 8 & 0xff) / 640.f);
+        if(i % 2)
+        {
+            mixer.setPan(voice, (int(seed >> 4 & 0xff) - 128) / 128.f);
+        }
+        else
+        {
+            mixer.setPosition(voice, Vector3f(float(seed % 1000) - 500, float(seed >> 10 & 0x3ff) - 512, 0));
+            mixer.setDistanceRange(voice, 256, 2025);
+        }
+        mixer.play(voice, true);
+    }
+}
+
+static void testThreads()
+{
+    // Mixing in several threads produces the same result.
+    AudioMixer single(RATE);
+    AudioMixer multi(RATE);
+    setupManyVoices(single, 300);
+    setupManyVoices(multi,  300);
+    single.setVoicesPerThread(1000);
+    multi.setVoicesPerThread(16);
+
+    AudioMixer::MemorySink a, b;
+    for(int i = 0; i < 10; ++i)
+    {
+        single.render(a, 1024);
+        multi.render(b, 1024);
+    }
+    DENG2_ASSERT(a.frameCount() == b.frameCount());
+    for(int i = 0; i < a.samples().size(); ++i)
+    {
+        DENG2_ASSERT(std::fabs(a.samples()[i] - b.samples()[i]) < 1e-4f);
+    }
+}
+
+static void benchmark()
+{
+    int const seconds = 10;
+    float frames[2 * 1024];
+
+    for(int threaded = 0; threaded < 2; ++threaded)
+    {
+        AudioMixer mixer(RATE);
+        setupManyVoices(mixer, 256);
+        mixer.setReverb(.5f, .5f, .5f, .5f);
+        mixer.setVoicesPerThread(threaded? 32 : 1000);
+
+        Time startedAt;
+        for(int i = 0; i < seconds * RATE / 1024; ++i)
+        {
+            mixer.render(frames, 1024);
+        }
+        qDebug() << "256 voices," << (threaded? "multithreaded:" : "one thread:")
+                 << seconds / ddouble(startedAt.since()) << "x realtime"
+                 << "(" << AudioMixer::kernelName() << ")";
+    }
+}
+
+int main(int, char **)
+{
+    try
+    {
+        testPanning();
+        testEndOfSound();
+        testPositional();
+        testReverb();
+        testThreads();
+        benchmark();
+    }
+    catch(Error const &err)
+    {
+        qWarning() << err.asText() << "\n";
+    }
+
+    qDebug() << "Exiting main()...\n";
+    return 0;
+}
@@ -0,0 +1,186 @@
+/**
+ * @file main.cpp
+ *
+ * Tests for writing and reading binary log files. @ingroup tests
+ *
+ * @authors Copyright (c) 2015 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#include <de/TextApp>
+#include <de/BinaryLogSink>
+#include <de/Block>
+#include <de/Folder>
+#include <de/Log>
+#include <de/Reader>
+#include <QDebug>
+#include <QList>
+
+using namespace de;
+
+static int const ENTRY_COUNT = 2500;
+static int const PLAIN_TEXT_AT = 1500;
+
+/*
+ * The first block has only Map entries below warning level, the second only
+ * developer GL entries at verbose level or below, and the last block warnings
+ * of both kinds.
+ */
+static duint32 entryMetadata(int i)
+{
+    int const block = i / BinaryLogSink::INDEX_INTERVAL;
+    if(block == 0) return LogEntry::Map | LogEntry::Level(LogEntry::Message + i % 2);
+    if(block == 1) return LogEntry::GL | LogEntry::Dev | LogEntry::Level(LogEntry::XVerbose + i % 2);
+    return (i % 2? LogEntry::Map : LogEntry::GL | LogEntry::Dev) | LogEntry::Warning;
+}
+
+static LogEntry *makeEntry(int i)
+{
+    LogEntry::Args args;
+    args << LogEntry::Arg::newFromPool(dint(i))
+         << LogEntry::Arg::newFromPool(String("text %1").arg(i))
+         << LogEntry::Arg::newFromPool(ddouble(i) / 4);
+    return new LogEntry(entryMetadata(i), "test_binarylog", 0, "Entry %i: %s %f", args);
+}
+
+static void writeLog(File &file, QList<LogEntry *> &written)
+{
+    BinaryLogSink sink(file);
+    for(int i = 0; i < ENTRY_COUNT; ++i)
+    {
+        if(i == PLAIN_TEXT_AT)
+        {
+            sink << String("Plain text");
+        }
+        written << makeEntry(i);
+        sink << *written.last();
+    }
+    // The last index is written when the sink is deleted.
+}
+
+static void readLog(Block const &data, QList<LogEntry *> const &written)
+{
+    Reader reader(data);
+    duint32 magic;
+    duint16 formatVersion;
+    reader >> magic >> formatVersion;
+    DENG2_ASSERT(magic == BinaryLogSink::MAGIC);
+    DENG2_ASSERT(formatVersion == BinaryLogSink::FORMAT_VERSION);
+    reader.withHeader();
+
+    QList<BinaryLogSink::Index> indices;
+    BinaryLogSink::Index expected;
+    dsize blockStart = reader.offset();
+    dsize lastIndexAt = 0;
+    int entryCount = 0;
+    int plainTextCount = 0;
+
+    while(!reader.atEnd())
+    {
+        dsize const recordAt = reader.offset();
+        dbyte type;
+        duint32 size;
+        reader >> type >> size;
+        dsize const payloadAt = reader.offset();
+
+        if(type == BinaryLogSink::EntryRecord)
+        {
+            LogEntry entry;
+            reader >> entry;
+
+            LogEntry const &original = *written.at(entryCount++);
+            DENG2_ASSERT(entry.metadata() == original.metadata());
+            DENG2_ASSERT(entry.section()  == original.section());
+            DENG2_ASSERT(entry.format()   == original.format());
+            DENG2_ASSERT(entry.asText()   == original.asText());
+            expected.add(entry);
+        }
+        else if(type == BinaryLogSink::PlainTextRecord)
+        {
+            String text;
+            reader >> text;
+            DENG2_ASSERT(text == "Plain text");
+            DENG2_ASSERT(entryCount == PLAIN_TEXT_AT);
+            plainTextCount++;
+        }
+        else
+        {
+            DENG2_ASSERT(type == BinaryLogSink::IndexRecord);
+
+            BinaryLogSink::Index index;
+            reader >> index;
+            DENG2_ASSERT(index.previous     == lastIndexAt);
+            DENG2_ASSERT(index.blockStart   == blockStart);
+            DENG2_ASSERT(index.entryCount   == expected.entryCount);
+            DENG2_ASSERT(index.userContext  == expected.userContext);
+            DENG2_ASSERT(index.devContext   == expected.devContext);
+            DENG2_ASSERT(index.highestLevel == expected.highestLevel);
+            DENG2_ASSERT(index.first        == expected.first);
+            DENG2_ASSERT(index.last         == expected.last);
+            indices << index;
+
+            lastIndexAt = recordAt;
+            blockStart  = payloadAt + size;
+            expected    = BinaryLogSink::Index();
+        }
+        DENG2_ASSERT(reader.offset() == payloadAt + size);
+        reader.setOffset(payloadAt + size);
+    }
+
+    DENG2_ASSERT(entryCount == ENTRY_COUNT);
+    DENG2_ASSERT(plainTextCount == 1);
+    DENG2_ASSERT(indices.size() == 3);
+    DENG2_ASSERT(indices.last().entryCount == duint32(ENTRY_COUNT % BinaryLogSink::INDEX_INTERVAL));
+
+    // Blocks that cannot match a filter are recognized from the index alone.
+    DENG2_ASSERT( indices[0].mayContain(LogEntry::Message, LogEntry::Map, false));
+    DENG2_ASSERT(!indices[0].mayContain(LogEntry::Message, LogEntry::GL,  true));
+    DENG2_ASSERT(!indices[0].mayContain(LogEntry::Warning, 0, true));
+    DENG2_ASSERT( indices[1].mayContain(LogEntry::XVerbose, LogEntry::GL, true));
+    DENG2_ASSERT(!indices[1].mayContain(LogEntry::XVerbose, LogEntry::GL, false));
+    DENG2_ASSERT(!indices[1].mayContain(LogEntry::Message, 0, true));
+    DENG2_ASSERT( indices[2].mayContain(LogEntry::Warning, LogEntry::GL, true));
+    DENG2_ASSERT(!indices[2].mayContain(LogEntry::Error, 0, true));
+    DENG2_UNUSED2(magic, formatVersion);
+}
+
+int main(int argc, char **argv)
+{
+    try
+    {
+        TextApp app(argc, argv);
+        app.initSubsystems(App::DisablePlugins);
+
+        QList<LogEntry *> written;
+        {
+            File &file = App::homeFolder().replaceFile("test_binarylog.dlog");
+            file.setMode(File::Write);
+            writeLog(file, written);
+            file.setMode(File::ReadOnly);
+        }
+        readLog(Block(App::homeFolder().locate<File const>("test_binarylog.dlog")), written);
+
+        App::homeFolder().removeFile("test_binarylog.dlog");
+        qDeleteAll(written);
+    }
+    catch(Error const &err)
+    {
+        qWarning() << err.asText();
+    }
+
+    qDebug() << "Exiting main()...";
+    return 0;
+}
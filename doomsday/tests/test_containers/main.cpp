@@ -0,0 +1,243 @@
+/**
+ * @file main.cpp
+ *
+ * Tests and benchmarks for the flat containers. @ingroup tests
+ *
+ * @authors Copyright (c) 2015 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#include <de/FlatHashMap>
+#include <de/SmallVector>
+#include <de/String>
+#include <de/Time>
+#include <QDebug>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+
+using namespace de;
+
+static void testMap()
+{
+    FlatHashMap<dint, String> map;
+    DENG2_ASSERT(map.isEmpty());
+
+    for(dint i = 0; i < 1000; ++i)
+    {
+        map.insert(i, String::number(i));
+    }
+    DENG2_ASSERT(map.size() == 1000);
+    DENG2_ASSERT(map.value(123) == "123");
+    DENG2_ASSERT(map.value(1000, "none") == "none");
+
+    // Replacing an existing value.
+    map.insert(5, "five");
+    DENG2_ASSERT(map.size() == 1000);
+    DENG2_ASSERT(map.constFind(5).value() == "five");
+
+    // Every other entry removed; the rest must still be found.
+    for(dint i = 0; i < 1000; i += 2)
+    {
+        dint const removed = map.remove(i);
+        DENG2_ASSERT(removed == 1);
+        DENG2_UNUSED(removed);
+    }
+    dint const removedAgain = map.remove(0);
+    DENG2_ASSERT(removedAgain == 0);
+    DENG2_ASSERT(map.size() == 500);
+    for(dint i = 0; i < 1000; ++i)
+    {
+        DENG2_ASSERT(map.contains(i) == (i % 2 == 1));
+    }
+
+    dint sum = 0;
+    for(auto i = map.constBegin(); i != map.constEnd(); ++i)
+    {
+        DENG2_ASSERT(i.key() % 2 == 1);
+        sum += i.key();
+    }
+    DENG2_ASSERT(sum == 250000);
+
+    map[2000] = "added";
+    DENG2_ASSERT(map.value(2000) == "added");
+
+    map.clear();
+    DENG2_ASSERT(map.isEmpty());
+    DENG2_ASSERT(!map.contains(2000));
+
+    DENG2_UNUSED2(sum, removedAgain);
+}
+
+static void testSet()
+{
+    dint objects[100];
+    FlatHashSet<dint *> set;
+    for(dint i = 0; i < 100; ++i)
+    {
+        set.insert(objects + i);
+    }
+    set.insert(objects);
+    DENG2_ASSERT(set.size() == 100);
+
+    for(dint i = 0; i < 100; i += 3)
+    {
+        bool const removed = set.remove(objects + i);
+        DENG2_ASSERT(removed);
+        DENG2_UNUSED(removed);
+    }
+    for(dint i = 0; i < 100; ++i)
+    {
+        DENG2_ASSERT(set.contains(objects + i) == (i % 3 != 0));
+    }
+}
+
+static void testSmallVector()
+{
+    SmallVector<String, 4> vec;
+    for(dint i = 0; i < 4; ++i) vec << String::number(i);
+    DENG2_ASSERT(!vec.isOnHeap());
+
+    // Grows to the heap; the appended element refers to the vector itself.
+    vec.append(vec.first());
+    DENG2_ASSERT(vec.isOnHeap());
+    DENG2_ASSERT(vec.size() == 5);
+    DENG2_ASSERT(vec.last() == "0");
+
+    SmallVector<String, 4> copied(vec);
+    SmallVector<String, 4> moved(std::move(copied));
+    DENG2_ASSERT(copied.isEmpty());
+    DENG2_ASSERT(moved.size() == 5);
+    DENG2_ASSERT(moved[3] == "3");
+
+    moved.removeLast();
+    moved.clear();
+    DENG2_ASSERT(moved.isEmpty());
+}
+
+/**
+ * Compares the flat containers against the Qt containers using the kind of
+ * workload seen in the engine's per-tick code: pointer or small integer keys,
+ * lots of lookups, and entries coming and going.
+ */
+static void benchmark()
+{
+    dint const count  = 50000;
+    dint const rounds = 20;
+
+    QVector<dint> storage(count);
+    QVector<dint *> keys(count);
+    for(dint i = 0; i < count; ++i) keys[i] = &storage[i];
+
+    dint64 checksum = 0;
+
+    // Maps.
+    {
+        Time startedAt;
+        QHash<dint *, dint> hash;
+        for(dint r = 0; r < rounds; ++r)
+        {
+            for(dint i = 0; i < count; ++i) hash.insert(keys[i], i);
+            for(dint i = 0; i < count; ++i) checksum += hash.value(keys[(i * 7) % count]);
+            for(dint i = 0; i < count; i += 2) hash.remove(keys[i]);
+            hash.clear();
+        }
+        TimeDelta const qtTime = startedAt.since();
+
+        startedAt = Time();
+        FlatHashMap<dint *, dint> flat;
+        for(dint r = 0; r < rounds; ++r)
+        {
+            for(dint i = 0; i < count; ++i) flat.insert(keys[i], i);
+            for(dint i = 0; i < count; ++i) checksum -= flat.value(keys[(i * 7) % count]);
+            for(dint i = 0; i < count; i += 2) flat.remove(keys[i]);
+            flat.clear();
+        }
+        TimeDelta const flatTime = startedAt.since();
+
+        qDebug() << "QHash:" << ddouble(qtTime) << "s, FlatHashMap:" << ddouble(flatTime) << "s";
+    }
+
+    // Sets.
+    {
+        Time startedAt;
+        QSet<dint *> qset;
+        for(dint r = 0; r < rounds; ++r)
+        {
+            for(dint i = 0; i < count; ++i) qset.insert(keys[i]);
+            for(dint i = 0; i < count; ++i) checksum += qset.contains(keys[i])? 1 : 0;
+            for(dint i = 0; i < count; ++i) qset.remove(keys[i]);
+        }
+        TimeDelta const qtTime = startedAt.since();
+
+        startedAt = Time();
+        FlatHashSet<dint *> flat;
+        for(dint r = 0; r < rounds; ++r)
+        {
+            for(dint i = 0; i < count; ++i) flat.insert(keys[i]);
+            for(dint i = 0; i < count; ++i) checksum -= flat.contains(keys[i])? 1 : 0;
+            for(dint i = 0; i < count; ++i) flat.remove(keys[i]);
+        }
+        TimeDelta const flatTime = startedAt.since();
+
+        qDebug() << "QSet:" << ddouble(qtTime) << "s, FlatHashSet:" << ddouble(flatTime) << "s";
+    }
+
+    // Short-lived small arrays.
+    {
+        Time startedAt;
+        for(dint i = 0; i < count * rounds; ++i)
+        {
+            QVector<dint *> found;
+            for(dint k = 0; k < 8; ++k) found.append(keys[(i + k) % count]);
+            checksum += found.size();
+        }
+        TimeDelta const qtTime = startedAt.since();
+
+        startedAt = Time();
+        for(dint i = 0; i < count * rounds; ++i)
+        {
+            SmallVector<dint *, 8> found;
+            for(dint k = 0; k < 8; ++k) found.append(keys[(i + k) % count]);
+            checksum -= found.size();
+        }
+        TimeDelta const flatTime = startedAt.since();
+
+        qDebug() << "QVector:" << ddouble(qtTime) << "s, SmallVector:" << ddouble(flatTime) << "s";
+    }
+
+    // Both sides of each benchmark did the same work.
+    DENG2_ASSERT(checksum == 0);
+    DENG2_UNUSED(checksum);
+}
+
+int main(int, char **)
+{
+    try
+    {
+        testMap();
+        testSet();
+        testSmallVector();
+        benchmark();
+    }
+    catch(Error const &err)
+    {
+        qWarning() << err.asText() << "\n";
+    }
+
+    qDebug() << "Exiting main()...\n";
+    return 0;
+}
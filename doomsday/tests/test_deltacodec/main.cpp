@@ -0,0 +1,357 @@
+/**
+ * @file main.cpp
+ *
+ * Tests for the encoding of frame deltas (PSV_FRAME2 and PSV_FRAME3).
+ * @ingroup tests
+ *
+ * @authors Copyright (c) 2015 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#include "network/deltacodec.h"
+
+#include <de/Error>
+#include <de/fixedpoint.h>
+#include <QDebug>
+#include <cstring>
+
+using namespace de;
+
+static duint32 seed = 1;
+
+static duint32 random32()
+{
+    duint32 value = 0;
+    for(int i = 0; i < 2; ++i)
+    {
+        seed = seed * 1103515245 + 12345;
+        value = (value << 16) | (seed >> 16);
+    }
+    return value;
+}
+
+/// Random 16.8 fixed-point coordinate anywhere in the map space.
+static fixed_t randomCoord()
+{
+    return fixed_t(random32() & ~0xff);
+}
+
+/// Random value with a random number of significant bits.
+static duint32 randomBits()
+{
+    duint32 const v = random32();
+    return v >> (v & 31);
+}
+
+static bool sameBytes(Writer const *a, Writer const *b)
+{
+    return Writer_Size(a) == Writer_Size(b) &&
+           !std::memcmp(Writer_Data(a), Writer_Data(b), Writer_Size(a));
+}
+
+struct Fields
+{
+    duint32 v;
+    duint32 packed;
+    duint16 packed16;   ///< Packed 16-bit values are limited to 15 bits.
+    fixed_t coord;
+    angle_t angle;
+    float real;
+
+    Fields()
+        : v(random32())
+        , packed(randomBits())
+        , packed16(duint16(randomBits() & 0x7fff))
+        , coord(fixed_t(random32()))
+        , angle(random32())
+        , real(float(dint32(v)) / 256)
+    {}
+};
+
+/**
+ * Without reference origins, the deltas must be written exactly like the
+ * PSV_FRAME2 deltas were before DeltaWriter, because clients older than
+ * protocol 26 still read them.
+ */
+static void testFrame2Compatibility()
+{
+    int const COUNT = 1000;
+    Fields fields[COUNT];
+
+    Writer *expected = Writer_NewWithDynamicBuffer(0);
+    Writer *written  = Writer_NewWithDynamicBuffer(0);
+
+    for(int i = 0; i < COUNT; ++i)
+    {
+        Fields const &f = fields[i];
+
+        // As in the original Sv_Write*Delta().
+        Writer_WriteUInt16(expected, duint16(f.v));
+        Writer_WriteByte(expected, byte(f.v));
+        Writer_WriteUInt16(expected, duint16(f.v >> 8));
+        Writer_WriteUInt32(expected, f.v);
+        Writer_WriteInt32(expected, dint32(f.v));
+        Writer_WriteFloat(expected, f.real);
+        Writer_WritePackedUInt16(expected, f.packed16);
+        Writer_WritePackedUInt32(expected, f.packed);
+        Writer_WriteInt16(expected, dint16(f.v));
+        Writer_WriteInt16(expected, f.angle >> 16);
+        Writer_WriteInt16(expected, f.coord >> FRACBITS);
+        Writer_WriteByte(expected, f.coord >> 8);
+
+        {
+            DeltaWriter out(written);
+            DENG2_ASSERT(!out.isBitPacked());
+            out.writeId(duint16(f.v));
+            out.writeByte(byte(f.v));
+            out.writeUInt16(duint16(f.v >> 8));
+            out.writeUInt32(f.v);
+            out.writeInt32(dint32(f.v));
+            out.writeFloat(f.real);
+            out.writePackedUInt16(f.packed16);
+            out.writePackedUInt32(f.packed);
+            out.writeInt16(dint16(f.v));
+            out.writeAngle(f.angle);
+            out.writeCoord(duint16(f.v), VX, f.coord);
+            out.removeOrigin(duint16(f.v)); // No effect.
+        }
+        DENG2_ASSERT(sameBytes(expected, written));
+    }
+
+    // The values are read back like the original client did.
+    Reader *reader = Reader_NewWithBuffer(Writer_Data(written), Writer_Size(written));
+    for(int i = 0; i < COUNT; ++i)
+    {
+        Fields const &f = fields[i];
+        DeltaReader in(reader);
+        DENG2_ASSERT(!in.isBitPacked());
+
+        uint16_t const id      = in.readId();
+        byte const b           = in.readByte();
+        uint16_t const u16     = in.readUInt16();
+        uint32_t const u32     = in.readUInt32();
+        int32_t const i32      = in.readInt32();
+        float const real       = in.readFloat();
+        uint16_t const packed  = in.readPackedUInt16();
+        uint32_t const packed2 = in.readPackedUInt32();
+        int16_t const i16      = in.readInt16();
+        angle_t const angle    = in.readAngle();
+        fixed_t const coord    = in.readCoord(id, VX);
+
+        DENG2_ASSERT(id      == duint16(f.v));
+        DENG2_ASSERT(b       == byte(f.v));
+        DENG2_ASSERT(u16     == duint16(f.v >> 8));
+        DENG2_ASSERT(u32     == f.v);
+        DENG2_ASSERT(i32     == dint32(f.v));
+        DENG2_ASSERT(real    == f.real);
+        DENG2_ASSERT(packed  == f.packed16);
+        DENG2_ASSERT(packed2 == f.packed);
+        DENG2_ASSERT(i16     == dint16(f.v));
+        DENG2_ASSERT(angle   == (f.angle & 0xffff0000));
+        DENG2_ASSERT(coord   == fixed_t(f.coord & ~0xff));
+        DENG2_UNUSED4(f, b, u16, u32);
+        DENG2_UNUSED4(i32, real, packed, packed2);
+        DENG2_UNUSED3(i16, angle, coord);
+    }
+    DENG2_ASSERT(Reader_AtEnd(reader));
+
+    Reader_Delete(reader);
+    Writer_Delete(written);
+    Writer_Delete(expected);
+}
+
+struct Mobj
+{
+    thid_t id;
+    fixed_t pos[3];
+};
+
+/**
+ * Writes and reads bit-packed deltas of moving mobjs. The first delta of an
+ * mobj has absolute coordinates (unknown origin) and the following ones are
+ * relative to the previous delta (known origin). Removed mobjs are forgotten
+ * on both ends, and a canceled delta is undone on the writing end.
+ */
+static void testBitPackedRoundTrip()
+{
+    int const MOBJ_COUNT = 64;
+    int const FRAMES     = 200;
+
+    DeltaOrigins serverOrigins, clientOrigins;
+    Mobj mobjs[MOBJ_COUNT];
+    thid_t nextId = 1;
+    for(int i = 0; i < MOBJ_COUNT; ++i)
+    {
+        mobjs[i].id = nextId++;
+        for(int k = 0; k < 3; ++k) mobjs[i].pos[k] = randomCoord();
+    }
+
+    dsize absoluteBytes = 0, relativeBytes = 0;
+    int absoluteCount = 0, relativeCount = 0;
+
+    for(int frame = 0; frame < FRAMES; ++frame)
+    {
+        Writer *writer = Writer_NewWithDynamicBuffer(0);
+        Reader *reader = 0;
+        dsize deltaEnd[MOBJ_COUNT];
+        duint32 const frameSeed = seed;
+
+        // The frame's deltas are first written and then read back, using the
+        // same random values.
+        for(int pass = 0; pass < 2; ++pass)
+        {
+            seed = frameSeed;
+            if(pass == 1)
+            {
+                reader = Reader_NewWithBuffer(Writer_Data(writer), Writer_Size(writer));
+            }
+
+            for(int i = 0; i < MOBJ_COUNT; ++i)
+            {
+                Mobj &mo = mobjs[i];
+
+                // Mostly small movement, now and then a teleport.
+                duint32 const r = random32();
+                fixed_t pos[3];
+                for(int k = 0; k < 3; ++k)
+                {
+                    duint32 const step = random32() % 0x100000;
+                    pos[k] = (r % 50 == 0? randomCoord() : fixed_t(duint32(mo.pos[k]) + step - 0x80000));
+                }
+                dint16 const mom    = dint16(randomBits());
+                angle_t const angle = random32();
+                duint32 const flags = randomBits();
+                bool const removed  = (r % 97 == 0);
+                bool const canceled = (r % 89 == 0);
+
+                if(pass == 0)
+                {
+                    bool const known  = (serverOrigins.origin(mo.id).known == 7);
+                    dsize const start = Writer_Size(writer);
+
+                    if(canceled)
+                    {
+                        // Written and then dropped from the frame, like when
+                        // the frame becomes too large.
+                        DeltaOrigins::Origin const saved = serverOrigins.origin(mo.id);
+                        {
+                            DeltaWriter out(writer, &serverOrigins);
+                            for(int k = 0; k < 3; ++k) out.writeCoord(mo.id, k, randomCoord());
+                        }
+                        serverOrigins.setOrigin(mo.id, saved);
+                        Writer_SetPos(writer, start);
+                    }
+                    {
+                        DeltaWriter out(writer, &serverOrigins);
+                        DENG2_ASSERT(out.isBitPacked());
+                        out.writeId(mo.id);
+                        out.writePackedUInt32(flags);
+                        for(int k = 0; k < 3; ++k) out.writeCoord(mo.id, k, pos[k]);
+                        out.writeInt16(mom);
+                        out.writeAngle(angle);
+                        if(removed) out.removeOrigin(mo.id);
+                    }
+                    deltaEnd[i] = Writer_Size(writer);
+
+                    if(known)
+                    {
+                        relativeBytes += deltaEnd[i] - start;
+                        relativeCount++;
+                    }
+                    else
+                    {
+                        absoluteBytes += deltaEnd[i] - start;
+                        absoluteCount++;
+                    }
+                }
+                else
+                {
+                    if(canceled)
+                    {
+                        // Consume the same random numbers as when writing.
+                        for(int k = 0; k < 3; ++k) randomCoord();
+                    }
+
+                    thid_t readId;
+                    duint32 readFlags;
+                    fixed_t readPos[3];
+                    dint16 readMom;
+                    angle_t readAngle;
+                    {
+                        DeltaReader in(reader, &clientOrigins);
+                        DENG2_ASSERT(in.isBitPacked());
+                        readId    = in.readId();
+                        readFlags = in.readPackedUInt32();
+                        for(int k = 0; k < 3; ++k) readPos[k] = in.readCoord(readId, k);
+                        readMom   = in.readInt16();
+                        readAngle = in.readAngle();
+                        if(removed) in.removeOrigin(readId);
+                    }
+
+                    DENG2_ASSERT(readId == mo.id);
+                    DENG2_ASSERT(readFlags == flags);
+                    for(int k = 0; k < 3; ++k)
+                    {
+                        DENG2_ASSERT(readPos[k] == fixed_t(pos[k] & ~0xff));
+                    }
+                    DENG2_ASSERT(readMom == mom);
+                    DENG2_ASSERT(readAngle == ((angle + 0x80000) & 0xfff00000));
+                    DENG2_UNUSED4(readFlags, readPos, readMom, readAngle);
+
+                    // Each delta is padded to whole bytes.
+                    DENG2_ASSERT(Reader_Pos(reader) == deltaEnd[i]);
+
+                    // Both ends agree about the reference coordinates.
+                    DeltaOrigins::Origin const server = serverOrigins.origin(readId);
+                    DeltaOrigins::Origin const client = clientOrigins.origin(readId);
+                    DENG2_ASSERT(server.known == client.known);
+                    DENG2_ASSERT(!std::memcmp(server.pos, client.pos, sizeof(server.pos)));
+                    DENG2_UNUSED2(server, client);
+
+                    for(int k = 0; k < 3; ++k) mo.pos[k] = pos[k];
+                    if(removed) mo.id = nextId++;
+                }
+            }
+        }
+        DENG2_ASSERT(Reader_AtEnd(reader));
+
+        Reader_Delete(reader);
+        Writer_Delete(writer);
+    }
+
+    DENG2_ASSERT(absoluteCount > 0 && relativeCount > 0);
+    DENG2_ASSERT(relativeBytes / relativeCount < absoluteBytes / absoluteCount);
+
+    qDebug() << absoluteCount << "deltas with unknown origin:" << absoluteBytes / absoluteCount
+             << "bytes on average;" << relativeCount << "deltas with known origin:"
+             << relativeBytes / relativeCount << "bytes on average";
+}
+
+int main(int, char **)
+{
+    try
+    {
+        testFrame2Compatibility();
+        testBitPackedRoundTrip();
+    }
+    catch(Error const &err)
+    {
+        qWarning() << err.asText() << "\n";
+    }
+
+    qDebug() << "Exiting main()...\n";
+    return 0;
+}
@@ -0,0 +1,251 @@
+/**
+ * @file main.cpp
+ *
+ * Tests for the seekable demo file format. @ingroup tests
+ *
+ * @authors Copyright (c) 2015 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#include "network/demofile.h"
+
+#include <de/Block>
+#include <de/Writer>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+
+using namespace de;
+
+static int const TICS           = 300;
+static int const PACKETS_PER_TIC = 3;
+static int const KEYFRAME_TICS  = 100;
+
+/// Contents of the @a n:th packet of @a tic. Long enough for the chunks to fill up.
+static Block packetData(int tic, int n)
+{
+    duint32 seed = duint32(tic * PACKETS_PER_TIC + n + 1);
+    Block data((seed * 37) % 900);
+    for(dsize i = 0; i < data.size(); ++i)
+    {
+        seed = seed * 1103515245 + 12345;
+        data.data()[i] = dbyte(seed >> 16);
+    }
+    return data;
+}
+
+static dbyte packetType(int tic, int n)
+{
+    return dbyte(tic * PACKETS_PER_TIC + n);
+}
+
+static NativePath tempPath(char const *name)
+{
+    return NativePath(QDir::tempPath()) / name;
+}
+
+static void writeDemo(NativePath const &path)
+{
+    DemoWriter writer(path);
+    for(int tic = 0; tic < TICS; ++tic)
+    {
+        if(!(tic % KEYFRAME_TICS))
+        {
+            writer.beginKeyframe(tic);
+        }
+        for(int n = 0; n < PACKETS_PER_TIC; ++n)
+        {
+            Block const data = packetData(tic, n);
+            writer.writePacket(tic, packetType(tic, n), data.constData(), data.size());
+        }
+    }
+}
+
+/**
+ * Reads packets until the end of the demo, checking that they are the ones
+ * written starting from @a startTic.
+ */
+static void readUntilEnd(DemoReader &reader, int startTic)
+{
+    int count = 0;
+    for(int tic = startTic; tic < TICS; ++tic)
+    {
+        for(int n = 0; n < PACKETS_PER_TIC; ++n)
+        {
+            int const nextTic = reader.nextTic();
+            DENG2_ASSERT(nextTic == tic);
+
+            dbyte type;
+            Block data;
+            reader.readPacket(type, data);
+            DENG2_ASSERT(type == packetType(tic, n));
+            DENG2_ASSERT(data == packetData(tic, n));
+            DENG2_UNUSED(nextTic);
+            count++;
+        }
+    }
+    int const atEnd = reader.nextTic();
+    DENG2_ASSERT(atEnd < 0);
+    DENG2_ASSERT(count == (TICS - startTic) * PACKETS_PER_TIC);
+    DENG2_UNUSED2(atEnd, count);
+}
+
+static void checkKeyframes(DemoReader const &reader)
+{
+    DENG2_ASSERT(reader.keyframeCount() == TICS / KEYFRAME_TICS);
+    for(int i = 0; i < reader.keyframeCount(); ++i)
+    {
+        DENG2_ASSERT(reader.keyframeTic(i) == i * KEYFRAME_TICS);
+    }
+}
+
+static void testRoundTrip()
+{
+    NativePath const path = tempPath("test_demofile.dem");
+    writeDemo(path);
+    DENG2_ASSERT(DemoReader::recognize(path));
+
+    DemoReader reader(path);
+    DENG2_ASSERT(reader.length() == TICS - 1);
+    checkKeyframes(reader);
+    readUntilEnd(reader, 0);
+
+    qDebug() << "Wrote and read" << TICS * PACKETS_PER_TIC << "packets,"
+             << QFile(path.toString()).size() << "bytes";
+
+    QFile::remove(path.toString());
+}
+
+static void testSeek()
+{
+    NativePath const path = tempPath("test_demofile_seek.dem");
+    writeDemo(path);
+
+    DemoReader reader(path);
+
+    // Forwards, backwards, and again from the same keyframe.
+    int const order[] = { 2, 1, 0, 1, 1 };
+    for(int i = 0; i < int(sizeof(order)/sizeof(order[0])); ++i)
+    {
+        reader.seekToKeyframe(order[i]);
+        readUntilEnd(reader, reader.keyframeTic(order[i]));
+    }
+
+    // Seeking in the middle of a chunk.
+    reader.seekToKeyframe(0);
+    dbyte type;
+    Block data;
+    reader.nextTic();
+    reader.readPacket(type, data);
+    reader.seekToKeyframe(2);
+    readUntilEnd(reader, 2 * KEYFRAME_TICS);
+
+    QFile::remove(path.toString());
+}
+
+static void testMissingIndex()
+{
+    NativePath const path = tempPath("test_demofile_noindex.dem");
+    writeDemo(path);
+
+    // Cut off the index, as if the recording had been interrupted.
+    QFile file(path.toString());
+    bool opened = file.open(QFile::ReadOnly);
+    DENG2_ASSERT(opened);
+    Block contents = file.readAll();
+    file.close();
+    int const indexAt = contents.lastIndexOf("DIdx");
+    DENG2_ASSERT(indexAt > 0);
+    contents.truncate(indexAt);
+    opened = file.open(QFile::WriteOnly | QFile::Truncate);
+    DENG2_ASSERT(opened);
+    file.write(contents);
+    file.close();
+    DENG2_UNUSED(opened);
+
+    // The index is rebuilt from the chunks.
+    DemoReader reader(path);
+    checkKeyframes(reader);
+    reader.seekToKeyframe(1);
+    readUntilEnd(reader, KEYFRAME_TICS);
+    reader.seekToKeyframe(0);
+    readUntilEnd(reader, 0);
+
+    QFile::remove(path.toString());
+}
+
+static void testCorruptPacket()
+{
+    NativePath const path = tempPath("test_demofile_corrupt.dem");
+
+    // A chunk whose only record claims to be longer than the chunk.
+    Block record;
+    Writer(record) << duint32(5) << duint32(1000) << dbyte(1);
+    record.append("abc");
+    Block const compressed = qCompress(record);
+
+    Block contents("DDmo");
+    Writer(contents, contents.size())
+            << duint32(1)                                   // Format version.
+            << duint32(5) << duint32(1) << duint32(compressed.size());
+    contents.append(compressed);
+
+    QFile file(path.toString());
+    bool const opened = file.open(QFile::WriteOnly | QFile::Truncate);
+    DENG2_ASSERT(opened);
+    file.write(contents);
+    file.close();
+    DENG2_UNUSED(opened);
+
+    DemoReader reader(path);
+    int const tic = reader.nextTic();
+    DENG2_ASSERT(tic == 5);
+    DENG2_UNUSED(tic);
+
+    bool rejected = false;
+    try
+    {
+        dbyte type;
+        Block data;
+        reader.readPacket(type, data);
+    }
+    catch(DemoReader::FormatError const &)
+    {
+        rejected = true;
+    }
+    DENG2_ASSERT(rejected);
+    DENG2_UNUSED(rejected);
+
+    QFile::remove(path.toString());
+}
+
+int main(int, char **)
+{
+    try
+    {
+        testRoundTrip();
+        testSeek();
+        testMissingIndex();
+        testCorruptPacket();
+    }
+    catch(Error const &err)
+    {
+        qWarning() << err.asText() << "\n";
+    }
+
+    qDebug() << "Exiting main()...\n";
+    return 0;
+}
@@ -0,0 +1,154 @@
+/**
+ * @file main.cpp
+ *
+ * Tests for the Huffman codec used for network messages. @ingroup tests
+ *
+ * @authors Copyright (c) 2015 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#include <de/Block>
+#include <de/Time>
+#include <de/data/huffman.h>
+#include <QDebug>
+#include <QVector>
+
+using namespace de;
+
+/*
+ * Output of the original tree-walking codec. The codes must not change, or
+ * peers running different versions could no longer talk to each other.
+ */
+static dbyte const encodedEmpty[]  = { 0x02 };
+static dbyte const encodedZero[]   = { 0x1c };
+static dbyte const encodedHello[]  = { 0xf4, 0x23, 0x17, 0x00, 0x80, 0x50, 0x76, 0xa2, 0x8a,
+                                       0x10, 0x21, 0xb1, 0x5c, 0xf3, 0x27, 0x0a, 0x06, 0x08 };
+static dbyte const encodedDelta[]  = { 0xfe, 0xff, 0xc7, 0x52 };
+static dbyte const encodedAllValues[] = {
+    0x9e, 0xcf, 0x3a, 0x9f, 0x6f, 0x82, 0xa4, 0x64, 0x69, 0x96, 0x09, 0x71,
+    0x6b, 0x41, 0x32, 0x64, 0x08, 0xc9, 0x93, 0x44, 0x83, 0x41, 0x4d, 0x84,
+    0xd6, 0x1c, 0x1b, 0x0a, 0x62, 0x8c, 0x35, 0x8d, 0x20, 0x84, 0xdc, 0x44,
+    0x01, 0xe2, 0x19, 0xb7, 0x79, 0x11, 0xb1, 0xb8, 0xa7, 0x43, 0x9e, 0x5f,
+    0xcb, 0xd9, 0x25, 0x96, 0x77, 0x84, 0x70, 0x5b, 0xa1, 0x98, 0x05, 0x08,
+    0x99, 0x3e, 0x79, 0xed, 0xd2, 0x25, 0xd6, 0x36, 0x8c, 0x61, 0x03, 0x81,
+    0x04, 0x73, 0x4e, 0x2f, 0xce, 0xc0, 0x31, 0xfc, 0xb0, 0x66, 0xde, 0x24,
+    0x39, 0xf8, 0xec, 0x59, 0xf0, 0x60, 0xd9, 0x8c, 0xf9, 0xf6, 0xed, 0x65,
+    0x76, 0x49, 0x09, 0x98, 0xb8, 0x8c, 0x04, 0x6d, 0xa4, 0x1a, 0x6a, 0x30,
+    0x11, 0x2d, 0xfe, 0xf9, 0xe5, 0xe6, 0x4e, 0xa3, 0x25, 0xda, 0x44, 0x23,
+    0x03, 0x88, 0x6d, 0x94, 0x10, 0x48, 0x59, 0x36, 0xb9, 0xb2, 0xb5, 0xd8,
+    0x5e, 0xfc, 0x86, 0xc1, 0xa4, 0xc0, 0xc2, 0x8b, 0x24, 0x3d, 0xb6, 0x1a,
+    0x41, 0x25, 0xe1, 0xc8, 0x19, 0xc7, 0x6d, 0x18, 0xab, 0x7e, 0xc5, 0x65,
+    0x63, 0x8a, 0xea, 0xba, 0x75, 0x34, 0x93, 0x31, 0x7d, 0x99, 0x72, 0x21,
+    0x29, 0x4a, 0xc8, 0x00, 0xf4, 0x2c, 0xd9, 0x0a, 0xee, 0x2e, 0x13, 0x44,
+    0x0b, 0x6e, 0xcc, 0xf8, 0xb0, 0x03, 0x9a, 0x7d, 0xc6, 0x88, 0xdb, 0x11,
+    0x1d, 0x30, 0x03, 0xf5, 0x64, 0x12, 0xe0, 0x34, 0x10, 0xbd, 0x78, 0x06,
+    0x12, 0x39, 0xf9, 0x6f, 0x2b, 0xb0, 0xed, 0xc6, 0xd2, 0x42, 0x79, 0xf2,
+    0xf6, 0xf3, 0x70, 0x27, 0x0d, 0x02, 0x34, 0x2f, 0x76, 0x96, 0xb3, 0x12,
+    0x01, 0xdb, 0xae, 0x0d, 0x66, 0x2d, 0x82, 0xb3, 0xd2, 0x6c, 0xae, 0xd4,
+    0x12, 0x96, 0xdd, 0x2a, 0x7d, 0x7f, 0x73, 0x89, 0x97, 0x04, 0x24, 0x68,
+    0xaa, 0x84, 0xc1, 0x73, 0x69, 0x82, 0x4a, 0x88, 0x0c, 0x93, 0x8b, 0xc7,
+    0x9f, 0x46, 0x62, 0x05, 0x63, 0x9a, 0x55, 0x74, 0x66, 0x23, 0x92, 0xe3,
+    0x2a, 0xac, 0xc8, 0xf0, 0xc4, 0x69, 0x86, 0x6e, 0x1c, 0x48, 0x0e, 0x46
+};
+
+static void testKnownCodes(Block const &data, dbyte const *expected, dsize expectedSize)
+{
+    Block const coded = codec::huffmanEncode(data);
+    DENG2_ASSERT(coded == Block(expected, expectedSize));
+    DENG2_ASSERT(codec::huffmanDecode(Block(expected, expectedSize)) == data);
+    DENG2_UNUSED2(coded, expectedSize);
+}
+
+static void testCompatibility()
+{
+    testKnownCodes(Block(), encodedEmpty, sizeof(encodedEmpty));
+    testKnownCodes(Block("\0", 1), encodedZero, sizeof(encodedZero));
+    testKnownCodes(Block("Hello, Doomsday!"), encodedHello, sizeof(encodedHello));
+    testKnownCodes(Block("\0\0\0\0\0\0\0\0\x12\x44\x80", 11), encodedDelta, sizeof(encodedDelta));
+
+    Block all(256);
+    for(int i = 0; i < 256; ++i) all.data()[i] = dbyte(i);
+    testKnownCodes(all, encodedAllValues, sizeof(encodedAllValues));
+}
+
+static void testRoundTrip()
+{
+    duint32 seed = 1;
+    QVector<dbyte> encoded, decoded;
+
+    for(int round = 0; round < 10000; ++round)
+    {
+        Block data(round % 600);
+        for(dsize i = 0; i < data.size(); ++i)
+        {
+            seed = seed * 1103515245 + 12345;
+            // Mostly zeros, as in real messages.
+            data.data()[i] = (seed >> 28 < 5? dbyte(seed >> 16) : 0);
+        }
+
+        encoded.resize(codec::huffmanMaxEncodedSize(data.size()));
+        dsize const codedSize = codec::huffmanEncode(data.data(), data.size(), encoded.data());
+        DENG2_ASSERT(codedSize <= dsize(encoded.size()));
+
+        decoded.resize(codec::huffmanMaxDecodedSize(codedSize));
+        dsize const decodedSize = codec::huffmanDecode(encoded.data(), codedSize, decoded.data());
+        DENG2_ASSERT(Block(decoded.constData(), decodedSize) == data);
+
+        // The Block variants produce the same bytes.
+        DENG2_ASSERT(codec::huffmanEncode(data) == Block(encoded.constData(), codedSize));
+        DENG2_UNUSED(decodedSize);
+    }
+}
+
+static void benchmark()
+{
+    int const count = 100000;
+    Block data(120);
+    for(dsize i = 0; i < data.size(); ++i) data.data()[i] = (i % 5? 0 : dbyte(i * 37));
+
+    QVector<dbyte> encoded(codec::huffmanMaxEncodedSize(data.size()));
+    QVector<dbyte> decoded(codec::huffmanMaxDecodedSize(encoded.size()));
+    dsize total = 0;
+
+    Time startedAt;
+    for(int i = 0; i < count; ++i)
+    {
+        dsize const size = codec::huffmanEncode(data.data(), data.size(), encoded.data());
+        total += codec::huffmanDecode(encoded.data(), size, decoded.data());
+    }
+    qDebug() << count << "messages of" << data.size() << "bytes encoded and decoded in"
+             << ddouble(startedAt.since()) << "s";
+
+    DENG2_ASSERT(total == count * data.size());
+    DENG2_UNUSED(total);
+}
+
+int main(int, char **)
+{
+    try
+    {
+        testCompatibility();
+        testRoundTrip();
+        benchmark();
+    }
+    catch(Error const &err)
+    {
+        qWarning() << err.asText() << "\n";
+    }
+
+    qDebug() << "Exiting main()...\n";
+    return 0;
+}
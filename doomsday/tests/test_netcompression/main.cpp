@@ -0,0 +1,271 @@
+/**
+ * @file main.cpp
+ *
+ * Tests and benchmarks the compression of network messages. @ingroup tests
+ *
+ * Replays server traffic recorded with the server's -netcapture option, or
+ * synthesized traffic if no capture file is given. The encoded messages are
+ * decoded again and compared to the originals, after which the compression
+ * methods are timed:
+ *
+ * <pre>test_netcompression [capture-file]</pre>
+ *
+ * @authors Copyright (c) 2015 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#include <de/Block>
+#include <de/Socket>
+#include <de/Time>
+#include <QDebug>
+#include <QFile>
+#include <QList>
+
+using namespace de;
+
+struct CapturedMessage
+{
+    int recipients;
+    Block payload;
+};
+
+typedef QList<CapturedMessage> Traffic;
+
+static Traffic readCapture(QString const &path)
+{
+    QFile file(path);
+    if(!file.open(QFile::ReadOnly))
+    {
+        throw Error("readCapture", "Cannot open " + path);
+    }
+    Block const data = file.readAll();
+
+    Traffic traffic;
+    dsize pos = 0;
+    while(pos + 5 <= data.size())
+    {
+        Byte const *header = data.data() + pos;
+        CapturedMessage msg;
+        msg.recipients = header[0];
+        dsize const size = header[1] | (header[2] << 8) | (header[3] << 16) | (duint32(header[4]) << 24);
+        pos += 5;
+        if(pos + size > data.size()) break; // Truncated.
+        msg.payload = Block(data, pos, size);
+        pos += size;
+        traffic << msg;
+    }
+    return traffic;
+}
+
+/**
+ * Generates traffic resembling a 16-player game: every tick each player gets
+ * a frame of deltas that mostly repeats the previous one, and now and then a
+ * sound or a chat message is broadcast to everyone.
+ */
+static Traffic synthesizeTraffic()
+{
+    int const players = 16;
+    int const ticks   = 35 * 60;
+
+    Traffic traffic;
+    Block frame(600);
+    for(dsize i = 0; i < frame.size(); ++i) frame.data()[i] = Byte(i * 31 % 97);
+
+    for(int tic = 0; tic < ticks; ++tic)
+    {
+        for(int plr = 0; plr < players; ++plr)
+        {
+            // Some of the deltas change every tick.
+            for(int k = 0; k < 40; ++k)
+            {
+                frame.data()[(tic * 13 + plr * 7 + k * 17) % frame.size()] = Byte(tic + plr + k);
+            }
+            CapturedMessage msg;
+            msg.recipients = 1;
+            msg.payload = frame;
+            traffic << msg;
+        }
+        if(tic % 5 == 0)
+        {
+            CapturedMessage msg;
+            msg.recipients = players;
+            msg.payload = Block(frame, 0, 100 + (tic % 3) * 200);
+            traffic << msg;
+        }
+    }
+    return traffic;
+}
+
+/**
+ * Decodes @a wire fed to a decoder in pieces of @a maxPiece bytes at most (or
+ * all at once if zero), and checks that the original payloads come out.
+ */
+static void decodeAll(Block const &wire, Traffic const &traffic, dsize maxPiece)
+{
+    Socket::MessageDecoder decoder;
+    duint32 seed = 1;
+    dsize pos = 0;
+    int decoded = 0;
+    Block payload;
+
+    while(pos < wire.size())
+    {
+        dsize piece = wire.size() - pos;
+        if(maxPiece)
+        {
+            seed = seed * 1103515245 + 12345;
+            piece = de::min(piece, 1 + (seed >> 16) % maxPiece);
+        }
+        decoder.receive(Block(wire, pos, piece));
+        pos += piece;
+
+        while(decoder.decode(payload))
+        {
+            DENG2_ASSERT(decoded < traffic.size());
+            DENG2_ASSERT(payload == traffic.at(decoded).payload);
+            decoded++;
+        }
+    }
+
+    // Nothing is left over.
+    bool const gotMore = decoder.decode(payload);
+    DENG2_ASSERT(!gotMore);
+    DENG2_ASSERT(decoded == traffic.size());
+    DENG2_UNUSED(gotMore);
+}
+
+/**
+ * Sends the traffic through the wire format and back. Like on the server,
+ * broadcasts are encoded without the connection's stream, and the rest of the
+ * messages continue the stream.
+ */
+static void testRoundTrip(Traffic traffic)
+{
+    // Also a message too large for the stream.
+    CapturedMessage large;
+    large.recipients = 1;
+    large.payload = Block(20000);
+    for(dsize i = 0; i < large.payload.size(); ++i) large.payload.data()[i] = Byte(i * i >> 5);
+    traffic.insert(traffic.size() / 2, large);
+
+    Block wire;
+    int streamed = 0;
+    Socket::DeflateStream stream;
+    foreach(CapturedMessage const &msg, traffic)
+    {
+        Socket::EncodedMessage const encoded(msg.payload, msg.recipients > 1? 0 : &stream);
+        Block const &bytes = encoded.bytes();
+
+        // Medium-sized header with the deflate and stream flags.
+        if((bytes.at(0) & 0x80) && (bytes.at(1) & 0xe0) == 0x60) streamed++;
+
+        wire += bytes;
+    }
+    DENG2_ASSERT(streamed > 0);
+    DENG2_UNUSED(streamed);
+
+    // Messages concatenated in one piece.
+    decodeAll(wire, traffic, 0);
+
+    // Messages split at arbitrary points, including within headers.
+    decodeAll(wire, traffic, 3);
+    decodeAll(wire, traffic, 1500);
+
+    qDebug() << traffic.size() << "messages decoded," << streamed << "of them stream compressed";
+}
+
+static void benchmark(Traffic const &traffic)
+{
+    dsize rawBytes = 0;
+    int broadcasts = 0;
+    foreach(CapturedMessage const &msg, traffic)
+    {
+        rawBytes += msg.payload.size() * msg.recipients;
+        if(msg.recipients > 1) broadcasts++;
+    }
+    qDebug() << traffic.size() << "messages," << broadcasts << "broadcasts,"
+             << rawBytes << "bytes uncompressed";
+
+    // Broadcasts: compressed separately for each recipient vs. only once.
+    {
+        dsize checksum = 0;
+        Time startedAt;
+        foreach(CapturedMessage const &msg, traffic)
+        {
+            for(int i = 0; i < msg.recipients; ++i)
+            {
+                checksum += Socket::EncodedMessage(msg.payload).bytes().size();
+            }
+        }
+        TimeDelta const separateTime = startedAt.since();
+
+        startedAt = Time();
+        dsize sentBytes = 0;
+        foreach(CapturedMessage const &msg, traffic)
+        {
+            Socket::EncodedMessage const encoded(msg.payload);
+            sentBytes += encoded.bytes().size() * msg.recipients;
+        }
+        TimeDelta const onceTime = startedAt.since();
+
+        // Identical output either way.
+        DENG2_ASSERT(checksum == sentBytes);
+        DENG2_UNUSED(checksum);
+
+        qDebug() << "Encoded per recipient:" << ddouble(separateTime) << "s,"
+                 << "encoded once:" << ddouble(onceTime) << "s";
+    }
+
+    // Each message compressed separately vs. as a connection's deflate stream.
+    {
+        dsize separateBytes = 0;
+        Time startedAt;
+        foreach(CapturedMessage const &msg, traffic)
+        {
+            separateBytes += Socket::EncodedMessage(msg.payload).bytes().size();
+        }
+        TimeDelta const separateTime = startedAt.since();
+
+        dsize streamBytes = 0;
+        Socket::DeflateStream stream;
+        startedAt = Time();
+        foreach(CapturedMessage const &msg, traffic)
+        {
+            streamBytes += Socket::EncodedMessage(msg.payload, &stream).bytes().size();
+        }
+        TimeDelta const streamTime = startedAt.since();
+
+        qDebug() << "Separate messages:" << separateBytes << "bytes in" << ddouble(separateTime) << "s,"
+                 << "deflate stream:" << streamBytes << "bytes in" << ddouble(streamTime) << "s";
+    }
+}
+
+int main(int argc, char **argv)
+{
+    try
+    {
+        Traffic const traffic = (argc > 1? readCapture(argv[1]) : synthesizeTraffic());
+        testRoundTrip(traffic);
+        benchmark(traffic);
+    }
+    catch(Error const &err)
+    {
+        qWarning() << err.asText() << "\n";
+    }
+
+    qDebug() << "Exiting main()...\n";
+    return 0;
+}
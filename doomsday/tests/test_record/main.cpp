@@ -72,6 +72,15 @@ int main(int argc, char **argv)
         Record copied = before;
         DENG2_ASSERT(copied.hasSubrecord("subrecord"));
         LOG_MSG("Copied:\n") << copied;
+
+        // Prepared keys find the same members as plain names and paths.
+        RecordKey const sizeKey("size");
+        RecordKey const valueKey("subrecord.value");
+        RecordKey const missingKey("subrecord.missing");
+        DENG2_ASSERT(rec2.has(sizeKey) && rec2[sizeKey].value().asNumber() == 1024);
+        DENG2_ASSERT(copied.has(valueKey) && copied[valueKey].value().isTrue());
+        DENG2_ASSERT(!copied.has(missingKey) && !rec2.has(valueKey));
+        DENG2_UNUSED3(sizeKey, valueKey, missingKey);
     }
     catch(Error const &err)
     {
@@ -0,0 +1,234 @@
+/**
+ * @file main.cpp
+ *
+ * Tests and benchmarks for the band-limited resampler. @ingroup tests
+ *
+ * @authors Copyright (c) 2015 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#include <de/Error>
+#include <de/Resampler>
+#include <de/Time>
+#include <de/math.h>
+#include <QDebug>
+#include <QVector>
+#include <cmath>
+
+using namespace de;
+
+/**
+ * The linear interpolation previously used by the sound sample cache
+ * (16-bit samples, 2x or 4x rate only).
+ */
+static QVector<short> legacyResample(QVector<short> const &src, int factor)
+{
+    QVector<short> dst(src.size() * factor);
+    short const *sp = src.constData();
+    short *dp = dst.data();
+    for(int i = 0; i < src.size() - 1; ++i, sp++)
+    {
+        if(factor == 2)
+        {
+            *dp++ = *sp;
+            *dp++ = (*sp + sp[1]) >> 1;
+        }
+        else
+        {
+            short const mid = (*sp + sp[1]) >> 1;
+            *dp++ = *sp;
+            *dp++ = (*sp + mid) >> 1;
+            *dp++ = mid;
+            *dp++ = (mid + sp[1]) >> 1;
+        }
+    }
+    for(int i = 0; i < factor; ++i) *dp++ = *sp;
+    return dst;
+}
+
+static QVector<short> newResample(QVector<short> const &src, int inRate, int outRate)
+{
+    Resampler resampler(inRate, outRate);
+
+    QVector<float> input(src.size());
+    for(int i = 0; i < src.size(); ++i) input[i] = src[i] / 32768.f;
+
+    QVector<float> output(int(resampler.outputLength(src.size())));
+    resampler.convert(input.constData(), src.size(), output.data());
+
+    QVector<short> dst(output.size());
+    for(int i = 0; i < output.size(); ++i)
+    {
+        dst[i] = short(de::clamp(-32768, int(std::floor(output[i] * 32768 + .5f)), 32767));
+    }
+    return dst;
+}
+
+static QVector<short> sine(double freq, int rate, int count)
+{
+    QVector<short> samples(count);
+    for(int i = 0; i < count; ++i)
+    {
+        samples[i] = short(16000 * std::sin(2 * PI * freq * i / rate));
+    }
+    return samples;
+}
+
+/**
+ * Signal-to-noise ratio (dB) of resampled sine wave compared to an ideal one.
+ * Both the images left by interpolation and the distortion of the passband
+ * count as noise. The ends of the sound are ignored.
+ */
+static double sineSNR(QVector<short> const &samples, double freq, int rate)
+{
+    double signal = 0, noise = 0;
+    for(int i = samples.size() / 10; i < samples.size() * 9 / 10; ++i)
+    {
+        double const ideal = 16000 * std::sin(2 * PI * freq * i / rate);
+        signal += ideal * ideal;
+        noise  += (samples[i] - ideal) * (samples[i] - ideal);
+    }
+    return 10 * std::log10(signal / de::max(noise, 1e-9));
+}
+
+static void testQuality()
+{
+    struct { int inRate; int outRate; double freq; } const cases[] = {
+        { 11025, 44100, 1000 },
+        { 11025, 44100, 4000 },
+        { 22050, 44100, 8000 }
+    };
+    for(auto const &c : cases)
+    {
+        QVector<short> const src = sine(c.freq, c.inRate, c.inRate);
+        double const legacy = sineSNR(legacyResample(src, c.outRate / c.inRate), c.freq, c.outRate);
+        double const snr    = sineSNR(newResample(src, c.inRate, c.outRate), c.freq, c.outRate);
+
+        qDebug() << c.inRate << "->" << c.outRate << "Hz," << c.freq << "Hz sine: SNR"
+                 << legacy << "dB (linear)," << snr << "dB (polyphase)";
+
+        // Limited by the 16-bit output.
+        DENG2_ASSERT(snr > 60);
+        DENG2_ASSERT(snr > legacy);
+        DENG2_UNUSED2(legacy, snr);
+    }
+
+    // Arbitrary ratios, including downsampling.
+    struct { int inRate; int outRate; double freq; } const arbitrary[] = {
+        { 48000, 44100, 3000 },
+        { 11025, 48000, 2000 },
+        { 44100, 22050, 1000 }
+    };
+    for(auto const &c : arbitrary)
+    {
+        double const snr = sineSNR(newResample(sine(c.freq, c.inRate, c.inRate), c.inRate, c.outRate),
+                                   c.freq, c.outRate);
+        qDebug() << c.inRate << "->" << c.outRate << "Hz," << c.freq << "Hz sine: SNR" << snr << "dB";
+        DENG2_ASSERT(snr > 60);
+        DENG2_UNUSED(snr);
+    }
+
+    // Frequencies above the Nyquist frequency of the output are removed
+    // instead of aliasing.
+    {
+        QVector<short> const out = newResample(sine(8000, 44100, 44100), 44100, 11025);
+        double energy = 0;
+        for(int i = out.size() / 10; i < out.size() * 9 / 10; ++i) energy += double(out[i]) * out[i];
+        double const level = 10 * std::log10(de::max(energy / (out.size() * .8), 1e-9) / (16000.0 * 16000 / 2));
+        qDebug() << "8000 Hz sine downsampled to 11025 Hz: alias level" << level << "dB";
+        DENG2_ASSERT(level < -60);
+        DENG2_UNUSED(level);
+    }
+}
+
+static void testStreaming()
+{
+    int const count = 10007;
+    QVector<float> input(count);
+    duint32 seed = 1;
+    for(int i = 0; i < count; ++i)
+    {
+        seed = seed * 1103515245 + 12345;
+        input[i] = float(std::sin(i * .01) * .5 + (int(seed >> 16 & 0xff) - 128) / 1024.0);
+    }
+
+    Resampler whole(11025, 44100);
+    QVector<float> expected(int(whole.outputLength(count)));
+    dsize const converted = whole.convert(input.constData(), count, expected.data());
+    DENG2_ASSERT(converted == dsize(expected.size()));
+    DENG2_UNUSED(converted);
+
+    // Feeding the input in pieces produces the same output.
+    Resampler stream(11025, 44100);
+    QVector<float> output;
+    float piece[777];
+    for(int pos = 0; pos < count; pos += 333)
+    {
+        stream.write(input.constData() + pos, de::min(333, count - pos));
+        while(dsize n = stream.read(piece, 777))
+        {
+            for(dsize i = 0; i < n; ++i) output << piece[i];
+        }
+    }
+    stream.finish();
+    while(dsize n = stream.read(piece, 777))
+    {
+        for(dsize i = 0; i < n; ++i) output << piece[i];
+    }
+    DENG2_ASSERT(output == expected);
+}
+
+static void benchmark()
+{
+    // Ten seconds of sound.
+    QVector<short> const src = sine(1000, 11025, 110250);
+    int const rounds = 20;
+
+    Time startedAt;
+    for(int i = 0; i < rounds; ++i) legacyResample(src, 4);
+    ddouble const legacyTime = startedAt.since();
+
+    startedAt = Time();
+    for(int i = 0; i < rounds; ++i) newResample(src, 11025, 44100);
+    ddouble const newTime = startedAt.since();
+
+    qDebug() << "11025 -> 44100 Hz, output samples per second:"
+             << rounds * src.size() * 4 / legacyTime << "(linear),"
+             << rounds * src.size() * 4 / newTime << "(polyphase," << Resampler::kernelName() << ")";
+
+    QVector<short> const hires = sine(1000, 48000, 480000);
+    startedAt = Time();
+    for(int i = 0; i < rounds; ++i) newResample(hires, 48000, 44100);
+    qDebug() << "48000 -> 44100 Hz, output samples per second:"
+             << rounds * hires.size() * 44100.0 / 48000 / ddouble(startedAt.since());
+}
+
+int main(int, char **)
+{
+    try
+    {
+        testQuality();
+        testStreaming();
+        benchmark();
+    }
+    catch(Error const &err)
+    {
+        qWarning() << err.asText() << "\n";
+    }
+
+    qDebug() << "Exiting main()...\n";
+    return 0;
+}
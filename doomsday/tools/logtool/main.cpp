@@ -0,0 +1,280 @@
+/*
+ * The Doomsday Engine Project
+ *
+ * Copyright (c) 2015 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * Filters and formats binary log files (written by de::BinaryLogSink) to text.
+ */
+
+#include <de/BinaryLogSink>
+#include <de/Block>
+#include <de/Log>
+#include <de/MonospaceLogSinkFormatter>
+#include <de/Range>
+#include <de/Reader>
+#include <QDateTime>
+#include <QFile>
+#include <QList>
+#include <QTextStream>
+
+using namespace de;
+
+namespace {
+
+struct Filter
+{
+    LogEntry::Level minLevel;
+    duint32 domains;    ///< Zero for all.
+    bool allowDev;
+    Time since;
+    Time until;
+
+    Filter()
+        : minLevel(LogEntry::LowestLogLevel)
+        , domains(0)
+        , allowDev(true)
+        , since(Time::invalidTime())
+        , until(Time::invalidTime())
+    {}
+
+    bool accepts(BinaryLogSink::Index const &index) const
+    {
+        if(!index.mayContain(minLevel, domains, allowDev)) return false;
+        if(since.isValid() && index.last  < since) return false;
+        if(until.isValid() && index.first > until) return false;
+        return true;
+    }
+
+    bool accepts(LogEntry const &entry) const
+    {
+        if(entry.level() < minLevel) return false;
+        if(domains && !(entry.metadata() & domains)) return false;
+        if(!allowDev && (entry.metadata() & LogEntry::Dev)) return false;
+        if(since.isValid() && entry.when() < since) return false;
+        if(until.isValid() && entry.when() > until) return false;
+        return true;
+    }
+};
+
+struct Record
+{
+    BinaryLogSink::RecordType type;
+    dsize offset;   ///< Offset of the record.
+    dsize payload;  ///< Offset of the payload.
+};
+
+void usage()
+{
+    QTextStream(stderr)
+        << "Usage: logtool [options] <file.dlog>\n"
+           "Options:\n"
+           "  --level <name>    Minimum entry level (e.g., Message, Warning).\n"
+           "  --domain <name>   Only entries in a domain (e.g., Map, GL); can be repeated.\n"
+           "  --nodev           Omit developer entries.\n"
+           "  --since <time>    Omit entries before the time.\n"
+           "  --until <time>    Omit entries after the time.\n"
+           "Times are given as \"yyyy-MM-dd hh:mm:ss.zzz\" (quoted), \"yyyy-MM-dd hh:mm:ss\"\n"
+           "or yyyy-MM-dd, in local time.\n"
+           "  --width <n>       Maximum line length.\n";
+}
+
+Time parseTime(String const &text)
+{
+    Time time = Time::fromText(text, Time::ISOFormat);
+    if(!time.isValid())
+    {
+        // Milliseconds may be omitted.
+        time = Time(QDateTime::fromString(text, "yyyy-MM-dd hh:mm:ss"));
+    }
+    if(!time.isValid())
+    {
+        time = Time::fromText(text, Time::ISODateOnly);
+    }
+    if(!time.isValid())
+    {
+        throw Error("logtool", "Invalid time: " + text);
+    }
+    return time;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    try
+    {
+        Filter filter;
+        MonospaceLogSinkFormatter formatter;
+        String fileName;
+
+        for(int i = 1; i < argc; ++i)
+        {
+            String const arg = String::fromUtf8(argv[i]);
+            bool const hasValue = (i + 1 < argc);
+            if(arg == "--level" && hasValue)
+            {
+                filter.minLevel = LogEntry::textToLevel(String::fromUtf8(argv[++i]));
+            }
+            else if(arg == "--domain" && hasValue)
+            {
+                filter.domains |= LogEntry::textToContext(String::fromUtf8(argv[++i])) &
+                                  LogEntry::DomainMask;
+            }
+            else if(arg == "--nodev")
+            {
+                filter.allowDev = false;
+            }
+            else if(arg == "--since" && hasValue)
+            {
+                filter.since = parseTime(String::fromUtf8(argv[++i]));
+            }
+            else if(arg == "--until" && hasValue)
+            {
+                filter.until = parseTime(String::fromUtf8(argv[++i]));
+            }
+            else if(arg == "--width" && hasValue)
+            {
+                formatter.setMaxLength(duint(String::fromUtf8(argv[++i]).toInt()));
+            }
+            else if(!arg.startsWith("-") && fileName.isEmpty())
+            {
+                fileName = arg;
+            }
+            else
+            {
+                usage();
+                return -1;
+            }
+        }
+        if(fileName.isEmpty())
+        {
+            usage();
+            return -1;
+        }
+
+        QFile file(fileName);
+        if(!file.open(QFile::ReadOnly))
+        {
+            throw Error("logtool", "Failed to open " + fileName);
+        }
+        Block const data = file.readAll();
+        file.close();
+
+        Reader reader(data);
+        duint32 magic;
+        duint16 formatVersion;
+        reader >> magic >> formatVersion;
+        if(magic != BinaryLogSink::MAGIC || formatVersion > BinaryLogSink::FORMAT_VERSION)
+        {
+            throw Error("logtool", fileName + " is not a supported binary log");
+        }
+        reader.withHeader();
+
+        // Locate all the records, and use the indices to find out which blocks
+        // can be skipped altogether.
+        QList<Record> records;
+        QList<Range<dsize> > skipped;
+        bool truncated = false;
+        while(!reader.atEnd())
+        {
+            Record rec;
+            rec.offset = reader.offset();
+
+            dbyte type;
+            duint32 size;
+            if(reader.remainingSize() < sizeof(type) + sizeof(size))
+            {
+                truncated = true;
+                break;
+            }
+            reader >> type >> size;
+            if(reader.remainingSize() < size)
+            {
+                truncated = true;
+                break;
+            }
+            rec.type    = BinaryLogSink::RecordType(type);
+            rec.payload = reader.offset();
+
+            if(rec.type == BinaryLogSink::IndexRecord)
+            {
+                BinaryLogSink::Index index;
+                reader >> index;
+                if(!filter.accepts(index))
+                {
+                    skipped << Range<dsize>(dsize(index.blockStart), rec.offset);
+                }
+            }
+            else
+            {
+                records << rec;
+            }
+            reader.setOffset(rec.payload + size);
+        }
+
+        // Format the entries. The indices only summarize entry records; plain
+        // text records are never filtered.
+        int nextSkip = 0;
+        foreach(Record const &rec, records)
+        {
+            while(nextSkip < skipped.size() && skipped[nextSkip].end <= rec.offset)
+            {
+                nextSkip++;
+            }
+            if(rec.type == BinaryLogSink::EntryRecord &&
+               nextSkip < skipped.size() && skipped[nextSkip].contains(rec.offset))
+            {
+                continue;
+            }
+
+            reader.setOffset(rec.payload);
+            if(rec.type == BinaryLogSink::EntryRecord)
+            {
+                LogEntry entry;
+                reader >> entry;
+                if(filter.accepts(entry))
+                {
+                    foreach(String const &line, formatter.logEntryToTextLines(entry))
+                    {
+                        out << line << "\n";
+                    }
+                }
+            }
+            else if(rec.type == BinaryLogSink::PlainTextRecord)
+            {
+                String text;
+                reader >> text;
+                out << text << "\n";
+            }
+        }
+
+        if(truncated)
+        {
+            err << fileName << ": the last record is incomplete\n";
+        }
+    }
+    catch(Error const &er)
+    {
+        err << er.asText() << "\n";
+        return -1;
+    }
+    return 0;
+}